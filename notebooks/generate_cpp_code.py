@@ -2,6 +2,9 @@ import numpy as np
 import sympy
 from sympy import Matrix, MatrixSymbol
 from sympy.printing import ccode
+from sympy.printing.cxx import CXX11CodePrinter
+from sympy.printing.precedence import precedence
+import re
 import subprocess
 
 from utils import jacobian
@@ -105,3 +108,181 @@ namespace autogen{{
 }}
 """)
     subprocess.run(["clang-format", str(file_name), "-i"])
+
+
+def wrap_line(line, indent, width=80):
+    """Wrap a long line of code before its binary operators."""
+    if len(indent) + len(line) <= width:
+        return [indent + line]
+    segments = []
+    for token in line.split(" "):
+        if not segments or token in ("+", "-", "*", "/"):
+            segments.append(token)
+        else:
+            segments[-1] += " " + token
+    lines, current = [], indent + segments[0]
+    for segment in segments[1:]:
+        if len(current) + 1 + len(segment) > width:
+            lines.append(current)
+            current = indent + "    " + segment
+        else:
+            current += " " + segment
+    lines.append(current)
+    return lines
+
+
+def strip_parentheses(code):
+    """Remove the parentheses around a whole expression."""
+    if not (code.startswith("(") and code.endswith(")")):
+        return code
+    depth = 0
+    for i, c in enumerate(code):
+        depth += {"(": 1, ")": -1}.get(c, 0)
+        if depth == 0 and i < len(code) - 1:
+            return code
+    return code[1:-1]
+
+
+def upper_triangle(H):
+    """Upper triangle of a symmetric matrix packed in column-major order."""
+    return [H[r, c] for c in range(H.shape[1]) for r in range(c + 1)]
+
+
+class BatchedCodePrinter(CXX11CodePrinter):
+    """C++ printer expanding squares and spacing out binary operators."""
+
+    def _print_Pow(self, expr):
+        if expr.exp in (2, -2):
+            base = self.parenthesize(expr.base, precedence(expr))
+            square = f"({base} * {base})"
+            return square if expr.exp == 2 else f"(1.0 / {square})"
+        return super()._print_Pow(expr)
+
+    def doprint(self, expr, assign_to=None):
+        code = super().doprint(expr, assign_to)
+        return re.sub(r"(?<=[\w)])([*/])(?=[\w(-])", r" \1 ", code)
+
+
+class CXXBatchedGenerator:
+    """Generate a kernel evaluating expressions of N stencils in SoA layout.
+
+    The i-th stencil's j-th parameter is read from x[j * n + i], and the k-th
+    value of an output is written to out[k * n + i]. The loop body is straight
+    line code, so the compiler can vectorize it across stencils. All outputs
+    share one common-subexpression elimination (e.g., the gradient and Hessian
+    reuse the same subexpressions).
+    """
+
+    def __init__(self, outputs, params, name):
+        self.outputs = outputs  # list of (name, list of expressions)
+        self.params = params
+        self.name = name
+        self.comment = (
+            f"// x is ({len(params)}×n) in SoA layout; "
+            + "; ".join(f"{out_name} is ({len(exprs)}×n)"
+                        for out_name, exprs in outputs))
+
+    def signature(self):
+        params = ["const size_t n", "const double* __restrict x"] + [
+            f"double* __restrict {out_name}" for out_name, _ in self.outputs]
+        params = ",\n".join("    " + param for param in params)
+        return f"{self.comment}\nvoid {self.name}(\n{params});"
+
+    def __call__(self):
+        exprs = [expr for _, out_exprs in self.outputs for expr in out_exprs]
+        helpers, results = sympy.cse(
+            exprs, sympy.numbered_symbols("t"), optimizations='basic')
+
+        printer = BatchedCodePrinter()
+        lines = []
+        for j, param in enumerate(self.params):
+            lines.append(f"const double {param} = x[{j} * n + i];")
+        for symbol, expr in helpers:
+            lines.append(
+                f"const double {symbol} = "
+                f"{strip_parentheses(printer.doprint(expr))};")
+        results = iter(results)
+        for out_name, out_exprs in self.outputs:
+            for k in range(len(out_exprs)):
+                index = "i" if len(out_exprs) == 1 else f"{k} * n + i"
+                lines.append(
+                    f"{out_name}[{index}] = "
+                    f"{strip_parentheses(printer.doprint(next(results)))};")
+
+        # The whole function is indented by 4 in the namespace.
+        body = "\n".join(
+            wrapped for line in lines
+            for wrapped in wrap_line(line, " " * 8, width=76))
+        return f"""\
+{self.signature()[:-1]}
+{{
+    IPC_TOOLKIT_VECTORIZE_LOOP
+    for (size_t i = 0; i < n; i++) {{
+{body}
+    }}
+}}"""
+
+
+class CXXBatchedDistanceGenerator(CXXBatchedGenerator):
+    """Batched distance, gradient, and packed upper-triangular Hessian."""
+
+    def __init__(self, expr, params, name):
+        params = list(params)
+        grad = [expr.diff(param) for param in params]
+        hess = Matrix([[g.diff(param) for param in params] for g in grad])
+        super().__init__(
+            [("d", [expr]), ("g", grad), ("H", upper_triangle(hess))],
+            params, name)
+
+
+def indent_code(code, indent):
+    return "\n".join(
+        indent + line if line else line for line in code.split("\n"))
+
+
+def generate_batched_hpp_file(code_generators, file_name, comment=""):
+    newline = "\n"
+    with open(file_name, 'w') as f:
+        f.write(f"""\
+#pragma once
+
+#include <cstddef>
+
+{comment}
+namespace ipc {{
+namespace autogen {{
+{newline.join(indent_code(code_generator.signature(), "    ") + newline
+              for code_generator in code_generators)}\
+}} // namespace autogen
+}} // namespace ipc
+""")
+
+
+def generate_batched_cpp_file(code_generators, file_name):
+    header = file_name.split("/")[-1][:-4] + ".hpp"
+    newline = "\n"
+    with open(file_name, 'w') as f:
+        f.write(f"""\
+#include "{header}"
+
+// The outputs of different stencils never alias, so the loops can be
+// vectorized without runtime alias checks between the output streams.
+#if defined(__clang__)
+#define IPC_TOOLKIT_VECTORIZE_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define IPC_TOOLKIT_VECTORIZE_LOOP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define IPC_TOOLKIT_VECTORIZE_LOOP __pragma(loop(ivdep))
+#else
+#define IPC_TOOLKIT_VECTORIZE_LOOP
+#endif
+
+// clang-format off
+namespace ipc {{
+namespace autogen {{
+{(newline * 2).join(indent_code(code_generator(), "    ")
+                    for code_generator in code_generators)}
+}} // namespace autogen
+}} // namespace ipc
+// clang-format on
+""")
@@ -23,8 +23,11 @@ PYBIND11_MODULE(ipctk, m)
     define_sweep(m);
     define_voxel_size_heuristic(m);
 
-    // candidates
+    // candidates (the CCD prefilter options are default arguments)
+    define_ccd_prefilter(m);
     define_candidates(m);
+    define_cached_candidates(m);
+    define_compact_candidates(m);
     define_collision_stencil(m);
     define_continuous_collision_candidate(m);
     define_edge_edge_candidate(m);
@@ -37,15 +40,19 @@ PYBIND11_MODULE(ipctk, m)
     define_ccd_aabb(m);
     define_ccd(m);
     define_inexact_point_edge(m);
+    define_point_sdf(m);
     define_point_static_plane(m);
 
     // collisions
+    define_batched_collision_constraints(m);
     define_collision_constraint(m);
     define_collision_constraints(m);
+    define_compact_collision_constraints(m);
     define_edge_edge_constraint(m);
     define_edge_vertex_constraint(m);
     define_face_vertex_constraint(m);
     define_plane_vertex_constraint(m);
+    define_sdf_vertex_constraint(m);
     define_vertex_vertex_constraint(m);
 
     // distance
@@ -76,7 +83,9 @@ PYBIND11_MODULE(ipctk, m)
     define_vertex_vertex_friction_constraint(m);
 
     // implicits
+    define_grid_sdf(m);
     define_plane_implicit(m);
+    define_sdf_implicit(m);
 
     // utils
     define_area_gradient(m);
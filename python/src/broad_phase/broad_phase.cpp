@@ -24,7 +24,9 @@ void define_broad_phase(py::module_& m)
 
     py::class_<BroadPhase>(m, "BroadPhase")
         .def_static(
-            "make_broad_phase", &BroadPhase::make_broad_phase,
+            "make_broad_phase",
+            py::overload_cast<const BroadPhaseMethod>(
+                &BroadPhase::make_broad_phase),
             R"ipc_Qu8mg5v7(
             Construct a registered broad phase object.
 
@@ -35,6 +37,24 @@ void define_broad_phase(py::module_& m)
                 The constructed broad phase object.
             )ipc_Qu8mg5v7",
             py::arg("broad_phase_method"))
+        .def_static(
+            "make_broad_phase",
+            py::overload_cast<const BroadPhaseMethod, const CollisionMesh&>(
+                &BroadPhase::make_broad_phase),
+            R"ipc_Qu8mg5v7(
+            Construct a registered broad phase object for a collision mesh.
+
+            Note:
+                The broad phase filters with the mesh's can_collide, and it is partitioned into static and moving elements if the mesh has static vertices.
+
+            Parameters:
+                broad_phase_method: The broad phase method to use.
+                mesh: The collision mesh.
+
+            Returns:
+                The constructed broad phase object.
+            )ipc_Qu8mg5v7",
+            py::arg("broad_phase_method"), py::arg("mesh"))
         .def(
             "build",
             py::overload_cast<
@@ -49,8 +69,8 @@ void define_broad_phase(py::module_& m)
                 faces: Collision mesh faces
                 inflation_radius: Radius of inflation around all elements.
             )ipc_Qu8mg5v7",
-            py::arg("vertices"), py::arg("edges"), py::arg("faces"),
-            py::arg("inflation_radius") = 0)
+            py::call_guard<py::gil_scoped_release>(), py::arg("vertices"),
+            py::arg("edges"), py::arg("faces"), py::arg("inflation_radius") = 0)
         .def(
             "build",
             py::overload_cast<
@@ -67,8 +87,9 @@ void define_broad_phase(py::module_& m)
                 faces: Collision mesh faces
                 inflation_radius: Radius of inflation around all elements.
             )ipc_Qu8mg5v7",
-            py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
-            py::arg("faces"), py::arg("inflation_radius") = 0)
+            py::call_guard<py::gil_scoped_release>(), py::arg("vertices_t0"),
+            py::arg("vertices_t1"), py::arg("edges"), py::arg("faces"),
+            py::arg("inflation_radius") = 0)
         .def("clear", &BroadPhase::clear, "Clear any built data.")
         .def(
             "detect_edge_vertex_candidates",
@@ -82,7 +103,8 @@ void define_broad_phase(py::module_& m)
 
             Returns:
                 The candidate edge-vertex collisisons.
-            )ipc_Qu8mg5v7")
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>())
         .def(
             "detect_edge_edge_candidates",
             [](BroadPhase& self) {
@@ -95,7 +117,8 @@ void define_broad_phase(py::module_& m)
 
             Returns:
                 The candidate edge-edge collisisons.
-            )ipc_Qu8mg5v7")
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>())
         .def(
             "detect_face_vertex_candidates",
             [](BroadPhase& self) {
@@ -108,7 +131,8 @@ void define_broad_phase(py::module_& m)
 
             Returns:
                 The candidate face-vertex collisisons.
-            )ipc_Qu8mg5v7")
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>())
         .def(
             "detect_edge_face_candidates",
             [](BroadPhase& self) {
@@ -121,7 +145,8 @@ void define_broad_phase(py::module_& m)
 
             Returns:
                 The candidate edge-face intersections.
-            )ipc_Qu8mg5v7")
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>())
         .def(
             "detect_collision_candidates",
             [](BroadPhase& self, int dim) {
@@ -135,7 +160,7 @@ void define_broad_phase(py::module_& m)
             Parameters:
                 dim: The dimension of the simulation (i.e., 2 or 3).
             )ipc_Qu8mg5v7",
-            py::arg("dim"))
+            py::call_guard<py::gil_scoped_release>(), py::arg("dim"))
         .def_readwrite(
             "can_vertices_collide", &BroadPhase::can_vertices_collide,
             "Function for determining if two vertices can collide.");
@@ -9,7 +9,7 @@ void define_hash_grid(py::module_& m)
 {
     py::class_<HashItem>(m, "HashItem")
         .def(
-            py::init<int, int>(),
+            py::init<int64_t, long>(),
             "Construct a hash item as a (key, value) pair.", py::arg("key"),
             py::arg("id"))
         .def(
@@ -107,6 +107,12 @@ void define_hash_grid(py::module_& m)
             Returns:
                 The candidate edge-face intersections.
             )ipc_Qu8mg5v7")
+        .def_readwrite(
+            "voxel_size_heuristic", &HashGrid::voxel_size_heuristic,
+            "Heuristic used to choose the voxel size.")
+        .def_readwrite(
+            "reuse_voxel_size", &HashGrid::reuse_voxel_size,
+            "Reuse the voxel size suggested by the previous build.")
         .def("cellSize", &HashGrid::cellSize, "")
         .def("gridSize", &HashGrid::gridSize, "")
         .def("domainMin", &HashGrid::domainMin, "")
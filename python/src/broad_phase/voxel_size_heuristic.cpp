@@ -7,6 +7,17 @@ using namespace ipc;
 
 void define_voxel_size_heuristic(py::module_& m)
 {
+    py::enum_<VoxelSizeHeuristic>(
+        m, "VoxelSizeHeuristic",
+        "Heuristic used to choose the voxel size of a hash grid.")
+        .value(
+            "MEDIAN_EDGE_LENGTH", VoxelSizeHeuristic::MEDIAN_EDGE_LENGTH,
+            "Twice the median edge (and displacement) length.")
+        .value(
+            "COST_MODEL", VoxelSizeHeuristic::COST_MODEL,
+            "Minimize a cost model of the number of items and pairs tested.")
+        .export_values();
+
     m.def(
         "suggest_good_voxel_size",
         py::overload_cast<
@@ -50,9 +61,18 @@ void define_voxel_size_heuristic(py::module_& m)
         py::arg("vertices_t1"), py::arg("edges"));
 
     m.def(
-        "median_displacement_length", &median_displacement_length,
+        "median_displacement_length",
+        py::overload_cast<const Eigen::MatrixXd&>(&median_displacement_length),
         "Compute the median displacement length.", py::arg("displacements"));
 
+    m.def(
+        "median_displacement_length",
+        py::overload_cast<const Eigen::MatrixXd&, const Eigen::MatrixXd&>(
+            &median_displacement_length),
+        "Compute the median displacement length from vertices_t0 to "
+        "vertices_t1.",
+        py::arg("vertices_t0"), py::arg("vertices_t1"));
+
     m.def(
         "max_edge_length", &max_edge_length,
         "Compute the maximum edge length of a mesh.", py::arg("vertices_t0"),
@@ -61,4 +81,22 @@ void define_voxel_size_heuristic(py::module_& m)
     m.def(
         "max_displacement_length", &max_displacement_length,
         "Compute the maximum displacement length.", py::arg("displacements"));
+
+    m.def(
+        "suggest_voxel_size_from_cost_model",
+        &suggest_voxel_size_from_cost_model,
+        R"ipc_Qu8mg5v7(
+        Suggest a voxel size by minimizing a cost model of a hash grid.
+
+        Parameters:
+            boxes: Boxes inserted in the hash grid.
+            domain_min: Minimum corner of the hash grid.
+            domain_max: Maximum corner of the hash grid.
+            initial_voxel_size: Voxel size to start the search from.
+
+        Returns:
+            The voxel size with the lowest estimated cost.
+        )ipc_Qu8mg5v7",
+        py::arg("boxes"), py::arg("domain_min"), py::arg("domain_max"),
+        py::arg("initial_voxel_size"));
 }
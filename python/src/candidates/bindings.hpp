@@ -3,8 +3,10 @@
 #include <pybind11/pybind11.h>
 
 // candidates
+void define_cached_candidates(py::module_& m);
 void define_candidates(py::module_& m);
 void define_collision_stencil(py::module_& m);
+void define_compact_candidates(py::module_& m);
 void define_continuous_collision_candidate(py::module_& m);
 void define_edge_edge_candidate(py::module_& m);
 void define_edge_face_candidate(py::module_& m);
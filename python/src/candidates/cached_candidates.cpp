@@ -0,0 +1,121 @@
+#include <common.hpp>
+
+#include <ipc/candidates/cached_candidates.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_cached_candidates(py::module_& m)
+{
+    py::class_<CachedCandidates>(m, "CachedCandidates")
+        .def(
+            py::init<double>(),
+            R"ipc_Qu8mg5v7(
+            Construct cached candidates.
+
+            Parameters:
+                skin: Extra distance between elements covered by the candidates.
+            )ipc_Qu8mg5v7",
+            py::arg("skin") = 0)
+        .def(
+            "update",
+            py::overload_cast<
+                const CollisionMesh&, const Eigen::MatrixXd&, const double,
+                const BroadPhaseMethod>(&CachedCandidates::update),
+            R"ipc_Qu8mg5v7(
+            Update the set of discrete collision detection candidates.
+
+            Note:
+                The broad phase is only run if the cached candidates are invalid.
+
+            Parameters:
+                mesh: The surface of the contact mesh.
+                vertices: Surface Vertex vertices at start as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase_method: Broad phase method to use.
+
+            Returns:
+                True if the broad phase was run.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("inflation_radius") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def(
+            "update",
+            py::overload_cast<
+                const CollisionMesh&, const Eigen::MatrixXd&,
+                const Eigen::MatrixXd&, const double, const BroadPhaseMethod>(
+                &CachedCandidates::update),
+            R"ipc_Qu8mg5v7(
+            Update the set of continuous collision detection candidates.
+
+            Note:
+                The broad phase is only run if the cached candidates are invalid.
+                Assumes the trajectory is linear.
+
+            Parameters:
+                mesh: The surface of the contact mesh.
+                vertices_t0: Surface vertex vertices at start as rows of a matrix.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase_method: Broad phase method to use.
+
+            Returns:
+                True if the broad phase was run.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("inflation_radius") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def(
+            "is_valid",
+            py::overload_cast<
+                const Eigen::MatrixXd&, const double, const BroadPhaseMethod>(
+                &CachedCandidates::is_valid, py::const_),
+            R"ipc_Qu8mg5v7(
+            Determine if the cached discrete candidates can be reused.
+
+            Parameters:
+                vertices: Surface Vertex vertices at start as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase_method: Broad phase method to use.
+
+            Returns:
+                True if no vertex moved more than skin / 2.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices"), py::arg("inflation_radius") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def(
+            "is_valid",
+            py::overload_cast<
+                const Eigen::MatrixXd&, const Eigen::MatrixXd&, const double,
+                const BroadPhaseMethod>(
+                &CachedCandidates::is_valid, py::const_),
+            R"ipc_Qu8mg5v7(
+            Determine if the cached continuous candidates can be reused.
+
+            Parameters:
+                vertices_t0: Surface vertex vertices at start as rows of a matrix.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase_method: Broad phase method to use.
+
+            Returns:
+                True if no vertex moved more than skin / 2.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("inflation_radius") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def_property_readonly(
+            "candidates", &CachedCandidates::candidates,
+            "The cached superset of candidates.")
+        .def_property_readonly(
+            "num_builds", &CachedCandidates::num_builds,
+            "The number of times the broad phase was run.")
+        .def(
+            "clear", &CachedCandidates::clear,
+            "Clear the cached candidates, so the next update runs the broad phase.")
+        .def_readwrite(
+            "skin", &CachedCandidates::skin,
+            "Extra distance between elements covered by the candidates.");
+}
@@ -23,15 +23,15 @@ void define_candidates(py::module_& m)
                 inflation_radius: Amount to inflate the bounding boxes.
                 broad_phase_method: Broad phase method to use.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices"),
-            py::arg("inflation_radius") = 0,
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("inflation_radius") = 0,
             py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
         .def(
             "build",
             py::overload_cast<
                 const CollisionMesh&, const Eigen::MatrixXd&,
-                const Eigen::MatrixXd&, const double, const BroadPhaseMethod>(
-                &Candidates::build),
+                const Eigen::MatrixXd&, const double, const BroadPhaseMethod,
+                const int>(&Candidates::build),
             R"ipc_Qu8mg5v7(
             Initialize the set of continuous collision detection candidates.
 
@@ -44,10 +44,32 @@ void define_candidates(py::module_& m)
                 vertices_t1: Surface vertex vertices at end as rows of a matrix.
                 inflation_radius: Amount to inflate the bounding boxes.
                 broad_phase_method: Broad phase method to use.
+                max_temporal_subdivisions: Maximum number of sub-intervals used to cull the candidates. A value of 1 disables the culling.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
             py::arg("inflation_radius") = 0,
-            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD,
+            py::arg("max_temporal_subdivisions") = 1)
+        .def(
+            "filter_by_temporal_subdivision",
+            &Candidates::filter_by_temporal_subdivision,
+            R"ipc_Qu8mg5v7(
+            Remove the candidates whose swept boxes do not overlap during any common sub-interval of time.
+
+            Note:
+                The number of sub-intervals of each candidate is chosen adaptively as the ratio of its vertices' displacement to the size of its elements.
+
+            Parameters:
+                mesh: The surface of the contact mesh.
+                vertices_t0: Surface vertex vertices at start as rows of a matrix.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                max_subdivisions: Maximum number of sub-intervals of [0, 1].
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("inflation_radius"), py::arg("max_subdivisions"))
         .def("__len__", &Candidates::size, "")
         .def("empty", &Candidates::empty, "")
         .def("clear", &Candidates::clear, "")
@@ -58,7 +80,16 @@ void define_candidates(py::module_& m)
             },
             py::return_value_policy::reference)
         .def(
-            "is_step_collision_free", &Candidates::is_step_collision_free,
+            "is_step_collision_free",
+            [](const Candidates& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices_t0,
+               const Eigen::MatrixXd& vertices_t1, const double min_distance,
+               const double tolerance, const long max_iterations,
+               const CCDPrefilterOptions& prefilter) {
+                return self.is_step_collision_free(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations, prefilter);
+            },
             R"ipc_Qu8mg5v7(
             Determine if the step is collision free from the set of candidates.
 
@@ -72,17 +103,28 @@ void define_candidates(py::module_& m)
                 min_distance: The minimum distance allowable between any two elements.
                 tolerance: The tolerance for the CCD algorithm.
                 max_iterations: The maximum number of iterations for the CCD algorithm.
+                prefilter: Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
 
             Returns:
                 True if <b>any</b> collisions occur.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
             py::arg("min_distance") = 0.0,
             py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
-            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS)
+            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+            py::arg("prefilter") = CCDPrefilterOptions())
         .def(
             "compute_collision_free_stepsize",
-            &Candidates::compute_collision_free_stepsize,
+            [](const Candidates& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices_t0,
+               const Eigen::MatrixXd& vertices_t1, const double min_distance,
+               const double tolerance, const long max_iterations,
+               const CCDPrefilterOptions& prefilter) {
+                return self.compute_collision_free_stepsize(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations, prefilter);
+            },
             R"ipc_Qu8mg5v7(
             Computes a maximal step size that is collision free using the set of collision candidates.
 
@@ -96,17 +138,83 @@ void define_candidates(py::module_& m)
                 min_distance: The minimum distance allowable between any two elements.
                 tolerance: The tolerance for the CCD algorithm.
                 max_iterations: The maximum number of iterations for the CCD algorithm.
+                prefilter: Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
 
             Returns:
                 A step-size $\in [0, 1]$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("min_distance") = 0.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+            py::arg("prefilter") = CCDPrefilterOptions())
+        .def(
+            "compute_collision_free_stepsize_with_statistics",
+            [](const Candidates& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices_t0,
+               const Eigen::MatrixXd& vertices_t1, const double min_distance,
+               const double tolerance, const long max_iterations,
+               const CCDPrefilterOptions& prefilter) {
+                CCDPrefilterStatistics statistics;
+                const double step = self.compute_collision_free_stepsize(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations, prefilter, &statistics);
+                return std::make_tuple(step, statistics);
+            },
+            R"ipc_Qu8mg5v7(
+            Computes a maximal step size that is collision free and the number of candidates rejected by each prefilter.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices_t0: Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                min_distance: The minimum distance allowable between any two elements.
+                tolerance: The tolerance for the CCD algorithm.
+                max_iterations: The maximum number of iterations for the CCD algorithm.
+                prefilter: Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+
+            Returns:
+                Tuple of:
+                A step-size $\in [0, 1]$ that is collision free.
+                The prefilter statistics.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
             py::arg("min_distance") = 0.0,
             py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
-            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS)
+            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+            py::arg("prefilter") = CCDPrefilterOptions())
         .def(
             "save_obj", &Candidates::save_obj, "", py::arg("filename"),
             py::arg("vertices"), py::arg("edges"), py::arg("faces"))
+        .def_property_readonly(
+            "ev_candidate_ids",
+            [](const Candidates& self) {
+                return to_id_array<2>(
+                    self.ev_candidates, [](const EdgeVertexCandidate& c) {
+                        return std::array<long, 2> { c.edge_id, c.vertex_id };
+                    });
+            },
+            "#EV by 2 array of the (edge, vertex) ids of the EV candidates.")
+        .def_property_readonly(
+            "ee_candidate_ids",
+            [](const Candidates& self) {
+                return to_id_array<2>(
+                    self.ee_candidates, [](const EdgeEdgeCandidate& c) {
+                        return std::array<long, 2> { c.edge0_id, c.edge1_id };
+                    });
+            },
+            "#EE by 2 array of the (edge, edge) ids of the EE candidates.")
+        .def_property_readonly(
+            "fv_candidate_ids",
+            [](const Candidates& self) {
+                return to_id_array<2>(
+                    self.fv_candidates, [](const FaceVertexCandidate& c) {
+                        return std::array<long, 2> { c.face_id, c.vertex_id };
+                    });
+            },
+            "#FV by 2 array of the (face, vertex) ids of the FV candidates.")
         .def_readwrite("ev_candidates", &Candidates::ev_candidates, "")
         .def_readwrite("ee_candidates", &Candidates::ee_candidates, "")
         .def_readwrite("fv_candidates", &Candidates::fv_candidates, "");
@@ -0,0 +1,222 @@
+#include <common.hpp>
+
+#include <ipc/candidates/compact_candidates.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+namespace {
+pybind11::array_t<int64_t>
+compact_ids(const std::vector<CompactCandidate>& candidates)
+{
+    return to_id_array<2>(candidates, [](const CompactCandidate& c) {
+        return std::array<long, 2> { c.id0, c.id1 };
+    });
+}
+} // namespace
+
+void define_compact_candidates(py::module_& m)
+{
+    py::class_<CompactCandidates>(m, "CompactCandidates")
+        .def(py::init(), "")
+        .def(
+            py::init<const Candidates&>(),
+            R"ipc_Qu8mg5v7(
+            Convert a set of candidates to compact storage.
+
+            Parameters:
+                candidates: The candidates to convert.
+            )ipc_Qu8mg5v7",
+            py::arg("candidates"))
+        .def(
+            "build",
+            py::overload_cast<
+                const CollisionMesh&, const Eigen::MatrixXd&, const double,
+                const BroadPhaseMethod>(&CompactCandidates::build),
+            R"ipc_Qu8mg5v7(
+            Initialize the set of discrete collision detection candidates.
+
+            Parameters:
+                mesh: The surface of the contact mesh.
+                vertices: Surface Vertex vertices at start as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase_method: Broad phase method to use.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("inflation_radius") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def(
+            "build",
+            py::overload_cast<
+                const CollisionMesh&, const Eigen::MatrixXd&,
+                const Eigen::MatrixXd&, const double, const BroadPhaseMethod,
+                const int>(&CompactCandidates::build),
+            R"ipc_Qu8mg5v7(
+            Initialize the set of continuous collision detection candidates.
+
+            Note:
+                Assumes the trajectory is linear.
+
+            Parameters:
+                mesh: The surface of the contact mesh.
+                vertices_t0: Surface vertex vertices at start as rows of a matrix.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase_method: Broad phase method to use.
+                max_temporal_subdivisions: Maximum number of sub-intervals used to cull the candidates. A value of 1 disables the culling.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("inflation_radius") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD,
+            py::arg("max_temporal_subdivisions") = 1)
+        .def(
+            "filter_by_temporal_subdivision",
+            &CompactCandidates::filter_by_temporal_subdivision,
+            R"ipc_Qu8mg5v7(
+            Remove the candidates whose swept boxes do not overlap during any common sub-interval of time.
+
+            Parameters:
+                mesh: The surface of the contact mesh.
+                vertices_t0: Surface vertex vertices at start as rows of a matrix.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                inflation_radius: Amount to inflate the bounding boxes.
+                max_subdivisions: Maximum number of sub-intervals of [0, 1].
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("inflation_radius"), py::arg("max_subdivisions"))
+        .def(
+            "to_candidates", &CompactCandidates::to_candidates,
+            "Expand the compact candidates into the polymorphic candidates.")
+        .def(
+            "sort_and_deduplicate", &CompactCandidates::sort_and_deduplicate,
+            "Sort the candidates and remove duplicates.")
+        .def("__len__", &CompactCandidates::size, "")
+        .def("empty", &CompactCandidates::empty, "")
+        .def("clear", &CompactCandidates::clear, "")
+        .def(
+            "is_step_collision_free",
+            [](const CompactCandidates& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices_t0,
+               const Eigen::MatrixXd& vertices_t1, const double min_distance,
+               const double tolerance, const long max_iterations,
+               const CCDPrefilterOptions& prefilter) {
+                return self.is_step_collision_free(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations, prefilter);
+            },
+            R"ipc_Qu8mg5v7(
+            Determine if the step is collision free from the set of candidates.
+
+            Note:
+                Assumes the trajectory is linear.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices_t0: Surface vertex vertices at start as rows of a matrix.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                min_distance: The minimum distance allowable between any two elements.
+                tolerance: The tolerance for the CCD algorithm.
+                max_iterations: The maximum number of iterations for the CCD algorithm.
+                prefilter: Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+
+            Returns:
+                True if <b>no</b> collisions occur.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("min_distance") = 0.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+            py::arg("prefilter") = CCDPrefilterOptions())
+        .def(
+            "compute_collision_free_stepsize",
+            [](const CompactCandidates& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices_t0,
+               const Eigen::MatrixXd& vertices_t1, const double min_distance,
+               const double tolerance, const long max_iterations,
+               const CCDPrefilterOptions& prefilter) {
+                return self.compute_collision_free_stepsize(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations, prefilter);
+            },
+            R"ipc_Qu8mg5v7(
+            Computes a maximal step size that is collision free using the set of collision candidates.
+
+            Note:
+                Assumes the trajectory is linear.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices_t0: Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                min_distance: The minimum distance allowable between any two elements.
+                tolerance: The tolerance for the CCD algorithm.
+                max_iterations: The maximum number of iterations for the CCD algorithm.
+                prefilter: Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+
+            Returns:
+                A step-size $\in [0, 1]$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("min_distance") = 0.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+            py::arg("prefilter") = CCDPrefilterOptions())
+        .def(
+            "compute_collision_free_stepsize_with_statistics",
+            [](const CompactCandidates& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices_t0,
+               const Eigen::MatrixXd& vertices_t1, const double min_distance,
+               const double tolerance, const long max_iterations,
+               const CCDPrefilterOptions& prefilter) {
+                CCDPrefilterStatistics statistics;
+                const double step = self.compute_collision_free_stepsize(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations, prefilter, &statistics);
+                return std::make_tuple(step, statistics);
+            },
+            R"ipc_Qu8mg5v7(
+            Computes a maximal step size that is collision free and the number of candidates rejected by each prefilter.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices_t0: Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+                vertices_t1: Surface vertex vertices at end as rows of a matrix.
+                min_distance: The minimum distance allowable between any two elements.
+                tolerance: The tolerance for the CCD algorithm.
+                max_iterations: The maximum number of iterations for the CCD algorithm.
+                prefilter: Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+
+            Returns:
+                Tuple of:
+                A step-size $\in [0, 1]$ that is collision free.
+                The prefilter statistics.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("min_distance") = 0.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+            py::arg("prefilter") = CCDPrefilterOptions())
+        .def_property_readonly(
+            "ev_candidate_ids",
+            [](const CompactCandidates& self) {
+                return compact_ids(self.ev_candidates);
+            },
+            "#EV by 2 array of the (edge, vertex) ids of the EV candidates.")
+        .def_property_readonly(
+            "ee_candidate_ids",
+            [](const CompactCandidates& self) {
+                return compact_ids(self.ee_candidates);
+            },
+            "#EE by 2 array of the (edge, edge) ids of the EE candidates.")
+        .def_property_readonly(
+            "fv_candidate_ids",
+            [](const CompactCandidates& self) {
+                return compact_ids(self.fv_candidates);
+            },
+            "#FV by 2 array of the (face, vertex) ids of the FV candidates.");
+}
@@ -5,5 +5,7 @@ namespace py = pybind11;
 
 void define_ccd_aabb(py::module_& m);
 void define_ccd(py::module_& m);
+void define_ccd_prefilter(py::module_& m);
 void define_inexact_point_edge(py::module_& m);
+void define_point_sdf(py::module_& m);
 void define_point_static_plane(py::module_& m);
\ No newline at end of file
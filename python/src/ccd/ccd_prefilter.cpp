@@ -0,0 +1,46 @@
+#include <common.hpp>
+
+#include <ipc/ccd/ccd_prefilter.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_ccd_prefilter(py::module_& m)
+{
+    py::class_<CCDPrefilterOptions>(m, "CCDPrefilterOptions")
+        .def(py::init(), "")
+        .def(
+            py::init([](const bool separating_axis, const bool coplanarity) {
+                return CCDPrefilterOptions { separating_axis, coplanarity };
+            }),
+            "", py::arg("separating_axis"), py::arg("coplanarity"))
+        .def_static(
+            "all", &CCDPrefilterOptions::all,
+            "Get options with all prefilters enabled.")
+        .def(
+            "any", &CCDPrefilterOptions::any,
+            "Determine if any prefilter is enabled.")
+        .def_readwrite(
+            "separating_axis", &CCDPrefilterOptions::separating_axis,
+            "Reject candidates separated along a fixed axis over the whole time step.")
+        .def_readwrite(
+            "coplanarity", &CCDPrefilterOptions::coplanarity,
+            "Reject face-vertex and edge-edge candidates whose vertices stay strictly on one side of the moving plane.");
+
+    py::class_<CCDPrefilterStatistics>(m, "CCDPrefilterStatistics")
+        .def(py::init(), "")
+        .def(
+            "num_rejections", &CCDPrefilterStatistics::num_rejections,
+            "Get the total number of candidates rejected.")
+        .def_readwrite(
+            "num_candidates", &CCDPrefilterStatistics::num_candidates,
+            "Number of candidates tested.")
+        .def_readwrite(
+            "num_separating_axis_rejections",
+            &CCDPrefilterStatistics::num_separating_axis_rejections,
+            "Number of candidates rejected by the separating-axis test.")
+        .def_readwrite(
+            "num_coplanarity_rejections",
+            &CCDPrefilterStatistics::num_coplanarity_rejections,
+            "Number of candidates rejected by the coplanarity test.");
+}
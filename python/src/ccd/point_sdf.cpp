@@ -0,0 +1,41 @@
+#include <common.hpp>
+
+#include <ipc/ccd/point_sdf.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_point_sdf(py::module_& m)
+{
+    m.def(
+        "point_sdf_ccd",
+        [](const VectorMax3d& p_t0, const VectorMax3d& p_t1,
+           const GridSDF& sdf, const double tolerance,
+           const long max_iterations, const double conservative_rescaling) {
+            double toi;
+            bool r = point_sdf_ccd(
+                p_t0, p_t1, sdf, toi, tolerance, max_iterations,
+                conservative_rescaling);
+            return std::make_tuple(r, toi);
+        },
+        R"ipc_Qu8mg5v7(
+        Conservative CCD of a point moving linearly against a static SDF.
+
+        Parameters:
+            p_t0: Position of the point at the start of the step.
+            p_t1: Position of the point at the end of the step.
+            sdf: Signed distance field of the obstacle.
+            tolerance: Stop advancing once the step falls below this (in time).
+            max_iterations: Maximum number of advancement steps.
+            conservative_rescaling: Fraction of the initial distance the point may close.
+
+        Returns:
+            Tuple of:
+            True if the point may impact the obstacle during the step.
+            The time of impact.
+        )ipc_Qu8mg5v7",
+        py::arg("p_t0"), py::arg("p_t1"), py::arg("sdf"),
+        py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+        py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+}
@@ -195,6 +195,37 @@ void define_collision_mesh(py::module_& m)
                 True if the vertex is on the boundary of the collision mesh.
             )ipc_Qu8mg5v7",
             py::arg("vi"))
+        .def(
+            "set_static_vertices", &CollisionMesh::set_static_vertices,
+            R"ipc_Qu8mg5v7(
+            Mark the vertices that never move from their rest positions.
+
+            The elements whose vertices are all static are inserted once into a
+            persistent acceleration structure, and the broad phase only boxes and
+            queries the remaining (moving) elements against it.
+
+            Note:
+                The positions of the static vertices passed to the broad phase must equal their rest positions.
+
+            Parameters:
+                is_vertex_static: Vector of bools indicating whether each vertex is static (empty to mark all vertices as moving).
+            )ipc_Qu8mg5v7",
+            py::arg("is_vertex_static"))
+        .def(
+            "has_static_vertices", &CollisionMesh::has_static_vertices,
+            "Determine if any vertex is static.")
+        .def(
+            "is_vertex_static", &CollisionMesh::is_vertex_static,
+            R"ipc_Qu8mg5v7(
+            Is a vertex static?
+
+            Parameters:
+                vi: Vertex ID.
+
+            Returns:
+                True if the vertex never moves from its rest position.
+            )ipc_Qu8mg5v7",
+            py::arg("vi"))
         .def(
             "vertex_area", &CollisionMesh::vertex_area,
             R"ipc_Qu8mg5v7(
@@ -0,0 +1,148 @@
+#include <common.hpp>
+
+#include <ipc/collisions/batched_collision_constraints.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_batched_collision_constraints(py::module_& m)
+{
+    py::class_<BatchedCollisionConstraints>(m, "BatchedCollisionConstraints")
+        .def(py::init(), "")
+        .def(
+            "build", &BatchedCollisionConstraints::build,
+            R"ipc_Qu8mg5v7(
+            Initialize the constraints of every scene.
+
+            Note:
+                Existing per-scene settings (e.g., use_convergent_formulation) are kept.
+
+            Parameters:
+                meshes: The collision mesh of each scene.
+                vertices: Vertices of each scene's collision mesh.
+                dhat: The activation distance of the barrier.
+                dmin: Minimum distance.
+                broad_phase_method: Broad-phase method to use.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("meshes"),
+            py::arg("vertices"), py::arg("dhat"), py::arg("dmin") = 0,
+            py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def(
+            "compute_potential",
+            &BatchedCollisionConstraints::compute_potential,
+            R"ipc_Qu8mg5v7(
+            Compute the barrier potential of every scene.
+
+            Parameters:
+                meshes: The collision mesh of each scene.
+                vertices: Vertices of each scene's collision mesh.
+                dhat: The activation distance of the barrier.
+
+            Returns:
+                The barrier potential of each scene (not scaled by the barrier stiffness).
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("meshes"),
+            py::arg("vertices"), py::arg("dhat"))
+        .def(
+            "compute_potential_gradient",
+            &BatchedCollisionConstraints::compute_potential_gradient,
+            R"ipc_Qu8mg5v7(
+            Compute the gradient of the barrier potential of every scene.
+
+            Parameters:
+                meshes: The collision mesh of each scene.
+                vertices: Vertices of each scene's collision mesh.
+                dhat: The activation distance of the barrier.
+
+            Returns:
+                The gradient of each scene's barrier potential (not scaled by the barrier stiffness).
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("meshes"),
+            py::arg("vertices"), py::arg("dhat"))
+        .def(
+            "compute_potential_hessian",
+            [](const BatchedCollisionConstraints& self,
+               const std::vector<CollisionMesh>& meshes,
+               const std::vector<Eigen::MatrixXd>& vertices, const double dhat,
+               const bool project_hessian_to_psd,
+               const bool upper_triangular) {
+                std::vector<Eigen::SparseMatrix<double, Eigen::RowMajor>>
+                    hessians;
+                {
+                    py::gil_scoped_release release;
+                    const std::vector<Eigen::SparseMatrix<double>> H =
+                        self.compute_potential_hessian(
+                            meshes, vertices, dhat, project_hessian_to_psd,
+                            upper_triangular);
+                    hessians.assign(H.begin(), H.end());
+                }
+                py::list out;
+                for (auto& hess : hessians) {
+                    out.append(to_scipy_csr(std::move(hess)));
+                }
+                return out;
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the hessian of the barrier potential of every scene.
+
+            Parameters:
+                meshes: The collision mesh of each scene.
+                vertices: Vertices of each scene's collision mesh.
+                dhat: The activation distance of the barrier.
+                project_hessian_to_psd: Make sure the hessian is positive semi-definite.
+                upper_triangular: Only assemble the upper triangle of the symmetric hessian.
+
+            Returns:
+                The hessian of each scene's barrier potential (not scaled by the barrier stiffness).
+            )ipc_Qu8mg5v7",
+            py::arg("meshes"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("project_hessian_to_psd") = false,
+            py::arg("upper_triangular") = false)
+        .def(
+            "compute_minimum_distance",
+            &BatchedCollisionConstraints::compute_minimum_distance,
+            R"ipc_Qu8mg5v7(
+            Computes the minimum distance between any non-adjacent elements of every scene.
+
+            Parameters:
+                meshes: The collision mesh of each scene.
+                vertices: Vertices of each scene's collision mesh.
+
+            Returns:
+                The minimum distance of each scene.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("meshes"),
+            py::arg("vertices"))
+        .def(
+            "__len__", &BatchedCollisionConstraints::size,
+            "Get the number of scenes.")
+        .def(
+            "empty", &BatchedCollisionConstraints::empty,
+            "Get if there are no scenes.")
+        .def(
+            "clear", &BatchedCollisionConstraints::clear,
+            "Remove all scenes.")
+        .def(
+            "__getitem__",
+            [](BatchedCollisionConstraints& self,
+               size_t idx) -> CollisionConstraints& {
+                if (idx >= self.size()) {
+                    throw py::index_error();
+                }
+                return self[idx];
+            },
+            py::return_value_policy::reference_internal,
+            R"ipc_Qu8mg5v7(
+            Get a reference to the constraints of scene idx.
+
+            Parameters:
+                idx: The index of the scene.
+
+            Returns:
+                A reference to the scene's constraints.
+            )ipc_Qu8mg5v7",
+            py::arg("idx"))
+        .def_readwrite(
+            "scenes", &BatchedCollisionConstraints::scenes,
+            "Collision constraints of each scene.");
+}
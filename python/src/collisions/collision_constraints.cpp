@@ -2,6 +2,8 @@
 
 #include <ipc/collisions/collision_constraints.hpp>
 
+#include <optional>
+
 namespace py = pybind11;
 using namespace ipc;
 
@@ -25,8 +27,8 @@ void define_collision_constraints(py::module_& m)
                 dmin: Minimum distance.
                 broad_phase_method: Broad-phase method to use.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
-            py::arg("dmin") = 0,
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("dhat"), py::arg("dmin") = 0,
             py::arg("broad_phase_method") = BroadPhaseMethod::HASH_GRID)
         .def(
             "build",
@@ -43,8 +45,31 @@ void define_collision_constraints(py::module_& m)
                 dhat: The activation distance of the barrier.
                 dmin:  Minimum distance.
             )ipc_Qu8mg5v7",
-            py::arg("candidates"), py::arg("mesh"), py::arg("vertices"),
-            py::arg("dhat"), py::arg("dmin") = 0)
+            py::call_guard<py::gil_scoped_release>(), py::arg("candidates"),
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("dmin") = 0)
+        .def(
+            "build",
+            py::overload_cast<
+                const CompactCandidates&, const CollisionMesh&,
+                const Eigen::MatrixXd&, const double, const double>(
+                &CollisionConstraints::build),
+            R"ipc_Qu8mg5v7(
+            Initialize the set of constraints used to compute the barrier potential.
+
+            Note:
+                The compact candidates are expanded one block at a time, so the full list of polymorphic candidates is never stored.
+
+            Parameters:
+                candidates: Compact distance candidates from which the constraint set is built.
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+                dmin: Minimum distance.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("candidates"),
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("dmin") = 0)
         .def(
             "compute_potential", &CollisionConstraints::compute_potential,
             R"ipc_Qu8mg5v7(
@@ -58,7 +83,8 @@ void define_collision_constraints(py::module_& m)
             Returns:
                 The sum of all barrier potentials (not scaled by the barrier stiffness).
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"))
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("dhat"))
         .def(
             "compute_potential_gradient",
             &CollisionConstraints::compute_potential_gradient,
@@ -73,10 +99,23 @@ void define_collision_constraints(py::module_& m)
             Returns:
                 The gradient of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |vertices|.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"))
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("dhat"))
         .def(
             "compute_potential_hessian",
-            &CollisionConstraints::compute_potential_hessian,
+            [](const CollisionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices, const double dhat,
+               const bool project_hessian_to_psd,
+               const bool upper_triangular) {
+                Eigen::SparseMatrix<double, Eigen::RowMajor> hess;
+                {
+                    py::gil_scoped_release release;
+                    hess = self.compute_potential_hessian(
+                        mesh, vertices, dhat, project_hessian_to_psd,
+                        upper_triangular);
+                }
+                return to_scipy_csr(std::move(hess));
+            },
             R"ipc_Qu8mg5v7(
             Compute the hessian of the barrier potential.
 
@@ -85,15 +124,128 @@ void define_collision_constraints(py::module_& m)
                 vertices: Vertices of the collision mesh.
                 dhat: The activation distance of the barrier.
                 project_hessian_to_psd: Make sure the hessian is positive semi-definite.
+                upper_triangular: Only assemble the upper triangle of the symmetric hessian.
 
             Returns:
                 The hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |vertices|x|vertices|.
             )ipc_Qu8mg5v7",
             py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("project_hessian_to_psd") = false,
+            py::arg("upper_triangular") = false)
+        .def(
+            "compute_potential_local_gradients",
+            [](const CollisionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices, const double dhat) {
+                Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>
+                    local_gradients(self.size(), 4 * vertices.cols());
+                LocalVertexIds vertex_ids(self.size(), 4);
+                {
+                    py::gil_scoped_release release;
+                    self.compute_potential_local_gradients(
+                        mesh, vertices, dhat, local_gradients, vertex_ids);
+                }
+                return std::make_tuple(local_gradients, vertex_ids);
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the unassembled gradients of the barrier potential of each constraint.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+
+            Returns:
+                Tuple of:
+                Local gradients as rows of size 4·dim (zero padded).
+                Vertex ids of each constraint (-1 for unused vertices).
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"))
+        .def(
+            "compute_potential_local_hessians",
+            [](const CollisionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices, const double dhat,
+               const bool project_hessian_to_psd) {
+                const int m = 4 * vertices.cols();
+                Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>
+                    local_hessians(self.size(), m * m);
+                LocalVertexIds vertex_ids(self.size(), 4);
+                {
+                    py::gil_scoped_release release;
+                    self.compute_potential_local_hessians(
+                        mesh, vertices, dhat, local_hessians, vertex_ids,
+                        project_hessian_to_psd);
+                }
+                return std::make_tuple(local_hessians, vertex_ids);
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the unassembled Hessians of the barrier potential of each constraint.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+                project_hessian_to_psd: Make sure the Hessians are positive semi-definite.
+
+            Returns:
+                Tuple of:
+                Local Hessians as rows of size (4·dim)² (column-major, zero padded).
+                Vertex ids of each constraint (-1 for unused vertices).
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("project_hessian_to_psd") = false)
+        .def(
+            "compute_vertex_potential_derivatives",
+            [](const CollisionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices, const double dhat,
+               const std::optional<std::vector<long>>& vertex_subset,
+               const bool project_hessian_to_psd) {
+                Eigen::MatrixXd gradients, hessians;
+                {
+                    py::gil_scoped_release release;
+                    if (vertex_subset) {
+                        self.compute_vertex_potential_derivatives(
+                            mesh, vertices, dhat, *vertex_subset, gradients,
+                            hessians, project_hessian_to_psd);
+                    } else {
+                        self.compute_vertex_potential_derivatives(
+                            mesh, vertices, dhat, gradients, hessians,
+                            project_hessian_to_psd);
+                    }
+                }
+                return std::make_tuple(gradients, hessians);
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the gradient and hessian of the barrier potential with respect to each vertex only.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+                vertex_subset: Ids of the vertices to evaluate (all vertices if None).
+                project_hessian_to_psd: Make sure the local hessians are positive semi-definite before extracting the blocks.
+
+            Returns:
+                Tuple of:
+                The gradients of each vertex (one per row).
+                The stacked dim×dim diagonal hessian blocks of each vertex.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("vertex_subset") = std::nullopt,
             py::arg("project_hessian_to_psd") = false)
         .def(
             "compute_shape_derivative",
-            &CollisionConstraints::compute_shape_derivative,
+            [](const CollisionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& vertices, const double dhat) {
+                Eigen::SparseMatrix<double, Eigen::RowMajor> shape_derivative;
+                {
+                    py::gil_scoped_release release;
+                    shape_derivative =
+                        self.compute_shape_derivative(mesh, vertices, dhat);
+                }
+                return to_scipy_csr(std::move(shape_derivative));
+            },
             R"ipc_Qu8mg5v7(
             Compute the barrier shape derivative.
 
@@ -121,7 +273,21 @@ void define_collision_constraints(py::module_& m)
             Returns:
                 The minimum distance between any non-adjacent elements.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("vertices"))
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"))
+        .def(
+            "build_vertex_incidence",
+            &CollisionConstraints::build_vertex_incidence,
+            R"ipc_Qu8mg5v7(
+            Build the index of the constraints incident on each vertex.
+
+            Note:
+                This is done by build(), but it must be called again if the constraints are modified afterwards.
+
+            Parameters:
+                mesh: The collision mesh.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"))
         .def(
             "__len__", &CollisionConstraints::size,
             "Get the number of collision constraints.")
@@ -157,9 +323,36 @@ void define_collision_constraints(py::module_& m)
             &CollisionConstraints::are_shape_derivatives_enabled,
             &CollisionConstraints::set_are_shape_derivatives_enabled,
             "If the collision constraints are using the convergent formulation.")
+        .def(
+            "vertex_ids",
+            [](const CollisionConstraints& self, const CollisionMesh& mesh) {
+                py::array_t<int64_t> ids(
+                    { static_cast<py::ssize_t>(self.size()), py::ssize_t(4) });
+                auto r = ids.mutable_unchecked<2>();
+                for (size_t i = 0; i < self.size(); i++) {
+                    const std::array<long, 4> vertex_ids =
+                        self[i].vertex_ids(mesh.edges(), mesh.faces());
+                    for (size_t j = 0; j < 4; j++) {
+                        r(i, j) = vertex_ids[j];
+                    }
+                }
+                return ids;
+            },
+            R"ipc_Qu8mg5v7(
+            Get the vertex ids of all constraints as a contiguous array.
+
+            Parameters:
+                mesh: The collision mesh.
+
+            Returns:
+                #C by 4 array of vertex ids (unused ids are -1).
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"))
         .def_readwrite("vv_constraints", &CollisionConstraints::vv_constraints)
         .def_readwrite("ev_constraints", &CollisionConstraints::ev_constraints)
         .def_readwrite("ee_constraints", &CollisionConstraints::ee_constraints)
         .def_readwrite("fv_constraints", &CollisionConstraints::fv_constraints)
-        .def_readwrite("pv_constraints", &CollisionConstraints::pv_constraints);
+        .def_readwrite("pv_constraints", &CollisionConstraints::pv_constraints)
+        .def_readwrite(
+            "sdf_constraints", &CollisionConstraints::sdf_constraints);
 }
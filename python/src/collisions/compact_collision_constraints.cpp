@@ -0,0 +1,144 @@
+#include <common.hpp>
+
+#include <ipc/collisions/compact_collision_constraints.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_compact_collision_constraints(py::module_& m)
+{
+    py::class_<CompactCollisionConstraints>(m, "CompactCollisionConstraints")
+        .def(py::init(), "")
+        .def(
+            py::init<const CollisionConstraints&>(),
+            R"ipc_Qu8mg5v7(
+            Convert a set of collision constraints to compact storage.
+
+            Parameters:
+                constraints: The collision constraints to convert.
+            )ipc_Qu8mg5v7",
+            py::arg("constraints"))
+        .def(
+            "build", &CompactCollisionConstraints::build,
+            R"ipc_Qu8mg5v7(
+            Initialize the set of constraints from compact candidates.
+
+            Note:
+                The candidates are expanded one block at a time, and only the active constraints are materialized before being compacted.
+
+            Parameters:
+                candidates: Compact distance candidates from which the constraint set is built.
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+                dmin: Minimum distance.
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("candidates"),
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("dmin") = 0)
+        .def(
+            "to_collision_constraints",
+            &CompactCollisionConstraints::to_collision_constraints,
+            R"ipc_Qu8mg5v7(
+            Expand the compact constraints into the polymorphic constraints.
+
+            Parameters:
+                mesh: The collision mesh (used to build the vertex incidence).
+
+            Returns:
+                The equivalent collision constraints.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"))
+        .def(
+            "compute_potential",
+            &CompactCollisionConstraints::compute_potential,
+            R"ipc_Qu8mg5v7(
+            Compute the barrier potential.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+
+            Returns:
+                The sum of all barrier potentials (not scaled by the barrier stiffness).
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("dhat"))
+        .def(
+            "compute_potential_gradient",
+            &CompactCollisionConstraints::compute_potential_gradient,
+            R"ipc_Qu8mg5v7(
+            Compute the gradient of the barrier potential.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+
+            Returns:
+                The gradient of all barrier potentials (not scaled by the barrier stiffness).
+            )ipc_Qu8mg5v7",
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("dhat"))
+        .def(
+            "compute_potential_hessian",
+            [](const CompactCollisionConstraints& self,
+               const CollisionMesh& mesh, const Eigen::MatrixXd& vertices,
+               const double dhat, const bool project_hessian_to_psd,
+               const bool upper_triangular) {
+                Eigen::SparseMatrix<double, Eigen::RowMajor> hess;
+                {
+                    py::gil_scoped_release release;
+                    hess = self.compute_potential_hessian(
+                        mesh, vertices, dhat, project_hessian_to_psd,
+                        upper_triangular);
+                }
+                return to_scipy_csr(std::move(hess));
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the hessian of the barrier potential.
+
+            Parameters:
+                mesh: The collision mesh.
+                vertices: Vertices of the collision mesh.
+                dhat: The activation distance of the barrier.
+                project_hessian_to_psd: Make sure the hessian is positive semi-definite.
+                upper_triangular: Only assemble the upper triangle of the symmetric hessian.
+
+            Returns:
+                The hessian of all barrier potentials (not scaled by the barrier stiffness).
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("vertices"), py::arg("dhat"),
+            py::arg("project_hessian_to_psd") = false,
+            py::arg("upper_triangular") = false)
+        .def("__len__", &CompactCollisionConstraints::size, "")
+        .def("empty", &CompactCollisionConstraints::empty, "")
+        .def("clear", &CompactCollisionConstraints::clear, "")
+        .def(
+            "minimum_distance", &CompactCollisionConstraints::minimum_distance,
+            "Get the minimum distance of constraint i.", py::arg("i"))
+        .def(
+            "weight", &CompactCollisionConstraints::weight,
+            "Get the weight of constraint i.", py::arg("i"))
+        .def_readwrite(
+            "ee_eps_x", &CompactCollisionConstraints::ee_eps_x,
+            "Mollifier threshold of each edge-edge constraint.")
+        .def_readwrite(
+            "minimum_distances",
+            &CompactCollisionConstraints::minimum_distances,
+            "Minimum distance of each constraint (empty if all are zero).")
+        .def_readwrite(
+            "weights", &CompactCollisionConstraints::weights,
+            "Weight of each constraint (empty if all are one).")
+        .def_readwrite(
+            "use_convergent_formulation",
+            &CompactCollisionConstraints::use_convergent_formulation,
+            "If the constraints use the convergent formulation (set before "
+            "calling build()).")
+        .def_readwrite(
+            "are_shape_derivatives_enabled",
+            &CompactCollisionConstraints::are_shape_derivatives_enabled,
+            "If the constraints have shape derivatives enabled (set before "
+            "calling build()).");
+}
@@ -0,0 +1,28 @@
+#include <common.hpp>
+
+#include <ipc/collisions/sdf_vertex.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_sdf_vertex_constraint(py::module_& m)
+{
+    py::class_<SDFVertexConstraint, CollisionConstraint>(
+        m, "SDFVertexConstraint")
+        .def(
+            py::init([](std::shared_ptr<GridSDF> sdf, const long vertex_id) {
+                return SDFVertexConstraint(sdf, vertex_id);
+            }),
+            "", py::arg("sdf"), py::arg("vertex_id"))
+        .def("num_vertices", &SDFVertexConstraint::num_vertices, "")
+        .def(
+            "vertex_ids", &SDFVertexConstraint::vertex_ids, "",
+            py::arg("edges"), py::arg("faces"))
+        .def_property_readonly(
+            "sdf",
+            [](const SDFVertexConstraint& self) {
+                return std::const_pointer_cast<GridSDF>(self.sdf);
+            },
+            "")
+        .def_readwrite("vertex_id", &SDFVertexConstraint::vertex_id, "");
+}
@@ -4,6 +4,7 @@
 #include <pybind11/operators.h>
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 
 #include <Eigen/Core>
 #include <Eigen/Sparse>
@@ -54,4 +55,54 @@ inline void copy_vector(
     } else {
         v_copy = v.transpose();
     }
-}
\ No newline at end of file
+}
+
+/// @brief Wrap a row-major sparse matrix as a scipy.sparse.csr_matrix.
+///
+/// The matrix is moved to the heap and NumPy views its buffers, so no copy
+/// is made on the Python side. Converting a column-major result to the
+/// row-major argument still copies once in C++. The returned matrix keeps
+/// the buffers alive.
+///
+/// @param M Sparse matrix to wrap (moved from).
+/// @return A scipy.sparse.csr_matrix viewing the buffers of M.
+inline pybind11::object
+to_scipy_csr(Eigen::SparseMatrix<double, Eigen::RowMajor>&& M)
+{
+    using CSR = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+    namespace py = pybind11;
+
+    CSR* csr = new CSR(std::move(M));
+    csr->makeCompressed();
+    py::capsule owner(csr, [](void* p) { delete reinterpret_cast<CSR*>(p); });
+
+    py::array data(csr->nonZeros(), csr->valuePtr(), owner);
+    py::array indices(csr->nonZeros(), csr->innerIndexPtr(), owner);
+    py::array indptr(csr->outerSize() + 1, csr->outerIndexPtr(), owner);
+
+    return py::module_::import("scipy.sparse")
+        .attr("csr_matrix")(
+            py::make_tuple(data, indices, indptr),
+            py::make_tuple(csr->rows(), csr->cols()), py::arg("copy") = false);
+}
+
+/// @brief Write the ids of each item directly into a contiguous int64 array.
+/// @param items Items to extract the ids of.
+/// @param ids Function returning the N ids of an item.
+/// @return A #items by N array of ids.
+template <size_t N, typename T, typename Function>
+pybind11::array_t<int64_t>
+to_id_array(const std::vector<T>& items, const Function& ids)
+{
+    pybind11::array_t<int64_t> out(
+        { static_cast<pybind11::ssize_t>(items.size()),
+          static_cast<pybind11::ssize_t>(N) });
+    auto r = out.mutable_unchecked<2>();
+    for (size_t i = 0; i < items.size(); i++) {
+        const auto item_ids = ids(items[i]);
+        for (size_t j = 0; j < N; j++) {
+            r(i, j) = item_ids[j];
+        }
+    }
+    return out;
+}
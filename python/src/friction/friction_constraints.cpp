@@ -15,8 +15,8 @@ void define_friction_constraints(py::module_& m)
                 const CollisionMesh&, const Eigen::MatrixXd&,
                 const CollisionConstraints&, double, double, double>(
                 &FrictionConstraints::build),
-            "", py::arg("mesh"), py::arg("vertices"),
-            py::arg("contact_constraints"), py::arg("dhat"),
+            "", py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("contact_constraints"), py::arg("dhat"),
             py::arg("barrier_stiffness"), py::arg("mu"))
         .def(
             "build",
@@ -29,8 +29,8 @@ void define_friction_constraints(py::module_& m)
                     mesh, vertices, contact_constraints, dhat,
                     barrier_stiffness, mus);
             },
-            "", py::arg("mesh"), py::arg("vertices"),
-            py::arg("contact_constraints"), py::arg("dhat"),
+            "", py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("contact_constraints"), py::arg("dhat"),
             py::arg("barrier_stiffness"), py::arg("mus"))
         .def(
             "build",
@@ -40,8 +40,8 @@ void define_friction_constraints(py::module_& m)
                 const Eigen::VectorXd&,
                 const std::function<double(double, double)>&>(
                 &FrictionConstraints::build),
-            "", py::arg("mesh"), py::arg("vertices"),
-            py::arg("contact_constraints"), py::arg("dhat"),
+            "", py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("vertices"), py::arg("contact_constraints"), py::arg("dhat"),
             py::arg("barrier_stiffness"), py::arg("mus"), py::arg("blend_mu"))
         .def(
             "compute_potential", &FrictionConstraints::compute_potential,
@@ -56,7 +56,8 @@ void define_friction_constraints(py::module_& m)
             Returns:
                 The friction dissapative potential.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("velocity"), py::arg("epsv"))
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("velocity"), py::arg("epsv"))
         .def(
             "compute_potential_gradient",
             &FrictionConstraints::compute_potential_gradient,
@@ -71,10 +72,23 @@ void define_friction_constraints(py::module_& m)
             Returns:
                 The gradient of the friction dissapative potential wrt the velocity.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("velocity"), py::arg("epsv"))
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("velocity"), py::arg("epsv"))
         .def(
             "compute_potential_hessian",
-            &FrictionConstraints::compute_potential_hessian,
+            [](const FrictionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& velocity, const double epsv,
+               const bool project_hessian_to_psd,
+               const bool upper_triangular) {
+                Eigen::SparseMatrix<double, Eigen::RowMajor> hess;
+                {
+                    py::gil_scoped_release release;
+                    hess = self.compute_potential_hessian(
+                        mesh, velocity, epsv, project_hessian_to_psd,
+                        upper_triangular);
+                }
+                return to_scipy_csr(std::move(hess));
+            },
             R"ipc_Qu8mg5v7(
             Compute the Hessian of the friction dissapative potential wrt the velocity.
 
@@ -83,11 +97,76 @@ void define_friction_constraints(py::module_& m)
                 velocity: Current vertex velocity (rowwise).
                 epsv: Mollifier parameter :math:`\epsilon_v`.
                 project_hessian_to_psd: If true, project the Hessian to be positive semi-definite.
+                upper_triangular: If true, only assemble the upper triangle of the symmetric Hessian.
 
             Returns:
                 The Hessian of the friction dissapative potential wrt the velocity.
             )ipc_Qu8mg5v7",
             py::arg("mesh"), py::arg("velocity"), py::arg("epsv"),
+            py::arg("project_hessian_to_psd") = false,
+            py::arg("upper_triangular") = false)
+        .def(
+            "compute_potential_local_gradients",
+            [](const FrictionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& velocity, const double epsv) {
+                Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>
+                    local_gradients(self.size(), 4 * velocity.cols());
+                LocalVertexIds vertex_ids(self.size(), 4);
+                {
+                    py::gil_scoped_release release;
+                    self.compute_potential_local_gradients(
+                        mesh, velocity, epsv, local_gradients, vertex_ids);
+                }
+                return std::make_tuple(local_gradients, vertex_ids);
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the unassembled gradients of the friction dissapative potential of each constraint.
+
+            Parameters:
+                mesh: The collision mesh.
+                velocity: Current vertex velocity (rowwise).
+                epsv: Mollifier parameter :math:`\epsilon_v`.
+
+            Returns:
+                Tuple of:
+                Local gradients as rows of size 4·dim (zero padded).
+                Vertex ids of each constraint (-1 for unused vertices).
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("velocity"), py::arg("epsv"))
+        .def(
+            "compute_potential_local_hessians",
+            [](const FrictionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& velocity, const double epsv,
+               const bool project_hessian_to_psd) {
+                const int m = 4 * velocity.cols();
+                Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>
+                    local_hessians(self.size(), m * m);
+                LocalVertexIds vertex_ids(self.size(), 4);
+                {
+                    py::gil_scoped_release release;
+                    self.compute_potential_local_hessians(
+                        mesh, velocity, epsv, local_hessians, vertex_ids,
+                        project_hessian_to_psd);
+                }
+                return std::make_tuple(local_hessians, vertex_ids);
+            },
+            R"ipc_Qu8mg5v7(
+            Compute the unassembled Hessians of the friction dissapative potential of each constraint.
+
+            Parameters:
+                mesh: The collision mesh.
+                velocity: Current vertex velocity (rowwise).
+                epsv: Mollifier parameter :math:`\epsilon_v`.
+                project_hessian_to_psd: Make sure the Hessians are positive semi-definite.
+
+            Returns:
+                Tuple of:
+                Local Hessians as rows of size (4·dim)² (column-major, zero padded).
+                Vertex ids of each constraint (-1 for unused vertices).
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("velocity"), py::arg("epsv"),
             py::arg("project_hessian_to_psd") = false)
         .def(
             "compute_force",
@@ -113,9 +192,10 @@ void define_friction_constraints(py::module_& m)
             Returns:
                 The friction force.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("X"), py::arg("Ut"), py::arg("U"),
-            py::arg("dhat"), py::arg("barrier_stiffness"), py::arg("epsv"),
-            py::arg("dmin") = 0, py::arg("no_mu") = false)
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("X"), py::arg("Ut"), py::arg("U"), py::arg("dhat"),
+            py::arg("barrier_stiffness"), py::arg("epsv"), py::arg("dmin") = 0,
+            py::arg("no_mu") = false)
         .def(
             "compute_force",
             py::overload_cast<
@@ -139,17 +219,26 @@ void define_friction_constraints(py::module_& m)
             Returns:
                 The friction force.
             )ipc_Qu8mg5v7",
-            py::arg("mesh"), py::arg("X"), py::arg("U"), py::arg("dhat"),
+            py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+            py::arg("X"), py::arg("U"), py::arg("dhat"),
             py::arg("barrier_stiffness"), py::arg("epsv"), py::arg("dmin") = 0,
             py::arg("no_mu") = false)
         .def(
             "compute_force_jacobian",
-            py::overload_cast<
-                const CollisionMesh&, const Eigen::MatrixXd&,
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&, const double,
-                const double, const double, const FrictionConstraint::DiffWRT,
-                const double>(
-                &FrictionConstraints::compute_force_jacobian, py::const_),
+            [](const FrictionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& X, const Eigen::MatrixXd& Ut,
+               const Eigen::MatrixXd& U, const double dhat,
+               const double barrier_stiffness, const double epsv,
+               const FrictionConstraint::DiffWRT wrt, const double dmin) {
+                Eigen::SparseMatrix<double, Eigen::RowMajor> jacobian;
+                {
+                    py::gil_scoped_release release;
+                    jacobian = self.compute_force_jacobian(
+                        mesh, X, Ut, U, dhat, barrier_stiffness, epsv, wrt,
+                        dmin);
+                }
+                return to_scipy_csr(std::move(jacobian));
+            },
             R"ipc_Qu8mg5v7(
             Compute the Jacobian of the friction force wrt the velocity.
 
@@ -172,11 +261,19 @@ void define_friction_constraints(py::module_& m)
             py::arg("wrt"), py::arg("dmin") = 0)
         .def(
             "compute_force_jacobian",
-            py::overload_cast<
-                const CollisionMesh&, const Eigen::MatrixXd&,
-                const Eigen::MatrixXd&, const double, const double,
-                const double, const FrictionConstraint::DiffWRT, const double>(
-                &FrictionConstraints::compute_force_jacobian, py::const_),
+            [](const FrictionConstraints& self, const CollisionMesh& mesh,
+               const Eigen::MatrixXd& X, const Eigen::MatrixXd& U,
+               const double dhat, const double barrier_stiffness,
+               const double epsv, const FrictionConstraint::DiffWRT wrt,
+               const double dmin) {
+                Eigen::SparseMatrix<double, Eigen::RowMajor> jacobian;
+                {
+                    py::gil_scoped_release release;
+                    jacobian = self.compute_force_jacobian(
+                        mesh, X, U, dhat, barrier_stiffness, epsv, wrt, dmin);
+                }
+                return to_scipy_csr(std::move(jacobian));
+            },
             R"ipc_Qu8mg5v7(
             Compute the Jacobian of the friction force wrt the velocity.
 
@@ -3,4 +3,6 @@
 #include <pybind11/pybind11.h>
 namespace py = pybind11;
 
-void define_plane_implicit(py::module_& m);
\ No newline at end of file
+void define_grid_sdf(py::module_& m);
+void define_plane_implicit(py::module_& m);
+void define_sdf_implicit(py::module_& m);
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <common.hpp>
+
+#include <ipc/implicits/grid_sdf.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_grid_sdf(py::module_& m)
+{
+    py::class_<GridSDF, std::shared_ptr<GridSDF>>(
+        m, "GridSDF",
+        R"ipc_Qu8mg5v7(
+        Signed distance field sampled on a regular grid.
+
+        The field is the bilinear (2D) or trilinear (3D) interpolation of the
+        samples. Outside the grid, the distance to the grid's bounding box is
+        added to the value at the closest point on the box.
+        )ipc_Qu8mg5v7")
+        .def(
+            py::init<
+                const VectorMax3d&, const double, const ArrayMax3i&,
+                const Eigen::VectorXd&>(),
+            R"ipc_Qu8mg5v7(
+            Construct a grid signed distance field.
+
+            Parameters:
+                origin: Position of the first sample (i.e., the minimum corner of the grid).
+                spacing: Distance between neighboring samples.
+                resolution: Number of samples along each axis (at least 2).
+                values: Samples ordered with x varying fastest, then y, then z.
+            )ipc_Qu8mg5v7",
+            py::arg("origin"), py::arg("spacing"), py::arg("resolution"),
+            py::arg("values"))
+        .def_static(
+            "load", &GridSDF::load,
+            R"ipc_Qu8mg5v7(
+            Load a grid signed distance field from a binary file.
+
+            Parameters:
+                filename: Path to the file.
+
+            Returns:
+                The loaded signed distance field.
+            )ipc_Qu8mg5v7",
+            py::arg("filename"))
+        .def(
+            "save", &GridSDF::save,
+            R"ipc_Qu8mg5v7(
+            Save the grid signed distance field to a binary file.
+
+            Parameters:
+                filename: Path to the file.
+            )ipc_Qu8mg5v7",
+            py::arg("filename"))
+        .def_property_readonly("dim", &GridSDF::dim)
+        .def_property_readonly("origin", &GridSDF::origin)
+        .def_property_readonly("spacing", &GridSDF::spacing)
+        .def_property_readonly("resolution", &GridSDF::resolution)
+        .def_property_readonly("values", &GridSDF::values)
+        .def_property_readonly(
+            "lipschitz_constant", &GridSDF::lipschitz_constant,
+            "A Lipschitz constant of the field.")
+        .def(
+            "signed_distance", &GridSDF::signed_distance,
+            R"ipc_Qu8mg5v7(
+            Evaluate the signed distance at a point.
+
+            Parameters:
+                p: Query point.
+
+            Returns:
+                The interpolated signed distance.
+            )ipc_Qu8mg5v7",
+            py::arg("p"))
+        .def(
+            "signed_distance_gradient", &GridSDF::signed_distance_gradient,
+            R"ipc_Qu8mg5v7(
+            Evaluate the gradient of the signed distance at a point.
+
+            Parameters:
+                p: Query point.
+
+            Returns:
+                The gradient of the interpolated signed distance.
+            )ipc_Qu8mg5v7",
+            py::arg("p"))
+        .def(
+            "signed_distance_hessian", &GridSDF::signed_distance_hessian,
+            R"ipc_Qu8mg5v7(
+            Evaluate the Hessian of the signed distance at a point.
+
+            Parameters:
+                p: Query point.
+
+            Returns:
+                The Hessian of the interpolated signed distance.
+            )ipc_Qu8mg5v7",
+            py::arg("p"));
+}
@@ -0,0 +1,83 @@
+#include <common.hpp>
+
+#include <ipc/implicits/sdf.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_sdf_implicit(py::module_& m)
+{
+    m.def(
+        "construct_point_sdf_constraint_set",
+        [](const Eigen::MatrixXd& points, std::shared_ptr<GridSDF> sdf,
+           const double dhat, const double dmin,
+           const std::function<bool(size_t)>& can_collide) {
+            std::vector<SDFVertexConstraint> sdf_constraints;
+            construct_point_sdf_constraint_set(
+                points, sdf, dhat, sdf_constraints, dmin, can_collide);
+            return sdf_constraints;
+        },
+        R"ipc_Qu8mg5v7(
+        Construct a set of point-SDF distance constraints used to compute
+        the barrier potential.
+
+        Parameters:
+            points: Points as rows of a matrix.
+            sdf: Signed distance field of the static obstacle.
+            dhat: The activation distance of the barrier.
+            dmin: Minimum distance.
+            can_collide: A function that takes a vertex ID (row number in points) then returns true if the vertex can collide with the obstacle. By default all points can collide with the obstacle.
+
+        Returns:
+            The constructed set of constraints.
+        )ipc_Qu8mg5v7",
+        py::arg("points"), py::arg("sdf"), py::arg("dhat"),
+        py::arg("dmin") = 0,
+        py::arg("can_collide") =
+            std::function<bool(size_t)>(default_can_point_sdf_collide));
+
+    m.def(
+        "is_step_point_sdf_collision_free", &is_step_point_sdf_collision_free,
+        R"ipc_Qu8mg5v7(
+        Determine if the step is collision free.
+
+        Note:
+            Assumes the trajectory is linear.
+
+        Parameters:
+            points_t0: Points at start as rows of a matrix.
+            points_t1: Points at end as rows of a matrix.
+            sdf: Signed distance field of the static obstacle.
+            can_collide: A function that takes a vertex ID (row number in points) then returns true if the vertex can collide with the obstacle. By default all points can collide with the obstacle.
+
+        Returns:
+            True if <b>no</b> collisions occur.
+        )ipc_Qu8mg5v7",
+        py::arg("points_t0"), py::arg("points_t1"), py::arg("sdf"),
+        py::arg("can_collide") =
+            std::function<bool(size_t)>(default_can_point_sdf_collide));
+
+    m.def(
+        "compute_point_sdf_collision_free_stepsize",
+        &compute_point_sdf_collision_free_stepsize,
+        R"ipc_Qu8mg5v7(
+        Computes a maximal step size that is collision free.
+
+        Notes:
+            Assumes points_t0 is intersection free.
+            Assumes the trajectory is linear.
+            A value of 1.0 if a full step and 0.0 is no step.
+
+        Parameters:
+            points_t0: Points at start as rows of a matrix.
+            points_t1: Points at end as rows of a matrix.
+            sdf: Signed distance field of the static obstacle.
+            can_collide: A function that takes a vertex ID (row number in points) then returns true if the vertex can collide with the obstacle. By default all points can collide with the obstacle.
+
+        Returns:
+            A step-size $\in [0, 1]$ that is collision free.
+        )ipc_Qu8mg5v7",
+        py::arg("points_t0"), py::arg("points_t1"), py::arg("sdf"),
+        py::arg("can_collide") =
+            std::function<bool(size_t)>(default_can_point_sdf_collide));
+}
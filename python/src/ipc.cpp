@@ -32,7 +32,8 @@ void define_ipc(py::module_& m)
         Returns:
             True if <b>any</b> collisions occur.
         )ipc_Qu8mg5v7",
-        py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+        py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+        py::arg("vertices_t0"), py::arg("vertices_t1"),
         py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD,
         py::arg("min_distance") = 0.0,
         py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
@@ -43,7 +44,8 @@ void define_ipc(py::module_& m)
         py::overload_cast<
             const CollisionMesh&, const Eigen::MatrixXd&,
             const Eigen::MatrixXd&, const BroadPhaseMethod, const double,
-            const double, const long>(&compute_collision_free_stepsize),
+            const double, const long, const int>(
+            &compute_collision_free_stepsize),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free.
 
@@ -58,15 +60,18 @@ void define_ipc(py::module_& m)
             min_distance: The minimum distance allowable between any two elements.
             tolerance: The tolerance for the CCD algorithm.
             max_iterations: The maximum number of iterations for the CCD algorithm.
+            max_temporal_subdivisions: Maximum number of sub-intervals of time used to cull the broad-phase candidates of fast-moving elements (1 disables it).
 
         Returns:
             A step-size $\in [0, 1]$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
         )ipc_Qu8mg5v7",
-        py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+        py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+        py::arg("vertices_t0"), py::arg("vertices_t1"),
         py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD,
         py::arg("min_distance") = 0.0,
         py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
-        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+        py::arg("max_temporal_subdivisions") = 1);
 
     m.def(
         "has_intersections", &has_intersections,
@@ -81,9 +86,75 @@ void define_ipc(py::module_& m)
         Returns:
             A boolean for if the mesh has intersections.
         )ipc_Qu8mg5v7",
+        py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+        py::arg("vertices"),
+        py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD);
+
+    m.def(
+        "find_intersections",
+        [](const CollisionMesh& mesh, const Eigen::MatrixXd& vertices,
+           const BroadPhaseMethod broad_phase_method) {
+            std::vector<EdgeEdgeCandidate> ee_intersections;
+            std::vector<EdgeFaceCandidate> ef_intersections;
+            {
+                py::gil_scoped_release release;
+                find_intersections(
+                    mesh, vertices, ee_intersections, ef_intersections,
+                    broad_phase_method);
+            }
+            return std::make_tuple(
+                to_id_array<2>(
+                    ee_intersections,
+                    [](const EdgeEdgeCandidate& c) {
+                        return std::array<long, 2> { { c.edge0_id,
+                                                       c.edge1_id } };
+                    }),
+                to_id_array<2>(ef_intersections, [](const EdgeFaceCandidate& c) {
+                    return std::array<long, 2> { { c.edge_id, c.face_id } };
+                }));
+        },
+        R"ipc_Qu8mg5v7(
+        Find all self intersections of the mesh.
+
+        Parameters:
+            mesh: The collision mesh.
+            vertices: Vertices of the collision mesh.
+            broad_phase_method: The broad phase method to use.
+
+        Returns:
+            Tuple of:
+            Sorted intersecting edge-edge pairs as an (n, 2) array (2D only).
+            Sorted intersecting edge-face pairs as an (m, 2) array (3D only).
+        )ipc_Qu8mg5v7",
         py::arg("mesh"), py::arg("vertices"),
         py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD);
 
+    m.def(
+        "compute_minimum_distance",
+        [](const CollisionMesh& mesh, const Eigen::MatrixXd& vertices) {
+            ClosestPair closest_pair;
+            const double distance =
+                compute_minimum_distance(mesh, vertices, closest_pair);
+            return std::make_tuple(distance, closest_pair);
+        },
+        R"ipc_Qu8mg5v7(
+        Compute the global minimum distance between the elements of the mesh.
+
+        Note:
+            The distance is actually squared distance.
+
+        Parameters:
+            mesh: The collision mesh.
+            vertices: Vertices of the collision mesh.
+
+        Returns:
+            Tuple of:
+            The minimum distance between any pair of elements that can collide (infinity if there is none).
+            The pair of elements attaining the minimum distance (None if there is none).
+        )ipc_Qu8mg5v7",
+        py::call_guard<py::gil_scoped_release>(), py::arg("mesh"),
+        py::arg("vertices"));
+
     m.def(
         "edges",
         [](const Eigen::MatrixXi& F) {
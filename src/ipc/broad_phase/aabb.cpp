@@ -3,10 +3,87 @@
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
-#include <cfenv>
+#include <cmath>
+#include <limits>
 
 namespace ipc {
 
+namespace {
+    /// @brief Set a box to the union of the boxes of an edge's vertices.
+    inline void set_edge_box(
+        const std::vector<AABB>& vertex_boxes,
+        const long e0i,
+        const long e1i,
+        AABB& edge_box)
+    {
+        const AABB& b0 = vertex_boxes[e0i];
+        const AABB& b1 = vertex_boxes[e1i];
+        edge_box.min = b0.min.min(b1.min);
+        edge_box.max = b0.max.max(b1.max);
+        edge_box.vertex_ids = { { e0i, e1i, -1 } };
+    }
+
+    /// @brief Set a box to the union of the boxes of a face's vertices.
+    inline void set_face_box(
+        const std::vector<AABB>& vertex_boxes,
+        const long f0i,
+        const long f1i,
+        const long f2i,
+        AABB& face_box)
+    {
+        const AABB& b0 = vertex_boxes[f0i];
+        const AABB& b1 = vertex_boxes[f1i];
+        const AABB& b2 = vertex_boxes[f2i];
+        face_box.min = b0.min.min(b1.min).min(b2.min);
+        face_box.max = b0.max.max(b1.max).max(b2.max);
+        face_box.vertex_ids = { { f0i, f1i, f2i } };
+    }
+
+    /// @brief Build all boxes given a function setting the box of a vertex.
+    /// @note The vertex boxes are built in one pass over the vertices, then the edge and face boxes are built together in one pass over the elements.
+    template <typename VertexBoxFunction>
+    void build_boxes(
+        const size_t num_vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const VertexBoxFunction& set_vertex_box,
+        std::vector<AABB>& vertex_boxes,
+        std::vector<AABB>& edge_boxes,
+        std::vector<AABB>& face_boxes)
+    {
+        // NOTE: resize() reuses the capacity of previous builds.
+        vertex_boxes.resize(num_vertices);
+        edge_boxes.resize(edges.rows());
+        face_boxes.resize(faces.rows());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), num_vertices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    set_vertex_box(i, vertex_boxes[i]);
+                }
+            });
+
+        const size_t num_edges = edges.rows();
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), num_edges + faces.rows()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    if (i < num_edges) {
+                        set_edge_box(
+                            vertex_boxes, edges(i, 0), edges(i, 1),
+                            edge_boxes[i]);
+                    } else {
+                        const size_t fi = i - num_edges;
+                        set_face_box(
+                            vertex_boxes, faces(fi, 0), faces(fi, 1),
+                            faces(fi, 2), face_boxes[fi]);
+                    }
+                }
+            });
+    }
+} // namespace
+
 AABB::AABB(const ArrayMax3d& min, const ArrayMax3d& max) : min(min), max(max)
 {
     assert(min.size() == max.size());
@@ -17,9 +94,24 @@ AABB::AABB(const ArrayMax3d& min, const ArrayMax3d& max) : min(min), max(max)
 
 AABB AABB::from_point(const VectorMax3d& p, const double inflation_radius)
 {
-    ArrayMax3d min = p.array(), max = p.array();
-    conservative_inflation(min, max, inflation_radius);
-    return AABB(min, max);
+    AABB aabb;
+    aabb.min = p.array();
+    aabb.max = p.array();
+    conservative_inflation(aabb.min, aabb.max, inflation_radius);
+    return aabb;
+}
+
+AABB AABB::from_point(
+    const VectorMax3d& p_t0,
+    const VectorMax3d& p_t1,
+    const double inflation_radius)
+{
+    // Inflating the union is the same as the union of the inflated points.
+    AABB aabb;
+    aabb.min = p_t0.array().min(p_t1.array());
+    aabb.max = p_t0.array().max(p_t1.array());
+    conservative_inflation(aabb.min, aabb.max, inflation_radius);
+    return aabb;
 }
 
 bool AABB::intersects(const AABB& other) const
@@ -44,16 +136,17 @@ bool AABB::intersects(const AABB& other) const
 void AABB::conservative_inflation(
     ArrayMax3d& min, ArrayMax3d& max, const double inflation_radius)
 {
-#pragma STDC FENV_ACCESS ON
-    const int current_round = std::fegetround();
-
-    std::fesetround(FE_DOWNWARD);
-    min -= inflation_radius;
-
-    std::fesetround(FE_UPWARD);
-    max += inflation_radius;
+    if (inflation_radius == 0) {
+        return; // Nothing to round
+    }
 
-    std::fesetround(current_round);
+    // Rounding to nearest is off by at most half an ulp, so moving one ulp
+    // outward is conservative without changing the rounding mode.
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < min.size(); i++) {
+        min[i] = std::nextafter(min[i] - inflation_radius, -inf);
+        max[i] = std::nextafter(max[i] + inflation_radius, inf);
+    }
 }
 
 void build_vertex_boxes(
@@ -104,9 +197,8 @@ void build_edge_boxes(
         tbb::blocked_range<size_t>(0, edges.rows()),
         [&](const tbb::blocked_range<size_t>& r) {
             for (size_t i = r.begin(); i < r.end(); i++) {
-                edge_boxes[i] =
-                    AABB(vertex_boxes[edges(i, 0)], vertex_boxes[edges(i, 1)]);
-                edge_boxes[i].vertex_ids = { { edges(i, 0), edges(i, 1), -1 } };
+                set_edge_box(
+                    vertex_boxes, edges(i, 0), edges(i, 1), edge_boxes[i]);
             }
         });
 }
@@ -122,13 +214,55 @@ void build_face_boxes(
         tbb::blocked_range<size_t>(0, faces.rows()),
         [&](const tbb::blocked_range<size_t>& r) {
             for (size_t i = r.begin(); i < r.end(); i++) {
-                face_boxes[i] = AABB(
-                    vertex_boxes[faces(i, 0)], vertex_boxes[faces(i, 1)],
-                    vertex_boxes[faces(i, 2)]);
-                face_boxes[i].vertex_ids = { { faces(i, 0), faces(i, 1),
-                                               faces(i, 2) } };
+                set_face_box(
+                    vertex_boxes, faces(i, 0), faces(i, 1), faces(i, 2),
+                    face_boxes[i]);
             }
         });
 }
 
+void build_boxes(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    std::vector<AABB>& vertex_boxes,
+    std::vector<AABB>& edge_boxes,
+    std::vector<AABB>& face_boxes,
+    const double inflation_radius)
+{
+    build_boxes(
+        vertices.rows(), edges, faces,
+        [&](const size_t i, AABB& box) {
+            box.min = vertices.row(i).array();
+            box.max = vertices.row(i).array();
+            AABB::conservative_inflation(box.min, box.max, inflation_radius);
+            box.vertex_ids = { { long(i), -1, -1 } };
+        },
+        vertex_boxes, edge_boxes, face_boxes);
+}
+
+void build_boxes(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    std::vector<AABB>& vertex_boxes,
+    std::vector<AABB>& edge_boxes,
+    std::vector<AABB>& face_boxes,
+    const double inflation_radius)
+{
+    assert(vertices_t0.rows() == vertices_t1.rows());
+    build_boxes(
+        vertices_t0.rows(), edges, faces,
+        [&](const size_t i, AABB& box) {
+            const auto p_t0 = vertices_t0.row(i).array();
+            const auto p_t1 = vertices_t1.row(i).array();
+            box.min = p_t0.min(p_t1);
+            box.max = p_t0.max(p_t1);
+            AABB::conservative_inflation(box.min, box.max, inflation_radius);
+            box.vertex_ids = { { long(i), -1, -1 } };
+        },
+        vertex_boxes, edge_boxes, face_boxes);
+}
+
 } // namespace ipc
\ No newline at end of file
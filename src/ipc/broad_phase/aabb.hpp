@@ -33,16 +33,12 @@ public:
     static AABB from_point(
         const VectorMax3d& p_t0,
         const VectorMax3d& p_t1,
-        const double inflation_radius = 0)
-    {
-        return AABB(
-            from_point(p_t0, inflation_radius),
-            from_point(p_t1, inflation_radius));
-    }
+        const double inflation_radius = 0);
 
     bool intersects(const AABB& other) const;
 
     /// @brief Compute a conservative inflation of the AABB.
+    /// @note The inflated bounds are rounded outward with nextafter instead of changing the floating-point rounding mode.
     static void conservative_inflation(
         ArrayMax3d& min, ArrayMax3d& max, const double inflation_radius);
 
@@ -73,4 +69,27 @@ void build_face_boxes(
     const Eigen::MatrixXi& faces,
     std::vector<AABB>& face_boxes);
 
+/// @brief Build the vertex, edge, and face boxes of a static mesh.
+/// @note This takes one parallel pass over the vertices and one over the edges and faces, and it reuses the capacity of the output vectors.
+void build_boxes(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    std::vector<AABB>& vertex_boxes,
+    std::vector<AABB>& edge_boxes,
+    std::vector<AABB>& face_boxes,
+    const double inflation_radius = 0);
+
+/// @brief Build the vertex, edge, and face boxes of a moving mesh.
+/// @note This takes one parallel pass over the vertices and one over the edges and faces, and it reuses the capacity of the output vectors.
+void build_boxes(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    std::vector<AABB>& vertex_boxes,
+    std::vector<AABB>& edge_boxes,
+    std::vector<AABB>& face_boxes,
+    const double inflation_radius = 0);
+
 } // namespace ipc
@@ -3,14 +3,87 @@
 #include <ipc/broad_phase/brute_force.hpp>
 #include <ipc/broad_phase/spatial_hash.hpp>
 #include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/broad_phase/partitioned_broad_phase.hpp>
 #include <ipc/broad_phase/sweep_and_tiniest_queue.hpp>
 #include <ipc/broad_phase/broadmark.hpp>
 #include <ipc/candidates/candidates.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
 
 #include <ipc/config.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_group.h>
+
+#include <atomic>
+
 namespace ipc {
 
+namespace {
+    /// @brief Pass the fixed blocks of a (sorted) list of candidates to a callback.
+    template <typename Candidate>
+    void stream_candidates(
+        std::vector<Candidate>& candidates,
+        const CandidateBatchCallback<Candidate>& callback)
+    {
+        // Sort the candidates so the batches do not depend on the scheduling.
+        tbb::parallel_sort(candidates.begin(), candidates.end());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), num_deterministic_blocks(candidates.size())),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t b = r.begin(); b < r.end(); b++) {
+                    const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                    const size_t end = std::min(
+                        start + DETERMINISTIC_BLOCK_SIZE, candidates.size());
+                    callback(
+                        b,
+                        std::vector<Candidate>(
+                            candidates.begin() + start,
+                            candidates.begin() + end));
+                }
+            });
+    }
+
+    /// @brief Visit the candidates streamed in batches until the visitor stops.
+    /// @param stream Function streaming the batches to a callback.
+    /// @param visitor Function called with each candidate.
+    /// @return True if every candidate was visited.
+    template <typename Candidate, typename StreamFunction>
+    bool visit_candidates(
+        const StreamFunction& stream,
+        const CandidateVisitor<Candidate>& visitor)
+    {
+        std::atomic<bool> stopped(false);
+
+        // The parallel loops of the broad phase are bound to this context, so
+        // cancelling it stops them from starting any new work.
+        tbb::task_group_context context;
+
+        tbb::parallel_for(
+            tbb::blocked_range<int>(0, 1),
+            [&](const tbb::blocked_range<int>&) {
+                stream([&](size_t, const std::vector<Candidate>& candidates) {
+                    for (const Candidate& candidate : candidates) {
+                        if (stopped.load(std::memory_order_relaxed)) {
+                            return;
+                        }
+                        if (!visitor(candidate)) {
+                            stopped = true;
+                            context.cancel_group_execution();
+                            return;
+                        }
+                    }
+                });
+            },
+            context);
+
+        return !stopped;
+    }
+} // namespace
+
 void BroadPhase::build(
     const Eigen::MatrixXd& vertices,
     const Eigen::MatrixXi& edges,
@@ -20,9 +93,9 @@ void BroadPhase::build(
     assert(edges.size() == 0 || edges.cols() == 2);
     assert(faces.size() == 0 || faces.cols() == 3);
     clear();
-    build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
-    build_edge_boxes(vertex_boxes, edges, edge_boxes);
-    build_face_boxes(vertex_boxes, faces, face_boxes);
+    build_boxes(
+        vertices, edges, faces, vertex_boxes, edge_boxes, face_boxes,
+        inflation_radius);
 }
 
 void BroadPhase::build(
@@ -35,10 +108,9 @@ void BroadPhase::build(
     assert(edges.size() == 0 || edges.cols() == 2);
     assert(faces.size() == 0 || faces.cols() == 3);
     clear();
-    build_vertex_boxes(
-        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
-    build_edge_boxes(vertex_boxes, edges, edge_boxes);
-    build_face_boxes(vertex_boxes, faces, face_boxes);
+    build_boxes(
+        vertices_t0, vertices_t1, edges, faces, vertex_boxes, edge_boxes,
+        face_boxes, inflation_radius);
 }
 
 void BroadPhase::clear()
@@ -48,6 +120,82 @@ void BroadPhase::clear()
     face_boxes.clear();
 }
 
+// NOTE: The default implementations store the full list of candidates before
+// passing it to the callback. Broad phases able to enumerate the candidates
+// without duplicates override these to never store the full list.
+
+void BroadPhase::stream_edge_vertex_candidates(
+    const CandidateBatchCallback<EdgeVertexCandidate>& callback) const
+{
+    std::vector<EdgeVertexCandidate> candidates;
+    detect_edge_vertex_candidates(candidates);
+    stream_candidates(candidates, callback);
+}
+
+void BroadPhase::stream_edge_edge_candidates(
+    const CandidateBatchCallback<EdgeEdgeCandidate>& callback) const
+{
+    std::vector<EdgeEdgeCandidate> candidates;
+    detect_edge_edge_candidates(candidates);
+    stream_candidates(candidates, callback);
+}
+
+void BroadPhase::stream_face_vertex_candidates(
+    const CandidateBatchCallback<FaceVertexCandidate>& callback) const
+{
+    std::vector<FaceVertexCandidate> candidates;
+    detect_face_vertex_candidates(candidates);
+    stream_candidates(candidates, callback);
+}
+
+void BroadPhase::stream_edge_face_candidates(
+    const CandidateBatchCallback<EdgeFaceCandidate>& callback) const
+{
+    std::vector<EdgeFaceCandidate> candidates;
+    detect_edge_face_candidates(candidates);
+    stream_candidates(candidates, callback);
+}
+
+bool BroadPhase::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    return visit_candidates(
+        [this](const CandidateBatchCallback<EdgeVertexCandidate>& callback) {
+            stream_edge_vertex_candidates(callback);
+        },
+        visitor);
+}
+
+bool BroadPhase::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    return visit_candidates(
+        [this](const CandidateBatchCallback<EdgeEdgeCandidate>& callback) {
+            stream_edge_edge_candidates(callback);
+        },
+        visitor);
+}
+
+bool BroadPhase::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    return visit_candidates(
+        [this](const CandidateBatchCallback<FaceVertexCandidate>& callback) {
+            stream_face_vertex_candidates(callback);
+        },
+        visitor);
+}
+
+bool BroadPhase::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    return visit_candidates(
+        [this](const CandidateBatchCallback<EdgeFaceCandidate>& callback) {
+            stream_edge_face_candidates(callback);
+        },
+        visitor);
+}
+
 void BroadPhase::detect_collision_candidates(
     int dim, Candidates& candidates) const
 {
@@ -119,6 +267,19 @@ BroadPhase::make_broad_phase(const BroadPhaseMethod broad_phase_method)
     }
 }
 
+std::unique_ptr<BroadPhase> BroadPhase::make_broad_phase(
+    const BroadPhaseMethod broad_phase_method, const CollisionMesh& mesh)
+{
+    std::unique_ptr<BroadPhase> broad_phase =
+        make_broad_phase(broad_phase_method);
+    if (mesh.has_static_vertices()) {
+        broad_phase = std::make_unique<PartitionedBroadPhase>(
+            mesh, std::move(broad_phase));
+    }
+    broad_phase->can_vertices_collide = mesh.can_collide;
+    return broad_phase;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool BroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
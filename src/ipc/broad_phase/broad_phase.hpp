@@ -9,6 +9,9 @@
 
 #include <Eigen/Core>
 
+#include <functional>
+#include <vector>
+
 namespace ipc {
 
 /// Enumeration of implemented broad phase methods.
@@ -41,6 +44,21 @@ static constexpr BroadPhaseMethod DEFAULT_BROAD_PHASE_METHOD =
 
 class Candidates; // Forward declaration
 
+/// @brief Function receiving a batch of candidates found by the broad phase.
+/// @note It is called concurrently from the threads of the broad phase.
+/// @param batch_id Index ordering the batches independent of the scheduling.
+/// @param candidates The candidates of the batch.
+template <typename Candidate>
+using CandidateBatchCallback = std::function<void(
+    const size_t batch_id, const std::vector<Candidate>& candidates)>;
+
+/// @brief Function visiting a candidate found by the broad phase.
+/// @note It is called concurrently from the threads of the broad phase.
+/// @param candidate The candidate to visit.
+/// @return False to stop the enumeration early, true to continue.
+template <typename Candidate>
+using CandidateVisitor = std::function<bool(const Candidate& candidate)>;
+
 class BroadPhase {
 public:
     virtual ~BroadPhase() { clear(); }
@@ -51,6 +69,14 @@ public:
     static std::unique_ptr<BroadPhase>
     make_broad_phase(const BroadPhaseMethod broad_phase_method);
 
+    /// @brief Construct a registered broad phase object for a collision mesh.
+    /// @note The broad phase filters with the mesh's can_collide, and it is partitioned into static and moving elements if the mesh has static vertices.
+    /// @param broad_phase_method The broad phase method to use.
+    /// @param mesh The collision mesh.
+    /// @return The constructed broad phase object.
+    static std::unique_ptr<BroadPhase> make_broad_phase(
+        const BroadPhaseMethod broad_phase_method, const CollisionMesh& mesh);
+
     /// @brief Build the broad phase for static collision detection.
     /// @param vertices Vertex positions
     /// @param edges Collision mesh edges
@@ -98,6 +124,58 @@ public:
     virtual void detect_edge_face_candidates(
         std::vector<EdgeFaceCandidate>& candidates) const = 0;
 
+    /// @brief Find the candidate edge-vertex collisisons in batches.
+    /// @note Every candidate is passed to the callback exactly once, without storing the full list of candidates.
+    /// @param callback Function called with each batch of candidates.
+    virtual void stream_edge_vertex_candidates(
+        const CandidateBatchCallback<EdgeVertexCandidate>& callback) const;
+
+    /// @brief Find the candidate edge-edge collisisons in batches.
+    /// @note Every candidate is passed to the callback exactly once, without storing the full list of candidates.
+    /// @param callback Function called with each batch of candidates.
+    virtual void stream_edge_edge_candidates(
+        const CandidateBatchCallback<EdgeEdgeCandidate>& callback) const;
+
+    /// @brief Find the candidate face-vertex collisisons in batches.
+    /// @note Every candidate is passed to the callback exactly once, without storing the full list of candidates.
+    /// @param callback Function called with each batch of candidates.
+    virtual void stream_face_vertex_candidates(
+        const CandidateBatchCallback<FaceVertexCandidate>& callback) const;
+
+    /// @brief Find the candidate edge-face intersections in batches.
+    /// @note Every candidate is passed to the callback exactly once, without storing the full list of candidates.
+    /// @param callback Function called with each batch of candidates.
+    virtual void stream_edge_face_candidates(
+        const CandidateBatchCallback<EdgeFaceCandidate>& callback) const;
+
+    /// @brief Visit the candidate edge-vertex collisisons as they are found.
+    /// @note The enumeration stops as soon as possible once the visitor returns false.
+    /// @param visitor Function called with each candidate.
+    /// @return True if every candidate was visited, false if the enumeration stopped early.
+    bool visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const;
+
+    /// @brief Visit the candidate edge-edge collisisons as they are found.
+    /// @note The enumeration stops as soon as possible once the visitor returns false.
+    /// @param visitor Function called with each candidate.
+    /// @return True if every candidate was visited, false if the enumeration stopped early.
+    bool visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const;
+
+    /// @brief Visit the candidate face-vertex collisisons as they are found.
+    /// @note The enumeration stops as soon as possible once the visitor returns false.
+    /// @param visitor Function called with each candidate.
+    /// @return True if every candidate was visited, false if the enumeration stopped early.
+    bool visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const;
+
+    /// @brief Visit the candidate edge-face intersections as they are found.
+    /// @note The enumeration stops as soon as possible once the visitor returns false.
+    /// @param visitor Function called with each candidate.
+    /// @return True if every candidate was visited, false if the enumeration stopped early.
+    bool visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const;
+
     /// @brief Detect all collision candidates needed for a given dimensional simulation.
     /// @param dim The dimension of the simulation (i.e., 2 or 3).
     /// @param candidates The detected collision candidates.
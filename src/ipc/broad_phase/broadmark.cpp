@@ -12,10 +12,7 @@ void Broadmark<T>::build(
     CopyMeshBroadPhase::copy_mesh(edges, faces);
     BroadPhase::build(vertices, edges, faces, inflation_radius);
     num_vertices = vertices.rows();
-    std::vector<ipc::AABB> ipc_aabbs;
-    ipc::combine_aabbs(edge_boxes, face_boxes, vertex_boxes, ipc_aabbs);
-    ipc::to_broadmark_aabbs(ipc_aabbs, boxes);
-    ipc_aabbs.clear();
+    ipc::to_broadmark_aabbs(vertex_boxes, edge_boxes, face_boxes, boxes);
     interface.CalcOverlaps(vertices, edges, faces, boxes, /*init=*/true);
 }
 
@@ -30,10 +27,7 @@ void Broadmark<T>::build(
     CopyMeshBroadPhase::copy_mesh(edges, faces);
     BroadPhase::build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
     num_vertices = vertices_t0.rows();
-    std::vector<ipc::AABB> ipc_aabbs;
-    ipc::combine_aabbs(edge_boxes, face_boxes, vertex_boxes, ipc_aabbs);
-    ipc::to_broadmark_aabbs(ipc_aabbs, boxes);
-    ipc_aabbs.clear();
+    ipc::to_broadmark_aabbs(vertex_boxes, edge_boxes, face_boxes, boxes);
     interface.CalcOverlaps(vertices_t0, edges, faces, boxes, /*init=*/true);
 }
 
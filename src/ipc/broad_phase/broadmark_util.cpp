@@ -404,6 +404,7 @@ void combine_aabbs(
     std::vector<ipc::AABB>& aabbs)
 {
     aabbs.clear();
+    aabbs.reserve(vertex_aabbs.size() + edge_aabbs.size() + face_aabbs.size());
     for (auto& aabb : vertex_aabbs)
         aabbs.emplace_back(aabb);
     for (auto& aabb : edge_aabbs)
@@ -425,6 +426,24 @@ void to_broadmark_aabbs(
     }
 }
 
+void to_broadmark_aabbs(
+    const std::vector<ipc::AABB>& vertex_aabbs,
+    const std::vector<ipc::AABB>& edge_aabbs,
+    const std::vector<ipc::AABB>& face_aabbs,
+    std::vector<broadmark::Aabb>& broadmark_aabbs)
+{
+    broadmark_aabbs.clear();
+    broadmark_aabbs.reserve(
+        vertex_aabbs.size() + edge_aabbs.size() + face_aabbs.size());
+    for (const auto* aabbs : { &vertex_aabbs, &edge_aabbs, &face_aabbs }) {
+        for (const ipc::AABB& aabb : *aabbs) {
+            broadmark_aabbs.emplace_back(
+                Vec3(aabb.min[0], aabb.min[1], aabb.min[2]),
+                Vec3(aabb.max[0], aabb.max[1], aabb.max[2]));
+        }
+    }
+}
+
 void to_aabbs(
     const Eigen::MatrixXd& V0,
     const Eigen::MatrixXd& V1,
@@ -102,6 +102,13 @@ void to_broadmark_aabbs(
     const std::vector<ipc::AABB>& ipc_aabbs,
     std::vector<broadmark::Aabb>& broadmark_aabbs);
 
+/// @brief Convert the vertex, edge, and face boxes (in that order) without combining them first.
+void to_broadmark_aabbs(
+    const std::vector<ipc::AABB>& vertex_aabbs,
+    const std::vector<ipc::AABB>& edge_aabbs,
+    const std::vector<ipc::AABB>& face_aabbs,
+    std::vector<broadmark::Aabb>& broadmark_aabbs);
+
 broadmark::Aabb buildWorldAabb(const std::vector<broadmark::Aabb>& aabbs);
 
 void growAabbs(std::vector<broadmark::Aabb>& aabbs, const Vec3& amount);
@@ -1,9 +1,11 @@
 #include "brute_force.hpp"
 
 #include <ipc/utils/merge_thread_local.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 #include <tbb/blocked_range2d.h>
 
 #include <algorithm> // std::min/max
@@ -58,6 +60,43 @@ void BruteForce::detect_candidates(
     merge_thread_local_vectors(storage, candidates);
 }
 
+template <typename Candidate, bool triangular>
+void BruteForce::stream_candidates(
+    const std::vector<AABB>& boxes0,
+    const std::vector<AABB>& boxes1,
+    const std::function<bool(size_t, size_t)>& can_collide,
+    const CandidateBatchCallback<Candidate>& callback) const
+{
+    // Each batch is a fixed block of rows, so every pair is found once and the
+    // batches do not depend on the scheduling.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(boxes0.size())),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::vector<Candidate> batch;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                batch.clear();
+
+                const size_t i_begin = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t i_end =
+                    std::min(i_begin + DETERMINISTIC_BLOCK_SIZE, boxes0.size());
+                for (size_t i = i_begin; i < i_end; i++) {
+                    const AABB& box0 = boxes0[i];
+                    for (size_t j = triangular ? (i + 1) : 0; j < boxes1.size();
+                         j++) {
+                        if (can_collide(i, j) && box0.intersects(boxes1[j])) {
+                            batch.emplace_back(i, j);
+                        }
+                    }
+                }
+
+                if (!batch.empty()) {
+                    callback(b, batch);
+                }
+            }
+        });
+}
+
 void BruteForce::detect_edge_vertex_candidates(
     std::vector<EdgeVertexCandidate>& candidates) const
 {
@@ -94,4 +133,40 @@ void BruteForce::detect_edge_face_candidates(
         candidates);
 }
 
+void BruteForce::stream_edge_vertex_candidates(
+    const CandidateBatchCallback<EdgeVertexCandidate>& callback) const
+{
+    stream_candidates(
+        edge_boxes, vertex_boxes,
+        [&](size_t ei, size_t vi) { return can_edge_vertex_collide(ei, vi); },
+        callback);
+}
+
+void BruteForce::stream_edge_edge_candidates(
+    const CandidateBatchCallback<EdgeEdgeCandidate>& callback) const
+{
+    stream_candidates<EdgeEdgeCandidate, true>(
+        edge_boxes, edge_boxes,
+        [&](size_t eai, size_t ebi) { return can_edges_collide(eai, ebi); },
+        callback);
+}
+
+void BruteForce::stream_face_vertex_candidates(
+    const CandidateBatchCallback<FaceVertexCandidate>& callback) const
+{
+    stream_candidates(
+        face_boxes, vertex_boxes,
+        [&](size_t fi, size_t vi) { return can_face_vertex_collide(fi, vi); },
+        callback);
+}
+
+void BruteForce::stream_edge_face_candidates(
+    const CandidateBatchCallback<EdgeFaceCandidate>& callback) const
+{
+    stream_candidates(
+        edge_boxes, face_boxes,
+        [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
+        callback);
+}
+
 } // namespace ipc
@@ -22,6 +22,26 @@ public:
     void detect_edge_face_candidates(
         std::vector<EdgeFaceCandidate>& candidates) const override;
 
+    /// @brief Find the candidate edge-vertex collisisons in batches.
+    void stream_edge_vertex_candidates(
+        const CandidateBatchCallback<EdgeVertexCandidate>& callback)
+        const override;
+
+    /// @brief Find the candidate edge-edge collisisons in batches.
+    void stream_edge_edge_candidates(
+        const CandidateBatchCallback<EdgeEdgeCandidate>& callback)
+        const override;
+
+    /// @brief Find the candidate face-vertex collisisons in batches.
+    void stream_face_vertex_candidates(
+        const CandidateBatchCallback<FaceVertexCandidate>& callback)
+        const override;
+
+    /// @brief Find the candidate edge-face intersections in batches.
+    void stream_edge_face_candidates(
+        const CandidateBatchCallback<EdgeFaceCandidate>& callback)
+        const override;
+
 private:
     template <typename Candidate, bool triangular = false>
     void detect_candidates(
@@ -29,6 +49,13 @@ private:
         const std::vector<AABB>& boxes1,
         const std::function<bool(size_t, size_t)>& can_collide,
         std::vector<Candidate>& candidates) const;
+
+    template <typename Candidate, bool triangular = false>
+    void stream_candidates(
+        const std::vector<AABB>& boxes0,
+        const std::vector<AABB>& boxes1,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        const CandidateBatchCallback<Candidate>& callback) const;
 };
 
 } // namespace ipc
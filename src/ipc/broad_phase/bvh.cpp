@@ -0,0 +1,70 @@
+#include "bvh.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace ipc {
+
+void BVH::build(const std::vector<AABB>& boxes)
+{
+    clear();
+    if (boxes.empty()) {
+        return;
+    }
+
+    element_boxes = boxes;
+    element_ids.resize(boxes.size());
+    std::iota(element_ids.begin(), element_ids.end(), 0);
+
+    // A binary tree with at least one element per leaf has at most 2n - 1
+    // nodes.
+    nodes.reserve(2 * boxes.size() - 1);
+    nodes.emplace_back();
+    build_node(boxes, 0, 0, boxes.size());
+}
+
+void BVH::clear()
+{
+    nodes.clear();
+    element_boxes.clear();
+    element_ids.clear();
+}
+
+void BVH::build_node(
+    const std::vector<AABB>& boxes, const int ni, const int begin, const int end)
+{
+    AABB box = boxes[element_ids[begin]];
+    for (int i = begin + 1; i < end; i++) {
+        box = AABB(box, boxes[element_ids[i]]);
+    }
+    nodes[ni].box = box;
+
+    if (end - begin <= MAX_LEAF_SIZE) {
+        nodes[ni].begin = begin;
+        nodes[ni].end = end;
+        return;
+    }
+
+    // Split at the median of the box centers along the longest axis.
+    int axis;
+    (box.max - box.min).maxCoeff(&axis);
+
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(
+        element_ids.begin() + begin, element_ids.begin() + mid,
+        element_ids.begin() + end, [&](int a, int b) {
+            return boxes[a].min[axis] + boxes[a].max[axis]
+                < boxes[b].min[axis] + boxes[b].max[axis];
+        });
+
+    // Allocate the children next to each other.
+    const int left = nodes.size();
+    nodes[ni].left = left;
+    nodes.emplace_back();
+    nodes.emplace_back();
+
+    build_node(boxes, left, begin, mid);
+    build_node(boxes, left + 1, mid, end);
+}
+
+} // namespace ipc
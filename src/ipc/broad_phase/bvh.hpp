@@ -0,0 +1,121 @@
+#pragma once
+
+#include <ipc/broad_phase/aabb.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Static bounding volume hierarchy of axis-aligned boxes.
+///
+/// The tree is built top-down by splitting the boxes at the median of their
+/// centers along the longest axis. It is used for branch-and-bound queries
+/// where the pruning bound shrinks while the tree is traversed.
+class BVH {
+public:
+    BVH() = default;
+
+    /// @brief Build the hierarchy over a list of boxes.
+    /// @param boxes The boxes of the elements (indexed by element ID).
+    void build(const std::vector<AABB>& boxes);
+
+    /// @brief Clear any built data.
+    void clear();
+
+    /// @brief Is the hierarchy empty?
+    bool empty() const { return nodes.empty(); }
+
+    /// @brief Visit the elements that can be closer to a box than a bound.
+    /// @note Nodes are visited closest first, and a node is pruned only if the squared distance between its box and the query is strictly greater than the current bound.
+    /// @param query The query box.
+    /// @param bound Function returning the current squared distance bound.
+    /// @param visit Function called with the ID of each element not pruned.
+    template <typename Bound, typename Function>
+    void branch_and_bound(
+        const AABB& query, const Bound& bound, const Function& visit) const;
+
+    /// @brief Compute the squared distance between two boxes.
+    /// @return Zero if the boxes overlap.
+    static double squared_distance(const AABB& a, const AABB& b)
+    {
+        return (a.min - b.max).max(b.min - a.max).max(0).matrix().squaredNorm();
+    }
+
+protected:
+    struct Node {
+        AABB box;
+        /// @brief Index of the left child (right child is left + 1) or -1 for a leaf.
+        int left = -1;
+        /// @brief Range of the leaf's elements in element_ids.
+        int begin = 0, end = 0;
+    };
+
+    /// @brief Recursively build the subtree of element_ids[begin, end).
+    /// @param boxes The boxes of the elements.
+    /// @param ni Index of the (already allocated) root node of the subtree.
+    /// @param begin Start of the range of elements.
+    /// @param end End of the range of elements.
+    void build_node(
+        const std::vector<AABB>& boxes,
+        const int ni,
+        const int begin,
+        const int end);
+
+    /// @brief Maximum number of elements in a leaf.
+    static constexpr int MAX_LEAF_SIZE = 4;
+
+    std::vector<Node> nodes;
+    std::vector<AABB> element_boxes;
+    std::vector<int> element_ids;
+};
+
+template <typename Bound, typename Function>
+void BVH::branch_and_bound(
+    const AABB& query, const Bound& bound, const Function& visit) const
+{
+    if (nodes.empty()) {
+        return;
+    }
+
+    // Stack of (squared distance, node) pairs
+    std::vector<std::pair<double, int>> stack;
+    stack.emplace_back(squared_distance(query, nodes[0].box), 0);
+
+    while (!stack.empty()) {
+        const auto [node_distance, ni] = stack.back();
+        stack.pop_back();
+
+        if (node_distance > bound()) {
+            continue;
+        }
+
+        const Node& node = nodes[ni];
+        if (node.left < 0) {
+            for (int i = node.begin; i < node.end; i++) {
+                const int id = element_ids[i];
+                if (squared_distance(query, element_boxes[id]) <= bound()) {
+                    visit(id);
+                }
+            }
+            continue;
+        }
+
+        const double left_distance =
+            squared_distance(query, nodes[node.left].box);
+        const double right_distance =
+            squared_distance(query, nodes[node.left + 1].box);
+
+        // Push the farther child first so the closer one is visited first.
+        if (left_distance < right_distance) {
+            stack.emplace_back(right_distance, node.left + 1);
+            stack.emplace_back(left_distance, node.left);
+        } else {
+            stack.emplace_back(left_distance, node.left);
+            stack.emplace_back(right_distance, node.left + 1);
+        }
+    }
+}
+
+} // namespace ipc
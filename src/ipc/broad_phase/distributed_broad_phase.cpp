@@ -0,0 +1,873 @@
+#include "distributed_broad_phase.hpp"
+
+#include <ipc/candidates/candidates.hpp>
+#include <ipc/utils/logger.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace ipc {
+
+namespace {
+    /// @brief Kind of message sent to a worker.
+    enum class RequestType : uint8_t { SLAB, CANDIDATES, STEPSIZE, SHUTDOWN };
+
+    /// @brief Bit flags of the candidate types requested from a worker.
+    enum CandidateTypes : uint8_t {
+        EDGE_VERTEX = 1 << 0,
+        EDGE_EDGE = 1 << 1,
+        FACE_VERTEX = 1 << 2,
+        EDGE_FACE = 1 << 3,
+    };
+
+    /// @brief Pair of element IDs sent between a worker and the coordinator.
+    using IDPair = std::array<long, 2>;
+
+    /// @brief Pair of colliding element IDs and their time of impact.
+    struct CollisionTOI {
+        long id0;
+        long id1;
+        double toi;
+    };
+
+    /// @brief Read the status of a response and throw any worker error.
+    void check_response(MessageReader& reader)
+    {
+        bool ok;
+        reader.read(ok);
+        if (!ok) {
+            std::vector<char> what;
+            reader.read(what);
+            throw std::runtime_error(
+                "Distributed broad phase worker failed: "
+                + std::string(what.begin(), what.end()));
+        }
+    }
+
+    /// @brief Get the ID pairs of the candidates owned by a worker's slab.
+    /// @param candidates Candidates found by the worker.
+    /// @param boxes0 Boxes of the first elements of the candidates.
+    /// @param boxes1 Boxes of the second elements of the candidates.
+    /// @param partition Slab partition of the domain.
+    /// @param slab The worker's slab.
+    /// @param ids Function getting the pair of IDs of a candidate.
+    /// @return The ID pairs of the owned candidates.
+    template <typename Candidate, typename IDFunction>
+    std::vector<IDPair> owned_pairs(
+        const std::vector<Candidate>& candidates,
+        const std::vector<AABB>& boxes0,
+        const std::vector<AABB>& boxes1,
+        const SlabPartition& partition,
+        const size_t slab,
+        const IDFunction& ids)
+    {
+        // The intersection of the boxes starts in exactly one slab, and both
+        // elements overlap that slab.
+        std::vector<IDPair> pairs;
+        for (const Candidate& candidate : candidates) {
+            const IDPair pair = ids(candidate);
+            const double start = std::max(
+                boxes0[pair[0]].min[partition.axis],
+                boxes1[pair[1]].min[partition.axis]);
+            if (partition.slab(start) == slab) {
+                pairs.push_back(pair);
+            }
+        }
+        return pairs;
+    }
+
+    /// @brief Compute the times of impact of the colliding candidates.
+    template <typename Candidate>
+    std::vector<CollisionTOI> colliding_candidates(
+        const std::vector<IDPair>& pairs,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double min_distance,
+        const double tolerance,
+        const long max_iterations)
+    {
+        tbb::enumerable_thread_specific<std::vector<CollisionTOI>> storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), pairs.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_collisions = storage.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    // The coordinator filters the collisions, so the times of
+                    // impact cannot be used to prune the others.
+                    double toi = std::numeric_limits<double>::infinity();
+                    const Candidate candidate(pairs[i][0], pairs[i][1]);
+                    if (candidate.ccd(
+                            vertices_t0, vertices_t1, edges, faces, toi,
+                            min_distance, /*tmax=*/1.0, tolerance,
+                            max_iterations)) {
+                        local_collisions.push_back(
+                            { pairs[i][0], pairs[i][1], toi });
+                    }
+                }
+            });
+
+        std::vector<CollisionTOI> collisions;
+        merge_thread_local_vectors(storage, collisions);
+        return collisions;
+    }
+
+    /// @brief Map local element IDs to mesh IDs in place.
+    void to_mesh_ids(
+        std::vector<IDPair>& pairs,
+        const std::vector<long>& ids0,
+        const std::vector<long>& ids1)
+    {
+        for (IDPair& pair : pairs) {
+            pair = { { ids0[pair[0]], ids1[pair[1]] } };
+        }
+    }
+
+    /// @brief Map local element IDs to mesh IDs in place.
+    void to_mesh_ids(
+        std::vector<CollisionTOI>& collisions,
+        const std::vector<long>& ids0,
+        const std::vector<long>& ids1)
+    {
+        for (CollisionTOI& collision : collisions) {
+            collision.id0 = ids0[collision.id0];
+            collision.id1 = ids1[collision.id1];
+        }
+    }
+
+    /// @brief Slab held by a worker between the requests of the coordinator.
+    class SlabWorker {
+    public:
+        /// @brief Load a slab and build its broad phase.
+        /// @note Errors are reported on the next request.
+        void load(MessageReader& reader);
+
+        /// @brief Find the owned candidates of the requested types.
+        void detect_candidates(
+            MessageReader& request, MessageWriter& response) const;
+
+        /// @brief Find the owned candidates colliding during the step.
+        void compute_collisions(
+            MessageReader& request, MessageWriter& response) const;
+
+    protected:
+        /// @brief Throw the error of the last load (if any).
+        void check_loaded() const;
+
+        std::vector<IDPair> ev_pairs() const;
+        std::vector<IDPair> ee_pairs() const;
+        std::vector<IDPair> fv_pairs() const;
+        std::vector<IDPair> ef_pairs() const;
+
+        SlabPartition m_partition;
+        size_t m_slab;
+        bool m_is_ccd;
+        Eigen::MatrixXd m_V0, m_V1;
+        Eigen::MatrixXi m_E, m_F;
+        /// @brief Mesh IDs of the slab's vertices, edges, and faces.
+        std::vector<long> m_vertex_ids, m_edge_ids, m_face_ids;
+        std::unique_ptr<BroadPhase> m_broad_phase;
+        std::vector<AABB> m_vertex_boxes, m_edge_boxes, m_face_boxes;
+        /// @brief Error of the last load (empty if it succeeded).
+        std::string m_error = "No slab was sent to the worker!";
+    };
+
+    void SlabWorker::load(MessageReader& reader)
+    {
+        try {
+            BroadPhaseMethod broad_phase_method;
+            double inflation_radius;
+            reader.read(broad_phase_method);
+            reader.read(m_partition.axis);
+            reader.read(m_partition.splits);
+            reader.read(m_slab);
+            reader.read(inflation_radius);
+            reader.read(m_is_ccd);
+            reader.read(m_V0);
+            if (m_is_ccd) {
+                reader.read(m_V1);
+            }
+            reader.read(m_E);
+            reader.read(m_F);
+            reader.read(m_vertex_ids);
+            reader.read(m_edge_ids);
+            reader.read(m_face_ids);
+
+            // Same boxes as the coordinator and the broad phase.
+            m_broad_phase = BroadPhase::make_broad_phase(broad_phase_method);
+            if (m_is_ccd) {
+                m_broad_phase->build(m_V0, m_V1, m_E, m_F, inflation_radius);
+                build_boxes(
+                    m_V0, m_V1, m_E, m_F, m_vertex_boxes, m_edge_boxes,
+                    m_face_boxes, inflation_radius);
+            } else {
+                m_broad_phase->build(m_V0, m_E, m_F, inflation_radius);
+                build_boxes(
+                    m_V0, m_E, m_F, m_vertex_boxes, m_edge_boxes, m_face_boxes,
+                    inflation_radius);
+            }
+            m_error.clear();
+        } catch (const std::exception& e) {
+            m_broad_phase = nullptr;
+            m_error = e.what();
+        }
+    }
+
+    void SlabWorker::check_loaded() const
+    {
+        if (!m_error.empty()) {
+            throw std::runtime_error(m_error);
+        }
+    }
+
+    std::vector<IDPair> SlabWorker::ev_pairs() const
+    {
+        std::vector<EdgeVertexCandidate> candidates;
+        m_broad_phase->detect_edge_vertex_candidates(candidates);
+        return owned_pairs(
+            candidates, m_edge_boxes, m_vertex_boxes, m_partition, m_slab,
+            [](const EdgeVertexCandidate& c) {
+                return IDPair { { c.edge_id, c.vertex_id } };
+            });
+    }
+
+    std::vector<IDPair> SlabWorker::ee_pairs() const
+    {
+        std::vector<EdgeEdgeCandidate> candidates;
+        m_broad_phase->detect_edge_edge_candidates(candidates);
+        return owned_pairs(
+            candidates, m_edge_boxes, m_edge_boxes, m_partition, m_slab,
+            [](const EdgeEdgeCandidate& c) {
+                return IDPair { { c.edge0_id, c.edge1_id } };
+            });
+    }
+
+    std::vector<IDPair> SlabWorker::fv_pairs() const
+    {
+        std::vector<FaceVertexCandidate> candidates;
+        m_broad_phase->detect_face_vertex_candidates(candidates);
+        return owned_pairs(
+            candidates, m_face_boxes, m_vertex_boxes, m_partition, m_slab,
+            [](const FaceVertexCandidate& c) {
+                return IDPair { { c.face_id, c.vertex_id } };
+            });
+    }
+
+    std::vector<IDPair> SlabWorker::ef_pairs() const
+    {
+        std::vector<EdgeFaceCandidate> candidates;
+        m_broad_phase->detect_edge_face_candidates(candidates);
+        return owned_pairs(
+            candidates, m_edge_boxes, m_face_boxes, m_partition, m_slab,
+            [](const EdgeFaceCandidate& c) {
+                return IDPair { { c.edge_id, c.face_id } };
+            });
+    }
+
+    void SlabWorker::detect_candidates(
+        MessageReader& request, MessageWriter& response) const
+    {
+        check_loaded();
+
+        uint8_t types;
+        request.read(types);
+
+        std::vector<IDPair> ev, ee, fv, ef;
+        if (types & EDGE_VERTEX) {
+            ev = ev_pairs();
+            to_mesh_ids(ev, m_edge_ids, m_vertex_ids);
+        }
+        if (types & EDGE_EDGE) {
+            ee = ee_pairs();
+            to_mesh_ids(ee, m_edge_ids, m_edge_ids);
+        }
+        if (types & FACE_VERTEX) {
+            fv = fv_pairs();
+            to_mesh_ids(fv, m_face_ids, m_vertex_ids);
+        }
+        if (types & EDGE_FACE) {
+            ef = ef_pairs();
+            to_mesh_ids(ef, m_edge_ids, m_face_ids);
+        }
+
+        response.write(true);
+        response.write(ev);
+        response.write(ee);
+        response.write(fv);
+        response.write(ef);
+    }
+
+    void SlabWorker::compute_collisions(
+        MessageReader& request, MessageWriter& response) const
+    {
+        check_loaded();
+
+        double min_distance, tolerance;
+        long max_iterations;
+        request.read(min_distance);
+        request.read(tolerance);
+        request.read(max_iterations);
+
+        const Eigen::MatrixXd& V1 = m_is_ccd ? m_V1 : m_V0;
+
+        std::vector<CollisionTOI> ev, ee, fv;
+        if (m_V0.cols() == 2) {
+            ev = colliding_candidates<EdgeVertexCandidate>(
+                ev_pairs(), m_V0, V1, m_E, m_F, min_distance, tolerance,
+                max_iterations);
+            to_mesh_ids(ev, m_edge_ids, m_vertex_ids);
+        } else {
+            ee = colliding_candidates<EdgeEdgeCandidate>(
+                ee_pairs(), m_V0, V1, m_E, m_F, min_distance, tolerance,
+                max_iterations);
+            to_mesh_ids(ee, m_edge_ids, m_edge_ids);
+            fv = colliding_candidates<FaceVertexCandidate>(
+                fv_pairs(), m_V0, V1, m_E, m_F, min_distance, tolerance,
+                max_iterations);
+            to_mesh_ids(fv, m_face_ids, m_vertex_ids);
+        }
+
+        response.write(true);
+        response.write(ev);
+        response.write(ee);
+        response.write(fv);
+    }
+} // namespace
+
+SlabPartition SlabPartition::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    size_t num_slabs)
+{
+    assert(num_slabs >= 1);
+    assert(vertices_t0.rows() == vertices_t1.rows());
+    assert(vertices_t0.cols() == vertices_t1.cols());
+
+    SlabPartition partition;
+    if (vertices_t0.rows() == 0) {
+        return partition;
+    }
+
+    const Eigen::RowVectorXd min = vertices_t0.colwise().minCoeff().cwiseMin(
+        vertices_t1.colwise().minCoeff());
+    const Eigen::RowVectorXd max = vertices_t0.colwise().maxCoeff().cwiseMax(
+        vertices_t1.colwise().maxCoeff());
+    (max - min).maxCoeff(&partition.axis);
+
+    // Centers of the swept vertex boxes
+    std::vector<double> centers(vertices_t0.rows());
+    tbb::parallel_for(size_t(0), centers.size(), [&](size_t i) {
+        centers[i] =
+            (vertices_t0(i, partition.axis) + vertices_t1(i, partition.axis))
+            / 2;
+    });
+
+    partition.splits.resize(num_slabs - 1);
+    for (size_t i = 1; i < num_slabs; i++) {
+        const auto split = centers.begin() + i * centers.size() / num_slabs;
+        std::nth_element(centers.begin(), split, centers.end());
+        partition.splits[i - 1] = *split;
+    }
+    std::sort(partition.splits.begin(), partition.splits.end());
+
+    return partition;
+}
+
+// ============================================================================
+
+DistributedBroadPhase::DistributedBroadPhase(
+    size_t num_partitions,
+    BroadPhaseMethod broad_phase_method,
+    WorkerLauncher launcher)
+    : m_num_partitions(num_partitions)
+    , m_broad_phase_method(broad_phase_method)
+    , m_launcher(std::move(launcher))
+{
+    if (num_partitions == 0) {
+        throw std::invalid_argument("The number of partitions must be > 0!");
+    }
+}
+
+DistributedBroadPhase::~DistributedBroadPhase()
+{
+    MessageWriter request;
+    request.write(RequestType::SHUTDOWN);
+    for (std::unique_ptr<Transport>& worker : m_workers) {
+        if (worker == nullptr) {
+            continue;
+        }
+        try {
+            worker->send(request.message());
+        } catch (const std::exception& e) {
+            logger().warn("unable to shut down a worker: {}", e.what());
+        }
+        worker = nullptr;
+    }
+}
+
+void DistributedBroadPhase::build(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius)
+{
+    clear();
+    send_slabs(vertices, nullptr, edges, faces, inflation_radius);
+}
+
+void DistributedBroadPhase::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius)
+{
+    assert(vertices_t0.rows() == vertices_t1.rows());
+    clear();
+    send_slabs(vertices_t0, &vertices_t1, edges, faces, inflation_radius);
+}
+
+void DistributedBroadPhase::clear()
+{
+    BroadPhase::clear();
+    m_partition = SlabPartition();
+    m_active_slabs.clear();
+    m_edges.resize(0, 0);
+    m_faces.resize(0, 0);
+    m_dim = 0;
+}
+
+void DistributedBroadPhase::send_slabs(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd* vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius)
+{
+    const bool is_ccd = vertices_t1 != nullptr;
+    m_dim = vertices_t0.cols();
+    m_edges = edges;
+    m_faces = faces;
+    m_partition = SlabPartition::build(
+        vertices_t0, is_ccd ? *vertices_t1 : vertices_t0, m_num_partitions);
+    const int axis = m_partition.axis;
+
+    // Range of slabs overlapped by the box of each vertex. The boxes are the
+    // same as the workers', so both agree on the slabs of every element.
+    using SlabRange = std::array<size_t, 2>;
+    std::vector<SlabRange> vertex_slabs(vertices_t0.rows());
+    tbb::parallel_for(size_t(0), vertex_slabs.size(), [&](size_t vi) {
+        const AABB box = is_ccd
+            ? AABB::from_point(
+                vertices_t0.row(vi), vertices_t1->row(vi), inflation_radius)
+            : AABB::from_point(vertices_t0.row(vi), inflation_radius);
+        vertex_slabs[vi] = { { m_partition.slab(box.min[axis]),
+                               m_partition.slab(box.max[axis]) } };
+    });
+
+    // The box of an element is the union of its vertices' boxes.
+    const auto element_slabs = [&](const Eigen::MatrixXi& elements, long i) {
+        SlabRange range = vertex_slabs[elements(i, 0)];
+        for (int j = 1; j < elements.cols(); j++) {
+            const SlabRange& vertex_range = vertex_slabs[elements(i, j)];
+            range[0] = std::min(range[0], vertex_range[0]);
+            range[1] = std::max(range[1], vertex_range[1]);
+        }
+        return range;
+    };
+
+    // Mesh IDs of the elements overlapping each slab
+    const size_t num_slabs = m_partition.num_slabs();
+    std::vector<std::vector<long>> slab_vertex_ids(num_slabs),
+        slab_edge_ids(num_slabs), slab_face_ids(num_slabs);
+    for (size_t vi = 0; vi < vertex_slabs.size(); vi++) {
+        for (size_t s = vertex_slabs[vi][0]; s <= vertex_slabs[vi][1]; s++) {
+            slab_vertex_ids[s].push_back(vi);
+        }
+    }
+    for (long ei = 0; ei < edges.rows(); ei++) {
+        const SlabRange range = element_slabs(edges, ei);
+        for (size_t s = range[0]; s <= range[1]; s++) {
+            slab_edge_ids[s].push_back(ei);
+        }
+    }
+    for (long fi = 0; fi < faces.rows(); fi++) {
+        const SlabRange range = element_slabs(faces, fi);
+        for (size_t s = range[0]; s <= range[1]; s++) {
+            slab_face_ids[s].push_back(fi);
+        }
+    }
+    std::vector<SlabRange>().swap(vertex_slabs);
+
+    // Gather, send, and release one slab at a time.
+    std::vector<long> local_vertex_ids(vertices_t0.rows(), -1);
+    for (size_t slab = 0; slab < num_slabs; slab++) {
+        std::vector<long>& vertex_ids = slab_vertex_ids[slab];
+        std::vector<long>& edge_ids = slab_edge_ids[slab];
+        std::vector<long>& face_ids = slab_face_ids[slab];
+
+        for (size_t i = 0; i < vertex_ids.size(); i++) {
+            local_vertex_ids[vertex_ids[i]] = i;
+        }
+        const auto add_vertex = [&](const long vi) {
+            if (local_vertex_ids[vi] < 0) {
+                local_vertex_ids[vi] = vertex_ids.size();
+                vertex_ids.push_back(vi);
+            }
+            return local_vertex_ids[vi];
+        };
+
+        // The vertices of the selected elements are ghosts of the slab.
+        Eigen::MatrixXi local_edges(edge_ids.size(), 2);
+        for (long i = 0; i < local_edges.rows(); i++) {
+            for (int j = 0; j < 2; j++) {
+                local_edges(i, j) = add_vertex(edges(edge_ids[i], j));
+            }
+        }
+        Eigen::MatrixXi local_faces(face_ids.size(), 3);
+        for (long i = 0; i < local_faces.rows(); i++) {
+            for (int j = 0; j < 3; j++) {
+                local_faces(i, j) = add_vertex(faces(face_ids[i], j));
+            }
+        }
+
+        if (!vertex_ids.empty()) {
+            const auto select_vertices = [&](const Eigen::MatrixXd& V) {
+                Eigen::MatrixXd local_V(vertex_ids.size(), V.cols());
+                for (long i = 0; i < local_V.rows(); i++) {
+                    local_V.row(i) = V.row(vertex_ids[i]);
+                }
+                return local_V;
+            };
+
+            MessageWriter writer;
+            writer.write(RequestType::SLAB);
+            writer.write(m_broad_phase_method);
+            writer.write(m_partition.axis);
+            writer.write(m_partition.splits);
+            writer.write(slab);
+            writer.write(inflation_radius);
+            writer.write(is_ccd);
+            writer.write(select_vertices(vertices_t0));
+            if (is_ccd) {
+                writer.write(select_vertices(*vertices_t1));
+            }
+            writer.write(local_edges);
+            writer.write(local_faces);
+            writer.write(vertex_ids);
+            writer.write(edge_ids);
+            writer.write(face_ids);
+            worker(slab).send(writer.message());
+
+            m_active_slabs.push_back(slab);
+        }
+
+        for (const long vi : vertex_ids) {
+            local_vertex_ids[vi] = -1;
+        }
+        std::vector<long>().swap(vertex_ids);
+        std::vector<long>().swap(edge_ids);
+        std::vector<long>().swap(face_ids);
+    }
+
+    logger().trace(
+        "distributed broad phase split along axis {} into {} partitions",
+        axis, m_active_slabs.size());
+}
+
+Transport& DistributedBroadPhase::worker(size_t slab)
+{
+    if (m_workers.size() <= slab) {
+        m_workers.resize(slab + 1);
+    }
+    if (m_workers[slab] == nullptr) {
+        m_workers[slab] = m_launcher(serve);
+    }
+    return *m_workers[slab];
+}
+
+std::vector<std::vector<char>>
+DistributedBroadPhase::run_workers(const std::vector<char>& request) const
+{
+    // Send every request before waiting for any response.
+    for (const size_t slab : m_active_slabs) {
+        m_workers[slab]->send(request);
+    }
+
+    std::vector<std::vector<char>> responses;
+    for (const size_t slab : m_active_slabs) {
+        responses.push_back(m_workers[slab]->receive());
+    }
+    return responses;
+}
+
+void DistributedBroadPhase::detect_candidates(
+    std::vector<EdgeVertexCandidate>* ev_candidates,
+    std::vector<EdgeEdgeCandidate>* ee_candidates,
+    std::vector<FaceVertexCandidate>* fv_candidates,
+    std::vector<EdgeFaceCandidate>* ef_candidates) const
+{
+    MessageWriter request;
+    request.write(RequestType::CANDIDATES);
+    request.write(uint8_t(
+        (ev_candidates ? EDGE_VERTEX : 0) | (ee_candidates ? EDGE_EDGE : 0)
+        | (fv_candidates ? FACE_VERTEX : 0)
+        | (ef_candidates ? EDGE_FACE : 0)));
+
+    const std::vector<std::vector<char>> responses =
+        run_workers(request.message());
+
+    // Merge the candidates in slab order, so the result is deterministic.
+    for (const std::vector<char>& response : responses) {
+        MessageReader reader(response);
+        check_response(reader);
+
+        std::vector<IDPair> pairs;
+        reader.read(pairs);
+        if (ev_candidates) {
+            for (const auto& [ei, vi] : pairs) {
+                if (can_edge_vertex_collide(ei, vi)) {
+                    ev_candidates->emplace_back(ei, vi);
+                }
+            }
+        }
+
+        reader.read(pairs);
+        if (ee_candidates) {
+            for (const auto& [eai, ebi] : pairs) {
+                if (can_edges_collide(eai, ebi)) {
+                    ee_candidates->emplace_back(eai, ebi);
+                }
+            }
+        }
+
+        reader.read(pairs);
+        if (fv_candidates) {
+            for (const auto& [fi, vi] : pairs) {
+                if (can_face_vertex_collide(fi, vi)) {
+                    fv_candidates->emplace_back(fi, vi);
+                }
+            }
+        }
+
+        reader.read(pairs);
+        if (ef_candidates) {
+            for (const auto& [ei, fi] : pairs) {
+                if (can_edge_face_collide(ei, fi)) {
+                    ef_candidates->emplace_back(ei, fi);
+                }
+            }
+        }
+    }
+}
+
+void DistributedBroadPhase::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    candidates.clear();
+    detect_candidates(&candidates, nullptr, nullptr, nullptr);
+}
+
+void DistributedBroadPhase::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    candidates.clear();
+    detect_candidates(nullptr, &candidates, nullptr, nullptr);
+}
+
+void DistributedBroadPhase::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    candidates.clear();
+    detect_candidates(nullptr, nullptr, &candidates, nullptr);
+}
+
+void DistributedBroadPhase::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    candidates.clear();
+    detect_candidates(nullptr, nullptr, nullptr, &candidates);
+}
+
+void DistributedBroadPhase::detect_collision_candidates(
+    int dim, Candidates& candidates) const
+{
+    candidates.clear();
+    if (dim == 2) {
+        // This is not needed for 3D
+        detect_candidates(&candidates.ev_candidates, nullptr, nullptr, nullptr);
+    } else {
+        // These are not needed for 2D
+        detect_candidates(
+            nullptr, &candidates.ee_candidates, &candidates.fv_candidates,
+            nullptr);
+    }
+}
+
+double DistributedBroadPhase::compute_collision_free_stepsize(
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations) const
+{
+    MessageWriter request;
+    request.write(RequestType::STEPSIZE);
+    request.write(min_distance);
+    request.write(tolerance);
+    request.write(max_iterations);
+
+    const std::vector<std::vector<char>> responses =
+        run_workers(request.message());
+
+    // The workers report every collision, so the ones between elements that
+    // cannot collide can be filtered out here.
+    double earliest_toi = 1;
+    for (const std::vector<char>& response : responses) {
+        MessageReader reader(response);
+        check_response(reader);
+
+        std::vector<CollisionTOI> collisions;
+        reader.read(collisions);
+        for (const auto& [ei, vi, toi] : collisions) {
+            if (can_edge_vertex_collide(ei, vi)) {
+                earliest_toi = std::min(earliest_toi, toi);
+            }
+        }
+
+        reader.read(collisions);
+        for (const auto& [eai, ebi, toi] : collisions) {
+            if (can_edges_collide(eai, ebi)) {
+                earliest_toi = std::min(earliest_toi, toi);
+            }
+        }
+
+        reader.read(collisions);
+        for (const auto& [fi, vi, toi] : collisions) {
+            if (can_face_vertex_collide(fi, vi)) {
+                earliest_toi = std::min(earliest_toi, toi);
+            }
+        }
+    }
+
+    assert(earliest_toi >= 0 && earliest_toi <= 1.0);
+    return earliest_toi;
+}
+
+bool DistributedBroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
+{
+    const size_t e0i = m_edges(ei, 0), e1i = m_edges(ei, 1);
+
+    return vi != e0i && vi != e1i
+        && (can_vertices_collide(vi, e0i) || can_vertices_collide(vi, e1i));
+}
+
+bool DistributedBroadPhase::can_edges_collide(size_t eai, size_t ebi) const
+{
+    const size_t ea0i = m_edges(eai, 0), ea1i = m_edges(eai, 1);
+    const size_t eb0i = m_edges(ebi, 0), eb1i = m_edges(ebi, 1);
+
+    bool share_endpoint =
+        ea0i == eb0i || ea0i == eb1i || ea1i == eb0i || ea1i == eb1i;
+
+    return !share_endpoint
+        && (can_vertices_collide(ea0i, eb0i) || can_vertices_collide(ea0i, eb1i)
+            || can_vertices_collide(ea1i, eb0i)
+            || can_vertices_collide(ea1i, eb1i));
+}
+
+bool DistributedBroadPhase::can_face_vertex_collide(size_t fi, size_t vi) const
+{
+    const size_t f0i = m_faces(fi, 0), f1i = m_faces(fi, 1),
+                 f2i = m_faces(fi, 2);
+
+    return vi != f0i && vi != f1i && vi != f2i
+        && (can_vertices_collide(vi, f0i) || can_vertices_collide(vi, f1i)
+            || can_vertices_collide(vi, f2i));
+}
+
+bool DistributedBroadPhase::can_edge_face_collide(size_t ei, size_t fi) const
+{
+    const size_t e0i = m_edges(ei, 0), e1i = m_edges(ei, 1);
+    const size_t f0i = m_faces(fi, 0), f1i = m_faces(fi, 1),
+                 f2i = m_faces(fi, 2);
+
+    bool share_endpoint = e0i == f0i || e0i == f1i || e0i == f2i || e1i == f0i
+        || e1i == f1i || e1i == f2i;
+
+    return !share_endpoint
+        && (can_vertices_collide(e0i, f0i) || can_vertices_collide(e0i, f1i)
+            || can_vertices_collide(e0i, f2i) || can_vertices_collide(e1i, f0i)
+            || can_vertices_collide(e1i, f1i)
+            || can_vertices_collide(e1i, f2i));
+}
+
+void DistributedBroadPhase::serve(Transport& transport)
+{
+    SlabWorker slab_worker;
+    while (true) {
+        const std::vector<char> message = transport.receive();
+        MessageReader request(message);
+        RequestType type;
+        request.read(type);
+
+        if (type == RequestType::SHUTDOWN) {
+            return;
+        } else if (type == RequestType::SLAB) {
+            slab_worker.load(request); // No response
+            continue;
+        }
+
+        MessageWriter response;
+        try {
+            if (type == RequestType::CANDIDATES) {
+                slab_worker.detect_candidates(request, response);
+            } else {
+                slab_worker.compute_collisions(request, response);
+            }
+        } catch (const std::exception& e) {
+            const std::string what = e.what();
+            response = MessageWriter();
+            response.write(false);
+            response.write(std::vector<char>(what.begin(), what.end()));
+        }
+        transport.send(response.message());
+    }
+}
+
+// ============================================================================
+
+double compute_distributed_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const size_t num_partitions,
+    const BroadPhaseMethod broad_phase_method,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const WorkerLauncher& launcher)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    DistributedBroadPhase broad_phase(
+        num_partitions, broad_phase_method, launcher);
+    broad_phase.can_vertices_collide = mesh.can_collide;
+    broad_phase.build(
+        vertices_t0, vertices_t1, mesh.edges(), mesh.faces(),
+        /*inflation_radius=*/min_distance / 2);
+
+    return broad_phase.compute_collision_free_stepsize(
+        min_distance, tolerance, max_iterations);
+}
+
+} // namespace ipc
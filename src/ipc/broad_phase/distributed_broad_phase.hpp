@@ -0,0 +1,226 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/ccd/ccd.hpp>
+#include <ipc/utils/transport.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Partition of space into slabs along one axis.
+struct SlabPartition {
+    /// @brief Axis perpendicular to the slabs.
+    int axis = 0;
+    /// @brief Lower bound of slabs 1 to n-1 (slab 0 starts at -∞ and slab n-1 ends at +∞).
+    std::vector<double> splits;
+
+    /// @brief Get the number of slabs.
+    size_t num_slabs() const { return splits.size() + 1; }
+
+    /// @brief Get the slab containing a coordinate along the axis.
+    size_t slab(double x) const
+    {
+        return std::upper_bound(splits.begin(), splits.end(), x)
+            - splits.begin();
+    }
+
+    /// @brief Split the longest axis of the swept vertices into slabs with balanced numbers of vertices.
+    /// @param vertices_t0 Vertex positions at the start of the step.
+    /// @param vertices_t1 Vertex positions at the end of the step (equal to vertices_t0 for static collision detection).
+    /// @param num_slabs Number of slabs.
+    /// @return The slab partition.
+    static SlabPartition build(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        size_t num_slabs);
+};
+
+/// @brief Broad phase decomposing the domain into slabs processed by separate workers.
+///
+/// Every element is sent to each slab its box overlaps, so a slab also holds
+/// a ghost layer of the elements from neighboring slabs within the inflation
+/// radius. Each worker runs a regular broad phase on its slab, and it only
+/// reports the pairs whose box intersection starts in its slab, so the merged
+/// candidates have no duplicates.
+///
+/// The coordinator never stores the boxes of the whole mesh: each slab is
+/// gathered, sent once per build, and released before the next one. The
+/// workers keep their slab and its broad phase, so every query of a build
+/// only exchanges the request and the results.
+///
+/// The workers are started with a pluggable WorkerLauncher on the first build
+/// and talk to this coordinator over a Transport until it is destroyed. By
+/// default they are threads of this process connected by Unix domain sockets.
+/// With launch_local_process, they are separate processes of the
+/// ipc_toolkit_broad_phase_worker executable (tools/broad_phase_worker.cpp).
+/// Queries must not be run concurrently on the same object.
+///
+/// @note The socket transports are only available on POSIX systems. On
+/// Windows, building or querying this broad phase throws a std::runtime_error
+/// unless a launcher with another transport is provided.
+class DistributedBroadPhase : public BroadPhase {
+public:
+    /// @brief Construct a distributed broad phase.
+    /// @param num_partitions Number of slabs (and workers).
+    /// @param broad_phase_method Broad phase method used by the workers.
+    /// @param launcher Function starting a worker.
+    DistributedBroadPhase(
+        size_t num_partitions,
+        BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
+        WorkerLauncher launcher = launch_local_thread);
+
+    /// @brief Shut down the workers.
+    ~DistributedBroadPhase() override;
+
+    /// @brief Build the broad phase for static collision detection.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Clear any built data (the workers are kept).
+    void clear() override;
+
+    /// @brief Find the candidate edge-vertex collisisons.
+    /// @param[out] candidates The candidate edge-vertex collisisons.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisisons.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisisons.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    /// @brief Detect all collision candidates needed for a given dimensional simulation.
+    /// @note All candidate types are found by a single round of workers.
+    /// @param dim The dimension of the simulation (i.e., 2 or 3).
+    /// @param candidates The detected collision candidates.
+    void
+    detect_collision_candidates(int dim, Candidates& candidates) const override;
+
+    /// @brief Compute the earliest time of impact of the built (continuous) broad phase.
+    /// @note The workers run the narrow phase on their own candidates.
+    /// @param min_distance The minimum distance allowable between any two elements.
+    /// @param tolerance The tolerance for the CCD algorithm.
+    /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @returns A step-size \f$\in [0, 1]\f$ that is collision free.
+    double compute_collision_free_stepsize(
+        const double min_distance = 0.0,
+        const double tolerance = DEFAULT_CCD_TOLERANCE,
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS) const;
+
+    /// @brief Get the slab partition of the last build.
+    const SlabPartition& partition() const { return m_partition; }
+
+    /// @brief Serve the requests of a DistributedBroadPhase until it is destroyed.
+    /// @note This is the function run by the workers.
+    /// @param transport The worker's end of the transport.
+    static void serve(Transport& transport);
+
+protected:
+    /// @brief Gather the elements of each slab and send them to its worker.
+    void send_slabs(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd* vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius);
+
+    /// @brief Get the worker of a slab, starting it if needed.
+    Transport& worker(size_t slab);
+
+    /// @brief Send a request to the worker of every non-empty slab.
+    /// @param request The request.
+    /// @return The response of each non-empty slab's worker.
+    std::vector<std::vector<char>>
+    run_workers(const std::vector<char>& request) const;
+
+    /// @brief Find the candidates of the requested types.
+    void detect_candidates(
+        std::vector<EdgeVertexCandidate>* ev_candidates,
+        std::vector<EdgeEdgeCandidate>* ee_candidates,
+        std::vector<FaceVertexCandidate>* fv_candidates,
+        std::vector<EdgeFaceCandidate>* ef_candidates) const;
+
+    // The boxes are never built, so use the mesh connectivity instead.
+    bool can_edge_vertex_collide(size_t ei, size_t vi) const override;
+    bool can_edges_collide(size_t eai, size_t ebi) const override;
+    bool can_face_vertex_collide(size_t fi, size_t vi) const override;
+    bool can_edge_face_collide(size_t ei, size_t fi) const override;
+
+    /// @brief Number of slabs (and workers).
+    size_t m_num_partitions;
+    /// @brief Broad phase method used by the workers.
+    BroadPhaseMethod m_broad_phase_method;
+    /// @brief Function starting a worker.
+    WorkerLauncher m_launcher;
+
+    /// @brief Slab partition of the last build.
+    SlabPartition m_partition;
+    /// @brief Non-empty slabs of the last build.
+    std::vector<size_t> m_active_slabs;
+    /// @brief Edges and faces of the last build.
+    Eigen::MatrixXi m_edges, m_faces;
+    /// @brief Dimension of the vertices of the last build.
+    int m_dim = 0;
+    /// @brief Transport to the worker of each slab (null until started).
+    std::vector<std::unique_ptr<Transport>> m_workers;
+};
+
+/// @brief Computes a maximal collision free step size using a distributed broad phase and narrow phase.
+/// @note Assumes the trajectory is linear.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param num_partitions Number of slabs (and workers).
+/// @param broad_phase_method Broad phase method used by the workers.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @param launcher Function starting a worker.
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+double compute_distributed_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const size_t num_partitions,
+    const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
+    const double min_distance = 0.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+    const WorkerLauncher& launcher = launch_local_thread);
+
+} // namespace ipc
@@ -3,16 +3,16 @@
 #include <ipc/broad_phase/voxel_size_heuristic.hpp>
 #include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/logger.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/blocked_range.h>
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 
 #include <algorithm> // std::min/max
 
-#define IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE // else use unordered_set
-
 namespace ipc {
 
 void HashGrid::build(
@@ -28,10 +28,13 @@ void HashGrid::build(
     ArrayMax3d mesh_max = vertices.colwise().maxCoeff().array();
     AABB::conservative_inflation(mesh_min, mesh_max, inflation_radius);
 
-    double cell_size =
-        suggest_good_voxel_size(vertices, edges, inflation_radius);
-    assert(std::isfinite(cell_size));
-    resize(mesh_min, mesh_max, cell_size);
+    if (!reuse_voxel_size || m_voxelSize <= 0) {
+        m_voxelSize = refine_voxel_size(
+            mesh_min, mesh_max,
+            suggest_good_voxel_size(vertices, edges, inflation_radius));
+    }
+    assert(std::isfinite(m_voxelSize));
+    resize(mesh_min, mesh_max, m_voxelSize);
 
     insert_boxes();
 }
@@ -55,23 +58,47 @@ void HashGrid::build(
     ArrayMax3d mesh_max = mesh_max_t0.max(mesh_max_t1);
     AABB::conservative_inflation(mesh_min, mesh_max, inflation_radius);
 
-    double cell_size = suggest_good_voxel_size(
-        vertices_t0, vertices_t1, edges, inflation_radius);
-    assert(std::isfinite(cell_size));
-    resize(mesh_min, mesh_max, cell_size);
+    if (!reuse_voxel_size || m_voxelSize <= 0) {
+        m_voxelSize = refine_voxel_size(
+            mesh_min, mesh_max,
+            suggest_good_voxel_size(
+                vertices_t0, vertices_t1, edges, inflation_radius));
+    }
+    assert(std::isfinite(m_voxelSize));
+    resize(mesh_min, mesh_max, m_voxelSize);
 
     insert_boxes();
 }
 
+double HashGrid::refine_voxel_size(
+    const ArrayMax3d& min, const ArrayMax3d& max, double voxel_size) const
+{
+    if (voxel_size_heuristic != VoxelSizeHeuristic::COST_MODEL
+        || voxel_size == std::numeric_limits<double>::max()) {
+        return voxel_size;
+    }
+    // Most items (and pairs) come from the edges, so they drive the cost.
+    return suggest_voxel_size_from_cost_model(
+        edge_boxes.empty() ? vertex_boxes : edge_boxes, min, max, voxel_size);
+}
+
 void HashGrid::resize(
     const ArrayMax3d& min, const ArrayMax3d& max, double cellSize)
 {
     assert(cellSize != 0.0);
     assert(std::isfinite(cellSize));
-    m_cellSize = cellSize;
+    // Limit the number of cells along each axis, so the cell coordinates fit
+    // in the Morton codes used as keys.
+    const int max_grid_size =
+        min.size() == 2 ? MORTON_2D_MAX_COORD : MORTON_3D_MAX_COORD;
+    m_cellSize = std::max(cellSize, (max - min).maxCoeff() / max_grid_size);
     m_domainMin = min;
     m_domainMax = max;
-    m_gridSize = ((max - min) / m_cellSize).ceil().cast<int>().max(1);
+    m_gridSize = ((max - min) / m_cellSize)
+                     .ceil()
+                     .cast<int>()
+                     .max(1)
+                     .min(max_grid_size);
     logger().trace(
         "hash-grid resized with a size of {:d}x{:d}x{:d}", m_gridSize[0],
         m_gridSize[1], m_gridSize.size() == 3 ? m_gridSize[2] : 1);
@@ -79,11 +106,38 @@ void HashGrid::resize(
 
 void HashGrid::insert_boxes()
 {
+    // Renumber the elements by the Morton order of their boxes, so the sorted
+    // items and the boxes they reference are both spatially coherent.
+    sort_boxes(this->vertex_boxes, vertex_order);
+    sort_boxes(this->edge_boxes, edge_order);
+    sort_boxes(this->face_boxes, face_order);
+
     insert_boxes(this->vertex_boxes, vertex_items);
     insert_boxes(this->edge_boxes, edge_items);
     insert_boxes(this->face_boxes, face_items);
 }
 
+void HashGrid::sort_boxes(
+    std::vector<AABB>& boxes, std::vector<long>& order) const
+{
+    std::vector<HashItem> codes(boxes.size(), HashItem(0, 0));
+    tbb::parallel_for(size_t(0), boxes.size(), [&](size_t i) {
+        const ArrayMax3i c = cell_index((boxes[i].min + boxes[i].max) / 2);
+        codes[i] = HashItem(hash(c.x(), c.y(), c.size() == 3 ? c.z() : 0), i);
+    });
+
+    // Ties are broken by the original index, so the order is deterministic.
+    tbb::parallel_sort(codes.begin(), codes.end());
+
+    std::vector<AABB> sorted_boxes(boxes.size());
+    order.resize(boxes.size());
+    tbb::parallel_for(size_t(0), boxes.size(), [&](size_t i) {
+        order[i] = codes[i].id;
+        sorted_boxes[i] = boxes[codes[i].id];
+    });
+    boxes = std::move(sorted_boxes);
+}
+
 void HashGrid::insert_boxes(
     const std::vector<AABB>& boxes, std::vector<HashItem>& items) const
 {
@@ -108,16 +162,8 @@ void HashGrid::insert_boxes(
 void HashGrid::insert_box(
     const AABB& aabb, const long id, std::vector<HashItem>& items) const
 {
-    ArrayMax3i int_min = ((aabb.min - m_domainMin) / m_cellSize).cast<int>();
-    // We can round down to -1, but not less
-    assert((int_min >= -1).all());
-    assert((int_min <= m_gridSize).all());
-    int_min = int_min.max(0).min(m_gridSize - 1);
-
-    ArrayMax3i int_max = ((aabb.max - m_domainMin) / m_cellSize).cast<int>();
-    assert((int_max >= -1).all());
-    assert((int_max <= m_gridSize).all());
-    int_max = int_max.max(0).min(m_gridSize - 1);
+    const ArrayMax3i int_min = cell_index(aabb.min);
+    const ArrayMax3i int_max = cell_index(aabb.max);
     assert((int_min <= int_max).all());
 
     int min_z = int_min.size() == 3 ? int_min.z() : 0;
@@ -131,21 +177,19 @@ void HashGrid::insert_box(
     }
 }
 
-template <typename Candidate>
-void HashGrid::detect_candidates(
-    const std::vector<HashItem>& items0,
-    const std::vector<HashItem>& items1,
-    const std::vector<AABB>& boxes0,
-    const std::vector<AABB>& boxes1,
-    const std::function<bool(size_t, size_t)>& can_collide,
-    std::vector<Candidate>& candidates) const
+ArrayMax3i HashGrid::cell_index(const ArrayMax3d& p) const
 {
-    // Entries with the same key means they share a cell (that cell index
-    // hashes to the same key) and should be flagged for low-level intersection
-    // testing. We loop over the entire sorted set of (key,value) pairs
-    // creating Candidate entries for pairs with the same key
+    const ArrayMax3i index = ((p - m_domainMin) / m_cellSize).cast<int>();
+    // We can round down to -1, but not less
+    assert((index >= -1).all());
+    assert((index <= m_gridSize).all());
+    return index.max(0).min(m_gridSize - 1);
+}
 
-    // 1. Soft merge of items (assuming items are sorted)
+std::vector<long> HashGrid::merge_items(
+    const std::vector<HashItem>& items0, const std::vector<HashItem>& items1)
+{
+    // Soft merge of items (assuming items are sorted)
     size_t num_items = items0.size() + items1.size();
     std::vector<long> merged_item_indices;
     merged_item_indices.reserve(num_items);
@@ -164,17 +208,35 @@ void HashGrid::detect_candidates(
         merged_item_indices.push_back(j++);
     }
     assert(merged_item_indices.size() == num_items);
+    return merged_item_indices;
+}
+
+template <typename Candidate>
+void HashGrid::detect_candidates(
+    const std::vector<HashItem>& items0,
+    const std::vector<HashItem>& items1,
+    const std::vector<AABB>& boxes0,
+    const std::vector<AABB>& boxes1,
+    const std::vector<long>& order0,
+    const std::vector<long>& order1,
+    const std::function<bool(size_t, size_t)>& can_collide,
+    std::vector<Candidate>& candidates) const
+{
+    // Entries with the same key means they share a cell (that cell index
+    // hashes to the same key) and should be flagged for low-level intersection
+    // testing. We loop over the entire sorted set of (key,value) pairs
+    // creating Candidate entries for pairs with the same key
+
+    // 1. Soft merge of items (assuming items are sorted)
+    const std::vector<long> merged_item_indices = merge_items(items0, items1);
+    const long num_items = merged_item_indices.size();
 
     const auto get_item = [&](long i) -> const HashItem& {
         return i < 0 ? items0[-(i + 1)] : items1[i];
     };
 
     // 2. Enumerate hash collisions
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
     tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-#else
-    tbb::enumerable_thread_specific<unordered_set<Candidate>> storage;
-#endif
 
     tbb::parallel_for(
         tbb::blocked_range2d<long>(0l, num_items - 1, 0l, num_items),
@@ -209,38 +271,25 @@ void HashGrid::detect_candidates(
                         continue;
                     }
 
-                    if (boxes0[id0].intersects(boxes1[id1])) {
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-                        local_candidates.emplace_back(id0, id1);
-#else
-                        local_candidates.emplace(id0, id1);
-#endif
+                    // Only the owner cell reports the pair.
+                    if (boxes0[id0].intersects(boxes1[id1])
+                        && owner_cell_key(boxes0[id0], boxes1[id1])
+                            == item0.key) {
+                        local_candidates.emplace_back(
+                            order0[id0], order1[id1]);
                     }
                 }
             }
         });
 
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
     merge_thread_local_vectors(storage, candidates);
-
-    // Remove the duplicate candidates
-    tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
-#else
-    unordered_set<Candidate> candidates_set;
-    merge_thread_local_unordered_sets(storage, candidates_set);
-
-    candidates.reserve(candidates_set.size());
-    candidates.insert(
-        candidates.end(), candidates_set.begin(), candidates_set.end());
-#endif
 }
 
 template <typename Candidate>
 void HashGrid::detect_candidates(
     const std::vector<HashItem>& items,
     const std::vector<AABB>& boxes,
+    const std::vector<long>& order,
     const std::function<bool(size_t, size_t)>& can_collide,
     std::vector<Candidate>& candidates) const
 {
@@ -249,11 +298,7 @@ void HashGrid::detect_candidates(
     // intersection testing. So we loop over the entire sorted set of
     // (key,value) pairs creating Candidate entries for pairs with the same key
 
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
     tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-#else
-    tbb::enumerable_thread_specific<unordered_set<Candidate>> storage;
-#endif
 
     tbb::parallel_for(
         tbb::blocked_range2d<long>(0l, items.size() - 1, 0l, items.size()),
@@ -280,41 +325,149 @@ void HashGrid::detect_candidates(
                         continue;
                     }
 
+                    // Only the owner cell reports the pair.
                     const AABB& box1 = boxes[item1.id];
-                    if (box0.intersects(box1)) {
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-                        local_candidates.emplace_back(item0.id, item1.id);
-#else
-                        local_candidates.emplace(item0.id, item1.id);
-#endif
+                    if (box0.intersects(box1)
+                        && owner_cell_key(box0, box1) == item0.key) {
+                        local_candidates.emplace_back(
+                            order[item0.id], order[item1.id]);
                     }
                 }
             }
         });
 
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
     merge_thread_local_vectors(storage, candidates);
+}
+
+// ============================================================================
+
+// NOTE: Each batch is a fixed block of the sorted items, so the batches do not
+// depend on the scheduling. Duplicates are dropped per pair through
+// owner_cell_key(), so the full list of candidates is never needed.
 
-    // Remove the duplicate candidates
-    tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
-#else
-    unordered_set<Candidate> candidates_set;
-    merge_thread_local_unordered_sets(storage, candidates_set);
-
-    candidates.reserve(candidates_set.size());
-    candidates.insert(
-        candidates.end(), candidates_set.begin(), candidates_set.end());
-#endif
+template <typename Candidate>
+void HashGrid::stream_candidates(
+    const std::vector<HashItem>& items0,
+    const std::vector<HashItem>& items1,
+    const std::vector<AABB>& boxes0,
+    const std::vector<AABB>& boxes1,
+    const std::vector<long>& order0,
+    const std::vector<long>& order1,
+    const std::function<bool(size_t, size_t)>& can_collide,
+    const CandidateBatchCallback<Candidate>& callback) const
+{
+    const std::vector<long> merged_item_indices = merge_items(items0, items1);
+    const size_t num_items = merged_item_indices.size();
+
+    const auto get_item = [&](long i) -> const HashItem& {
+        return i < 0 ? items0[-(i + 1)] : items1[i];
+    };
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(num_items)),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::vector<Candidate> batch;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                batch.clear();
+
+                const size_t i_begin = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t i_end =
+                    std::min(i_begin + DETERMINISTIC_BLOCK_SIZE, num_items);
+                for (size_t i = i_begin; i < i_end; i++) {
+                    const long idx0 = merged_item_indices[i];
+                    const HashItem& item0 = get_item(idx0);
+
+                    for (size_t j = i + 1; j < num_items; j++) {
+                        const long idx1 = merged_item_indices[j];
+                        const HashItem& item1 = get_item(idx1);
+
+                        if (item0.key != item1.key) {
+                            break; // This avoids a brute force comparison
+                        }
+
+                        long id0 = item0.id, id1 = item1.id;
+                        if (idx0 >= 0 && idx1 < 0) {
+                            std::swap(id0, id1);
+                        } else if (idx0 >= 0 || idx1 < 0) {
+                            continue;
+                        }
+                        assert(id0 < boxes0.size() && id1 < boxes1.size());
+
+                        if (can_collide(id0, id1)
+                            && boxes0[id0].intersects(boxes1[id1])
+                            && owner_cell_key(boxes0[id0], boxes1[id1])
+                                == item0.key) {
+                            batch.emplace_back(order0[id0], order1[id1]);
+                        }
+                    }
+                }
+
+                if (!batch.empty()) {
+                    callback(b, batch);
+                }
+            }
+        });
+}
+
+template <typename Candidate>
+void HashGrid::stream_candidates(
+    const std::vector<HashItem>& items,
+    const std::vector<AABB>& boxes,
+    const std::vector<long>& order,
+    const std::function<bool(size_t, size_t)>& can_collide,
+    const CandidateBatchCallback<Candidate>& callback) const
+{
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(items.size())),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::vector<Candidate> batch;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                batch.clear();
+
+                const size_t i_begin = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t i_end =
+                    std::min(i_begin + DETERMINISTIC_BLOCK_SIZE, items.size());
+                for (size_t i = i_begin; i < i_end; i++) {
+                    const HashItem& item0 = items[i];
+                    const AABB& box0 = boxes[item0.id];
+
+                    for (size_t j = i + 1; j < items.size(); j++) {
+                        const HashItem& item1 = items[j];
+
+                        if (item0.key != item1.key) {
+                            break; // This avoids a brute force comparison
+                        }
+
+                        const AABB& box1 = boxes[item1.id];
+                        if (can_collide(item0.id, item1.id)
+                            && box0.intersects(box1)
+                            && owner_cell_key(box0, box1) == item0.key) {
+                            batch.emplace_back(
+                                order[item0.id], order[item1.id]);
+                        }
+                    }
+                }
+
+                if (!batch.empty()) {
+                    callback(b, batch);
+                }
+            }
+        });
 }
 
+// ============================================================================
+
 void HashGrid::detect_edge_vertex_candidates(
     std::vector<EdgeVertexCandidate>& candidates) const
 {
     detect_candidates(
-        edge_items, vertex_items, edge_boxes, vertex_boxes,
-        [&](size_t ei, size_t vi) { return can_edge_vertex_collide(ei, vi); },
+        edge_items, vertex_items, edge_boxes, vertex_boxes, edge_order,
+        vertex_order,
+        [&](size_t ei, size_t vi) {
+            return can_edge_vertex_collide(ei, vertex_order[vi]);
+        },
         candidates);
 }
 
@@ -322,7 +475,7 @@ void HashGrid::detect_edge_edge_candidates(
     std::vector<EdgeEdgeCandidate>& candidates) const
 {
     detect_candidates(
-        edge_items, edge_boxes,
+        edge_items, edge_boxes, edge_order,
         [&](size_t eai, size_t ebi) { return can_edges_collide(eai, ebi); },
         candidates);
 }
@@ -331,8 +484,11 @@ void HashGrid::detect_face_vertex_candidates(
     std::vector<FaceVertexCandidate>& candidates) const
 {
     detect_candidates(
-        face_items, vertex_items, face_boxes, vertex_boxes,
-        [&](size_t fi, size_t vi) { return can_face_vertex_collide(fi, vi); },
+        face_items, vertex_items, face_boxes, vertex_boxes, face_order,
+        vertex_order,
+        [&](size_t fi, size_t vi) {
+            return can_face_vertex_collide(fi, vertex_order[vi]);
+        },
         candidates);
 }
 
@@ -340,9 +496,51 @@ void HashGrid::detect_edge_face_candidates(
     std::vector<EdgeFaceCandidate>& candidates) const
 {
     detect_candidates(
-        edge_items, face_items, edge_boxes, face_boxes,
+        edge_items, face_items, edge_boxes, face_boxes, edge_order, face_order,
         [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
         candidates);
 }
 
+void HashGrid::stream_edge_vertex_candidates(
+    const CandidateBatchCallback<EdgeVertexCandidate>& callback) const
+{
+    stream_candidates(
+        edge_items, vertex_items, edge_boxes, vertex_boxes, edge_order,
+        vertex_order,
+        [&](size_t ei, size_t vi) {
+            return can_edge_vertex_collide(ei, vertex_order[vi]);
+        },
+        callback);
+}
+
+void HashGrid::stream_edge_edge_candidates(
+    const CandidateBatchCallback<EdgeEdgeCandidate>& callback) const
+{
+    stream_candidates(
+        edge_items, edge_boxes, edge_order,
+        [&](size_t eai, size_t ebi) { return can_edges_collide(eai, ebi); },
+        callback);
+}
+
+void HashGrid::stream_face_vertex_candidates(
+    const CandidateBatchCallback<FaceVertexCandidate>& callback) const
+{
+    stream_candidates(
+        face_items, vertex_items, face_boxes, vertex_boxes, face_order,
+        vertex_order,
+        [&](size_t fi, size_t vi) {
+            return can_face_vertex_collide(fi, vertex_order[vi]);
+        },
+        callback);
+}
+
+void HashGrid::stream_edge_face_candidates(
+    const CandidateBatchCallback<EdgeFaceCandidate>& callback) const
+{
+    stream_candidates(
+        edge_items, face_items, edge_boxes, face_boxes, edge_order, face_order,
+        [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
+        callback);
+}
+
 } // namespace ipc
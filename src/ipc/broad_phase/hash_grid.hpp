@@ -1,16 +1,21 @@
 #pragma once
 
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/broad_phase/voxel_size_heuristic.hpp>
+#include <ipc/utils/morton.hpp>
+
+#include <cstdint>
 
 namespace ipc {
 
 /// @brief An entry into the hash grid as a (key, value) pair.
+/// @note The key is 64-bit on every platform (long is 32-bit on Windows), so it can hold the Morton code of any cell.
 struct HashItem {
-    long key; /// @brief The key of the item.
-    long id;  /// @brief The value of the item.
+    int64_t key; /// @brief The key of the item.
+    long id;     /// @brief The value of the item.
 
     /// @brief Construct a hash item as a (key, value) pair.
-    HashItem(int key, int id) : key(key), id(id) { }
+    HashItem(int64_t key, long id) : key(key), id(id) { }
 
     /// @brief Compare HashItems by their keys for sorting.
     bool operator<(const HashItem& other) const
@@ -55,6 +60,9 @@ public:
         vertex_items.clear();
         edge_items.clear();
         face_items.clear();
+        vertex_order.clear();
+        edge_order.clear();
+        face_order.clear();
     }
 
     /// @brief Find the candidate edge-vertex collisisons.
@@ -77,6 +85,34 @@ public:
     void detect_edge_face_candidates(
         std::vector<EdgeFaceCandidate>& candidates) const override;
 
+    /// @brief Find the candidate edge-vertex collisisons in batches.
+    void stream_edge_vertex_candidates(
+        const CandidateBatchCallback<EdgeVertexCandidate>& callback)
+        const override;
+
+    /// @brief Find the candidate edge-edge collisisons in batches.
+    void stream_edge_edge_candidates(
+        const CandidateBatchCallback<EdgeEdgeCandidate>& callback)
+        const override;
+
+    /// @brief Find the candidate face-vertex collisisons in batches.
+    void stream_face_vertex_candidates(
+        const CandidateBatchCallback<FaceVertexCandidate>& callback)
+        const override;
+
+    /// @brief Find the candidate edge-face intersections in batches.
+    void stream_edge_face_candidates(
+        const CandidateBatchCallback<EdgeFaceCandidate>& callback)
+        const override;
+
+    /// @brief Heuristic used to choose the voxel size.
+    VoxelSizeHeuristic voxel_size_heuristic =
+        VoxelSizeHeuristic::MEDIAN_EDGE_LENGTH;
+
+    /// @brief Reuse the voxel size suggested by the previous build.
+    /// @note Set this when rebuilding for a mesh whose edge and displacement lengths are unchanged (e.g., during a line search) to skip the heuristic. The voxel size only affects the performance, not the candidates found.
+    bool reuse_voxel_size = false;
+
     double cellSize() const { return m_cellSize; }
     const ArrayMax3i& gridSize() const { return m_gridSize; }
     const ArrayMax3d& domainMin() const { return m_domainMin; }
@@ -85,32 +121,66 @@ public:
 protected:
     void resize(const ArrayMax3d& min, const ArrayMax3d& max, double cellSize);
 
+    /// @brief Refine the suggested voxel size with the selected heuristic.
+    double refine_voxel_size(
+        const ArrayMax3d& min, const ArrayMax3d& max, double voxel_size) const;
+
     void insert_boxes();
 
     void insert_boxes(
         const std::vector<AABB>& boxes, std::vector<HashItem>& items) const;
 
+    /// @brief Sort boxes by the Morton code of the cell containing their center.
+    /// @param[in,out] boxes The boxes to sort.
+    /// @param[out] order Original index of each sorted box.
+    void sort_boxes(std::vector<AABB>& boxes, std::vector<long>& order) const;
+
     /// @brief Add an AABB of the extents to the hash grid.
     void insert_box(
         const AABB& aabb, const long id, std::vector<HashItem>& items) const;
 
+    /// @brief Get the index of the cell containing a point (clamped to the grid).
+    ArrayMax3i cell_index(const ArrayMax3d& p) const;
+
+    /// @brief Get the key of the cell that owns a pair of overlapping boxes.
+    ///
+    /// A pair of boxes is found in every cell both of them overlap. Only the
+    /// first of these cells (the cell of the maximum of their minimum
+    /// corners) reports the pair, so each candidate is generated exactly once
+    /// without sorting and deduplicating the candidates afterwards.
+    int64_t owner_cell_key(const AABB& box0, const AABB& box1) const
+    {
+        const ArrayMax3i c = cell_index(box0.min).max(cell_index(box1.min));
+        return hash(c.x(), c.y(), c.size() == 3 ? c.z() : 0);
+    }
+
     /// @brief Create the hash of a cell location.
-    inline long hash(int x, int y, int z) const
+    /// @note This is the Morton code of the cell, so nearby cells have close keys.
+    inline int64_t hash(int x, int y, int z) const
     {
         assert(x >= 0 && y >= 0 && z >= 0);
         assert(
             x < m_gridSize[0] && y < m_gridSize[1]
             && (m_gridSize.size() == 2 || z < m_gridSize[2]));
-        return (z * m_gridSize[1] + y) * m_gridSize[0] + x;
+        return m_gridSize.size() == 2 ? morton_code(x, y)
+                                      : morton_code(x, y, z);
     }
 
 private:
+    /// @brief Merge two sorted lists of items.
+    /// @return Indices of the merged items: -i-1 for items0[i] and j for items1[j].
+    static std::vector<long> merge_items(
+        const std::vector<HashItem>& items0,
+        const std::vector<HashItem>& items1);
+
     template <typename Candidate>
     void detect_candidates(
         const std::vector<HashItem>& items0,
         const std::vector<HashItem>& items1,
         const std::vector<AABB>& boxes0,
         const std::vector<AABB>& boxes1,
+        const std::vector<long>& order0,
+        const std::vector<long>& order1,
         const std::function<bool(size_t, size_t)>& can_collide,
         std::vector<Candidate>& candidates) const;
 
@@ -118,10 +188,32 @@ private:
     void detect_candidates(
         const std::vector<HashItem>& items,
         const std::vector<AABB>& boxes,
+        const std::vector<long>& order,
         const std::function<bool(size_t, size_t)>& can_collide,
         std::vector<Candidate>& candidates) const;
 
+    template <typename Candidate>
+    void stream_candidates(
+        const std::vector<HashItem>& items0,
+        const std::vector<HashItem>& items1,
+        const std::vector<AABB>& boxes0,
+        const std::vector<AABB>& boxes1,
+        const std::vector<long>& order0,
+        const std::vector<long>& order1,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        const CandidateBatchCallback<Candidate>& callback) const;
+
+    template <typename Candidate>
+    void stream_candidates(
+        const std::vector<HashItem>& items,
+        const std::vector<AABB>& boxes,
+        const std::vector<long>& order,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        const CandidateBatchCallback<Candidate>& callback) const;
+
 protected:
+    /// @brief Voxel size suggested by the heuristic in the last build.
+    double m_voxelSize = -1;
     double m_cellSize;
     ArrayMax3i m_gridSize;
     ArrayMax3d m_domainMin;
@@ -130,6 +222,11 @@ protected:
     std::vector<HashItem> vertex_items;
     std::vector<HashItem> edge_items;
     std::vector<HashItem> face_items;
+
+    /// @brief Original index of each (Morton sorted) vertex, edge, and face box.
+    std::vector<long> vertex_order;
+    std::vector<long> edge_order;
+    std::vector<long> face_order;
 };
 
 } // namespace ipc
@@ -0,0 +1,536 @@
+#include "partitioned_broad_phase.hpp"
+
+#include <ipc/broad_phase/voxel_size_heuristic.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ipc {
+
+namespace {
+    /// @brief Maximum number of cells along each axis of the static grid.
+    /// @note This keeps the cell hashes in the range of the HashItem keys.
+    constexpr int MAX_STATIC_GRID_SIZE = 1024;
+
+    /// @brief Dereference the static grid of a mesh.
+    /// @throws std::runtime_error If the mesh has no static vertices.
+    const StaticElementGrid&
+    checked_static_grid(const std::shared_ptr<const StaticElementGrid>& grid)
+    {
+        if (grid == nullptr) {
+            throw std::runtime_error(
+                "Partitioned broad phase requires a mesh with static vertices!");
+        }
+        return *grid;
+    }
+} // namespace
+
+StaticElementGrid::StaticElementGrid(
+    const Eigen::MatrixXd& rest_positions,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const std::vector<bool>& is_vertex_static)
+{
+    assert(is_vertex_static.size() == size_t(rest_positions.rows()));
+
+    for (long vi = 0; vi < rest_positions.rows(); vi++) {
+        (is_vertex_static[vi] ? vertex_ids : moving_vertex_ids).push_back(vi);
+    }
+    for (long ei = 0; ei < edges.rows(); ei++) {
+        if (is_vertex_static[edges(ei, 0)] && is_vertex_static[edges(ei, 1)]) {
+            edge_ids.push_back(ei);
+        } else {
+            moving_edge_ids.push_back(ei);
+        }
+    }
+    for (long fi = 0; fi < faces.rows(); fi++) {
+        if (is_vertex_static[faces(fi, 0)] && is_vertex_static[faces(fi, 1)]
+            && is_vertex_static[faces(fi, 2)]) {
+            face_ids.push_back(fi);
+        } else {
+            moving_face_ids.push_back(fi);
+        }
+    }
+
+    // Local IDs of the vertices in the moving part: every moving vertex,
+    // followed by the static vertices of moving elements.
+    std::vector<int> local_ids(rest_positions.rows(), -1);
+    for (size_t i = 0; i < moving_vertex_ids.size(); i++) {
+        local_ids[moving_vertex_ids[i]] = int(i);
+    }
+    const auto local_id = [&](const int vi) {
+        if (local_ids[vi] < 0) {
+            local_ids[vi] = int(moving_vertex_ids.size());
+            moving_vertex_ids.push_back(vi);
+        }
+        return local_ids[vi];
+    };
+
+    moving_edges.resize(moving_edge_ids.size(), 2);
+    for (size_t i = 0; i < moving_edge_ids.size(); i++) {
+        for (int j = 0; j < 2; j++) {
+            moving_edges(i, j) = local_id(edges(moving_edge_ids[i], j));
+        }
+    }
+    moving_faces.resize(moving_face_ids.size(), 3);
+    for (size_t i = 0; i < moving_face_ids.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            moving_faces(i, j) = local_id(faces(moving_face_ids[i], j));
+        }
+    }
+
+    // The boxes are not inflated, so any inflation radius can be used when
+    // querying the grid.
+    std::vector<AABB> all_vertex_boxes;
+    build_vertex_boxes(rest_positions, all_vertex_boxes);
+
+    vertex_boxes.resize(vertex_ids.size());
+    for (size_t i = 0; i < vertex_ids.size(); i++) {
+        vertex_boxes[i] = all_vertex_boxes[vertex_ids[i]];
+    }
+
+    Eigen::MatrixXi static_edges(edge_ids.size(), 2);
+    edge_boxes.resize(edge_ids.size());
+    for (size_t i = 0; i < edge_ids.size(); i++) {
+        static_edges.row(i) = edges.row(edge_ids[i]);
+        const long e0i = edges(edge_ids[i], 0), e1i = edges(edge_ids[i], 1);
+        edge_boxes[i] = AABB(all_vertex_boxes[e0i], all_vertex_boxes[e1i]);
+        edge_boxes[i].vertex_ids = { { e0i, e1i, -1 } };
+    }
+
+    face_boxes.resize(face_ids.size());
+    for (size_t i = 0; i < face_ids.size(); i++) {
+        const long f0i = faces(face_ids[i], 0), f1i = faces(face_ids[i], 1),
+                   f2i = faces(face_ids[i], 2);
+        face_boxes[i] = AABB(
+            all_vertex_boxes[f0i], all_vertex_boxes[f1i],
+            all_vertex_boxes[f2i]);
+        face_boxes[i].vertex_ids = { { f0i, f1i, f2i } };
+    }
+
+    // Fit the grid to the static vertices.
+    assert(!vertex_boxes.empty());
+    m_domain_min = vertex_boxes[0].min;
+    ArrayMax3d domain_max = vertex_boxes[0].max;
+    for (const AABB& box : vertex_boxes) {
+        m_domain_min = m_domain_min.min(box.min);
+        domain_max = domain_max.max(box.max);
+    }
+    const double extent = (domain_max - m_domain_min).maxCoeff();
+
+    m_cell_size = static_edges.rows() > 0
+        ? suggest_good_voxel_size(rest_positions, static_edges)
+        : 0;
+    m_cell_size = std::max(m_cell_size, extent / MAX_STATIC_GRID_SIZE);
+    if (!std::isfinite(m_cell_size) || m_cell_size <= 0) {
+        m_cell_size = 1; // All static vertices are at the same point.
+    }
+    m_grid_size = ((domain_max - m_domain_min) / m_cell_size)
+                      .ceil()
+                      .cast<int>()
+                      .max(1)
+                      .min(MAX_STATIC_GRID_SIZE);
+
+    insert_boxes(vertex_boxes, vertex_items);
+    insert_boxes(edge_boxes, edge_items);
+    insert_boxes(face_boxes, face_items);
+}
+
+ArrayMax3i StaticElementGrid::cell_index(const ArrayMax3d& p) const
+{
+    // Clamp before casting, so query points far outside the grid do not
+    // overflow the integer cell index.
+    const ArrayMax3d index = ((p - m_domain_min) / m_cell_size).floor();
+    return index.max(0).min((m_grid_size - 1).cast<double>()).cast<int>();
+}
+
+long StaticElementGrid::find_moved_static_vertex(
+    const Eigen::MatrixXd& vertices) const
+{
+    // The static vertex boxes are the (uninflated) rest positions. Report the
+    // first moved vertex, so the result does not depend on the scheduling.
+    const size_t first_moved = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(size_t(0), vertex_ids.size()),
+        vertex_ids.size(),
+        [&](const tbb::blocked_range<size_t>& r, size_t first) {
+            for (size_t i = r.begin(); i < r.end() && i < first; i++) {
+                const ArrayMax3d p =
+                    vertices.row(vertex_ids[i]).transpose().array();
+                const AABB& box = vertex_boxes[i];
+                if ((p < box.min).any() || (p > box.max).any()) {
+                    return i;
+                }
+            }
+            return first;
+        },
+        [](size_t a, size_t b) { return std::min(a, b); });
+    return first_moved < vertex_ids.size() ? vertex_ids[first_moved] : -1;
+}
+
+void StaticElementGrid::insert_boxes(
+    const std::vector<AABB>& boxes, std::vector<HashItem>& items) const
+{
+    tbb::enumerable_thread_specific<std::vector<HashItem>> storage;
+
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, long(boxes.size())),
+        [&](const tbb::blocked_range<long>& range) {
+            auto& local_items = storage.local();
+            for (long i = range.begin(); i != range.end(); i++) {
+                const ArrayMax3i int_min = cell_index(boxes[i].min);
+                const ArrayMax3i int_max = cell_index(boxes[i].max);
+
+                const int min_z = int_min.size() == 3 ? int_min.z() : 0;
+                const int max_z = int_max.size() == 3 ? int_max.z() : 0;
+                for (int x = int_min.x(); x <= int_max.x(); ++x) {
+                    for (int y = int_min.y(); y <= int_max.y(); ++y) {
+                        for (int z = min_z; z <= max_z; ++z) {
+                            local_items.emplace_back(hash(x, y, z), i);
+                        }
+                    }
+                }
+            }
+        });
+
+    merge_thread_local_vectors(storage, items);
+
+    tbb::parallel_sort(items.begin(), items.end());
+}
+
+// ============================================================================
+
+PartitionedBroadPhase::PartitionedBroadPhase(
+    const CollisionMesh& mesh, std::unique_ptr<BroadPhase> broad_phase)
+    : m_static_grid(mesh.static_element_grid())
+    , m_is_vertex_static(mesh.static_vertices())
+    , m_broad_phase(std::move(broad_phase))
+    , m_vertex_ids(checked_static_grid(m_static_grid).moving_vertex_ids)
+    , m_edge_ids(m_static_grid->moving_edge_ids)
+    , m_face_ids(m_static_grid->moving_face_ids)
+    , m_num_edges(mesh.num_edges())
+    , m_num_faces(mesh.num_faces())
+{
+    // The wrapped broad phase only sees the moving part of the mesh, so map
+    // its vertex IDs back to the mesh before filtering.
+    m_broad_phase->can_vertices_collide = [this](size_t vi, size_t vj) {
+        return can_vertices_collide(m_vertex_ids[vi], m_vertex_ids[vj]);
+    };
+}
+
+void PartitionedBroadPhase::build(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius)
+{
+    clear();
+
+    check_mesh_size(vertices.rows(), edges, faces);
+    if (validate_static_vertices) {
+        check_static_vertices(vertices);
+    }
+    if (m_vertex_ids.empty()) {
+        return;
+    }
+
+    const Eigen::MatrixXi& moving_edges = m_static_grid->moving_edges;
+    const Eigen::MatrixXi& moving_faces = m_static_grid->moving_faces;
+
+    const Eigen::MatrixXd moving_vertices = select_moving_vertices(vertices);
+
+    m_broad_phase->build(
+        moving_vertices, moving_edges, moving_faces, inflation_radius);
+
+    build_boxes(
+        moving_vertices, moving_edges, moving_faces, vertex_boxes, edge_boxes,
+        face_boxes, inflation_radius);
+    map_box_vertex_ids();
+
+    m_inflation_radius = inflation_radius;
+}
+
+void PartitionedBroadPhase::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius)
+{
+    clear();
+
+    check_mesh_size(vertices_t0.rows(), edges, faces);
+    if (validate_static_vertices) {
+        check_static_vertices(vertices_t0);
+        check_static_vertices(vertices_t1);
+    }
+    if (m_vertex_ids.empty()) {
+        return;
+    }
+
+    const Eigen::MatrixXi& moving_edges = m_static_grid->moving_edges;
+    const Eigen::MatrixXi& moving_faces = m_static_grid->moving_faces;
+
+    const Eigen::MatrixXd moving_vertices_t0 =
+        select_moving_vertices(vertices_t0);
+    const Eigen::MatrixXd moving_vertices_t1 =
+        select_moving_vertices(vertices_t1);
+
+    m_broad_phase->build(
+        moving_vertices_t0, moving_vertices_t1, moving_edges, moving_faces,
+        inflation_radius);
+
+    build_boxes(
+        moving_vertices_t0, moving_vertices_t1, moving_edges, moving_faces,
+        vertex_boxes, edge_boxes, face_boxes, inflation_radius);
+    map_box_vertex_ids();
+
+    m_inflation_radius = inflation_radius;
+}
+
+void PartitionedBroadPhase::clear()
+{
+    BroadPhase::clear();
+    m_broad_phase->clear();
+}
+
+// ============================================================================
+
+void PartitionedBroadPhase::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    // Moving edges and moving vertices
+    m_broad_phase->detect_edge_vertex_candidates(candidates);
+    size_t n = 0;
+    for (const EdgeVertexCandidate& c : candidates) {
+        const long vi = m_vertex_ids[c.vertex_id];
+        if (!m_is_vertex_static[vi]) {
+            candidates[n++] = EdgeVertexCandidate(m_edge_ids[c.edge_id], vi);
+        }
+    }
+    candidates.erase(candidates.begin() + n, candidates.end());
+
+    // Moving edges and static vertices
+    detect_static_candidates(
+        edge_boxes, m_static_grid->vertex_items, m_static_grid->vertex_boxes,
+        [&](std::vector<EdgeVertexCandidate>& local, size_t ei, size_t i) {
+            local.emplace_back(m_edge_ids[ei], m_static_grid->vertex_ids[i]);
+        },
+        candidates);
+
+    // Moving vertices and static edges
+    detect_static_candidates(
+        vertex_boxes, m_static_grid->edge_items, m_static_grid->edge_boxes,
+        [&](std::vector<EdgeVertexCandidate>& local, size_t vi, size_t i) {
+            local.emplace_back(m_static_grid->edge_ids[i], m_vertex_ids[vi]);
+        },
+        candidates);
+
+    tbb::parallel_sort(candidates.begin(), candidates.end());
+}
+
+void PartitionedBroadPhase::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    // Moving edges and moving edges
+    m_broad_phase->detect_edge_edge_candidates(candidates);
+    for (EdgeEdgeCandidate& c : candidates) {
+        c = EdgeEdgeCandidate(m_edge_ids[c.edge0_id], m_edge_ids[c.edge1_id]);
+    }
+
+    // Moving edges and static edges
+    detect_static_candidates(
+        edge_boxes, m_static_grid->edge_items, m_static_grid->edge_boxes,
+        [&](std::vector<EdgeEdgeCandidate>& local, size_t ei, size_t i) {
+            local.emplace_back(m_edge_ids[ei], m_static_grid->edge_ids[i]);
+        },
+        candidates);
+
+    tbb::parallel_sort(candidates.begin(), candidates.end());
+}
+
+void PartitionedBroadPhase::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    // Moving faces and moving vertices
+    m_broad_phase->detect_face_vertex_candidates(candidates);
+    size_t n = 0;
+    for (const FaceVertexCandidate& c : candidates) {
+        const long vi = m_vertex_ids[c.vertex_id];
+        if (!m_is_vertex_static[vi]) {
+            candidates[n++] = FaceVertexCandidate(m_face_ids[c.face_id], vi);
+        }
+    }
+    candidates.erase(candidates.begin() + n, candidates.end());
+
+    // Moving faces and static vertices
+    detect_static_candidates(
+        face_boxes, m_static_grid->vertex_items, m_static_grid->vertex_boxes,
+        [&](std::vector<FaceVertexCandidate>& local, size_t fi, size_t i) {
+            local.emplace_back(m_face_ids[fi], m_static_grid->vertex_ids[i]);
+        },
+        candidates);
+
+    // Moving vertices and static faces
+    detect_static_candidates(
+        vertex_boxes, m_static_grid->face_items, m_static_grid->face_boxes,
+        [&](std::vector<FaceVertexCandidate>& local, size_t vi, size_t i) {
+            local.emplace_back(m_static_grid->face_ids[i], m_vertex_ids[vi]);
+        },
+        candidates);
+
+    tbb::parallel_sort(candidates.begin(), candidates.end());
+}
+
+void PartitionedBroadPhase::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    // Moving edges and moving faces
+    m_broad_phase->detect_edge_face_candidates(candidates);
+    for (EdgeFaceCandidate& c : candidates) {
+        c = EdgeFaceCandidate(m_edge_ids[c.edge_id], m_face_ids[c.face_id]);
+    }
+
+    // Moving edges and static faces
+    detect_static_candidates(
+        edge_boxes, m_static_grid->face_items, m_static_grid->face_boxes,
+        [&](std::vector<EdgeFaceCandidate>& local, size_t ei, size_t i) {
+            local.emplace_back(m_edge_ids[ei], m_static_grid->face_ids[i]);
+        },
+        candidates);
+
+    // Moving faces and static edges
+    detect_static_candidates(
+        face_boxes, m_static_grid->edge_items, m_static_grid->edge_boxes,
+        [&](std::vector<EdgeFaceCandidate>& local, size_t fi, size_t i) {
+            local.emplace_back(m_static_grid->edge_ids[i], m_face_ids[fi]);
+        },
+        candidates);
+
+    tbb::parallel_sort(candidates.begin(), candidates.end());
+}
+
+// ============================================================================
+
+void PartitionedBroadPhase::check_mesh_size(
+    const size_t num_vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces) const
+{
+    if (m_is_vertex_static.size() != num_vertices
+        || size_t(edges.rows()) != m_num_edges
+        || size_t(faces.rows()) != m_num_faces) {
+        throw std::runtime_error(
+            "Mesh does not match the mesh used to build the partitioned broad phase!");
+    }
+}
+
+void PartitionedBroadPhase::check_static_vertices(
+    const Eigen::MatrixXd& vertices) const
+{
+    const long vi = m_static_grid->find_moved_static_vertex(vertices);
+    if (vi >= 0) {
+        throw std::runtime_error(
+            "Static vertex " + std::to_string(vi)
+            + " is not at its rest position!");
+    }
+}
+
+Eigen::MatrixXd
+PartitionedBroadPhase::select_moving_vertices(const Eigen::MatrixXd& V) const
+{
+    Eigen::MatrixXd moving_vertices(m_vertex_ids.size(), V.cols());
+    for (size_t i = 0; i < m_vertex_ids.size(); i++) {
+        moving_vertices.row(i) = V.row(m_vertex_ids[i]);
+    }
+    return moving_vertices;
+}
+
+void PartitionedBroadPhase::map_box_vertex_ids()
+{
+    for (std::vector<AABB>* boxes : { &vertex_boxes, &edge_boxes, &face_boxes }) {
+        for (AABB& box : *boxes) {
+            for (long& id : box.vertex_ids) {
+                if (id >= 0) {
+                    id = m_vertex_ids[id];
+                }
+            }
+        }
+    }
+}
+
+template <typename Candidate, typename Function>
+void PartitionedBroadPhase::detect_static_candidates(
+    const std::vector<AABB>& boxes,
+    const std::vector<HashItem>& items,
+    const std::vector<AABB>& static_boxes,
+    const Function& add,
+    std::vector<Candidate>& candidates) const
+{
+    if (items.empty()) {
+        return;
+    }
+
+    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            auto& local_candidates = storage.local();
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const AABB& box = boxes[i];
+                // Static vertices of the moving elements are in the static
+                // grid already.
+                if (box.vertex_ids[1] < 0
+                    && m_is_vertex_static[box.vertex_ids[0]]) {
+                    continue;
+                }
+
+                // The static boxes are not inflated, so inflate the query box
+                // by the radius of both boxes.
+                AABB query = box;
+                AABB::conservative_inflation(
+                    query.min, query.max, m_inflation_radius);
+
+                m_static_grid->query(
+                    query, items, static_boxes, [&](const long j) {
+                        if (can_collide(
+                                box.vertex_ids, static_boxes[j].vertex_ids)) {
+                            add(local_candidates, i, j);
+                        }
+                    });
+            }
+        });
+
+    merge_thread_local_vectors(storage, candidates);
+}
+
+bool PartitionedBroadPhase::can_collide(
+    const std::array<long, 3>& ids0, const std::array<long, 3>& ids1) const
+{
+    for (const long vi : ids0) {
+        for (const long vj : ids1) {
+            if (vi >= 0 && vi == vj) {
+                return false; // Adjacent elements
+            }
+        }
+    }
+
+    for (const long vi : ids0) {
+        for (const long vj : ids1) {
+            if (vi >= 0 && vj >= 0 && can_vertices_collide(vi, vj)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace ipc
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Persistent acceleration structure of the static elements of a mesh.
+///
+/// An element is static if all of its vertices are static. The (uninflated)
+/// boxes of the static elements are inserted into a sorted uniform grid once
+/// and then queried by the moving elements on every broad phase. The moving
+/// part of the mesh is also selected once here.
+class StaticElementGrid {
+public:
+    /// @brief Build the grid of the static elements.
+    /// @param rest_positions Positions of all vertices (static vertices never move).
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param is_vertex_static Whether each vertex is static.
+    StaticElementGrid(
+        const Eigen::MatrixXd& rest_positions,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const std::vector<bool>& is_vertex_static);
+
+    /// @brief Find the static elements whose boxes overlap a query box.
+    /// @note Each overlapping element is visited exactly once.
+    /// @param box The query box (including any inflation of both boxes).
+    /// @param items Sorted grid items of the static elements.
+    /// @param boxes Boxes of the static elements.
+    /// @param visit Function called with the index of each overlapping static element.
+    template <typename Function>
+    void query(
+        const AABB& box,
+        const std::vector<HashItem>& items,
+        const std::vector<AABB>& boxes,
+        const Function& visit) const;
+
+    /// @brief Find a static vertex that is not at its rest position.
+    /// @param vertices Vertex positions passed to the broad phase.
+    /// @return The mesh ID of the first such vertex or -1 if all static vertices are at rest.
+    long find_moved_static_vertex(const Eigen::MatrixXd& vertices) const;
+
+public:
+    /// @brief Boxes of the static vertices, edges, and faces.
+    std::vector<AABB> vertex_boxes, edge_boxes, face_boxes;
+    /// @brief Mesh IDs of the static vertices, edges, and faces.
+    std::vector<long> vertex_ids, edge_ids, face_ids;
+    /// @brief Sorted grid items of the static vertices, edges, and faces.
+    std::vector<HashItem> vertex_items, edge_items, face_items;
+
+    /// @brief Mesh IDs of the vertices, edges, and faces of the moving part.
+    /// @note The moving vertices come first, followed by the static vertices of the moving elements.
+    std::vector<long> moving_vertex_ids, moving_edge_ids, moving_face_ids;
+    /// @brief Moving edges and faces using the local IDs of moving_vertex_ids.
+    Eigen::MatrixXi moving_edges, moving_faces;
+
+protected:
+    /// @brief Get the index of the cell containing a point (clamped to the grid).
+    ArrayMax3i cell_index(const ArrayMax3d& p) const;
+
+    /// @brief Create the hash of a cell location.
+    int64_t hash(int x, int y, int z) const
+    {
+        return (int64_t(z) * m_grid_size[1] + y) * m_grid_size[0] + x;
+    }
+
+    /// @brief Insert boxes into the grid as sorted items.
+    void insert_boxes(
+        const std::vector<AABB>& boxes, std::vector<HashItem>& items) const;
+
+    /// @brief Size of the grid cells.
+    double m_cell_size;
+    /// @brief Minimum corner of the grid.
+    ArrayMax3d m_domain_min;
+    /// @brief Number of cells along each axis.
+    ArrayMax3i m_grid_size;
+};
+
+template <typename Function>
+void StaticElementGrid::query(
+    const AABB& box,
+    const std::vector<HashItem>& items,
+    const std::vector<AABB>& boxes,
+    const Function& visit) const
+{
+    const ArrayMax3i cell_min = cell_index(box.min);
+    const ArrayMax3i cell_max = cell_index(box.max);
+
+    const int min_z = cell_min.size() == 3 ? cell_min.z() : 0;
+    const int max_z = cell_max.size() == 3 ? cell_max.z() : 0;
+    for (int x = cell_min.x(); x <= cell_max.x(); ++x) {
+        for (int y = cell_min.y(); y <= cell_max.y(); ++y) {
+            for (int z = min_z; z <= max_z; ++z) {
+                const int64_t key = hash(x, y, z);
+                auto it = std::lower_bound(
+                    items.begin(), items.end(), key,
+                    [](const HashItem& item, int64_t k) {
+                        return item.key < k;
+                    });
+                for (; it != items.end() && it->key == key; ++it) {
+                    const AABB& other = boxes[it->id];
+                    if (!box.intersects(other)) {
+                        continue;
+                    }
+                    // Only report the pair in the first cell both boxes share.
+                    const ArrayMax3i c = cell_min.max(cell_index(other.min));
+                    if (hash(c.x(), c.y(), c.size() == 3 ? c.z() : 0) == key) {
+                        visit(it->id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// @brief Broad phase that partitions the mesh into static and moving elements.
+///
+/// Only the elements with a moving vertex are boxed and inserted into the
+/// wrapped broad phase. They are also queried against the mesh's persistent
+/// StaticElementGrid, and pairs of static elements are never considered, so
+/// the cost scales with the moving part of the mesh.
+class PartitionedBroadPhase : public BroadPhase {
+public:
+    /// @brief Construct a partitioned broad phase.
+    /// @param mesh The collision mesh with static vertices.
+    /// @param broad_phase Broad phase used between the moving elements.
+    PartitionedBroadPhase(
+        const CollisionMesh& mesh, std::unique_ptr<BroadPhase> broad_phase);
+
+    /// @brief Build the broad phase for static collision detection.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Clear any built data (the static grid is kept).
+    void clear() override;
+
+    /// @brief Check that the static vertices are at their rest positions on every build.
+    /// @note This costs a pass over all static vertices, so it is only enabled by default in debug builds.
+#ifdef NDEBUG
+    bool validate_static_vertices = false;
+#else
+    bool validate_static_vertices = true;
+#endif
+
+    /// @brief Find the candidate edge-vertex collisisons.
+    /// @param[out] candidates The candidate edge-vertex collisisons.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisisons.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisisons.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+protected:
+    /// @brief Check that a mesh matches the one the broad phase was constructed with.
+    /// @param num_vertices Number of vertices in the mesh.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @throws std::runtime_error If the number of vertices, edges, or faces differs.
+    void check_mesh_size(
+        const size_t num_vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces) const;
+
+    /// @brief Check that the static vertices are at their rest positions.
+    /// @note Otherwise the static grid is stale and candidates would be silently dropped.
+    /// @param vertices Vertex positions passed to the broad phase.
+    /// @throws std::runtime_error If a static vertex has moved.
+    void check_static_vertices(const Eigen::MatrixXd& vertices) const;
+
+    /// @brief Get the rows of the moving part of a vertex matrix.
+    Eigen::MatrixXd select_moving_vertices(const Eigen::MatrixXd& V) const;
+
+    /// @brief Map the vertex IDs of the local boxes to the mesh IDs.
+    void map_box_vertex_ids();
+
+    /// @brief Find the pairs of a moving and a static element.
+    /// @param boxes Boxes of the moving elements.
+    /// @param items Sorted grid items of the static elements.
+    /// @param static_boxes Boxes of the static elements.
+    /// @param add Function called with a thread's candidates, the local ID of the moving element, and the index of the static element.
+    /// @param[out] candidates The candidates added by add.
+    template <typename Candidate, typename Function>
+    void detect_static_candidates(
+        const std::vector<AABB>& boxes,
+        const std::vector<HashItem>& items,
+        const std::vector<AABB>& static_boxes,
+        const Function& add,
+        std::vector<Candidate>& candidates) const;
+
+    /// @brief Determine if a pair of vertex sets (in mesh IDs) can collide.
+    bool can_collide(
+        const std::array<long, 3>& ids0, const std::array<long, 3>& ids1) const;
+
+    /// @brief Persistent grid of the static elements.
+    std::shared_ptr<const StaticElementGrid> m_static_grid;
+    /// @brief Whether each vertex is static.
+    std::vector<bool> m_is_vertex_static;
+    /// @brief Broad phase used between the moving elements.
+    std::unique_ptr<BroadPhase> m_broad_phase;
+
+    /// @brief Mesh IDs of the vertices in the wrapped broad phase.
+    const std::vector<long>& m_vertex_ids;
+    /// @brief Mesh IDs of the edges in the wrapped broad phase.
+    const std::vector<long>& m_edge_ids;
+    /// @brief Mesh IDs of the faces in the wrapped broad phase.
+    const std::vector<long>& m_face_ids;
+    /// @brief Number of edges and faces in the mesh.
+    size_t m_num_edges, m_num_faces;
+    /// @brief Extra inflation of the moving boxes when querying the static grid.
+    double m_inflation_radius = 0;
+};
+
+} // namespace ipc
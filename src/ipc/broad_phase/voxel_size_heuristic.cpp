@@ -1,11 +1,61 @@
 #include "voxel_size_heuristic.hpp"
 
+#include <ipc/utils/deterministic_reduction.hpp>
 #include <ipc/utils/logger.hpp>
 
-#include <igl/median.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
 
 namespace ipc {
 
+namespace {
+    /// @brief Seed of the uniform samples, fixed so estimates are reproducible.
+    constexpr uint64_t SAMPLE_SEED = 0x9E3779B97F4A7C15;
+
+    /// @brief Index of the i-th uniform random sample of n elements.
+    /// @note Each index is a SplitMix64 hash of i, so the samples can be drawn in parallel and are the same on every platform. The modulo bias is at most n/2^64.
+    /// @param i Sample number.
+    /// @param n Number of elements.
+    /// @return An index in [0, n).
+    size_t sample_index(const size_t i, const size_t n)
+    {
+        uint64_t z = SAMPLE_SEED * (uint64_t(i) + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        z ^= z >> 31;
+        return size_t(z % uint64_t(n));
+    }
+
+    /// @brief Compute the median of n lengths from at most MAX_MEDIAN_SAMPLES of them.
+    /// @param n Number of lengths.
+    /// @param length Function computing the i-th length.
+    /// @return The (estimated) median length or zero if there are no lengths.
+    template <typename LengthFunction>
+    double sampled_median(const size_t n, const LengthFunction& length)
+    {
+        if (n == 0) {
+            return 0;
+        }
+
+        const bool is_exact = n <= MAX_MEDIAN_SAMPLES;
+        const size_t num_samples = is_exact ? n : MAX_MEDIAN_SAMPLES;
+        std::vector<double> samples(num_samples);
+        tbb::parallel_for(size_t(0), num_samples, [&](size_t i) {
+            samples[i] = length(is_exact ? i : sample_index(i, n));
+        });
+
+        const auto mid = samples.begin() + num_samples / 2;
+        std::nth_element(samples.begin(), mid, samples.end());
+        if (num_samples % 2 == 1) {
+            return *mid;
+        }
+        // Average the two middle lengths of an even number of samples.
+        return (*std::max_element(samples.begin(), mid) + *mid) / 2;
+    }
+} // namespace
+
 double suggest_good_voxel_size(
     const Eigen::MatrixXd& vertices,
     const Eigen::MatrixXi& edges,
@@ -49,7 +99,7 @@ double suggest_good_voxel_size(
     //     + inflation_radius;
 
     double edge_len = median_edge_length(vertices_t0, vertices_t1, edges);
-    double disp_len = median_displacement_length(vertices_t1 - vertices_t0);
+    double disp_len = median_displacement_length(vertices_t0, vertices_t1);
     double voxel_size = 2 * std::max(edge_len, disp_len) + inflation_radius;
 
     // double voxel_size = std::max(
@@ -115,31 +165,29 @@ double median_edge_length(
     const Eigen::MatrixXd& vertices_t1,
     const Eigen::MatrixXi& edges)
 {
-    if (edges.rows() == 0) {
-        return 0;
-    }
-
-    Eigen::VectorXd lengths(2 * edges.rows());
-    for (int i = 0; i < edges.rows(); i++) {
-        const size_t e0i = edges(i, 0), e1i = edges(i, 1);
-        lengths[2 * i + 0] =
-            (vertices_t0.row(e0i) - vertices_t0.row(e1i)).norm();
-        lengths[2 * i + 1] =
-            (vertices_t1.row(e0i) - vertices_t1.row(e1i)).norm();
-    }
-
-    double median = -1;
-    const bool success = igl::median(lengths, median);
-    assert(success);
-    return median;
+    // The lengths of each edge at t0 and t1 are interleaved.
+    return sampled_median(2 * edges.rows(), [&](size_t i) {
+        const Eigen::MatrixXd& vertices =
+            i % 2 == 0 ? vertices_t0 : vertices_t1;
+        const size_t e0i = edges(i / 2, 0), e1i = edges(i / 2, 1);
+        return (vertices.row(e0i) - vertices.row(e1i)).norm();
+    });
 }
 
 double median_displacement_length(const Eigen::MatrixXd& displacements)
 {
-    double median = -1;
-    const bool success = igl::median(displacements.rowwise().norm(), median);
-    assert(success);
-    return median;
+    return sampled_median(displacements.rows(), [&](size_t i) {
+        return displacements.row(i).norm();
+    });
+}
+
+double median_displacement_length(
+    const Eigen::MatrixXd& vertices_t0, const Eigen::MatrixXd& vertices_t1)
+{
+    assert(vertices_t0.rows() == vertices_t1.rows());
+    return sampled_median(vertices_t0.rows(), [&](size_t i) {
+        return (vertices_t1.row(i) - vertices_t0.row(i)).norm();
+    });
 }
 
 double max_edge_length(
@@ -164,4 +212,51 @@ double max_displacement_length(const Eigen::MatrixXd& displacements)
     return displacements.rowwise().norm().maxCoeff();
 }
 
+double suggest_voxel_size_from_cost_model(
+    const std::vector<AABB>& boxes,
+    const ArrayMax3d& domain_min,
+    const ArrayMax3d& domain_max,
+    double initial_voxel_size)
+{
+    assert(initial_voxel_size > 0);
+    if (boxes.empty()) {
+        return initial_voxel_size;
+    }
+
+    // Estimate the number of items from a uniform sample of boxes.
+    const bool is_exact = boxes.size() <= MAX_MEDIAN_SAMPLES;
+    const size_t num_samples = is_exact ? boxes.size() : MAX_MEDIAN_SAMPLES;
+    const double sample_scale = double(boxes.size()) / num_samples;
+
+    const auto cost = [&](const double voxel_size) {
+        const double num_sampled_items =
+            deterministic_parallel_sum(num_samples, [&](size_t i) {
+                const AABB& box =
+                    boxes[is_exact ? i : sample_index(i, boxes.size())];
+                return ((box.max - box.min) / voxel_size + 1).floor().prod();
+            });
+        const double num_items = sample_scale * num_sampled_items;
+        const double num_cells =
+            ((domain_max - domain_min) / voxel_size).ceil().max(1).prod();
+        const double num_occupied_cells = std::min(num_cells, num_items);
+        return num_items + num_items * num_items / (2 * num_occupied_cells);
+    };
+
+    double best_voxel_size = initial_voxel_size;
+    double best_cost = cost(initial_voxel_size);
+    for (int i = -4; i <= 4; i++) {
+        const double voxel_size = initial_voxel_size * std::pow(2, i / 2.0);
+        const double voxel_size_cost = cost(voxel_size);
+        if (voxel_size_cost < best_cost) {
+            best_voxel_size = voxel_size;
+            best_cost = voxel_size_cost;
+        }
+    }
+
+    logger().trace(
+        "cost model suggests voxel size of {} (initial={})", best_voxel_size,
+        initial_voxel_size);
+    return best_voxel_size;
+}
+
 } // namespace ipc
@@ -1,9 +1,25 @@
 #pragma once
 
+#include <ipc/broad_phase/aabb.hpp>
+
 #include <Eigen/Core>
 
+#include <vector>
+
 namespace ipc {
 
+/// @brief Maximum number of lengths sampled to estimate a median length.
+/// @note Medians of fewer lengths are exact. Otherwise, the median of MAX_MEDIAN_SAMPLES lengths drawn uniformly at random (with a fixed seed, so the estimate is reproducible) is used. By the Dvoretzky-Kiefer-Wolfowitz (DKW) inequality, its rank is off by more than eps * n with probability at most 2 exp(-2 MAX_MEDIAN_SAMPLES eps^2), e.g., eps = 1% fails with probability below 5e-6 regardless of the order of the lengths. A poor estimate only affects the performance of the broad phase, never the candidates found.
+static constexpr size_t MAX_MEDIAN_SAMPLES = 1 << 16;
+
+/// @brief Heuristic used to choose the voxel size of a hash grid.
+enum class VoxelSizeHeuristic {
+    /// @brief Twice the median edge (and displacement) length.
+    MEDIAN_EDGE_LENGTH,
+    /// @brief Minimize a cost model of the number of items and pairs tested.
+    COST_MODEL
+};
+
 double suggest_good_voxel_size(
     const Eigen::MatrixXd& vertices,
     const Eigen::MatrixXi& edges,
@@ -35,6 +51,10 @@ double median_edge_length(
 /// @brief Compute the median displacement length.
 double median_displacement_length(const Eigen::MatrixXd& displacements);
 
+/// @brief Compute the median displacement length from vertices_t0 to vertices_t1.
+double median_displacement_length(
+    const Eigen::MatrixXd& vertices_t0, const Eigen::MatrixXd& vertices_t1);
+
 /// @brief Compute the maximum edge length of a mesh.
 double max_edge_length(
     const Eigen::MatrixXd& vertices_t0,
@@ -44,4 +64,17 @@ double max_edge_length(
 /// @brief Compute the maximum displacement length.
 double max_displacement_length(const Eigen::MatrixXd& displacements);
 
+/// @brief Suggest a voxel size by minimizing a cost model of a hash grid.
+/// @details The cost of a voxel size is the number of (box, cell) items plus the number of pairs of items sharing a cell, assuming the items are evenly spread over min(#cells, #items) cells. Voxel sizes within a factor of four of the initial voxel size are tried.
+/// @param boxes Boxes inserted in the hash grid.
+/// @param domain_min Minimum corner of the hash grid.
+/// @param domain_max Maximum corner of the hash grid.
+/// @param initial_voxel_size Voxel size to start the search from.
+/// @return The voxel size with the lowest estimated cost.
+double suggest_voxel_size_from_cost_model(
+    const std::vector<AABB>& boxes,
+    const ArrayMax3d& domain_min,
+    const ArrayMax3d& domain_max,
+    double initial_voxel_size);
+
 } // namespace ipc
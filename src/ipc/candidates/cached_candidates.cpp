@@ -0,0 +1,134 @@
+#include "cached_candidates.hpp"
+
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ipc {
+
+// NOTE: Building with an inflation of r + skin / 2 finds every pair of
+// elements within a distance of 2r + skin. If no vertex moved more than
+// skin / 2, then the distance between any two elements decreased by at most
+// skin, so every pair within a distance of 2r is still in the superset.
+
+bool CachedCandidates::update(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method)
+{
+    if (is_valid(vertices, inflation_radius, broad_phase_method)) {
+        return false;
+    }
+
+    m_candidates.build(
+        mesh, vertices, inflation_radius + skin / 2, broad_phase_method);
+
+    m_reference_vertices_t0 = vertices;
+    m_reference_vertices_t1.resize(0, 0);
+    m_inflation_radius = inflation_radius;
+    m_skin = skin;
+    m_broad_phase_method = broad_phase_method;
+    m_is_continuous = false;
+    m_num_builds++;
+    return true;
+}
+
+bool CachedCandidates::update(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method)
+{
+    if (is_valid(
+            vertices_t0, vertices_t1, inflation_radius, broad_phase_method)) {
+        return false;
+    }
+
+    m_candidates.build(
+        mesh, vertices_t0, vertices_t1, inflation_radius + skin / 2,
+        broad_phase_method);
+
+    m_reference_vertices_t0 = vertices_t0;
+    m_reference_vertices_t1 = vertices_t1;
+    m_inflation_radius = inflation_radius;
+    m_skin = skin;
+    m_broad_phase_method = broad_phase_method;
+    m_is_continuous = true;
+    m_num_builds++;
+    return true;
+}
+
+bool CachedCandidates::is_valid(
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method) const
+{
+    return is_compatible(vertices, inflation_radius, broad_phase_method, false)
+        && max_displacement(vertices, m_reference_vertices_t0) <= m_skin / 2;
+}
+
+bool CachedCandidates::is_valid(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method) const
+{
+    // The displacement along the linear trajectories is bounded by the
+    // displacement of the endpoints.
+    return is_compatible(
+               vertices_t0, inflation_radius, broad_phase_method, true)
+        && vertices_t1.rows() == m_reference_vertices_t1.rows()
+        && vertices_t1.cols() == m_reference_vertices_t1.cols()
+        && max_displacement(vertices_t0, m_reference_vertices_t0) <= m_skin / 2
+        && max_displacement(vertices_t1, m_reference_vertices_t1) <= m_skin / 2;
+}
+
+void CachedCandidates::clear()
+{
+    m_candidates.clear();
+    m_reference_vertices_t0.resize(0, 0);
+    m_reference_vertices_t1.resize(0, 0);
+    m_inflation_radius = -1;
+}
+
+double CachedCandidates::max_displacement(
+    const Eigen::MatrixXd& vertices, const Eigen::MatrixXd& reference_vertices)
+{
+    assert(vertices.rows() == reference_vertices.rows());
+    assert(vertices.cols() == reference_vertices.cols());
+
+    const double max_displacement_sqr = tbb::parallel_reduce(
+        tbb::blocked_range<long>(0l, long(vertices.rows())), 0.0,
+        [&](const tbb::blocked_range<long>& r, double partial_max) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                partial_max = std::max(
+                    partial_max,
+                    (vertices.row(i) - reference_vertices.row(i))
+                        .squaredNorm());
+            }
+            return partial_max;
+        },
+        [](double a, double b) { return std::max(a, b); });
+
+    return std::sqrt(max_displacement_sqr);
+}
+
+bool CachedCandidates::is_compatible(
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method,
+    const bool is_continuous) const
+{
+    // A larger inflation radius or a new skin needs a new broad phase.
+    return m_inflation_radius >= 0 && is_continuous == m_is_continuous
+        && inflation_radius <= m_inflation_radius && skin == m_skin
+        && broad_phase_method == m_broad_phase_method
+        && vertices.rows() == m_reference_vertices_t0.rows()
+        && vertices.cols() == m_reference_vertices_t0.cols();
+}
+
+} // namespace ipc
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <ipc/candidates/candidates.hpp>
+
+#include <Eigen/Core>
+
+namespace ipc {
+
+/// @brief Collision candidates reused between builds (i.e., a Verlet list).
+///
+/// The broad phase is run with an extra skin distance around every element,
+/// so the resulting superset of candidates stays valid until some vertex has
+/// moved more than skin / 2 from where the broad phase was last run.
+class CachedCandidates {
+public:
+    /// @brief Construct cached candidates.
+    /// @param skin Extra distance between elements covered by the candidates.
+    explicit CachedCandidates(const double skin = 0) : skin(skin) { }
+
+    /// @brief Update the set of discrete collision detection candidates.
+    /// @note The broad phase is only run if the cached candidates are invalid.
+    /// @param mesh The surface of the contact mesh.
+    /// @param vertices Surface Vertex vertices at start as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    /// @return True if the broad phase was run.
+    bool update(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius = 0,
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
+    /// @brief Update the set of continuous collision detection candidates.
+    /// @note The broad phase is only run if the cached candidates are invalid.
+    /// @note Assumes the trajectory is linear.
+    /// @param mesh The surface of the contact mesh.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    /// @return True if the broad phase was run.
+    bool update(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius = 0,
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
+    /// @brief Determine if the cached discrete candidates can be reused.
+    /// @param vertices Surface Vertex vertices at start as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    /// @return True if no vertex moved more than skin / 2.
+    bool is_valid(
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius = 0,
+        const BroadPhaseMethod broad_phase_method =
+            DEFAULT_BROAD_PHASE_METHOD) const;
+
+    /// @brief Determine if the cached continuous candidates can be reused.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    /// @return True if no vertex moved more than skin / 2.
+    bool is_valid(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius = 0,
+        const BroadPhaseMethod broad_phase_method =
+            DEFAULT_BROAD_PHASE_METHOD) const;
+
+    /// @brief Get the cached superset of candidates.
+    const Candidates& candidates() const { return m_candidates; }
+
+    /// @brief Get the number of times the broad phase was run.
+    size_t num_builds() const { return m_num_builds; }
+
+    /// @brief Clear the cached candidates, so the next update runs the broad phase.
+    void clear();
+
+public:
+    /// @brief Extra distance between elements covered by the candidates.
+    double skin;
+
+protected:
+    /// @brief Compute the largest distance any vertex moved from its reference position.
+    static double max_displacement(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXd& reference_vertices);
+
+    /// @brief Determine if the cache was built with compatible settings.
+    bool is_compatible(
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius,
+        const BroadPhaseMethod broad_phase_method,
+        const bool is_continuous) const;
+
+    /// @brief The cached superset of candidates.
+    Candidates m_candidates;
+    /// @brief Vertex positions at the start when the broad phase was run.
+    Eigen::MatrixXd m_reference_vertices_t0;
+    /// @brief Vertex positions at the end when the broad phase was run (continuous only).
+    Eigen::MatrixXd m_reference_vertices_t1;
+    /// @brief Inflation radius the cached candidates were built with (excluding the skin).
+    double m_inflation_radius = -1;
+    /// @brief Skin the cached candidates were built with.
+    double m_skin = 0;
+    /// @brief Broad phase method the cached candidates were built with.
+    BroadPhaseMethod m_broad_phase_method = DEFAULT_BROAD_PHASE_METHOD;
+    /// @brief Whether the cached candidates are for continuous collision detection.
+    bool m_is_continuous = false;
+    /// @brief Number of times the broad phase was run.
+    size_t m_num_builds = 0;
+};
+
+} // namespace ipc
@@ -1,18 +1,50 @@
 #include "candidates.hpp"
 
+#include <ipc/candidates/narrow_phase.hpp>
 #include <ipc/utils/save_obj.hpp>
 
 #include <ipc/config.hpp>
 
-#include <tbb/parallel_for.h>
-#include <tbb/blocked_range.h>
-#include <tbb/enumerable_thread_specific.h>
-#include <shared_mutex>
+#include <tbb/parallel_sort.h>
 
 #include <fstream>
+#include <stdexcept>
 
 namespace ipc {
 
+namespace {
+    /// @brief Sort the candidates so their order does not depend on the
+    /// scheduling of the (parallel) broad phase.
+    void sort_candidates(Candidates& candidates)
+    {
+        tbb::parallel_sort(
+            candidates.ev_candidates.begin(), candidates.ev_candidates.end());
+        tbb::parallel_sort(
+            candidates.ee_candidates.begin(), candidates.ee_candidates.end());
+        tbb::parallel_sort(
+            candidates.fv_candidates.begin(), candidates.fv_candidates.end());
+    }
+
+    /// @brief Call a function with the i-th candidate.
+    /// @param candidates The candidates.
+    /// @param i Index of the candidate (in the order ev, ee, fv).
+    /// @param f Function called with the candidate and the number of vertices of its first element.
+    template <typename Function>
+    auto visit_candidate(
+        const Candidates& candidates, size_t i, const Function& f)
+    {
+        if (i < candidates.ev_candidates.size()) {
+            return f(candidates.ev_candidates[i], /*n_first=*/1);
+        }
+        i -= candidates.ev_candidates.size();
+        if (i < candidates.ee_candidates.size()) {
+            return f(candidates.ee_candidates[i], /*n_first=*/2);
+        }
+        i -= candidates.ee_candidates.size();
+        return f(candidates.fv_candidates.at(i), /*n_first=*/1);
+    }
+} // namespace
+
 void Candidates::build(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices,
@@ -24,11 +56,12 @@ void Candidates::build(
     clear();
 
     std::unique_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
+        BroadPhase::make_broad_phase(broad_phase_method, mesh);
     broad_phase->build(vertices, mesh.edges(), mesh.faces(), inflation_radius);
     broad_phase->detect_collision_candidates(dim, *this);
     broad_phase->clear();
+
+    sort_candidates(*this);
 }
 
 void Candidates::build(
@@ -36,94 +69,91 @@ void Candidates::build(
     const Eigen::MatrixXd& vertices_t0,
     const Eigen::MatrixXd& vertices_t1,
     const double inflation_radius,
-    const BroadPhaseMethod broad_phase_method)
+    const BroadPhaseMethod broad_phase_method,
+    const int max_temporal_subdivisions)
 {
     const int dim = vertices_t0.cols();
 
     clear();
 
     std::unique_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
+        BroadPhase::make_broad_phase(broad_phase_method, mesh);
     broad_phase->build(
         vertices_t0, vertices_t1, mesh.edges(), mesh.faces(), inflation_radius);
     broad_phase->detect_collision_candidates(dim, *this);
     broad_phase->clear();
+
+    sort_candidates(*this);
+
+    if (max_temporal_subdivisions > 1) {
+        filter_by_temporal_subdivision(
+            mesh, vertices_t0, vertices_t1, inflation_radius,
+            max_temporal_subdivisions);
+    }
 }
 
-bool Candidates::is_step_collision_free(
+void Candidates::filter_by_temporal_subdivision(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices_t0,
     const Eigen::MatrixXd& vertices_t1,
-    const double min_distance,
-    const double tolerance,
-    const long max_iterations) const
+    const double inflation_radius,
+    const int max_subdivisions)
 {
     assert(vertices_t0.rows() == mesh.num_vertices());
     assert(vertices_t1.rows() == mesh.num_vertices());
 
-    // Narrow phase
-    for (size_t i = 0; i < size(); i++) {
-        double toi;
-        bool is_collision = (*this)[i].ccd(
-            vertices_t0, vertices_t1, mesh.edges(), mesh.faces(), toi,
-            min_distance,
-            /*tmax=*/1.0, tolerance, max_iterations);
-
-        if (is_collision) {
-            return false;
-        }
+    if (max_subdivisions <= 1) {
+        return;
     }
 
-    return true;
+    // The first vertex of edge-vertex and face-vertex candidates and the first
+    // two vertices of edge-edge candidates belong to the first element.
+    const auto vertex_ids = [&](const auto& c) {
+        return c.vertex_ids(mesh.edges(), mesh.faces());
+    };
+    filter_candidates_by_temporal_subdivision(
+        ev_candidates, vertex_ids, vertices_t0, vertices_t1, /*n_first=*/1,
+        inflation_radius, max_subdivisions);
+    filter_candidates_by_temporal_subdivision(
+        ee_candidates, vertex_ids, vertices_t0, vertices_t1, /*n_first=*/2,
+        inflation_radius, max_subdivisions);
+    filter_candidates_by_temporal_subdivision(
+        fv_candidates, vertex_ids, vertices_t0, vertices_t1, /*n_first=*/1,
+        inflation_radius, max_subdivisions);
 }
 
-double Candidates::compute_collision_free_stepsize(
+bool Candidates::is_step_collision_free(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices_t0,
     const Eigen::MatrixXd& vertices_t1,
     const double min_distance,
     const double tolerance,
-    const long max_iterations) const
+    const long max_iterations,
+    const CCDPrefilterOptions& prefilter,
+    CCDPrefilterStatistics* prefilter_statistics) const
 {
-    assert(vertices_t0.rows() == mesh.num_vertices());
-    assert(vertices_t1.rows() == mesh.num_vertices());
-
-    if (empty()) {
-        return 1; // No possible collisions, so can take full step.
-    }
+    return narrow_phase_is_step_collision_free(
+        size(),
+        [&](size_t i, const auto& f) { return visit_candidate(*this, i, f); },
+        mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+        max_iterations, prefilter, prefilter_statistics);
+}
 
-    double earliest_toi = 1;
-    std::shared_mutex earliest_toi_mutex;
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, size()),
-        [&](tbb::blocked_range<size_t> r) {
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                // Use the mutex to read as well in case writing double takes
-                // more than one clock cycle.
-                double tmax;
-                {
-                    std::shared_lock lock(earliest_toi_mutex);
-                    tmax = earliest_toi;
-                }
-
-                double toi = std::numeric_limits<double>::infinity(); // output
-                const bool are_colliding = (*this)[i].ccd(
-                    vertices_t0, vertices_t1, mesh.edges(), mesh.faces(), toi,
-                    min_distance, tmax, tolerance, max_iterations);
-
-                if (are_colliding) {
-                    std::unique_lock lock(earliest_toi_mutex);
-                    if (toi < earliest_toi) {
-                        earliest_toi = toi;
-                    }
-                }
-            }
-        });
-
-    assert(earliest_toi >= 0 && earliest_toi <= 1.0);
-    return earliest_toi;
+double Candidates::compute_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const CCDPrefilterOptions& prefilter,
+    CCDPrefilterStatistics* prefilter_statistics) const
+{
+    return narrow_phase_collision_free_stepsize(
+        size(),
+        [&](size_t i, const auto& f) { return visit_candidate(*this, i, f); },
+        mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+        max_iterations, prefilter, prefilter_statistics);
 }
 
 size_t Candidates::size() const
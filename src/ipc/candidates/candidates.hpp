@@ -4,6 +4,7 @@
 #include <ipc/candidates/edge_vertex.hpp>
 #include <ipc/candidates/edge_edge.hpp>
 #include <ipc/candidates/face_vertex.hpp>
+#include <ipc/ccd/ccd_prefilter.hpp>
 
 #include <Eigen/Core>
 
@@ -33,12 +34,28 @@ public:
     /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
     /// @param inflation_radius Amount to inflate the bounding boxes.
     /// @param broad_phase_method Broad phase method to use.
+    /// @param max_temporal_subdivisions Maximum number of sub-intervals used to cull the candidates (see filter_by_temporal_subdivision). A value of 1 disables the culling.
     void build(
         const CollisionMesh& mesh,
         const Eigen::MatrixXd& vertices_t0,
         const Eigen::MatrixXd& vertices_t1,
         const double inflation_radius = 0,
-        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
+        const int max_temporal_subdivisions = 1);
+
+    /// @brief Remove the candidates whose swept boxes do not overlap during any common sub-interval of time.
+    /// @note The number of sub-intervals of each candidate is chosen adaptively as the ratio of its vertices' displacement to the size of its elements (clamped to [1, max_subdivisions]). This removes most false positives of fast-moving elements while keeping every candidate that can collide.
+    /// @param mesh The surface of the contact mesh.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param max_subdivisions Maximum number of sub-intervals of [0, 1].
+    void filter_by_temporal_subdivision(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius,
+        const int max_subdivisions);
 
     size_t size() const;
 
@@ -57,6 +74,8 @@ public:
     /// @param min_distance The minimum distance allowable between any two elements.
     /// @param tolerance The tolerance for the CCD algorithm.
     /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @param prefilter Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+    /// @param[out] prefilter_statistics If not null, the number of candidates tested and rejected by each prefilter.
     /// @returns True if <b>any</b> collisions occur.
     bool is_step_collision_free(
         const CollisionMesh& mesh,
@@ -64,7 +83,9 @@ public:
         const Eigen::MatrixXd& vertices_t1,
         const double min_distance = 0.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
-        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS) const;
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        const CCDPrefilterOptions& prefilter = CCDPrefilterOptions(),
+        CCDPrefilterStatistics* prefilter_statistics = nullptr) const;
 
     /// @brief Computes a maximal step size that is collision free using the set of collision candidates.
     /// @note Assumes the trajectory is linear.
@@ -74,6 +95,8 @@ public:
     /// @param min_distance The minimum distance allowable between any two elements.
     /// @param tolerance The tolerance for the CCD algorithm.
     /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @param prefilter Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+    /// @param[out] prefilter_statistics If not null, the number of candidates tested and rejected by each prefilter.
     /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
     double compute_collision_free_stepsize(
         const CollisionMesh& mesh,
@@ -81,7 +104,9 @@ public:
         const Eigen::MatrixXd& vertices_t1,
         const double min_distance = 0.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
-        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS) const;
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        const CCDPrefilterOptions& prefilter = CCDPrefilterOptions(),
+        CCDPrefilterStatistics* prefilter_statistics = nullptr) const;
 
     bool save_obj(
         const std::string& filename,
@@ -0,0 +1,309 @@
+#include "compact_candidates.hpp"
+
+#include <ipc/candidates/narrow_phase.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+    /// @brief Stream candidates from the broad phase into a compact list.
+    /// @param stream Function streaming the batches of candidates to a callback.
+    /// @param to_compact Function converting a candidate to compact storage.
+    /// @param[out] compact_candidates The compact candidates (unsorted).
+    template <typename Candidate, typename StreamFunction, typename ToCompact>
+    void stream_compact_candidates(
+        const StreamFunction& stream,
+        const ToCompact& to_compact,
+        std::vector<CompactCandidate>& compact_candidates)
+    {
+        tbb::enumerable_thread_specific<std::vector<CompactCandidate>> storage;
+
+        stream([&](const size_t, const std::vector<Candidate>& batch) {
+            std::vector<CompactCandidate>& local_candidates = storage.local();
+            for (const Candidate& candidate : batch) {
+                local_candidates.push_back(to_compact(candidate));
+            }
+        });
+
+        size_t num_candidates = 0;
+        for (const auto& local_candidates : storage) {
+            num_candidates += local_candidates.size();
+        }
+        compact_candidates.clear();
+        compact_candidates.reserve(num_candidates);
+        for (const auto& local_candidates : storage) {
+            compact_candidates.insert(
+                compact_candidates.end(), local_candidates.begin(),
+                local_candidates.end());
+        }
+    }
+
+    /// @brief Sort a compact list and remove duplicates.
+    void sort_and_unique(std::vector<CompactCandidate>& candidates)
+    {
+        tbb::parallel_sort(candidates.begin(), candidates.end());
+        candidates.erase(
+            std::unique(candidates.begin(), candidates.end()),
+            candidates.end());
+    }
+
+    /// @brief Call a function with the i-th candidate materialized on the stack.
+    /// @param candidates The compact candidates.
+    /// @param i Index of the candidate (in the order ev, ee, fv).
+    /// @param f Function called with the candidate and the number of vertices of its first element.
+    template <typename Function>
+    auto visit_candidate(
+        const CompactCandidates& candidates, size_t i, const Function& f)
+    {
+        if (i < candidates.ev_candidates.size()) {
+            const CompactCandidate& c = candidates.ev_candidates[i];
+            return f(EdgeVertexCandidate(c.id0, c.id1), /*n_first=*/1);
+        }
+        i -= candidates.ev_candidates.size();
+        if (i < candidates.ee_candidates.size()) {
+            const CompactCandidate& c = candidates.ee_candidates[i];
+            return f(EdgeEdgeCandidate(c.id0, c.id1), /*n_first=*/2);
+        }
+        i -= candidates.ee_candidates.size();
+        const CompactCandidate& c = candidates.fv_candidates.at(i);
+        return f(FaceVertexCandidate(c.id0, c.id1), /*n_first=*/1);
+    }
+} // namespace
+
+CompactCandidate CompactCandidate::make(const long id0, const long id1)
+{
+    constexpr long max_id = std::numeric_limits<uint32_t>::max();
+    if (id0 < 0 || id1 < 0 || id0 > max_id || id1 > max_id) {
+        throw std::out_of_range(
+            "Element id does not fit in a compact candidate!");
+    }
+    return { uint32_t(id0), uint32_t(id1) };
+}
+
+CompactCandidates::CompactCandidates(const Candidates& candidates)
+{
+    ev_candidates.reserve(candidates.ev_candidates.size());
+    for (const EdgeVertexCandidate& ev : candidates.ev_candidates) {
+        ev_candidates.push_back(
+            CompactCandidate::make(ev.edge_id, ev.vertex_id));
+    }
+    ee_candidates.reserve(candidates.ee_candidates.size());
+    for (const EdgeEdgeCandidate& ee : candidates.ee_candidates) {
+        ee_candidates.push_back(
+            CompactCandidate::make(ee.edge0_id, ee.edge1_id));
+    }
+    fv_candidates.reserve(candidates.fv_candidates.size());
+    for (const FaceVertexCandidate& fv : candidates.fv_candidates) {
+        fv_candidates.push_back(
+            CompactCandidate::make(fv.face_id, fv.vertex_id));
+    }
+}
+
+void CompactCandidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method)
+{
+    clear();
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(broad_phase_method, mesh);
+    broad_phase->build(vertices, mesh.edges(), mesh.faces(), inflation_radius);
+    detect_candidates(vertices.cols(), *broad_phase);
+    broad_phase->clear();
+}
+
+void CompactCandidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method,
+    const int max_temporal_subdivisions)
+{
+    clear();
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(broad_phase_method, mesh);
+    broad_phase->build(
+        vertices_t0, vertices_t1, mesh.edges(), mesh.faces(), inflation_radius);
+    detect_candidates(vertices_t0.cols(), *broad_phase);
+    broad_phase->clear();
+
+    if (max_temporal_subdivisions > 1) {
+        filter_by_temporal_subdivision(
+            mesh, vertices_t0, vertices_t1, inflation_radius,
+            max_temporal_subdivisions);
+    }
+}
+
+void CompactCandidates::filter_by_temporal_subdivision(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double inflation_radius,
+    const int max_subdivisions)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    if (max_subdivisions <= 1) {
+        return;
+    }
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    // The first vertex of edge-vertex and face-vertex candidates and the first
+    // two vertices of edge-edge candidates belong to the first element.
+    filter_candidates_by_temporal_subdivision(
+        ev_candidates,
+        [&](const CompactCandidate& c) {
+            return EdgeVertexCandidate(c.id0, c.id1).vertex_ids(edges, faces);
+        },
+        vertices_t0, vertices_t1, /*n_first=*/1, inflation_radius,
+        max_subdivisions);
+    filter_candidates_by_temporal_subdivision(
+        ee_candidates,
+        [&](const CompactCandidate& c) {
+            return EdgeEdgeCandidate(c.id0, c.id1).vertex_ids(edges, faces);
+        },
+        vertices_t0, vertices_t1, /*n_first=*/2, inflation_radius,
+        max_subdivisions);
+    filter_candidates_by_temporal_subdivision(
+        fv_candidates,
+        [&](const CompactCandidate& c) {
+            return FaceVertexCandidate(c.id0, c.id1).vertex_ids(edges, faces);
+        },
+        vertices_t0, vertices_t1, /*n_first=*/1, inflation_radius,
+        max_subdivisions);
+}
+
+void CompactCandidates::detect_candidates(
+    const int dim, const BroadPhase& broad_phase)
+{
+    if (dim == 2) {
+        stream_compact_candidates<EdgeVertexCandidate>(
+            [&](const auto& callback) {
+                broad_phase.stream_edge_vertex_candidates(callback);
+            },
+            [](const EdgeVertexCandidate& ev) {
+                return CompactCandidate::make(ev.edge_id, ev.vertex_id);
+            },
+            ev_candidates);
+    } else {
+        stream_compact_candidates<EdgeEdgeCandidate>(
+            [&](const auto& callback) {
+                broad_phase.stream_edge_edge_candidates(callback);
+            },
+            [](const EdgeEdgeCandidate& ee) {
+                return CompactCandidate::make(ee.edge0_id, ee.edge1_id);
+            },
+            ee_candidates);
+        stream_compact_candidates<FaceVertexCandidate>(
+            [&](const auto& callback) {
+                broad_phase.stream_face_vertex_candidates(callback);
+            },
+            [](const FaceVertexCandidate& fv) {
+                return CompactCandidate::make(fv.face_id, fv.vertex_id);
+            },
+            fv_candidates);
+    }
+
+    sort_and_deduplicate();
+}
+
+Candidates CompactCandidates::to_candidates() const
+{
+    Candidates candidates;
+    candidates.ev_candidates.reserve(ev_candidates.size());
+    for (const CompactCandidate& c : ev_candidates) {
+        candidates.ev_candidates.emplace_back(c.id0, c.id1);
+    }
+    candidates.ee_candidates.reserve(ee_candidates.size());
+    for (const CompactCandidate& c : ee_candidates) {
+        candidates.ee_candidates.emplace_back(c.id0, c.id1);
+    }
+    candidates.fv_candidates.reserve(fv_candidates.size());
+    for (const CompactCandidate& c : fv_candidates) {
+        candidates.fv_candidates.emplace_back(c.id0, c.id1);
+    }
+    return candidates;
+}
+
+void CompactCandidates::sort_and_deduplicate()
+{
+    // (i, j) and (j, i) are the same edge-edge candidate.
+    for (CompactCandidate& c : ee_candidates) {
+        if (c.id1 < c.id0) {
+            std::swap(c.id0, c.id1);
+        }
+    }
+
+    sort_and_unique(ev_candidates);
+    sort_and_unique(ee_candidates);
+    sort_and_unique(fv_candidates);
+}
+
+size_t CompactCandidates::size() const
+{
+    return ev_candidates.size() + ee_candidates.size() + fv_candidates.size();
+}
+
+bool CompactCandidates::empty() const
+{
+    return ev_candidates.empty() && ee_candidates.empty()
+        && fv_candidates.empty();
+}
+
+void CompactCandidates::clear()
+{
+    ev_candidates.clear();
+    ee_candidates.clear();
+    fv_candidates.clear();
+}
+
+bool CompactCandidates::is_step_collision_free(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const CCDPrefilterOptions& prefilter,
+    CCDPrefilterStatistics* prefilter_statistics) const
+{
+    return narrow_phase_is_step_collision_free(
+        size(),
+        [&](size_t i, const auto& f) { return visit_candidate(*this, i, f); },
+        mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+        max_iterations, prefilter, prefilter_statistics);
+}
+
+double CompactCandidates::compute_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const CCDPrefilterOptions& prefilter,
+    CCDPrefilterStatistics* prefilter_statistics) const
+{
+    return narrow_phase_collision_free_stepsize(
+        size(),
+        [&](size_t i, const auto& f) { return visit_candidate(*this, i, f); },
+        mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+        max_iterations, prefilter, prefilter_statistics);
+}
+
+} // namespace ipc
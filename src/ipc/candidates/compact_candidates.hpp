@@ -0,0 +1,176 @@
+#pragma once
+
+#include <ipc/candidates/candidates.hpp>
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Plain-old-data candidate of two element ids.
+///
+/// The meaning of the ids depends on the list storing the candidate (e.g.,
+/// edge and vertex ids for edge-vertex candidates). Unlike the polymorphic
+/// candidate classes, it has no vtable pointers, so sorting, deduplicating,
+/// and iterating over large sets of candidates move far less memory.
+struct CompactCandidate {
+    /// @brief Id of the first element.
+    uint32_t id0;
+    /// @brief Id of the second element.
+    uint32_t id1;
+
+    bool operator==(const CompactCandidate& other) const
+    {
+        return id0 == other.id0 && id1 == other.id1;
+    }
+
+    bool operator!=(const CompactCandidate& other) const
+    {
+        return !(*this == other);
+    }
+
+    /// @brief Compare the candidates lexicographically by (id0, id1).
+    bool operator<(const CompactCandidate& other) const
+    {
+        return id0 < other.id0 || (id0 == other.id0 && id1 < other.id1);
+    }
+
+    /// @brief Make a compact candidate from two element ids.
+    /// @throws std::out_of_range if an id does not fit in 32 bits.
+    static CompactCandidate make(const long id0, const long id1);
+};
+
+static_assert(
+    sizeof(CompactCandidate) == 2 * sizeof(uint32_t)
+        && std::is_trivially_copyable_v<CompactCandidate>,
+    "CompactCandidate must be a tightly packed plain-old-data type");
+
+/// @brief Continuous collision detection candidates stored as plain-old-data.
+///
+/// Equivalent to Candidates, but each candidate only takes two 32-bit ids.
+/// The polymorphic candidate objects are only materialized on the stack when
+/// running the narrow phase.
+class CompactCandidates {
+public:
+    CompactCandidates() { }
+
+    /// @brief Convert a set of candidates to compact storage.
+    /// @param candidates The candidates to convert.
+    explicit CompactCandidates(const Candidates& candidates);
+
+    /// @brief Initialize the set of discrete collision detection candidates.
+    /// @note The broad phase streams its results directly into compact storage.
+    /// @param mesh The surface of the contact mesh.
+    /// @param vertices Surface Vertex vertices at start as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    void build(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius = 0,
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
+    /// @brief Initialize the set of continuous collision detection candidates.
+    /// @note Assumes the trajectory is linear.
+    /// @param mesh The surface of the contact mesh.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    /// @param max_temporal_subdivisions Maximum number of sub-intervals used to cull the candidates (see filter_by_temporal_subdivision). A value of 1 disables the culling.
+    void build(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius = 0,
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
+        const int max_temporal_subdivisions = 1);
+
+    /// @brief Remove the candidates whose swept boxes do not overlap during any common sub-interval of time.
+    /// @note See Candidates::filter_by_temporal_subdivision.
+    /// @param mesh The surface of the contact mesh.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param max_subdivisions Maximum number of sub-intervals of [0, 1].
+    void filter_by_temporal_subdivision(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius,
+        const int max_subdivisions);
+
+    /// @brief Expand the compact candidates into the polymorphic candidates.
+    Candidates to_candidates() const;
+
+    /// @brief Sort the candidates and remove duplicates.
+    /// @note Edge-edge candidates are symmetric, so they are stored with id0 ≤ id1.
+    void sort_and_deduplicate();
+
+    size_t size() const;
+
+    bool empty() const;
+
+    void clear();
+
+    /// @brief Determine if the step is collision free from the set of candidates.
+    /// @note Assumes the trajectory is linear.
+    /// @param mesh The collision mesh.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param min_distance The minimum distance allowable between any two elements.
+    /// @param tolerance The tolerance for the CCD algorithm.
+    /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @param prefilter Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+    /// @param[out] prefilter_statistics If not null, the number of candidates tested and rejected by each prefilter.
+    /// @returns True if <b>no</b> collisions occur.
+    bool is_step_collision_free(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double min_distance = 0.0,
+        const double tolerance = DEFAULT_CCD_TOLERANCE,
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        const CCDPrefilterOptions& prefilter = CCDPrefilterOptions(),
+        CCDPrefilterStatistics* prefilter_statistics = nullptr) const;
+
+    /// @brief Computes a maximal step size that is collision free using the set of collision candidates.
+    /// @note Assumes the trajectory is linear.
+    /// @param mesh The collision mesh.
+    /// @param vertices_t0 Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param min_distance The minimum distance allowable between any two elements.
+    /// @param tolerance The tolerance for the CCD algorithm.
+    /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @param prefilter Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+    /// @param[out] prefilter_statistics If not null, the number of candidates tested and rejected by each prefilter.
+    /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+    double compute_collision_free_stepsize(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double min_distance = 0.0,
+        const double tolerance = DEFAULT_CCD_TOLERANCE,
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        const CCDPrefilterOptions& prefilter = CCDPrefilterOptions(),
+        CCDPrefilterStatistics* prefilter_statistics = nullptr) const;
+
+public:
+    /// @brief Edge-vertex candidates as (edge id, vertex id).
+    std::vector<CompactCandidate> ev_candidates;
+    /// @brief Edge-edge candidates as (edge id, edge id).
+    std::vector<CompactCandidate> ee_candidates;
+    /// @brief Face-vertex candidates as (face id, vertex id).
+    std::vector<CompactCandidate> fv_candidates;
+
+protected:
+    /// @brief Stream the candidates of a built broad phase into compact storage.
+    /// @param dim The dimension of the simulation (i.e., 2 or 3).
+    /// @param broad_phase The built broad phase.
+    void detect_candidates(const int dim, const BroadPhase& broad_phase);
+};
+
+} // namespace ipc
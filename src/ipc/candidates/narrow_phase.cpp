@@ -0,0 +1,87 @@
+#include "narrow_phase.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ipc {
+
+bool do_subdivided_swept_boxes_overlap(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const double inflation_radius,
+    const int max_subdivisions)
+{
+    const int dim = vertices_t0.cols();
+    const int n = ids[3] < 0 ? 3 : 4;
+
+    // Choose the number of sub-intervals from the ratio of the
+    // displacement to the size of the elements.
+    double displacement = 0, max_abs_coord = 0;
+    ArrayMax3d min_a = ArrayMax3d::Constant(dim, INFINITY),
+               max_a = ArrayMax3d::Constant(dim, -INFINITY);
+    ArrayMax3d min_b = min_a, max_b = max_a;
+    for (int i = 0; i < n; i++) {
+        const auto x0 = vertices_t0.row(ids[i]).array();
+        const auto x1 = vertices_t1.row(ids[i]).array();
+        displacement = std::max(displacement, (x1 - x0).abs().maxCoeff());
+        max_abs_coord = std::max(
+            { max_abs_coord, x0.abs().maxCoeff(), x1.abs().maxCoeff() });
+        if (i < n_first) {
+            min_a = min_a.min(x0.transpose());
+            max_a = max_a.max(x0.transpose());
+        } else {
+            min_b = min_b.min(x0.transpose());
+            max_b = max_b.max(x0.transpose());
+        }
+    }
+    if (displacement == 0) {
+        return true; // The broad phase already checked the full sweep.
+    }
+    const double size = std::max(
+                            (max_a - min_a).maxCoeff(),
+                            (max_b - min_b).maxCoeff())
+        + 2 * inflation_radius;
+    const int k = size > 0
+        ? int(std::clamp(
+            std::ceil(displacement / size), 1.0, double(max_subdivisions)))
+        : max_subdivisions;
+    if (k <= 1) {
+        return true; // The broad phase already checked the full sweep.
+    }
+
+    // Pad the boxes to account for the rounding of the interpolation.
+    const double padding = inflation_radius
+        + 4 * std::numeric_limits<double>::epsilon() * max_abs_coord;
+
+    for (int j = 0; j < k; j++) {
+        const double ta = double(j) / k, tb = double(j + 1) / k;
+        min_a.setConstant(INFINITY);
+        max_a.setConstant(-INFINITY);
+        min_b.setConstant(INFINITY);
+        max_b.setConstant(-INFINITY);
+        for (int i = 0; i < n; i++) {
+            const auto x0 = vertices_t0.row(ids[i]).array().transpose();
+            const auto dx =
+                (vertices_t1.row(ids[i]) - vertices_t0.row(ids[i]))
+                    .array()
+                    .transpose();
+            const ArrayMax3d xa = x0 + ta * dx, xb = x0 + tb * dx;
+            if (i < n_first) {
+                min_a = min_a.min(xa).min(xb);
+                max_a = max_a.max(xa).max(xb);
+            } else {
+                min_b = min_b.min(xa).min(xb);
+                max_b = max_b.max(xa).max(xb);
+            }
+        }
+        if ((min_a - padding <= max_b + padding).all()
+            && (min_b - padding <= max_a + padding).all()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace ipc
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/ccd/ccd_prefilter.hpp>
+
+#include <Eigen/Core>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+
+#include <array>
+#include <limits>
+#include <shared_mutex>
+#include <vector>
+
+// Narrow phase shared by Candidates and CompactCandidates. The candidates are
+// accessed through a visitor, visit(i, f), which calls f(candidate, n_first)
+// with the i-th candidate and the number of vertices of its first element and
+// returns the result of f.
+
+namespace ipc {
+
+/// @brief Determine if the swept boxes of a candidate's two elements overlap during any common sub-interval of time.
+/// @param vertices_t0 Vertex positions at the start of the time step.
+/// @param vertices_t1 Vertex positions at the end of the time step.
+/// @param ids Vertex ids of the candidate (-1 for unused vertices).
+/// @param n_first Number of vertices of the first element.
+/// @param inflation_radius Amount to inflate the bounding boxes.
+/// @param max_subdivisions Maximum number of sub-intervals of [0, 1].
+/// @return False if the candidate certainly cannot collide.
+bool do_subdivided_swept_boxes_overlap(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const double inflation_radius,
+    const int max_subdivisions);
+
+/// @brief Remove the candidates that cannot collide during any common sub-interval of time.
+/// @note The order of the remaining candidates is preserved.
+/// @param[in,out] candidates The candidates to filter.
+/// @param vertex_ids Function returning the vertex ids of a candidate.
+/// @param vertices_t0 Vertex positions at the start of the time step.
+/// @param vertices_t1 Vertex positions at the end of the time step.
+/// @param n_first Number of vertices of the first element of each candidate.
+/// @param inflation_radius Amount to inflate the bounding boxes.
+/// @param max_subdivisions Maximum number of sub-intervals of [0, 1].
+template <typename Candidate, typename VertexIds>
+void filter_candidates_by_temporal_subdivision(
+    std::vector<Candidate>& candidates,
+    const VertexIds& vertex_ids,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const int n_first,
+    const double inflation_radius,
+    const int max_subdivisions)
+{
+    std::vector<char> keep(candidates.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), candidates.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                keep[i] = do_subdivided_swept_boxes_overlap(
+                    vertices_t0, vertices_t1, vertex_ids(candidates[i]),
+                    n_first, inflation_radius, max_subdivisions);
+            }
+        });
+
+    // Compact in place to preserve the (sorted) order of the candidates.
+    size_t n_kept = 0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (keep[i]) {
+            candidates[n_kept++] = candidates[i];
+        }
+    }
+    candidates.erase(candidates.begin() + n_kept, candidates.end());
+}
+
+/// @brief Determine if the step is collision free from a set of candidates.
+/// @param num_candidates Number of candidates.
+/// @param visit Visitor of the i-th candidate (see above).
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @param prefilter Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+/// @param[out] prefilter_statistics If not null, the number of candidates tested and rejected by each prefilter.
+/// @returns True if <b>no</b> collisions occur.
+template <typename Visitor>
+bool narrow_phase_is_step_collision_free(
+    const size_t num_candidates,
+    const Visitor& visit,
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const CCDPrefilterOptions& prefilter,
+    CCDPrefilterStatistics* prefilter_statistics)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    CCDPrefilterStatistics statistics;
+
+    // Narrow phase
+    bool is_collision_free = true;
+    for (size_t i = 0; i < num_candidates; i++) {
+        const bool is_collision =
+            visit(i, [&](const auto& candidate, const int n_first) {
+                if (prefilter.any()) {
+                    const CCDPrefilterResult result = apply_ccd_prefilters(
+                        vertices_t0, vertices_t1,
+                        candidate.vertex_ids(edges, faces), n_first,
+                        min_distance, prefilter);
+                    statistics.record(result);
+                    if (result != CCDPrefilterResult::NOT_REJECTED) {
+                        return false;
+                    }
+                }
+                double toi;
+                return candidate.ccd(
+                    vertices_t0, vertices_t1, edges, faces, toi, min_distance,
+                    /*tmax=*/1.0, tolerance, max_iterations);
+            });
+
+        if (is_collision) {
+            is_collision_free = false;
+            break;
+        }
+    }
+
+    if (prefilter_statistics != nullptr) {
+        *prefilter_statistics = statistics;
+    }
+
+    return is_collision_free;
+}
+
+/// @brief Computes a maximal step size that is collision free using a set of candidates.
+/// @param num_candidates Number of candidates.
+/// @param visit Visitor of the i-th candidate (see above).
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @param prefilter Cheap conservative tests used to skip the narrow phase of candidates that cannot collide.
+/// @param[out] prefilter_statistics If not null, the number of candidates tested and rejected by each prefilter.
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+template <typename Visitor>
+double narrow_phase_collision_free_stepsize(
+    const size_t num_candidates,
+    const Visitor& visit,
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const CCDPrefilterOptions& prefilter,
+    CCDPrefilterStatistics* prefilter_statistics)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    if (prefilter_statistics != nullptr) {
+        *prefilter_statistics = CCDPrefilterStatistics();
+    }
+
+    if (num_candidates == 0) {
+        return 1; // No possible collisions, so can take full step.
+    }
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    double earliest_toi = 1;
+    std::shared_mutex earliest_toi_mutex;
+
+    tbb::enumerable_thread_specific<CCDPrefilterStatistics> storage;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_candidates),
+        [&](tbb::blocked_range<size_t> r) {
+            CCDPrefilterStatistics& local_statistics = storage.local();
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                visit(i, [&](const auto& candidate, const int n_first) {
+                    if (prefilter.any()) {
+                        const CCDPrefilterResult result = apply_ccd_prefilters(
+                            vertices_t0, vertices_t1,
+                            candidate.vertex_ids(edges, faces), n_first,
+                            min_distance, prefilter);
+                        local_statistics.record(result);
+                        if (result != CCDPrefilterResult::NOT_REJECTED) {
+                            return;
+                        }
+                    }
+
+                    // Use the mutex to read as well in case writing double
+                    // takes more than one clock cycle.
+                    double tmax;
+                    {
+                        std::shared_lock lock(earliest_toi_mutex);
+                        tmax = earliest_toi;
+                    }
+
+                    double toi = std::numeric_limits<double>::infinity();
+                    const bool are_colliding = candidate.ccd(
+                        vertices_t0, vertices_t1, edges, faces, toi,
+                        min_distance, tmax, tolerance, max_iterations);
+
+                    if (are_colliding) {
+                        std::unique_lock lock(earliest_toi_mutex);
+                        if (toi < earliest_toi) {
+                            earliest_toi = toi;
+                        }
+                    }
+                });
+            }
+        });
+
+    if (prefilter_statistics != nullptr) {
+        for (const CCDPrefilterStatistics& local_statistics : storage) {
+            *prefilter_statistics += local_statistics;
+        }
+    }
+
+    assert(earliest_toi >= 0 && earliest_toi <= 1.0);
+    return earliest_toi;
+}
+
+} // namespace ipc
@@ -8,6 +8,7 @@
 #include <ipc/config.hpp>
 
 #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
+#include <ipc/ccd/closed_form_ccd.hpp>
 #include <tight_inclusion/ccd.hpp>
 #include <tight_inclusion/interval_root_finder.hpp>
 #else
@@ -29,6 +30,38 @@ static constexpr long TIGHT_INCLUSION_UNLIMITED_ITERATIONS = -1;
 /// @brief Tolerance for small time of impact which triggers rerunning CCD without a minimum separation.
 static constexpr double SMALL_TOI = 1e-6;
 
+#ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
+/// @brief Use the result of a closed-form CCD kernel if it is certain.
+/// @param result Result of the closed-form CCD kernel.
+/// @param closed_form_toi Time of impact computed by the closed-form kernel.
+/// @param no_zero_toi Refuse a time of impact of zero.
+/// @param[out] is_impacting If the elements are impacting.
+/// @param[out] toi Time of impact.
+/// @return True if the result is certain, false if a robust CCD is needed.
+inline bool use_closed_form_result(
+    const ClosedFormCCDResult result,
+    const double closed_form_toi,
+    const bool no_zero_toi,
+    bool& is_impacting,
+    double& toi)
+{
+    switch (result) {
+    case ClosedFormCCDResult::NO_IMPACT:
+        is_impacting = false;
+        return true;
+    case ClosedFormCCDResult::IMPACT:
+        if (no_zero_toi && closed_form_toi <= 0) {
+            return false;
+        }
+        is_impacting = true;
+        toi = closed_form_toi;
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
+
 bool ccd_strategy(
     const std::function<bool(
         long /*max_iterations*/,
@@ -111,6 +144,18 @@ bool point_point_ccd(
     const auto ccd = [&](long max_iterations, double min_distance,
                          bool no_zero_toi, double& toi) -> bool {
 #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
+        // The squared distance is a quadratic in time, so first try the
+        // filtered closed-form solution.
+        bool is_impacting;
+        double closed_form_toi;
+        if (use_closed_form_result(
+                closed_form_point_point_ccd(
+                    p0_t0, p1_t0, p0_t1, p1_t1, closed_form_toi,
+                    min_distance, tmax),
+                closed_form_toi, no_zero_toi, is_impacting, toi)) {
+            return is_impacting;
+        }
+
         double output_tolerance;
         // NOTE: Use degenerate edge-edge
         return ticcd::edgeEdgeCCD(
@@ -174,9 +219,21 @@ bool point_edge_ccd_2D(
 
     const auto ccd = [&](long max_iterations, double min_distance,
                          bool no_zero_toi, double& toi) -> bool {
+        // The signed area is a quadratic in time, so first try the filtered
+        // closed-form solution.
+        bool is_impacting;
+        double closed_form_toi;
+        if (use_closed_form_result(
+                closed_form_point_edge_ccd_2D(
+                    p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, closed_form_toi,
+                    min_distance, tmax, adjusted_tolerance),
+                closed_form_toi, no_zero_toi, is_impacting, toi)) {
+            return is_impacting;
+        }
+
         double output_tolerance;
         // NOTE: Use degenerate edge-edge
-        bool is_impacting = ticcd::edgeEdgeCCD(
+        is_impacting = ticcd::edgeEdgeCCD(
             p_t0_3D, p_t0_3D, e0_t0_3D, e1_t0_3D, //
             p_t1_3D, p_t1_3D, e0_t1_3D, e1_t1_3D,
             Eigen::Array3d::Constant(-1), // rounding error (auto)
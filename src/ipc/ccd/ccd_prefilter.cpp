@@ -0,0 +1,238 @@
+#include "ccd_prefilter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ipc {
+
+namespace {
+    constexpr double EPS = std::numeric_limits<double>::epsilon();
+
+    /// @brief Signed gap between the projections of the two groups onto an axis.
+    /// @return min over the second group minus max over the first group and the largest absolute coordinate.
+    double projected_gap(
+        const Eigen::MatrixXd& vertices,
+        const std::array<long, 4>& ids,
+        const int n_first,
+        const VectorMax3d& axis,
+        double& max_abs_coord)
+    {
+        double max_a = -std::numeric_limits<double>::infinity();
+        double min_b = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 4 && ids[i] >= 0; i++) {
+            const auto x = vertices.row(ids[i]);
+            const double p = x.dot(axis.transpose());
+            max_abs_coord = std::max(max_abs_coord, x.cwiseAbs().maxCoeff());
+            if (i < n_first) {
+                max_a = std::max(max_a, p);
+            } else {
+                min_b = std::min(min_b, p);
+            }
+        }
+        return min_b - max_a;
+    }
+
+    /// @brief Signed gap with the roles of the two groups swapped.
+    double reversed_projected_gap(
+        const Eigen::MatrixXd& vertices,
+        const std::array<long, 4>& ids,
+        const int n_first,
+        const VectorMax3d& axis)
+    {
+        double min_a = std::numeric_limits<double>::infinity();
+        double max_b = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 4 && ids[i] >= 0; i++) {
+            const double p = vertices.row(ids[i]).dot(axis.transpose());
+            if (i < n_first) {
+                min_a = std::min(min_a, p);
+            } else {
+                max_b = std::max(max_b, p);
+            }
+        }
+        return min_a - max_b;
+    }
+} // namespace
+
+void CCDPrefilterStatistics::record(const CCDPrefilterResult result)
+{
+    num_candidates++;
+    if (result == CCDPrefilterResult::SEPARATING_AXIS) {
+        num_separating_axis_rejections++;
+    } else if (result == CCDPrefilterResult::COPLANARITY) {
+        num_coplanarity_rejections++;
+    }
+}
+
+CCDPrefilterStatistics&
+CCDPrefilterStatistics::operator+=(const CCDPrefilterStatistics& other)
+{
+    num_candidates += other.num_candidates;
+    num_separating_axis_rejections += other.num_separating_axis_rejections;
+    num_coplanarity_rejections += other.num_coplanarity_rejections;
+    return *this;
+}
+
+bool is_separated_along_axis(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const VectorMax3d& axis,
+    const double min_distance)
+{
+    assert(axis.size() == vertices_t0.cols());
+    assert(vertices_t0.cols() == vertices_t1.cols());
+
+    const double axis_norm = axis.norm();
+    if (axis_norm == 0 || !std::isfinite(axis_norm)) {
+        return false;
+    }
+
+    double max_abs_coord = 0;
+    const double gap_t0 =
+        projected_gap(vertices_t0, ids, n_first, axis, max_abs_coord);
+    const double gap_t1 =
+        projected_gap(vertices_t1, ids, n_first, axis, max_abs_coord);
+
+    // Bound on the rounding error of the projections.
+    const double threshold = min_distance * axis_norm * (1 + 4 * EPS)
+        + 4 * axis.size() * EPS * max_abs_coord * axis.cwiseAbs().sum();
+
+    if (gap_t0 > threshold && gap_t1 > threshold) {
+        return true;
+    }
+    return reversed_projected_gap(vertices_t0, ids, n_first, axis) > threshold
+        && reversed_projected_gap(vertices_t1, ids, n_first, axis) > threshold;
+}
+
+bool separating_axis_ccd_prefilter(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const double min_distance)
+{
+    const int dim = vertices_t0.cols();
+    assert(vertices_t1.cols() == dim);
+
+    // Coordinate axes
+    for (int i = 0; i < dim; i++) {
+        if (is_separated_along_axis(
+                vertices_t0, vertices_t1, ids, n_first,
+                VectorMax3d::Unit(dim, i), min_distance)) {
+            return true;
+        }
+    }
+
+    // Element normals at the start and end of the time step. Any axis is
+    // valid, so the rounding of the normals does not matter.
+    const bool is_edge_edge = n_first == 2 && ids[3] >= 0;
+    for (const Eigen::MatrixXd* V : { &vertices_t0, &vertices_t1 }) {
+        VectorMax3d axis;
+        if (dim == 2) {
+            if (ids[3] >= 0) {
+                continue;
+            }
+            // Normal of the edge of the edge-vertex candidate
+            const Eigen::Vector2d e = V->row(ids[2]) - V->row(ids[1]);
+            axis = Eigen::Vector2d(-e.y(), e.x());
+        } else if (is_edge_edge) {
+            const Eigen::Vector3d ea = V->row(ids[1]) - V->row(ids[0]);
+            const Eigen::Vector3d eb = V->row(ids[3]) - V->row(ids[2]);
+            axis = ea.cross(eb);
+        } else if (ids[3] >= 0) {
+            // Normal of the triangle of the face-vertex candidate
+            const Eigen::Vector3d e0 = V->row(ids[2]) - V->row(ids[1]);
+            const Eigen::Vector3d e1 = V->row(ids[3]) - V->row(ids[1]);
+            axis = e0.cross(e1);
+        } else {
+            continue;
+        }
+        if (is_separated_along_axis(
+                vertices_t0, vertices_t1, ids, n_first, axis, min_distance)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool coplanarity_ccd_prefilter(
+    const Eigen::Vector3d& a_t0,
+    const Eigen::Vector3d& b_t0,
+    const Eigen::Vector3d& c_t0,
+    const Eigen::Vector3d& a_t1,
+    const Eigen::Vector3d& b_t1,
+    const Eigen::Vector3d& c_t1,
+    const double min_distance)
+{
+    const Eigen::Vector3d n00 = a_t0.cross(b_t0), n01 = a_t0.cross(b_t1),
+                          n10 = a_t1.cross(b_t0), n11 = a_t1.cross(b_t1);
+
+    // Bernstein coefficients of f(t) = (a(t) × b(t)) · c(t)
+    const std::array<double, 4> f = { {
+        n00.dot(c_t0),
+        (n10.dot(c_t0) + n01.dot(c_t0) + n00.dot(c_t1)) / 3,
+        (n11.dot(c_t0) + n10.dot(c_t1) + n01.dot(c_t1)) / 3,
+        n11.dot(c_t1),
+    } };
+
+    // The normal n(t) = a(t) × b(t) is a quadratic with Bernstein coefficients
+    // n00, (n01 + n10) / 2, and n11, so its norm is bounded by their norms.
+    const double max_normal_norm = std::max(
+        { n00.norm(), (0.5 * (n01 + n10)).norm(), n11.norm() });
+
+    // Bound on the rounding error of the coefficients
+    const double max_a = std::max(a_t0.norm(), a_t1.norm());
+    const double max_b = std::max(b_t0.norm(), b_t1.norm());
+    const double max_c = std::max(c_t0.norm(), c_t1.norm());
+    const double threshold = min_distance * max_normal_norm * (1 + 8 * EPS)
+        + 32 * EPS * max_a * max_b * max_c;
+
+    const auto [min_f, max_f] = std::minmax_element(f.begin(), f.end());
+    return *min_f > threshold || *max_f < -threshold;
+}
+
+CCDPrefilterResult apply_ccd_prefilters(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const double min_distance,
+    const CCDPrefilterOptions& options)
+{
+    if (options.separating_axis
+        && separating_axis_ccd_prefilter(
+            vertices_t0, vertices_t1, ids, n_first, min_distance)) {
+        return CCDPrefilterResult::SEPARATING_AXIS;
+    }
+
+    // The plane is spanned by the triangle (face-vertex) or by the two edges
+    // (edge-edge), so only 3D candidates with four vertices apply.
+    if (options.coplanarity && vertices_t0.cols() == 3 && ids[3] >= 0) {
+        // Plane origin and vertices spanning the plane
+        const int o = n_first == 2 ? 0 : 1;
+        const int ia = n_first == 2 ? 1 : 2;
+        const int ib0 = n_first == 2 ? 2 : 1, ib1 = 3;
+        const int ic = n_first == 2 ? 2 : 0;
+
+        const auto x0 = [&](int i) -> Eigen::Vector3d {
+            return vertices_t0.row(ids[i]);
+        };
+        const auto x1 = [&](int i) -> Eigen::Vector3d {
+            return vertices_t1.row(ids[i]);
+        };
+
+        if (coplanarity_ccd_prefilter(
+                x0(ia) - x0(o), x0(ib1) - x0(ib0), x0(ic) - x0(o),
+                x1(ia) - x1(o), x1(ib1) - x1(ib0), x1(ic) - x1(o),
+                min_distance)) {
+            return CCDPrefilterResult::COPLANARITY;
+        }
+    }
+
+    return CCDPrefilterResult::NOT_REJECTED;
+}
+
+} // namespace ipc
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstddef>
+
+namespace ipc {
+
+/// @brief Cheap conservative tests used to reject CCD candidates before the narrow phase.
+struct CCDPrefilterOptions {
+    /// @brief Reject candidates separated along a fixed axis over the whole time step.
+    bool separating_axis = false;
+    /// @brief Reject face-vertex and edge-edge candidates whose vertices stay strictly on one side of the moving plane.
+    bool coplanarity = false;
+
+    /// @brief Get options with all prefilters enabled.
+    static CCDPrefilterOptions all() { return { true, true }; }
+
+    /// @brief Determine if any prefilter is enabled.
+    bool any() const { return separating_axis || coplanarity; }
+};
+
+/// @brief Result of applying the CCD prefilters to a candidate.
+enum class CCDPrefilterResult {
+    /// @brief The candidate could collide (run the narrow phase).
+    NOT_REJECTED,
+    /// @brief Rejected by the separating-axis test.
+    SEPARATING_AXIS,
+    /// @brief Rejected by the coplanarity test.
+    COPLANARITY
+};
+
+/// @brief Number of candidates tested and rejected by each CCD prefilter.
+struct CCDPrefilterStatistics {
+    /// @brief Number of candidates tested.
+    size_t num_candidates = 0;
+    /// @brief Number of candidates rejected by the separating-axis test.
+    size_t num_separating_axis_rejections = 0;
+    /// @brief Number of candidates rejected by the coplanarity test.
+    size_t num_coplanarity_rejections = 0;
+
+    /// @brief Get the total number of candidates rejected.
+    size_t num_rejections() const
+    {
+        return num_separating_axis_rejections + num_coplanarity_rejections;
+    }
+
+    /// @brief Record the result of the prefilters on one candidate.
+    /// @param result Which prefilter (if any) rejected the candidate.
+    void record(const CCDPrefilterResult result);
+
+    /// @brief Accumulate the statistics of another set of candidates.
+    CCDPrefilterStatistics& operator+=(const CCDPrefilterStatistics& other);
+};
+
+/// @brief Determine if two groups of linearly moving vertices stay separated along a fixed axis over the whole time step.
+/// @note The gap along a fixed axis is a concave function of time, so it only needs to be checked at t=0 and t=1.
+/// @param vertices_t0 Vertex positions at the start of the time step.
+/// @param vertices_t1 Vertex positions at the end of the time step.
+/// @param ids Vertex ids of the candidate (-1 for unused vertices).
+/// @param n_first Number of vertices of the first element.
+/// @param axis Axis to project onto (need not be normalized).
+/// @param min_distance Minimum separation distance.
+/// @return True if the elements certainly stay more than min_distance apart.
+bool is_separated_along_axis(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const VectorMax3d& axis,
+    const double min_distance);
+
+/// @brief Separating-axis test of a CCD candidate.
+/// @note Checks the coordinate axes and the element normals (triangle normal, edge-edge cross product, or 2D edge normal) at the start and end of the time step.
+/// @param vertices_t0 Vertex positions at the start of the time step.
+/// @param vertices_t1 Vertex positions at the end of the time step.
+/// @param ids Vertex ids of the candidate (-1 for unused vertices).
+/// @param n_first Number of vertices of the first element.
+/// @param min_distance Minimum separation distance.
+/// @return True if the elements certainly stay more than min_distance apart.
+bool separating_axis_ccd_prefilter(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const double min_distance);
+
+/// @brief Determine if four linearly moving points stay strictly non-coplanar.
+/// @note The signed volume f(t) = (a(t) × b(t)) · c(t) is a cubic in t. If all four of its Bernstein coefficients are farther than min_distance · max‖a(t) × b(t)‖ from zero on the same side, the fourth point never comes within min_distance of the plane.
+/// @param a_t0 First spanning vector of the plane at t=0.
+/// @param b_t0 Second spanning vector of the plane at t=0.
+/// @param c_t0 Vector from the plane to the fourth point at t=0.
+/// @param a_t1 First spanning vector of the plane at t=1.
+/// @param b_t1 Second spanning vector of the plane at t=1.
+/// @param c_t1 Vector from the plane to the fourth point at t=1.
+/// @param min_distance Minimum separation distance.
+/// @return True if the points certainly stay more than min_distance from coplanar.
+bool coplanarity_ccd_prefilter(
+    const Eigen::Vector3d& a_t0,
+    const Eigen::Vector3d& b_t0,
+    const Eigen::Vector3d& c_t0,
+    const Eigen::Vector3d& a_t1,
+    const Eigen::Vector3d& b_t1,
+    const Eigen::Vector3d& c_t1,
+    const double min_distance);
+
+/// @brief Apply the enabled prefilters to a CCD candidate.
+/// @param vertices_t0 Vertex positions at the start of the time step.
+/// @param vertices_t1 Vertex positions at the end of the time step.
+/// @param ids Vertex ids of the candidate (-1 for unused vertices).
+/// @param n_first Number of vertices of the first element (1 for edge-vertex and face-vertex, 2 for edge-edge).
+/// @param min_distance Minimum separation distance.
+/// @param options Prefilters to apply.
+/// @return Which prefilter (if any) rejected the candidate.
+CCDPrefilterResult apply_ccd_prefilters(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const std::array<long, 4>& ids,
+    const int n_first,
+    const double min_distance,
+    const CCDPrefilterOptions& options);
+
+} // namespace ipc
@@ -0,0 +1,184 @@
+#include "closed_form_ccd.hpp"
+
+#include <ipc/distance/point_edge.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ipc {
+
+namespace {
+    constexpr double EPS = std::numeric_limits<double>::epsilon();
+
+    /// @brief Certified earliest root of q(t) = at² + bt + c on [0, tmax].
+    /// @param a Quadratic coefficient.
+    /// @param b Linear coefficient.
+    /// @param c Constant coefficient (q(0)).
+    /// @param coefficient_error Bound on the absolute error of each coefficient.
+    /// @param tmax Maximum time to check (≤ 1).
+    /// @param[out] t Time such that q > 0 on [0, t] and t is at most the earliest root if IMPACT is returned.
+    /// @return If q certainly has a root, certainly has no root, or if the filter is uncertain.
+    ClosedFormCCDResult earliest_quadratic_root(
+        const double a,
+        const double b,
+        const double c,
+        const double coefficient_error,
+        const double tmax,
+        double& t)
+    {
+        assert(0 <= tmax && tmax <= 1);
+
+        // Bound on the error of evaluating q(t) for t ∈ [0, 1] in floating
+        // point, including the error of the coefficients.
+        const double err = 3 * coefficient_error
+            + 8 * EPS * (std::abs(a) + std::abs(b) + std::abs(c));
+        const auto q = [&](double t) { return (a * t + b) * t + c; };
+
+        if (c <= err) {
+            return ClosedFormCCDResult::UNCERTAIN; // Possibly in contact at t=0
+        }
+
+        // q is decreasing on [0, t_min] and the minimum on [0, tmax] is at
+        // t_min (if a ≤ 0, q is concave and the minimum is at an endpoint).
+        const double t_min =
+            a > 0 ? std::clamp(-b / (2 * a), 0.0, tmax) : tmax;
+        const double q_min = q(t_min);
+        if (q_min > err) {
+            return ClosedFormCCDResult::NO_IMPACT;
+        } else if (q_min >= -err) {
+            return ClosedFormCCDResult::UNCERTAIN; // Grazing contact
+        }
+
+        // A root certainly exists in (0, t_min), and it is the only root there.
+        double root;
+        if (a == 0) {
+            root = -c / b;
+        } else {
+            const double discriminant = b * b - 4 * a * c;
+            if (discriminant < 0) {
+                return ClosedFormCCDResult::UNCERTAIN;
+            }
+            // Numerically stable roots: q/a and c/q.
+            const double qq =
+                -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+            const double r0 = qq / a, r1 = c / qq;
+            root = std::numeric_limits<double>::infinity();
+            for (const double r : { r0, r1 }) {
+                if (r >= 0 && r <= t_min) {
+                    root = std::min(root, r);
+                }
+            }
+            if (!std::isfinite(root)) {
+                return ClosedFormCCDResult::UNCERTAIN;
+            }
+        }
+
+        // Step back from the root until q is certainly positive. Because q > 0
+        // on [0, root), q(t) > err certifies that [0, t] is free of roots.
+        const double dq = std::abs(2 * a * root + b);
+        t = std::max(root - (dq > 0 ? 2 * err / dq : 0.0), 0.0);
+        if (q(t) <= err) {
+            return ClosedFormCCDResult::UNCERTAIN;
+        }
+        return ClosedFormCCDResult::IMPACT;
+    }
+
+    inline double cross2(const Eigen::Vector2d& x, const Eigen::Vector2d& y)
+    {
+        return x.x() * y.y() - x.y() * y.x();
+    }
+} // namespace
+
+ClosedFormCCDResult closed_form_point_point_ccd(
+    const VectorMax3d& p0_t0,
+    const VectorMax3d& p1_t0,
+    const VectorMax3d& p0_t1,
+    const VectorMax3d& p1_t1,
+    double& toi,
+    const double min_distance,
+    const double tmax)
+{
+    const int dim = p0_t0.size();
+    assert(p1_t0.size() == dim && p0_t1.size() == dim && p1_t1.size() == dim);
+
+    // Relative position x(t) = x0 + t v, so ‖x(t)‖² - d² is a quadratic.
+    const VectorMax3d dp0 = p0_t1 - p0_t0, dp1 = p1_t1 - p1_t0;
+    const VectorMax3d x0 = p0_t0 - p1_t0;
+    const VectorMax3d v = dp0 - dp1;
+
+    // Each difference has a relative error of at most EPS, so the errors scale
+    // with the magnitudes of the differences and not the coordinates.
+    const double scale = x0.cwiseAbs().maxCoeff()
+        + (dp0.cwiseAbs() + dp1.cwiseAbs()).maxCoeff();
+    const double coefficient_error =
+        16 * dim * EPS * scale * scale + 2 * EPS * min_distance * min_distance;
+
+    return earliest_quadratic_root(
+        v.squaredNorm(), 2 * x0.dot(v),
+        x0.squaredNorm() - min_distance * min_distance, coefficient_error,
+        tmax, toi);
+}
+
+ClosedFormCCDResult closed_form_point_edge_ccd_2D(
+    const Eigen::Vector2d& p_t0,
+    const Eigen::Vector2d& e0_t0,
+    const Eigen::Vector2d& e1_t0,
+    const Eigen::Vector2d& p_t1,
+    const Eigen::Vector2d& e0_t1,
+    const Eigen::Vector2d& e1_t1,
+    double& toi,
+    const double min_distance,
+    const double tmax,
+    const double tolerance)
+{
+    // Edge vector e(t) = E + t dE and relative position w(t) = W + t dW.
+    const Eigen::Vector2d dp = p_t1 - p_t0, de0 = e0_t1 - e0_t0,
+                          de1 = e1_t1 - e1_t0;
+    const Eigen::Vector2d E = e1_t0 - e0_t0, dE = de1 - de0;
+    const Eigen::Vector2d W = p_t0 - e0_t0, dW = dp - de0;
+
+    // The signed area g(t) = e(t) × w(t) is a quadratic in t.
+    const double a = cross2(dE, dW);
+    const double b = cross2(E, dW) + cross2(dE, W);
+    const double c = cross2(E, W);
+
+    const double scale =
+        std::max(E.cwiseAbs().maxCoeff(), W.cwiseAbs().maxCoeff())
+        + (dp.cwiseAbs() + de0.cwiseAbs() + de1.cwiseAbs()).maxCoeff();
+    const double coefficient_error = 32 * EPS * scale * scale;
+
+    // The point is within min_distance of the edge only if it is within
+    // min_distance of the line, i.e., |g(t)| ≤ d‖e(t)‖. ‖e(t)‖ is convex, so
+    // it is bounded by its values at the end points of [0, tmax].
+    const double max_edge_length =
+        std::max(E.norm(), (E + tmax * dE).norm()) * (1 + 4 * EPS);
+    const double h = min_distance * max_edge_length;
+
+    // Solve sign(g(0)) g(t) - h = 0 for the earliest time the point is within
+    // the conservative distance of the line.
+    const double s = c < 0 ? -1 : 1;
+    double t_line;
+    const ClosedFormCCDResult line_result = earliest_quadratic_root(
+        s * a, s * b, s * c - h, coefficient_error + EPS * h, tmax, t_line);
+    if (line_result != ClosedFormCCDResult::IMPACT) {
+        return line_result;
+    }
+
+    // t_line is a lower bound on the time of impact. Only report it if the
+    // point is certainly within min_distance + tolerance of the edge.
+    const double max_distance = min_distance + tolerance;
+    const double distance_sqr = point_edge_distance(
+        Eigen::Vector2d(p_t0 + t_line * dp),
+        Eigen::Vector2d(e0_t0 + t_line * de0),
+        Eigen::Vector2d(e1_t0 + t_line * de1));
+    if (distance_sqr * (1 + 16 * EPS) + coefficient_error
+        > max_distance * max_distance) {
+        return ClosedFormCCDResult::UNCERTAIN;
+    }
+
+    toi = t_line;
+    return ClosedFormCCDResult::IMPACT;
+}
+
+} // namespace ipc
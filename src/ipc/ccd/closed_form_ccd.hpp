@@ -0,0 +1,61 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+namespace ipc {
+
+/// @brief Result of a filtered closed-form CCD query.
+enum class ClosedFormCCDResult {
+    /// @brief The elements certainly do not come within the minimum distance.
+    NO_IMPACT,
+    /// @brief The elements certainly come within the minimum distance at toi.
+    IMPACT,
+    /// @brief The floating-point filter could not decide (use a robust CCD).
+    UNCERTAIN
+};
+
+/// @brief Filtered closed-form CCD between two linearly moving points.
+/// @note The squared distance between the points is a quadratic in time, so the time of impact is its earliest root. The root is only reported if floating-point error bounds certify the result.
+/// @param p0_t0 Initial position of the first point.
+/// @param p1_t0 Initial position of the second point.
+/// @param p0_t1 Final position of the first point.
+/// @param p1_t1 Final position of the second point.
+/// @param[out] toi Conservative (lower bound) time of impact if IMPACT is returned.
+/// @param min_distance Minimum separation distance.
+/// @param tmax Maximum time to check.
+/// @return If the points certainly impact, certainly do not impact, or if the filter is uncertain.
+ClosedFormCCDResult closed_form_point_point_ccd(
+    const VectorMax3d& p0_t0,
+    const VectorMax3d& p1_t0,
+    const VectorMax3d& p0_t1,
+    const VectorMax3d& p1_t1,
+    double& toi,
+    const double min_distance = 0.0,
+    const double tmax = 1.0);
+
+/// @brief Filtered closed-form CCD between a linearly moving point and edge in 2D.
+/// @note The signed area of the point and edge is a quadratic in time. The earliest time it reaches min_distance times a bound on the edge length is the earliest time the point can be within min_distance of the edge's line, so it is a lower bound on the time of impact (and if it does not exist, there is no impact). The bound is only reported if the point is certified to be within min_distance + tolerance of the edge at that time. Otherwise (e.g., the point passes the line beyond an endpoint), the filter is uncertain.
+/// @param p_t0 Initial position of the point.
+/// @param e0_t0 Initial position of the first endpoint of the edge.
+/// @param e1_t0 Initial position of the second endpoint of the edge.
+/// @param p_t1 Final position of the point.
+/// @param e0_t1 Final position of the first endpoint of the edge.
+/// @param e1_t1 Final position of the second endpoint of the edge.
+/// @param[out] toi Conservative (lower bound) time of impact if IMPACT is returned.
+/// @param min_distance Minimum separation distance.
+/// @param tmax Maximum time to check.
+/// @param tolerance Distance tolerance of the reported time of impact.
+/// @return If the point and edge certainly impact, certainly do not impact, or if the filter is uncertain.
+ClosedFormCCDResult closed_form_point_edge_ccd_2D(
+    const Eigen::Vector2d& p_t0,
+    const Eigen::Vector2d& e0_t0,
+    const Eigen::Vector2d& e1_t0,
+    const Eigen::Vector2d& p_t1,
+    const Eigen::Vector2d& e0_t1,
+    const Eigen::Vector2d& e1_t1,
+    double& toi,
+    const double min_distance,
+    const double tmax,
+    const double tolerance);
+
+} // namespace ipc
@@ -0,0 +1,66 @@
+#include "point_sdf.hpp"
+
+#include <ipc/utils/logger.hpp>
+
+namespace ipc {
+
+bool point_sdf_ccd(
+    const VectorMax3d& p_t0,
+    const VectorMax3d& p_t1,
+    const GridSDF& sdf,
+    double& toi,
+    const double tolerance,
+    const long max_iterations,
+    const double conservative_rescaling)
+{
+    assert(p_t0.size() == sdf.dim() && p_t1.size() == sdf.dim());
+
+    const double initial_distance = sdf.signed_distance(p_t0);
+    if (initial_distance <= 0) {
+        logger().warn(
+            "Initial point-SDF distance is {:g}, returning toi=0!",
+            initial_distance);
+        toi = 0;
+        return true;
+    }
+
+    // Upper bound on the rate of change of the distance along the trajectory
+    const double max_speed = sdf.lipschitz_constant() * (p_t1 - p_t0).norm();
+    if (max_speed == 0) {
+        return false;
+    }
+
+    const double min_distance = (1.0 - conservative_rescaling) * initial_distance;
+
+    double t = 0;
+    double distance = initial_distance;
+    for (long i = 0; i < max_iterations; i++) {
+        // The distance can drop by at most max_speed * dt, so this step keeps
+        // the point at least min_distance away from the obstacle.
+        const double dt = (distance - min_distance) / max_speed;
+        if (dt <= tolerance) {
+            toi = t;
+            return true;
+        }
+
+        t += dt;
+        if (t >= 1) {
+            return false;
+        }
+
+        distance = sdf.signed_distance((p_t1 - p_t0) * t + p_t0);
+        if (distance <= min_distance) {
+            // Only possible through rounding errors.
+            toi = t - dt;
+            return true;
+        }
+    }
+
+    logger().warn(
+        "Point-SDF CCD reached the maximum number of iterations ({:d})!",
+        max_iterations);
+    toi = t;
+    return true;
+}
+
+} // namespace ipc
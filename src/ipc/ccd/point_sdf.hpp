@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ipc/ccd/ccd.hpp>
+#include <ipc/implicits/grid_sdf.hpp>
+
+namespace ipc {
+
+/// @brief Conservative CCD of a point moving linearly against a static SDF.
+///
+/// Uses conservative advancement: the field changes at most
+/// sdf.lipschitz_constant() per unit length, so the point can safely advance
+/// until it has traveled the current distance minus the minimum separation.
+///
+/// @param p_t0 Position of the point at the start of the step.
+/// @param p_t1 Position of the point at the end of the step.
+/// @param sdf Signed distance field of the obstacle.
+/// @param toi Output time of impact.
+/// @param tolerance Stop advancing once the step falls below this (in time).
+/// @param max_iterations Maximum number of advancement steps.
+/// @param conservative_rescaling Fraction of the initial distance the point may close.
+/// @return True if the point may impact the obstacle during the step.
+bool point_sdf_ccd(
+    const VectorMax3d& p_t0,
+    const VectorMax3d& p_t1,
+    const GridSDF& sdf,
+    double& toi,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+} // namespace ipc
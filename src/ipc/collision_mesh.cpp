@@ -5,6 +5,9 @@
 #include <ipc/utils/eigen_ext.hpp>
 #include <ipc/utils/local_to_global.hpp>
 #include <ipc/utils/area_gradient.hpp>
+#include <ipc/broad_phase/partitioned_broad_phase.hpp>
+
+#include <algorithm>
 
 namespace ipc {
 
@@ -352,6 +355,28 @@ CollisionMesh::to_full_dof(const Eigen::SparseMatrix<double>& X) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CollisionMesh::set_static_vertices(
+    const std::vector<bool>& is_vertex_static)
+{
+    if (!is_vertex_static.empty() && is_vertex_static.size() != num_vertices()) {
+        throw std::runtime_error(
+            "Number of static vertex flags does not match the number of vertices!");
+    }
+
+    if (std::find(is_vertex_static.begin(), is_vertex_static.end(), true)
+        == is_vertex_static.end()) {
+        m_is_vertex_static.clear();
+        m_static_element_grid = nullptr;
+        return;
+    }
+
+    m_is_vertex_static = is_vertex_static;
+    m_static_element_grid = std::make_shared<const StaticElementGrid>(
+        m_rest_positions, m_edges, m_faces, m_is_vertex_static);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::vector<bool> CollisionMesh::construct_is_on_surface(
     const int num_vertices, const Eigen::MatrixXi& edges)
 {
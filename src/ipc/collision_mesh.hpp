@@ -5,8 +5,13 @@
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <memory>
+#include <vector>
+
 namespace ipc {
 
+class StaticElementGrid; // Forward declaration
+
 /// @brief A class for encapsolating the transformation/selections needed to go from a volumetric FE mesh to a surface collision mesh.
 class CollisionMesh {
 public:
@@ -239,6 +244,42 @@ public:
 
     // -----------------------------------------------------------------------
 
+    /// @brief Mark the vertices that never move from their rest positions.
+    ///
+    /// The elements whose vertices are all static are inserted once into a
+    /// persistent acceleration structure, and the broad phase only boxes and
+    /// queries the remaining (moving) elements against it.
+    ///
+    /// @note The positions of the static vertices passed to the broad phase must equal their rest positions. In debug builds (or with PartitionedBroadPhase::validate_static_vertices), the broad phase checks this and throws std::runtime_error otherwise.
+    /// @param is_vertex_static Vector of bools indicating whether each vertex is static (empty to mark all vertices as moving).
+    void set_static_vertices(const std::vector<bool>& is_vertex_static);
+
+    /// @brief Determine if any vertex is static.
+    bool has_static_vertices() const { return m_static_element_grid != nullptr; }
+
+    /// @brief Is a vertex static?
+    /// @param vi Vertex ID.
+    /// @return True if the vertex never moves from its rest position.
+    bool is_vertex_static(const size_t vi) const
+    {
+        return has_static_vertices() && m_is_vertex_static[vi];
+    }
+
+    /// @brief Get the vector of bools indicating whether each vertex is static.
+    const std::vector<bool>& static_vertices() const
+    {
+        return m_is_vertex_static;
+    }
+
+    /// @brief Get the persistent acceleration structure of the static elements.
+    /// @return Pointer to the structure or nullptr if no vertex is static.
+    const std::shared_ptr<const StaticElementGrid>& static_element_grid() const
+    {
+        return m_static_element_grid;
+    }
+
+    // -----------------------------------------------------------------------
+
     /// @brief Construct a vector of bools indicating whether each vertex is on the surface.
     /// @param num_vertices The number of vertices in the mesh.
     /// @param edges The surface edges of the mesh (#E × 2).
@@ -322,6 +363,12 @@ protected:
     /// 3D: 1/3 sum of area of connected triangles
     Eigen::VectorXd m_edge_areas;
 
+    /// @brief Is vertex static (empty if no vertex is static)?
+    std::vector<bool> m_is_vertex_static;
+    /// @brief Acceleration structure of the static elements.
+    /// @note Shared so copies of the mesh do not rebuild it.
+    std::shared_ptr<const StaticElementGrid> m_static_element_grid;
+
     // Stored as a std::vector so it is easier to access the rows directly.
     /// @brief The rows of the Jacobian of the vertex areas vector.
     std::vector<Eigen::SparseVector<double>> m_vertex_area_jacobian;
@@ -0,0 +1,139 @@
+#include "batched_collision_constraints.hpp"
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <stdexcept>
+
+namespace ipc {
+
+// NOTE: Each scene's own parallel loops are nested inside the loop over
+// scenes, so TBB's work stealing balances small and large scenes.
+
+void BatchedCollisionConstraints::build(
+    const std::vector<CollisionMesh>& meshes,
+    const std::vector<Eigen::MatrixXd>& vertices,
+    const double dhat,
+    const double dmin,
+    const BroadPhaseMethod broad_phase_method)
+{
+    if (meshes.size() != vertices.size()) {
+        throw std::runtime_error(
+            "Number of meshes and vertex matrices in the batch differ!");
+    }
+
+    scenes.resize(meshes.size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                scenes[i].build(
+                    meshes[i], vertices[i], dhat, dmin, broad_phase_method);
+            }
+        });
+}
+
+// ============================================================================
+
+Eigen::VectorXd BatchedCollisionConstraints::compute_potential(
+    const std::vector<CollisionMesh>& meshes,
+    const std::vector<Eigen::MatrixXd>& vertices,
+    const double dhat) const
+{
+    check_num_scenes(meshes, vertices);
+
+    Eigen::VectorXd potentials(size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                potentials[i] =
+                    scenes[i].compute_potential(meshes[i], vertices[i], dhat);
+            }
+        });
+
+    return potentials;
+}
+
+std::vector<Eigen::VectorXd>
+BatchedCollisionConstraints::compute_potential_gradient(
+    const std::vector<CollisionMesh>& meshes,
+    const std::vector<Eigen::MatrixXd>& vertices,
+    const double dhat) const
+{
+    check_num_scenes(meshes, vertices);
+
+    std::vector<Eigen::VectorXd> gradients(size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                gradients[i] = scenes[i].compute_potential_gradient(
+                    meshes[i], vertices[i], dhat);
+            }
+        });
+
+    return gradients;
+}
+
+std::vector<Eigen::SparseMatrix<double>>
+BatchedCollisionConstraints::compute_potential_hessian(
+    const std::vector<CollisionMesh>& meshes,
+    const std::vector<Eigen::MatrixXd>& vertices,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const bool upper_triangular) const
+{
+    check_num_scenes(meshes, vertices);
+
+    std::vector<Eigen::SparseMatrix<double>> hessians(size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                hessians[i] = scenes[i].compute_potential_hessian(
+                    meshes[i], vertices[i], dhat, project_hessian_to_psd,
+                    upper_triangular);
+            }
+        });
+
+    return hessians;
+}
+
+Eigen::VectorXd BatchedCollisionConstraints::compute_minimum_distance(
+    const std::vector<CollisionMesh>& meshes,
+    const std::vector<Eigen::MatrixXd>& vertices) const
+{
+    check_num_scenes(meshes, vertices);
+
+    Eigen::VectorXd min_distances(size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                min_distances[i] =
+                    scenes[i].compute_minimum_distance(meshes[i], vertices[i]);
+            }
+        });
+
+    return min_distances;
+}
+
+// ============================================================================
+
+void BatchedCollisionConstraints::check_num_scenes(
+    const std::vector<CollisionMesh>& meshes,
+    const std::vector<Eigen::MatrixXd>& vertices) const
+{
+    if (meshes.size() != size() || vertices.size() != size()) {
+        throw std::runtime_error(
+            "Number of scenes in the batch differs from the built constraints!");
+    }
+}
+
+} // namespace ipc
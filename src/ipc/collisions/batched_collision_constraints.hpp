@@ -0,0 +1,116 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/collision_constraints.hpp>
+#include <ipc/broad_phase/broad_phase.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Collision constraints of many independent scenes.
+///
+/// Every operation runs in parallel over the scenes, and each scene's own
+/// (parallel) broad phase and evaluation is nested inside, so many small
+/// scenes still keep all cores busy.
+class BatchedCollisionConstraints {
+public:
+    BatchedCollisionConstraints() { }
+
+    /// @brief Initialize the constraints of every scene.
+    /// @note Existing per-scene settings (e.g., use_convergent_formulation) are kept.
+    /// @param meshes The collision mesh of each scene.
+    /// @param vertices Vertices of each scene's collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    /// @param broad_phase_method Broad-phase method to use.
+    void build(
+        const std::vector<CollisionMesh>& meshes,
+        const std::vector<Eigen::MatrixXd>& vertices,
+        const double dhat,
+        const double dmin = 0,
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
+    // ------------------------------------------------------------------------
+
+    /// @brief Compute the barrier potential of every scene.
+    /// @param meshes The collision mesh of each scene.
+    /// @param vertices Vertices of each scene's collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @returns The barrier potential of each scene (not scaled by the barrier stiffness).
+    Eigen::VectorXd compute_potential(
+        const std::vector<CollisionMesh>& meshes,
+        const std::vector<Eigen::MatrixXd>& vertices,
+        const double dhat) const;
+
+    /// @brief Compute the gradient of the barrier potential of every scene.
+    /// @param meshes The collision mesh of each scene.
+    /// @param vertices Vertices of each scene's collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @returns The gradient of each scene's barrier potential (not scaled by the barrier stiffness).
+    std::vector<Eigen::VectorXd> compute_potential_gradient(
+        const std::vector<CollisionMesh>& meshes,
+        const std::vector<Eigen::MatrixXd>& vertices,
+        const double dhat) const;
+
+    /// @brief Compute the hessian of the barrier potential of every scene.
+    /// @param meshes The collision mesh of each scene.
+    /// @param vertices Vertices of each scene's collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @param upper_triangular Only assemble the upper triangle of each symmetric hessian.
+    /// @returns The hessian of each scene's barrier potential (not scaled by the barrier stiffness).
+    std::vector<Eigen::SparseMatrix<double>> compute_potential_hessian(
+        const std::vector<CollisionMesh>& meshes,
+        const std::vector<Eigen::MatrixXd>& vertices,
+        const double dhat,
+        const bool project_hessian_to_psd = false,
+        const bool upper_triangular = false) const;
+
+    /// @brief Computes the minimum distance between any non-adjacent elements of every scene.
+    /// @param meshes The collision mesh of each scene.
+    /// @param vertices Vertices of each scene's collision mesh.
+    /// @returns The minimum distance of each scene.
+    Eigen::VectorXd compute_minimum_distance(
+        const std::vector<CollisionMesh>& meshes,
+        const std::vector<Eigen::MatrixXd>& vertices) const;
+
+    // ------------------------------------------------------------------------
+
+    /// @brief Get the number of scenes.
+    size_t size() const { return scenes.size(); }
+
+    /// @brief Get if there are no scenes.
+    bool empty() const { return scenes.empty(); }
+
+    /// @brief Remove all scenes.
+    void clear() { scenes.clear(); }
+
+    /// @brief Get a reference to the constraints of scene idx.
+    /// @param idx The index of the scene.
+    /// @return A reference to the scene's constraints.
+    CollisionConstraints& operator[](const size_t idx) { return scenes[idx]; }
+
+    /// @brief Get a const reference to the constraints of scene idx.
+    /// @param idx The index of the scene.
+    /// @return A const reference to the scene's constraints.
+    const CollisionConstraints& operator[](const size_t idx) const
+    {
+        return scenes[idx];
+    }
+
+public:
+    /// @brief Collision constraints of each scene.
+    std::vector<CollisionConstraints> scenes;
+
+protected:
+    /// @brief Check the inputs have one mesh and one vertex matrix per scene.
+    void check_num_scenes(
+        const std::vector<CollisionMesh>& meshes,
+        const std::vector<Eigen::MatrixXd>& vertices) const;
+};
+
+} // namespace ipc
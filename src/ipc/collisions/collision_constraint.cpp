@@ -41,6 +41,19 @@ MatrixMax12d CollisionConstraint::compute_potential_hessian(
     const Eigen::MatrixXi& faces,
     const double dhat,
     const bool project_hessian_to_psd) const
+{
+    const VectorMax12d positions = dof(vertices, edges, faces);
+    return compute_potential_hessian_from_distance(
+        compute_distance(positions), compute_distance_gradient(positions),
+        compute_distance_hessian(positions), dhat, project_hessian_to_psd);
+}
+
+MatrixMax12d CollisionConstraint::compute_potential_hessian_from_distance(
+    const double distance,
+    const VectorMax12d& distance_grad,
+    const MatrixMax12d& distance_hess,
+    const double dhat,
+    const bool project_hessian_to_psd) const
 {
     const double adjusted_dhat = 2 * minimum_distance * dhat + dhat * dhat;
     const double min_dist_squared = minimum_distance * minimum_distance;
@@ -48,11 +61,6 @@ MatrixMax12d CollisionConstraint::compute_potential_hessian(
     // ∇²[b(d(x))] = ∇(b'(d(x)) * ∇d(x))
     //             = b"(d(x)) * ∇d(x) * ∇d(x)ᵀ + b'(d(x)) * ∇²d(x)
 
-    const VectorMax12d positions = dof(vertices, edges, faces);
-    const double distance = compute_distance(positions);
-    const VectorMax12d distance_grad = compute_distance_gradient(positions);
-    const MatrixMax12d distance_hess = compute_distance_hessian(positions);
-
     const double grad_b =
         barrier_gradient(distance - min_dist_squared, adjusted_dhat);
     const double hess_b =
@@ -32,6 +32,21 @@ public:
         const double dhat,
         const bool project_hessian_to_psd) const;
 
+    /// @brief Compute the potential hessian from precomputed distance derivatives.
+    /// @note This is used to evaluate the distance derivatives of many constraints with batched kernels.
+    /// @param distance Squared distance of the stencil.
+    /// @param distance_grad Gradient of the squared distance.
+    /// @param distance_hess Hessian of the squared distance.
+    /// @param dhat The activation distance of the barrier.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @return The hessian of the potential.
+    MatrixMax12d compute_potential_hessian_from_distance(
+        const double distance,
+        const VectorMax12d& distance_grad,
+        const MatrixMax12d& distance_hess,
+        const double dhat,
+        const bool project_hessian_to_psd) const;
+
     double minimum_distance = 0;
     double weight = 1;
     Eigen::SparseVector<double> weight_gradient;
@@ -1,14 +1,22 @@
 #include "collision_constraints.hpp"
 
 #include <ipc/collisions/collision_constraints_builder.hpp>
+#include <ipc/collisions/potential_hessian_visitors.hpp>
 // #include <ipc/utils/unordered_map_and_set.hpp>
 #include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
+#include <ipc/utils/async.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_sort.h>
 
-#include <stdexcept> // std::out_of_range
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept> // std::out_of_range, std::runtime_error
 
 namespace ipc {
 
@@ -21,12 +29,90 @@ void CollisionConstraints::build(
 {
     assert(vertices.rows() == mesh.num_vertices());
 
+    clear();
+
+    const int dim = vertices.cols();
     double inflation_radius = (dhat + dmin) / 2;
 
-    Candidates candidates;
-    candidates.build(mesh, vertices, inflation_radius, broad_phase_method);
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(broad_phase_method, mesh);
+    broad_phase->build(vertices, mesh.edges(), mesh.faces(), inflation_radius);
+
+    // Cull the candidates by measuring the distance and dropping those that are
+    // greater than dhat.
+    const double offset_sqr = (dmin + dhat) * (dmin + dhat);
+    auto is_active = [&](double distance_sqr) {
+        return distance_sqr < offset_sqr;
+    };
+
+    // Cull each batch of candidates as soon as the broad phase finds it, so the
+    // full list of candidates is never stored. The batches are keyed by their
+    // candidate type (EV, EE, FV) and batch id, so merging them in key order
+    // does not depend on the scheduling.
+    using BatchKey = std::pair<int, size_t>;
+    tbb::enumerable_thread_specific<
+        std::vector<std::pair<BatchKey, CollisionConstraintsBuilder>>>
+        storage;
+
+    const auto add_batch = [&](const BatchKey& key) -> auto& {
+        return storage.local()
+            .emplace_back(key, CollisionConstraintsBuilder(*this))
+            .second;
+    };
+
+    if (dim == 2) {
+        // This is not needed for 3D
+        broad_phase->stream_edge_vertex_candidates(
+            [&](size_t batch_id,
+                const std::vector<EdgeVertexCandidate>& candidates) {
+                add_batch({ 0, batch_id })
+                    .add_edge_vertex_constraints(
+                        mesh, vertices, candidates, is_active, 0,
+                        candidates.size());
+            });
+    } else {
+        // These are not needed for 2D
+        broad_phase->stream_edge_edge_candidates(
+            [&](size_t batch_id,
+                const std::vector<EdgeEdgeCandidate>& candidates) {
+                add_batch({ 1, batch_id })
+                    .add_edge_edge_constraints(
+                        mesh, vertices, candidates, is_active, 0,
+                        candidates.size());
+            });
+        broad_phase->stream_face_vertex_candidates(
+            [&](size_t batch_id,
+                const std::vector<FaceVertexCandidate>& candidates) {
+                add_batch({ 2, batch_id })
+                    .add_face_vertex_constraints(
+                        mesh, vertices, candidates, is_active, 0,
+                        candidates.size());
+            });
+    }
+    broad_phase->clear();
 
-    this->build(candidates, mesh, vertices, dhat, dmin);
+    std::vector<std::pair<BatchKey, CollisionConstraintsBuilder>> batches;
+    for (auto& local_batches : storage) {
+        std::move(
+            local_batches.begin(), local_batches.end(),
+            std::back_inserter(batches));
+    }
+    storage.clear();
+
+    std::sort(
+        batches.begin(), batches.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<CollisionConstraintsBuilder> builders;
+    builders.reserve(batches.size());
+    for (auto& [key, builder] : batches) {
+        builders.push_back(std::move(builder));
+    }
+    batches.clear();
+
+    CollisionConstraintsBuilder::merge(builders, *this);
+
+    finalize_build(mesh, dhat, dmin);
 }
 
 void CollisionConstraints::build(
@@ -47,35 +133,76 @@ void CollisionConstraints::build(
         return distance_sqr < offset_sqr;
     };
 
-    tbb::enumerable_thread_specific<CollisionConstraintsBuilder> storage(
-        CollisionConstraintsBuilder(*this));
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), candidates.ev_candidates.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            storage.local().add_edge_vertex_constraints(
-                mesh, vertices, candidates.ev_candidates, is_active, r.begin(),
-                r.end());
+    std::vector<CollisionConstraintsBuilder> storage = build_constraint_blocks(
+        CollisionConstraintsBuilder(*this), candidates.ev_candidates.size(),
+        candidates.ee_candidates.size(), candidates.fv_candidates.size(),
+        [&](size_t start, size_t end, CollisionConstraintsBuilder& builder) {
+            builder.add_edge_vertex_constraints(
+                mesh, vertices, candidates.ev_candidates, is_active, start,
+                end);
+        },
+        [&](size_t start, size_t end, CollisionConstraintsBuilder& builder) {
+            builder.add_edge_edge_constraints(
+                mesh, vertices, candidates.ee_candidates, is_active, start,
+                end);
+        },
+        [&](size_t start, size_t end, CollisionConstraintsBuilder& builder) {
+            builder.add_face_vertex_constraints(
+                mesh, vertices, candidates.fv_candidates, is_active, start,
+                end);
         });
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), candidates.ee_candidates.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            storage.local().add_edge_edge_constraints(
-                mesh, vertices, candidates.ee_candidates, is_active, r.begin(),
-                r.end());
-        });
+    CollisionConstraintsBuilder::merge(storage, *this);
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), candidates.fv_candidates.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            storage.local().add_face_vertex_constraints(
-                mesh, vertices, candidates.fv_candidates, is_active, r.begin(),
-                r.end());
+    finalize_build(mesh, dhat, dmin);
+}
+
+void CollisionConstraints::build(
+    const CompactCandidates& candidates,
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const double dmin)
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    clear();
+
+    // Cull the candidates by measuring the distance and dropping those that are
+    // greater than dhat.
+    const double offset_sqr = (dmin + dhat) * (dmin + dhat);
+    auto is_active = [&](double distance_sqr) {
+        return distance_sqr < offset_sqr;
+    };
+
+    // The compact candidates are only materialized on the stack.
+    std::vector<CollisionConstraintsBuilder> storage = build_constraint_blocks(
+        CollisionConstraintsBuilder(*this), candidates.ev_candidates.size(),
+        candidates.ee_candidates.size(), candidates.fv_candidates.size(),
+        [&](size_t start, size_t end, CollisionConstraintsBuilder& builder) {
+            builder.add_edge_vertex_constraints(
+                mesh, vertices, candidates.ev_candidates, is_active, start,
+                end);
+        },
+        [&](size_t start, size_t end, CollisionConstraintsBuilder& builder) {
+            builder.add_edge_edge_constraints(
+                mesh, vertices, candidates.ee_candidates, is_active, start,
+                end);
+        },
+        [&](size_t start, size_t end, CollisionConstraintsBuilder& builder) {
+            builder.add_face_vertex_constraints(
+                mesh, vertices, candidates.fv_candidates, is_active, start,
+                end);
         });
 
     CollisionConstraintsBuilder::merge(storage, *this);
 
+    finalize_build(mesh, dhat, dmin);
+}
+
+void CollisionConstraints::finalize_build(
+    const CollisionMesh& mesh, const double dhat, const double dmin)
+{
     for (size_t ci = 0; ci < size(); ci++) {
         CollisionConstraint& constraint = (*this)[ci];
         constraint.minimum_distance = dmin;
@@ -98,6 +225,99 @@ void CollisionConstraints::build(
             }
         }
     }
+
+    build_vertex_incidence(mesh);
+}
+
+void CollisionConstraints::build_vertex_incidence(const CollisionMesh& mesh)
+{
+    const std::vector<std::array<long, 4>> vertex_ids =
+        constraint_vertex_ids(mesh);
+
+    // Counting sort of the (constraint, local vertex) pairs by vertex, so the
+    // incident constraints of each vertex are sorted by constraint id.
+    m_vertex_incidence_offsets.assign(mesh.num_vertices() + 1, 0);
+    for (const std::array<long, 4>& ids : vertex_ids) {
+        for (const long vi : ids) {
+            if (vi >= 0) {
+                m_vertex_incidence_offsets[vi + 1]++;
+            }
+        }
+    }
+    std::partial_sum(
+        m_vertex_incidence_offsets.begin(), m_vertex_incidence_offsets.end(),
+        m_vertex_incidence_offsets.begin());
+
+    m_vertex_incidence.resize(m_vertex_incidence_offsets.back());
+    std::vector<size_t> next(
+        m_vertex_incidence_offsets.begin(),
+        m_vertex_incidence_offsets.end() - 1);
+    for (size_t ci = 0; ci < vertex_ids.size(); ci++) {
+        for (int i = 0; i < 4; i++) {
+            if (vertex_ids[ci][i] >= 0) {
+                m_vertex_incidence[next[vertex_ids[ci][i]]++] = { ci, i };
+            }
+        }
+    }
+    m_vertex_incidence_size = vertex_ids.size();
+#ifndef NDEBUG
+    m_vertex_incidence_fingerprint = vertex_ids_fingerprint(vertex_ids);
+#endif
+}
+
+std::vector<std::array<long, 4>>
+CollisionConstraints::constraint_vertex_ids(const CollisionMesh& mesh) const
+{
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    std::vector<std::array<long, 4>> vertex_ids(size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t ci = r.begin(); ci < r.end(); ci++) {
+                vertex_ids[ci] = (*this)[ci].vertex_ids(edges, faces);
+            }
+        });
+    return vertex_ids;
+}
+
+uint64_t CollisionConstraints::vertex_ids_fingerprint(
+    const std::vector<std::array<long, 4>>& vertex_ids)
+{
+    // 64-bit FNV-1a of the number of constraints and their vertex ids
+    uint64_t fingerprint = 0xcbf29ce484222325;
+    const auto combine = [&](const uint64_t value) {
+        fingerprint = (fingerprint ^ value) * 0x100000001b3;
+    };
+    combine(vertex_ids.size());
+    for (const std::array<long, 4>& ids : vertex_ids) {
+        for (const long vi : ids) {
+            combine(vi);
+        }
+    }
+    return fingerprint;
+}
+
+size_t CollisionConstraints::num_vertex_constraints(const size_t vi) const
+{
+    if (vi + 1 >= m_vertex_incidence_offsets.size()) {
+        return 0;
+    }
+    return m_vertex_incidence_offsets[vi + 1] - m_vertex_incidence_offsets[vi];
+}
+
+std::future<void> CollisionConstraints::build_async(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const double dmin,
+    const BroadPhaseMethod broad_phase_method)
+{
+    return run_async(
+        [this, &mesh, &vertices, dhat, dmin, broad_phase_method]() {
+            this->build(mesh, vertices, dhat, dmin, broad_phase_method);
+        });
 }
 
 void CollisionConstraints::set_use_convergent_formulation(
@@ -140,24 +360,11 @@ double CollisionConstraints::compute_potential(
         return 0;
     }
 
-    tbb::enumerable_thread_specific<double> storage(0);
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_potential = storage.local();
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                // Quadrature weight is premultiplied by compute_potential
-                local_potential += (*this)[i].compute_potential(
-                    vertices, mesh.edges(), mesh.faces(), dhat);
-            }
-        });
-
-    double potential = 0;
-    for (const auto& local_potential : storage) {
-        potential += local_potential;
-    }
-    return potential;
+    // Quadrature weight is premultiplied by compute_potential
+    return deterministic_parallel_sum(size(), [&](size_t i) {
+        return (*this)[i].compute_potential(
+            vertices, mesh.edges(), mesh.faces(), dhat);
+    });
 }
 
 Eigen::VectorXd CollisionConstraints::compute_potential_gradient(
@@ -174,40 +381,152 @@ Eigen::VectorXd CollisionConstraints::compute_potential_gradient(
     const Eigen::MatrixXi& edges = mesh.edges();
     const Eigen::MatrixXi& faces = mesh.faces();
 
-    int dim = vertices.cols();
+    const int dim = vertices.cols();
+
+    return deterministic_gradient_assembly(
+        size(), vertices.rows(), dim,
+        [&](size_t i, VectorMax12d& local_grad, std::array<long, 4>& ids) {
+            local_grad = (*this)[i].compute_potential_gradient(
+                vertices, edges, faces, dhat);
+            ids = (*this)[i].vertex_ids(edges, faces);
+        });
+}
+
+Eigen::SparseMatrix<double> CollisionConstraints::compute_potential_hessian(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const bool upper_triangular) const
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    if (empty()) {
+        return Eigen::SparseMatrix<double>(vertices.size(), vertices.size());
+    }
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    const int dim = vertices.cols();
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(vertices.size()));
+    return deterministic_sparse_block_assembly(
+        size(), vertices.size(), vertices.size(),
+        [&](size_t start, size_t end,
+            std::vector<Eigen::Triplet<double>>& triplets) {
+            visit_potential_hessians(
+                *this, start, end, vertices, edges, faces, dhat,
+                project_hessian_to_psd,
+                [&](size_t i, const MatrixMax12d& local_hess) {
+                    local_hessian_to_global_triplets(
+                        local_hess, (*this)[i].vertex_ids(edges, faces), dim,
+                        triplets, upper_triangular);
+                });
+        });
+}
+
+void CollisionConstraints::compute_potential_local_gradients(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    LocalValuesBuffer local_gradients,
+    LocalVertexIdsBuffer vertex_ids) const
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    const int dim = vertices.cols();
+    check_local_buffers(size(), 4 * dim, local_gradients, vertex_ids);
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_grad = storage.local();
             for (size_t i = r.begin(); i < r.end(); i++) {
-                local_gradient_to_global_gradient(
+                local_gradient_to_buffer(
                     (*this)[i].compute_potential_gradient(
                         vertices, edges, faces, dhat),
-                    (*this)[i].vertex_ids(edges, faces), dim, local_grad);
+                    (*this)[i].vertex_ids(edges, faces),
+                    local_gradients.row(i), vertex_ids.row(i));
             }
         });
+}
 
-    Eigen::VectorXd grad = Eigen::VectorXd::Zero(vertices.size());
-    for (const auto& local_grad : storage) {
-        grad += local_grad;
-    }
-    return grad;
+void CollisionConstraints::compute_potential_local_hessians(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    LocalValuesBuffer local_hessians,
+    LocalVertexIdsBuffer vertex_ids,
+    const bool project_hessian_to_psd) const
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    const int dim = vertices.cols();
+    check_local_buffers(size(), 16 * dim * dim, local_hessians, vertex_ids);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), num_deterministic_blocks(size())),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end =
+                    std::min(size(), start + DETERMINISTIC_BLOCK_SIZE);
+                visit_potential_hessians(
+                    *this, start, end, vertices, edges, faces, dhat,
+                    project_hessian_to_psd,
+                    [&](size_t i, const MatrixMax12d& local_hess) {
+                        local_hessian_to_buffer(
+                            local_hess, (*this)[i].vertex_ids(edges, faces),
+                            dim, local_hessians.row(i), vertex_ids.row(i));
+                    });
+            }
+        });
 }
 
-Eigen::SparseMatrix<double> CollisionConstraints::compute_potential_hessian(
+void CollisionConstraints::compute_vertex_potential_derivatives(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices,
     const double dhat,
+    Eigen::MatrixXd& gradients,
+    Eigen::MatrixXd& hessians,
+    const bool project_hessian_to_psd) const
+{
+    std::vector<long> vertex_subset(vertices.rows());
+    std::iota(vertex_subset.begin(), vertex_subset.end(), 0);
+    compute_vertex_potential_derivatives(
+        mesh, vertices, dhat, vertex_subset, gradients, hessians,
+        project_hessian_to_psd);
+}
+
+void CollisionConstraints::compute_vertex_potential_derivatives(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const std::vector<long>& vertex_subset,
+    Eigen::MatrixXd& gradients,
+    Eigen::MatrixXd& hessians,
     const bool project_hessian_to_psd) const
 {
     assert(vertices.rows() == mesh.num_vertices());
 
-    if (empty()) {
-        return Eigen::SparseMatrix<double>(vertices.size(), vertices.size());
+    // Appending constraints is detected in constant time. Modifying them in
+    // place is only detected in debug builds, because it requires a pass over
+    // every constraint.
+    if (m_vertex_incidence_offsets.size() != mesh.num_vertices() + 1
+        || m_vertex_incidence_size != size()
+#ifndef NDEBUG
+        || m_vertex_incidence_fingerprint
+            != vertex_ids_fingerprint(constraint_vertex_ids(mesh))
+#endif
+    ) {
+        throw std::runtime_error(
+            "Vertex incidence is out of date! Call build_vertex_incidence() "
+            "after modifying the constraints.");
     }
 
     const Eigen::MatrixXi& edges = mesh.edges();
@@ -215,32 +534,101 @@ Eigen::SparseMatrix<double> CollisionConstraints::compute_potential_hessian(
 
     const int dim = vertices.cols();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
+    // Gather the constraints incident on the subset (in constraint order), so
+    // each one is evaluated once even if several of its vertices are in it.
+    // Only the incidence ranges of the subset are visited.
+    std::vector<size_t> incident_constraints;
+    for (const long vi : vertex_subset) {
+        assert(vi >= 0 && vi < vertices.rows());
+        for (size_t k = m_vertex_incidence_offsets[vi];
+             k < m_vertex_incidence_offsets[vi + 1]; k++) {
+            incident_constraints.push_back(m_vertex_incidence[k].first);
+        }
+    }
+    tbb::parallel_sort(
+        incident_constraints.begin(), incident_constraints.end());
+    incident_constraints.erase(
+        std::unique(incident_constraints.begin(), incident_constraints.end()),
+        incident_constraints.end());
+    const auto local_index = [&](const size_t ci) -> size_t {
+        return std::lower_bound(
+                   incident_constraints.begin(), incident_constraints.end(),
+                   ci)
+            - incident_constraints.begin();
+    };
 
+    // Local gradients and diagonal hessian blocks of each incident constraint
+    const size_t n = incident_constraints.size();
+    Eigen::MatrixXd local_gradients(4 * dim, n);
+    Eigen::MatrixXd local_diagonal_blocks(4 * dim * dim, n);
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
+        tbb::blocked_range<size_t>(size_t(0), n),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_hess_triplets = storage.local();
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const CollisionConstraint& constraint =
+                    (*this)[incident_constraints[i]];
 
+                const VectorMax12d local_grad =
+                    constraint.compute_potential_gradient(
+                        vertices, edges, faces, dhat);
+                const MatrixMax12d local_hess =
+                    constraint.compute_potential_hessian(
+                        vertices, edges, faces, dhat, project_hessian_to_psd);
+
+                const int n_verts = local_grad.size() / dim;
+                local_gradients.col(i).head(local_grad.size()) = local_grad;
+                for (int j = 0; j < n_verts; j++) {
+                    Eigen::Map<Eigen::MatrixXd>(
+                        local_diagonal_blocks.col(i).data() + j * dim * dim,
+                        dim, dim) =
+                        local_hess.block(dim * j, dim * j, dim, dim);
+                }
+            }
+        });
+
+    gradients.setZero(vertex_subset.size(), dim);
+    hessians.setZero(dim * vertex_subset.size(), dim);
+
+    // Each vertex only accumulates its own incident constraints in a fixed
+    // order, so the result is deterministic without any reduction.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), vertex_subset.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
             for (size_t i = r.begin(); i < r.end(); i++) {
-                local_hessian_to_global_triplets(
-                    (*this)[i].compute_potential_hessian(
-                        vertices, edges, faces, dhat, project_hessian_to_psd),
-                    (*this)[i].vertex_ids(edges, faces), dim,
-                    local_hess_triplets);
+                const long vi = vertex_subset[i];
+                for (size_t k = m_vertex_incidence_offsets[vi];
+                     k < m_vertex_incidence_offsets[vi + 1]; k++) {
+                    const auto& [ci, local_id] = m_vertex_incidence[k];
+                    const size_t li = local_index(ci);
+
+                    gradients.row(i) += local_gradients.col(li)
+                                            .segment(dim * local_id, dim)
+                                            .transpose();
+                    hessians.middleRows(dim * i, dim) +=
+                        Eigen::Map<const Eigen::MatrixXd>(
+                            local_diagonal_blocks.col(li).data()
+                                + local_id * dim * dim,
+                            dim, dim);
+                }
             }
         });
+}
 
-    Eigen::SparseMatrix<double> hess(vertices.size(), vertices.size());
-    for (const auto& local_hess_triplets : storage) {
-        Eigen::SparseMatrix<double> local_hess(
-            vertices.size(), vertices.size());
-        local_hess.setFromTriplets(
-            local_hess_triplets.begin(), local_hess_triplets.end());
-        hess += local_hess;
-    }
-    return hess;
+std::future<Eigen::SparseMatrix<double>>
+CollisionConstraints::compute_potential_hessian_async(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const bool upper_triangular) const
+{
+    return run_async(
+        [this, &mesh, &vertices, dhat, project_hessian_to_psd,
+         upper_triangular]() {
+            return this->compute_potential_hessian(
+                mesh, vertices, dhat, project_hessian_to_psd,
+                upper_triangular);
+        });
 }
 
 // ============================================================================
@@ -258,58 +646,41 @@ Eigen::SparseMatrix<double> CollisionConstraints::compute_shape_derivative(
 
     const int dim = vertices.cols();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_triplets = storage.local();
-
-            // for (size_t ci = 0; ci < constraint_set.size(); ci++) {
-            for (size_t ci = r.begin(); ci < r.end(); ci++) {
-
-                const CollisionConstraint& constraint = (*this)[ci];
-                const Eigen::SparseVector<double>& weight_gradient =
-                    constraint.weight_gradient;
-                if (weight_gradient.size() != vertices.size()) {
-                    throw std::runtime_error(
-                        "Shape derivative is not computed for contact constraint!");
-                }
+    shape_derivative += deterministic_sparse_assembly(
+        size(), vertices.size(), vertices.size(),
+        [&](size_t ci, std::vector<Eigen::Triplet<double>>& local_triplets) {
+            const CollisionConstraint& constraint = (*this)[ci];
+            const Eigen::SparseVector<double>& weight_gradient =
+                constraint.weight_gradient;
+            if (weight_gradient.size() != vertices.size()) {
+                throw std::runtime_error(
+                    "Shape derivative is not computed for contact constraint!");
+            }
 
-                VectorMax12d local_barrier_grad =
-                    constraint.compute_potential_gradient(
-                        vertices, edges, faces, dhat);
-                assert(constraint.weight != 0);
-                local_barrier_grad.array() /= constraint.weight;
-
-                const std::array<long, 4> ids =
-                    constraint.vertex_ids(edges, faces);
-                assert(local_barrier_grad.size() % dim == 0);
-                const int n_verts = local_barrier_grad.size() / dim;
-                assert(ids.size() >= n_verts); // Can be extra ids
-
-                for (int i = 0; i < n_verts; i++) {
-                    for (int d = 0; d < dim; d++) {
-                        using Itr = Eigen::SparseVector<double>::InnerIterator;
-                        for (Itr j(weight_gradient); j; ++j) {
-                            local_triplets.emplace_back(
-                                ids[i] * dim + d, j.index(),
-                                local_barrier_grad[dim * i + d] * j.value());
-                        }
+            VectorMax12d local_barrier_grad =
+                constraint.compute_potential_gradient(
+                    vertices, edges, faces, dhat);
+            assert(constraint.weight != 0);
+            local_barrier_grad.array() /= constraint.weight;
+
+            const std::array<long, 4> ids =
+                constraint.vertex_ids(edges, faces);
+            assert(local_barrier_grad.size() % dim == 0);
+            const int n_verts = local_barrier_grad.size() / dim;
+            assert(ids.size() >= n_verts); // Can be extra ids
+
+            for (int i = 0; i < n_verts; i++) {
+                for (int d = 0; d < dim; d++) {
+                    using Itr = Eigen::SparseVector<double>::InnerIterator;
+                    for (Itr j(weight_gradient); j; ++j) {
+                        local_triplets.emplace_back(
+                            ids[i] * dim + d, j.index(),
+                            local_barrier_grad[dim * i + d] * j.value());
                     }
                 }
             }
         });
 
-    for (const auto& local_triplets : storage) {
-        Eigen::SparseMatrix<double> local_shape_derivative(
-            vertices.size(), vertices.size());
-        local_shape_derivative.setFromTriplets(
-            local_triplets.begin(), local_triplets.end());
-        shape_derivative += local_shape_derivative;
-    }
-
     return shape_derivative;
 }
 
@@ -359,14 +730,15 @@ double CollisionConstraints::compute_minimum_distance(
 size_t CollisionConstraints::size() const
 {
     return vv_constraints.size() + ev_constraints.size() + ee_constraints.size()
-        + fv_constraints.size() + pv_constraints.size();
+        + fv_constraints.size() + pv_constraints.size()
+        + sdf_constraints.size();
 }
 
 bool CollisionConstraints::empty() const
 {
     return vv_constraints.empty() && ev_constraints.empty()
         && ee_constraints.empty() && fv_constraints.empty()
-        && pv_constraints.empty();
+        && pv_constraints.empty() && sdf_constraints.empty();
 }
 
 void CollisionConstraints::clear()
@@ -376,6 +748,11 @@ void CollisionConstraints::clear()
     ee_constraints.clear();
     fv_constraints.clear();
     pv_constraints.clear();
+    sdf_constraints.clear();
+    m_vertex_incidence_offsets.clear();
+    m_vertex_incidence.clear();
+    m_vertex_incidence_size = 0;
+    m_vertex_incidence_fingerprint = 0;
 }
 
 CollisionConstraint& CollisionConstraints::operator[](size_t idx)
@@ -399,6 +776,10 @@ CollisionConstraint& CollisionConstraints::operator[](size_t idx)
     if (idx < pv_constraints.size()) {
         return pv_constraints[idx];
     }
+    idx -= pv_constraints.size();
+    if (idx < sdf_constraints.size()) {
+        return sdf_constraints[idx];
+    }
     throw std::out_of_range("Constraint index is out of range!");
 }
 
@@ -423,6 +804,10 @@ const CollisionConstraint& CollisionConstraints::operator[](size_t idx) const
     if (idx < pv_constraints.size()) {
         return pv_constraints[idx];
     }
+    idx -= pv_constraints.size();
+    if (idx < sdf_constraints.size()) {
+        return sdf_constraints[idx];
+    }
     throw std::out_of_range("Constraint index is out of range!");
 }
 
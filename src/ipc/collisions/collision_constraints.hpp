@@ -7,13 +7,19 @@
 #include <ipc/collisions/edge_edge.hpp>
 #include <ipc/collisions/face_vertex.hpp>
 #include <ipc/collisions/plane_vertex.hpp>
+#include <ipc/collisions/sdf_vertex.hpp>
 #include <ipc/broad_phase/broad_phase.hpp>
 #include <ipc/candidates/candidates.hpp>
+#include <ipc/candidates/compact_candidates.hpp>
+#include <ipc/utils/local_to_global.hpp>
 
 #include <Eigen/Core>
 
 #include <tbb/enumerable_thread_specific.h>
 
+#include <array>
+#include <cstdint>
+#include <future>
 #include <vector>
 
 namespace ipc {
@@ -23,6 +29,7 @@ public:
     CollisionConstraints() { }
 
     /// @brief Initialize the set of constraints used to compute the barrier potential.
+    /// @note The candidates are culled as the broad phase finds them, so the full list of candidates is never stored.
     /// @param mesh The collision mesh.
     /// @param vertices Vertices of the collision mesh.
     /// @param dhat The activation distance of the barrier.
@@ -48,6 +55,35 @@ public:
         const double dhat,
         const double dmin = 0);
 
+    /// @brief Initialize the set of constraints used to compute the barrier potential.
+    /// @note The compact candidates are expanded one block at a time, so the full list of polymorphic candidates is never stored.
+    /// @param candidates Compact distance candidates from which the constraint set is built.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    void build(
+        const CompactCandidates& candidates,
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        const double dmin = 0);
+
+    /// @brief Asynchronously initialize the set of constraints used to compute the barrier potential.
+    /// @note The constraints, mesh, and vertices must not be modified or destroyed until the future is ready.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    /// @param broad_phase_method Broad-phase method to use.
+    /// @returns A future that is ready once the constraints are built.
+    std::future<void> build_async(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        const double dmin = 0,
+        const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
     // ------------------------------------------------------------------------
 
     /// @brief Compute the barrier potential for a given constraint set.
@@ -75,13 +111,99 @@ public:
     /// @param vertices Vertices of the collision mesh.
     /// @param dhat The activation distance of the barrier.
     /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @param upper_triangular Only assemble the upper triangle of the symmetric hessian (e.g., for symmetric solvers or use with selfadjointView<Eigen::Upper>()).
     /// @returns The hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |vertices|x|vertices|.
     Eigen::SparseMatrix<double> compute_potential_hessian(
         const CollisionMesh& mesh,
         const Eigen::MatrixXd& vertices,
         const double dhat,
+        const bool project_hessian_to_psd = false,
+        const bool upper_triangular = false) const;
+
+    /// @brief Compute the unassembled gradients of the barrier potential of each constraint.
+    /// @note Row i of the buffers holds the local gradient of constraint i zero padded to 4·dim entries and its vertex ids (-1 for unused vertices). This allows custom assemblers to skip the global assembly.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param[out] local_gradients Buffer of at least size() × (4·dim) local gradients (not scaled by the barrier stiffness).
+    /// @param[out] vertex_ids Buffer of at least size() × 4 vertex ids.
+    /// @throws std::invalid_argument If a buffer is too small.
+    void compute_potential_local_gradients(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        LocalValuesBuffer local_gradients,
+        LocalVertexIdsBuffer vertex_ids) const;
+
+    /// @brief Compute the unassembled hessians of the barrier potential of each constraint.
+    /// @note Row i of the buffers holds the local hessian of constraint i as a (4·dim)×(4·dim) column-major matrix (zero padded) and its vertex ids (-1 for unused vertices). This allows custom assemblers to skip the global assembly.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param[out] local_hessians Buffer of at least size() × (4·dim)² local hessians (not scaled by the barrier stiffness).
+    /// @param[out] vertex_ids Buffer of at least size() × 4 vertex ids.
+    /// @param project_hessian_to_psd Make sure the hessians are positive semi-definite.
+    /// @throws std::invalid_argument If a buffer is too small.
+    void compute_potential_local_hessians(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        LocalValuesBuffer local_hessians,
+        LocalVertexIdsBuffer vertex_ids,
         const bool project_hessian_to_psd = false) const;
 
+    /// @brief Compute the gradient and hessian of the barrier potential with respect to each vertex only.
+    /// @note This is intended for block-coordinate (e.g., vertex block descent) solvers. Only the constraints incident on each vertex are evaluated, and no global assembly is performed.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param[out] gradients The |vertices|×dim gradients of each vertex (not scaled by the barrier stiffness).
+    /// @param[out] hessians The (dim·|vertices|)×dim stacked diagonal hessian blocks of each vertex (not scaled by the barrier stiffness).
+    /// @param project_hessian_to_psd Make sure the local hessians are positive semi-definite before extracting the blocks.
+    /// @throws std::runtime_error If the vertex incidence is out of date (constraints modified in place are only detected in debug builds).
+    void compute_vertex_potential_derivatives(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        Eigen::MatrixXd& gradients,
+        Eigen::MatrixXd& hessians,
+        const bool project_hessian_to_psd = false) const;
+
+    /// @brief Compute the gradient and hessian of the barrier potential with respect to each vertex in a subset (e.g., a color group).
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param vertex_subset Ids of the vertices to evaluate.
+    /// @param[out] gradients The |vertex_subset|×dim gradients of each vertex in the subset (not scaled by the barrier stiffness).
+    /// @param[out] hessians The (dim·|vertex_subset|)×dim stacked diagonal hessian blocks of each vertex in the subset (not scaled by the barrier stiffness).
+    /// @param project_hessian_to_psd Make sure the local hessians are positive semi-definite before extracting the blocks.
+    /// @note Each incident constraint is evaluated once, even if several vertices of the subset share it.
+    /// @note The cost is proportional to the number of constraints incident on the subset, not the total number of constraints.
+    /// @throws std::runtime_error If the vertex incidence is out of date (constraints modified in place are only detected in debug builds).
+    void compute_vertex_potential_derivatives(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        const std::vector<long>& vertex_subset,
+        Eigen::MatrixXd& gradients,
+        Eigen::MatrixXd& hessians,
+        const bool project_hessian_to_psd = false) const;
+
+    /// @brief Asynchronously compute the hessian of the barrier potential.
+    /// @note The constraints, mesh, and vertices must not be modified or destroyed until the future is ready.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @param upper_triangular Only assemble the upper triangle of the symmetric hessian.
+    /// @returns A future to the hessian of all barrier potentials (not scaled by the barrier stiffness).
+    std::future<Eigen::SparseMatrix<double>> compute_potential_hessian_async(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        const bool project_hessian_to_psd = false,
+        const bool upper_triangular = false) const;
+
     // ------------------------------------------------------------------------
 
     /// @brief Compute the barrier shape derivative.
@@ -123,6 +245,16 @@ public:
     /// @return A const reference to the constraint.
     const CollisionConstraint& operator[](size_t idx) const;
 
+    /// @brief Build the index of the constraints incident on each vertex.
+    /// @note This is done by build(), but it must be called again if the constraints are modified afterwards (e.g., by adding plane-vertex or SDF-vertex constraints).
+    /// @param mesh The collision mesh.
+    void build_vertex_incidence(const CollisionMesh& mesh);
+
+    /// @brief Get the number of constraints incident on a vertex.
+    /// @param vi The id of the vertex.
+    /// @return The number of constraints incident on vertex vi.
+    size_t num_vertex_constraints(const size_t vi) const;
+
     /// @brief Get if the collision constraints should use the convergent formulation.
     /// @note If not empty, this is the current value not necessarily the value used to build the constraints.
     /// @return If the collision constraints should use the convergent formulation.
@@ -156,10 +288,40 @@ public:
     std::vector<EdgeEdgeConstraint> ee_constraints;
     std::vector<FaceVertexConstraint> fv_constraints;
     std::vector<PlaneVertexConstraint> pv_constraints;
+    std::vector<SDFVertexConstraint> sdf_constraints;
 
 protected:
+    /// @brief Set the minimum distance, scale the weights of the built constraints, and build the vertex incidence.
+    /// @param mesh The collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    void finalize_build(
+        const CollisionMesh& mesh, const double dhat, const double dmin);
+
     bool m_use_convergent_formulation = false;
     bool m_are_shape_derivatives_enabled = false;
+
+    /// @brief Offsets of each vertex into m_vertex_incidence (CSR format).
+    std::vector<size_t> m_vertex_incidence_offsets;
+    /// @brief Incident (constraint id, local vertex id) pairs of each vertex sorted by constraint id.
+    std::vector<std::pair<size_t, int>> m_vertex_incidence;
+    /// @brief Number of constraints when the vertex incidence was built.
+    size_t m_vertex_incidence_size = 0;
+    /// @brief Fingerprint of the constraints' vertex ids when the vertex incidence was built (only computed in debug builds).
+    uint64_t m_vertex_incidence_fingerprint = 0;
+
+    /// @brief Compute a fingerprint of the vertex ids of every constraint.
+    /// @note Used in debug builds to detect constraints modified in place after building the vertex incidence.
+    /// @param vertex_ids Vertex ids of each constraint.
+    /// @return The fingerprint.
+    static uint64_t
+    vertex_ids_fingerprint(const std::vector<std::array<long, 4>>& vertex_ids);
+
+    /// @brief Get the vertex ids of every constraint.
+    /// @param mesh The collision mesh.
+    /// @return The vertex ids of each constraint (-1 for unused vertices).
+    std::vector<std::array<long, 4>>
+    constraint_vertex_ids(const CollisionMesh& mesh) const;
 };
 
 } // namespace ipc
@@ -5,9 +5,298 @@
 #include <ipc/distance/edge_edge.hpp>
 #include <ipc/distance/edge_edge_mollifier.hpp>
 #include <ipc/distance/point_triangle.hpp>
+#include <ipc/collisions/compact_collision_constraints.hpp>
+
+#include <array>
+#include <iterator>
 
 namespace ipc {
 
+namespace {
+    /// @brief Accessor of the i-th candidate of a vector.
+    template <typename Candidate>
+    auto element_at(const std::vector<Candidate>& candidates)
+    {
+        return [&candidates](size_t i) -> const Candidate& {
+            return candidates[i];
+        };
+    }
+
+    /// @brief Accessor materializing the i-th compact candidate on the stack.
+    template <typename Candidate>
+    auto materialize_at(const std::vector<CompactCandidate>& candidates)
+    {
+        return [&candidates](size_t i) {
+            return Candidate(candidates[i].id0, candidates[i].id1);
+        };
+    }
+
+    /// @brief Add the active constraints of the edge-vertex candidates [start, end).
+    /// @param builder Builder the constraints are added to (merging duplicate vertex-vertex and edge-vertex constraints).
+    /// @param candidate_at Function returning the i-th candidate.
+    template <typename Builder, typename CandidateAt>
+    void add_edge_vertex_candidates(
+        Builder& builder,
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const CandidateAt& candidate_at,
+        const std::function<bool(double)>& is_active,
+        const size_t start,
+        const size_t end)
+    {
+        for (size_t i = start; i < end; i++) {
+            const auto& candidate = candidate_at(i);
+            const auto& [ei, vi] = candidate;
+            const long e0i = mesh.edges()(ei, 0), e1i = mesh.edges()(ei, 1);
+
+            const auto [v, e0, e1, _] =
+                candidate.vertices(vertices, mesh.edges(), mesh.faces());
+            PointEdgeDistanceType dtype = point_edge_distance_type(v, e0, e1);
+            double distance_sqr = point_edge_distance(v, e0, e1, dtype);
+
+            if (!is_active(distance_sqr))
+                continue;
+
+            // ÷ 2 to handle double counting for correct integration
+            const double weight = builder.use_convergent_formulation()
+                ? (mesh.vertex_area(vi) / 2)
+                : 1;
+
+            Eigen::SparseVector<double> weight_gradient;
+            if (builder.should_compute_weight_gradient()) {
+                weight_gradient = builder.use_convergent_formulation()
+                    ? (mesh.vertex_area_gradient(vi) / 2)
+                    : Eigen::SparseVector<double>(vertices.size());
+            }
+
+            switch (dtype) {
+            case PointEdgeDistanceType::P_E0:
+                builder.add_vertex_vertex_constraint(
+                    vi, e0i, weight, weight_gradient);
+                break;
+
+            case PointEdgeDistanceType::P_E1:
+                builder.add_vertex_vertex_constraint(
+                    vi, e1i, weight, weight_gradient);
+                break;
+
+            case PointEdgeDistanceType::P_E:
+                // ev_candidates is a set, so this is never a duplicate.
+                builder.add_edge_vertex_constraint(
+                    ei, vi, weight, weight_gradient);
+                break;
+
+            case PointEdgeDistanceType::AUTO:
+                assert(false);
+                break;
+            }
+        }
+    }
+
+    /// @brief Add the active constraints of the edge-edge candidates [start, end).
+    /// @param builder Builder the constraints are added to (merging duplicate vertex-vertex and edge-vertex constraints).
+    /// @param candidate_at Function returning the i-th candidate.
+    template <typename Builder, typename CandidateAt>
+    void add_edge_edge_candidates(
+        Builder& builder,
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const CandidateAt& candidate_at,
+        const std::function<bool(double)>& is_active,
+        const size_t start,
+        const size_t end)
+    {
+        for (size_t i = start; i < end; i++) {
+            const auto& candidate = candidate_at(i);
+            const auto& [eai, ebi] = candidate;
+
+            const auto [ea0i, ea1i, eb0i, eb1i] =
+                candidate.vertex_ids(mesh.edges(), mesh.faces());
+
+            const auto [ea0, ea1, eb0, eb1] =
+                candidate.vertices(vertices, mesh.edges(), mesh.faces());
+
+            EdgeEdgeDistanceType dtype =
+                edge_edge_distance_type(ea0, ea1, eb0, eb1);
+
+            const double distance_sqr =
+                edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
+
+            if (!is_active(distance_sqr))
+                continue;
+
+            const double eps_x = edge_edge_mollifier_threshold(
+                mesh.rest_positions().row(ea0i),
+                mesh.rest_positions().row(ea1i),
+                mesh.rest_positions().row(eb0i),
+                mesh.rest_positions().row(eb1i));
+
+            const double ee_cross_norm_sqr =
+                edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1);
+
+            if (ee_cross_norm_sqr < eps_x) {
+                // NOTE: This may not actually be the distance type, but all EE
+                // pairs requiring mollification must be mollified later.
+                dtype = EdgeEdgeDistanceType::EA_EB;
+            }
+
+            // ÷ 4 to handle double counting and PT + EE for correct
+            // integration.
+            // Sum edge areas because duplicate edge candidates were removed.
+            const double weight = builder.use_convergent_formulation()
+                ? ((mesh.edge_area(eai) + mesh.edge_area(ebi)) / 4)
+                : 1;
+
+            Eigen::SparseVector<double> weight_gradient;
+            if (builder.should_compute_weight_gradient()) {
+                weight_gradient = builder.use_convergent_formulation()
+                    ? ((mesh.edge_area_gradient(eai)
+                        + mesh.edge_area_gradient(ebi))
+                       / 4)
+                    : Eigen::SparseVector<double>(vertices.size());
+            }
+
+            switch (dtype) {
+            case EdgeEdgeDistanceType::EA0_EB0:
+                builder.add_vertex_vertex_constraint(
+                    ea0i, eb0i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA0_EB1:
+                builder.add_vertex_vertex_constraint(
+                    ea0i, eb1i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA1_EB0:
+                builder.add_vertex_vertex_constraint(
+                    ea1i, eb0i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA1_EB1:
+                builder.add_vertex_vertex_constraint(
+                    ea1i, eb1i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA_EB0:
+                builder.add_edge_vertex_constraint(
+                    eai, eb0i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA_EB1:
+                builder.add_edge_vertex_constraint(
+                    eai, eb1i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA0_EB:
+                builder.add_edge_vertex_constraint(
+                    ebi, ea0i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA1_EB:
+                builder.add_edge_vertex_constraint(
+                    ebi, ea1i, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::EA_EB:
+                builder.add_edge_edge_constraint(
+                    eai, ebi, eps_x, weight, weight_gradient);
+                break;
+
+            case EdgeEdgeDistanceType::AUTO:
+                assert(false);
+                break;
+            }
+        }
+    }
+
+    /// @brief Add the active constraints of the face-vertex candidates [start, end).
+    /// @param builder Builder the constraints are added to (merging duplicate vertex-vertex and edge-vertex constraints).
+    /// @param candidate_at Function returning the i-th candidate.
+    template <typename Builder, typename CandidateAt>
+    void add_face_vertex_candidates(
+        Builder& builder,
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const CandidateAt& candidate_at,
+        const std::function<bool(double)>& is_active,
+        const size_t start,
+        const size_t end)
+    {
+        for (size_t i = start; i < end; i++) {
+            const auto& candidate = candidate_at(i);
+            const auto& [fi, vi] = candidate;
+            const long f0i = mesh.faces()(fi, 0), f1i = mesh.faces()(fi, 1),
+                       f2i = mesh.faces()(fi, 2);
+
+            const auto [v, f0, f1, f2] =
+                candidate.vertices(vertices, mesh.edges(), mesh.faces());
+
+            // Compute distance type
+            const PointTriangleDistanceType dtype =
+                point_triangle_distance_type(v, f0, f1, f2);
+            const double distance_sqr =
+                point_triangle_distance(v, f0, f1, f2, dtype);
+
+            if (!is_active(distance_sqr))
+                continue;
+
+            // ÷ 4 to handle double counting and PT + EE for correct
+            // integration
+            const double weight = builder.use_convergent_formulation()
+                ? (mesh.vertex_area(vi) / 4)
+                : 1;
+
+            Eigen::SparseVector<double> weight_gradient;
+            if (builder.should_compute_weight_gradient()) {
+                weight_gradient = builder.use_convergent_formulation()
+                    ? (mesh.vertex_area_gradient(vi) / 4)
+                    : Eigen::SparseVector<double>(vertices.size());
+            }
+
+            switch (dtype) {
+            case PointTriangleDistanceType::P_T0:
+                builder.add_vertex_vertex_constraint(
+                    vi, f0i, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::P_T1:
+                builder.add_vertex_vertex_constraint(
+                    vi, f1i, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::P_T2:
+                builder.add_vertex_vertex_constraint(
+                    vi, f2i, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::P_E0:
+                builder.add_edge_vertex_constraint(
+                    mesh.faces_to_edges()(fi, 0), vi, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::P_E1:
+                builder.add_edge_vertex_constraint(
+                    mesh.faces_to_edges()(fi, 1), vi, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::P_E2:
+                builder.add_edge_vertex_constraint(
+                    mesh.faces_to_edges()(fi, 2), vi, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::P_T:
+                builder.add_face_vertex_constraint(
+                    fi, vi, weight, weight_gradient);
+                break;
+
+            case PointTriangleDistanceType::AUTO:
+                assert(false);
+                break;
+            }
+        }
+    }
+} // namespace
+
 CollisionConstraintsBuilder::CollisionConstraintsBuilder(
     const CollisionConstraints& empty_constraints)
 {
@@ -25,53 +314,9 @@ void CollisionConstraintsBuilder::add_edge_vertex_constraints(
     const size_t start_i,
     const size_t end_i)
 {
-    for (size_t i = start_i; i < end_i; i++) {
-        const auto& [ei, vi] = candidates[i];
-        const long e0i = mesh.edges()(ei, 0), e1i = mesh.edges()(ei, 1);
-
-        const auto [v, e0, e1, _] =
-            candidates[i].vertices(vertices, mesh.edges(), mesh.faces());
-        PointEdgeDistanceType dtype = point_edge_distance_type(v, e0, e1);
-        double distance_sqr = point_edge_distance(v, e0, e1, dtype);
-
-        if (!is_active(distance_sqr))
-            continue;
-
-        // ÷ 2 to handle double counting for correct integration
-        const double weight =
-            use_convergent_formulation() ? (mesh.vertex_area(vi) / 2) : 1;
-
-        Eigen::SparseVector<double> weight_gradient;
-        if (should_compute_weight_gradient()) {
-            weight_gradient = use_convergent_formulation()
-                ? (mesh.vertex_area_gradient(vi) / 2)
-                : Eigen::SparseVector<double>(vertices.size());
-        }
-
-        switch (dtype) {
-        case PointEdgeDistanceType::P_E0:
-            add_vertex_vertex_constraint(vi, e0i, weight, weight_gradient);
-            break;
-
-        case PointEdgeDistanceType::P_E1:
-            add_vertex_vertex_constraint(vi, e1i, weight, weight_gradient);
-            break;
-
-        case PointEdgeDistanceType::P_E:
-            // ev_candidates is a set, so no duplicate EV CollisionConstraints
-            constraints.ev_constraints.emplace_back(ei, vi);
-            constraints.ev_constraints.back().weight = weight;
-            constraints.ev_constraints.back().weight_gradient = weight_gradient;
-            ev_to_id.emplace(
-                constraints.ev_constraints.back(),
-                constraints.ev_constraints.size() - 1);
-            break;
-
-        case PointEdgeDistanceType::AUTO:
-            assert(false);
-            break;
-        }
-    }
+    add_edge_vertex_candidates(
+        *this, mesh, vertices, element_at(candidates), is_active, start_i,
+        end_i);
 }
 
 void CollisionConstraintsBuilder::add_edge_edge_constraints(
@@ -82,172 +327,64 @@ void CollisionConstraintsBuilder::add_edge_edge_constraints(
     const size_t start_i,
     const size_t end_i)
 {
-    for (size_t i = start_i; i < end_i; i++) {
-        const auto& [eai, ebi] = candidates[i];
-
-        const auto [ea0i, ea1i, eb0i, eb1i] =
-            candidates[i].vertex_ids(mesh.edges(), mesh.faces());
-
-        const auto [ea0, ea1, eb0, eb1] =
-            candidates[i].vertices(vertices, mesh.edges(), mesh.faces());
-
-        EdgeEdgeDistanceType dtype =
-            edge_edge_distance_type(ea0, ea1, eb0, eb1);
-
-        const double distance_sqr =
-            edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
-
-        if (!is_active(distance_sqr))
-            continue;
-
-        const double eps_x = edge_edge_mollifier_threshold(
-            mesh.rest_positions().row(ea0i), mesh.rest_positions().row(ea1i),
-            mesh.rest_positions().row(eb0i), mesh.rest_positions().row(eb1i));
-
-        const double ee_cross_norm_sqr =
-            edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1);
-
-        if (ee_cross_norm_sqr < eps_x) {
-            // NOTE: This may not actually be the distance type, but all EE
-            // pairs requiring mollification must be mollified later.
-            dtype = EdgeEdgeDistanceType::EA_EB;
-        }
-
-        // ÷ 4 to handle double counting and PT + EE for correct integration.
-        // Sum edge areas because duplicate edge candidates were removed.
-        const double weight = use_convergent_formulation()
-            ? ((mesh.edge_area(eai) + mesh.edge_area(ebi)) / 4)
-            : 1;
-
-        Eigen::SparseVector<double> weight_gradient;
-        if (should_compute_weight_gradient()) {
-            weight_gradient = use_convergent_formulation()
-                ? ((mesh.edge_area_gradient(eai) + mesh.edge_area_gradient(ebi))
-                   / 4)
-                : Eigen::SparseVector<double>(vertices.size());
-        }
-
-        switch (dtype) {
-        case EdgeEdgeDistanceType::EA0_EB0:
-            add_vertex_vertex_constraint(ea0i, eb0i, weight, weight_gradient);
-            break;
-
-        case EdgeEdgeDistanceType::EA0_EB1:
-            add_vertex_vertex_constraint(ea0i, eb1i, weight, weight_gradient);
-            break;
-
-        case EdgeEdgeDistanceType::EA1_EB0:
-            add_vertex_vertex_constraint(ea1i, eb0i, weight, weight_gradient);
-            break;
-
-        case EdgeEdgeDistanceType::EA1_EB1:
-            add_vertex_vertex_constraint(ea1i, eb1i, weight, weight_gradient);
-            break;
-
-        case EdgeEdgeDistanceType::EA_EB0:
-            add_edge_vertex_constraint(eai, eb0i, weight, weight_gradient);
-            break;
-
-        case EdgeEdgeDistanceType::EA_EB1:
-            add_edge_vertex_constraint(eai, eb1i, weight, weight_gradient);
-            break;
-
-        case EdgeEdgeDistanceType::EA0_EB:
-            add_edge_vertex_constraint(ebi, ea0i, weight, weight_gradient);
-            break;
+    add_edge_edge_candidates(
+        *this, mesh, vertices, element_at(candidates), is_active, start_i,
+        end_i);
+}
 
-        case EdgeEdgeDistanceType::EA1_EB:
-            add_edge_vertex_constraint(ebi, ea1i, weight, weight_gradient);
-            break;
+void CollisionConstraintsBuilder::add_face_vertex_constraints(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const std::vector<FaceVertexCandidate>& candidates,
+    const std::function<bool(double)>& is_active,
+    const size_t start_i,
+    const size_t end_i)
+{
+    add_face_vertex_candidates(
+        *this, mesh, vertices, element_at(candidates), is_active, start_i,
+        end_i);
+}
 
-        case EdgeEdgeDistanceType::EA_EB:
-            constraints.ee_constraints.emplace_back(eai, ebi, eps_x);
-            constraints.ee_constraints.back().weight = weight;
-            constraints.ee_constraints.back().weight_gradient = weight_gradient;
-            break;
+void CollisionConstraintsBuilder::add_edge_vertex_constraints(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const std::vector<CompactCandidate>& candidates,
+    const std::function<bool(double)>& is_active,
+    const size_t start_i,
+    const size_t end_i)
+{
+    add_edge_vertex_candidates(
+        *this, mesh, vertices,
+        materialize_at<EdgeVertexCandidate>(candidates), is_active, start_i,
+        end_i);
+}
 
-        case EdgeEdgeDistanceType::AUTO:
-            assert(false);
-            break;
-        }
-    }
+void CollisionConstraintsBuilder::add_edge_edge_constraints(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const std::vector<CompactCandidate>& candidates,
+    const std::function<bool(double)>& is_active,
+    const size_t start_i,
+    const size_t end_i)
+{
+    add_edge_edge_candidates(
+        *this, mesh, vertices,
+        materialize_at<EdgeEdgeCandidate>(candidates), is_active, start_i,
+        end_i);
 }
 
 void CollisionConstraintsBuilder::add_face_vertex_constraints(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices,
-    const std::vector<FaceVertexCandidate>& candidates,
+    const std::vector<CompactCandidate>& candidates,
     const std::function<bool(double)>& is_active,
     const size_t start_i,
     const size_t end_i)
 {
-    for (size_t i = start_i; i < end_i; i++) {
-        const auto& [fi, vi] = candidates[i];
-        const long f0i = mesh.faces()(fi, 0), f1i = mesh.faces()(fi, 1),
-                   f2i = mesh.faces()(fi, 2);
-
-        const auto [v, f0, f1, f2] =
-            candidates[i].vertices(vertices, mesh.edges(), mesh.faces());
-
-        // Compute distance type
-        const PointTriangleDistanceType dtype =
-            point_triangle_distance_type(v, f0, f1, f2);
-        const double distance_sqr =
-            point_triangle_distance(v, f0, f1, f2, dtype);
-
-        if (!is_active(distance_sqr))
-            continue;
-
-        // ÷ 4 to handle double counting and PT + EE for correct integration
-        const double weight =
-            use_convergent_formulation() ? (mesh.vertex_area(vi) / 4) : 1;
-
-        Eigen::SparseVector<double> weight_gradient;
-        if (should_compute_weight_gradient()) {
-            weight_gradient = use_convergent_formulation()
-                ? (mesh.vertex_area_gradient(vi) / 4)
-                : Eigen::SparseVector<double>(vertices.size());
-        }
-
-        switch (dtype) {
-        case PointTriangleDistanceType::P_T0:
-            add_vertex_vertex_constraint(vi, f0i, weight, weight_gradient);
-            break;
-
-        case PointTriangleDistanceType::P_T1:
-            add_vertex_vertex_constraint(vi, f1i, weight, weight_gradient);
-            break;
-
-        case PointTriangleDistanceType::P_T2:
-            add_vertex_vertex_constraint(vi, f2i, weight, weight_gradient);
-            break;
-
-        case PointTriangleDistanceType::P_E0:
-            add_edge_vertex_constraint(
-                mesh.faces_to_edges()(fi, 0), vi, weight, weight_gradient);
-            break;
-
-        case PointTriangleDistanceType::P_E1:
-            add_edge_vertex_constraint(
-                mesh.faces_to_edges()(fi, 1), vi, weight, weight_gradient);
-            break;
-
-        case PointTriangleDistanceType::P_E2:
-            add_edge_vertex_constraint(
-                mesh.faces_to_edges()(fi, 2), vi, weight, weight_gradient);
-            break;
-
-        case PointTriangleDistanceType::P_T:
-            constraints.fv_constraints.emplace_back(fi, vi);
-            constraints.fv_constraints.back().weight = weight;
-            constraints.fv_constraints.back().weight_gradient = weight_gradient;
-            break;
-
-        case PointTriangleDistanceType::AUTO:
-            assert(false);
-            break;
-        }
-    }
+    add_face_vertex_candidates(
+        *this, mesh, vertices,
+        materialize_at<FaceVertexCandidate>(candidates), is_active, start_i,
+        end_i);
 }
 
 // ============================================================================
@@ -301,8 +438,7 @@ void CollisionConstraintsBuilder::add_edge_vertex_constraint(
 // ============================================================================
 
 void CollisionConstraintsBuilder::merge(
-    const tbb::enumerable_thread_specific<CollisionConstraintsBuilder>&
-        local_storage,
+    const std::vector<CollisionConstraintsBuilder>& local_storage,
     CollisionConstraints& merged_constraints)
 {
     unordered_map<VertexVertexConstraint, long> vv_to_id;
@@ -365,4 +501,161 @@ void CollisionConstraintsBuilder::merge(
     }
 }
 
+// ============================================================================
+
+CompactCollisionConstraintsBuilder::CompactCollisionConstraintsBuilder(
+    const CompactCollisionConstraints& empty_constraints)
+    : m_use_convergent_formulation(
+          empty_constraints.use_convergent_formulation)
+    , m_should_compute_weight_gradient(
+          empty_constraints.are_shape_derivatives_enabled)
+{
+    assert(empty_constraints.empty());
+}
+
+void CompactCollisionConstraintsBuilder::add_edge_vertex_constraints(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const std::vector<CompactCandidate>& candidates,
+    const std::function<bool(double)>& is_active,
+    const size_t start_i,
+    const size_t end_i)
+{
+    add_edge_vertex_candidates(
+        *this, mesh, vertices,
+        materialize_at<EdgeVertexCandidate>(candidates), is_active, start_i,
+        end_i);
+}
+
+void CompactCollisionConstraintsBuilder::add_edge_edge_constraints(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const std::vector<CompactCandidate>& candidates,
+    const std::function<bool(double)>& is_active,
+    const size_t start_i,
+    const size_t end_i)
+{
+    add_edge_edge_candidates(
+        *this, mesh, vertices,
+        materialize_at<EdgeEdgeCandidate>(candidates), is_active, start_i,
+        end_i);
+}
+
+void CompactCollisionConstraintsBuilder::add_face_vertex_constraints(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const std::vector<CompactCandidate>& candidates,
+    const std::function<bool(double)>& is_active,
+    const size_t start_i,
+    const size_t end_i)
+{
+    add_face_vertex_candidates(
+        *this, mesh, vertices,
+        materialize_at<FaceVertexCandidate>(candidates), is_active, start_i,
+        end_i);
+}
+
+void CompactCollisionConstraintsBuilder::add_deduplicated_constraint(
+    const CompactCandidate& id,
+    const double weight,
+    const Eigen::SparseVector<double>& weight_gradient,
+    unordered_map<uint64_t, long>& to_id,
+    ConstraintList& constraints) const
+{
+    const uint64_t key = (uint64_t(id.id0) << 32) | uint64_t(id.id1);
+    auto found_item = to_id.find(key);
+    if (found_item != to_id.end()) {
+        // Constraint already exists, so increase weight
+        constraints.weights[found_item->second] += weight;
+        if (m_should_compute_weight_gradient) {
+            constraints.weight_gradients[found_item->second] +=
+                weight_gradient;
+        }
+    } else {
+        // New constraint, so add it to the end of the constraints
+        to_id.emplace(key, constraints.ids.size());
+        constraints.add(
+            id, weight, weight_gradient, m_should_compute_weight_gradient);
+    }
+}
+
+void CompactCollisionConstraintsBuilder::merge(
+    const std::vector<CompactCollisionConstraintsBuilder>& local_storage,
+    CompactCollisionConstraints& merged_constraints)
+{
+    CompactCollisionConstraintsBuilder merged(merged_constraints);
+
+    // The weight gradient of the i-th constraint of a list (if computed).
+    const Eigen::SparseVector<double> no_weight_gradient;
+    const auto weight_gradient = [&](const ConstraintList& constraints,
+                                     const size_t i)
+        -> const Eigen::SparseVector<double>& {
+        return constraints.weight_gradients.empty()
+            ? no_weight_gradient
+            : constraints.weight_gradients[i];
+    };
+
+    // merge
+    for (const auto& builder : local_storage) {
+        if (merged.vv_constraints.ids.empty()) {
+            merged.vv_to_id = builder.vv_to_id;
+            merged.vv_constraints.append(builder.vv_constraints);
+        } else {
+            const ConstraintList& vv = builder.vv_constraints;
+            for (size_t i = 0; i < vv.ids.size(); i++) {
+                merged.add_deduplicated_constraint(
+                    vv.ids[i], vv.weights[i], weight_gradient(vv, i),
+                    merged.vv_to_id, merged.vv_constraints);
+            }
+        }
+
+        if (merged.ev_constraints.ids.empty()) {
+            merged.ev_to_id = builder.ev_to_id;
+            merged.ev_constraints.append(builder.ev_constraints);
+        } else {
+            const ConstraintList& ev = builder.ev_constraints;
+            for (size_t i = 0; i < ev.ids.size(); i++) {
+                merged.add_deduplicated_constraint(
+                    ev.ids[i], ev.weights[i], weight_gradient(ev, i),
+                    merged.ev_to_id, merged.ev_constraints);
+            }
+        }
+
+        merged.ee_constraints.append(builder.ee_constraints);
+        merged.ee_eps_x.insert(
+            merged.ee_eps_x.end(), builder.ee_eps_x.begin(),
+            builder.ee_eps_x.end());
+        merged.fv_constraints.append(builder.fv_constraints);
+    }
+
+    // Concatenate the side arrays in the order vv, ev, ee, fv.
+    const std::array<ConstraintList*, 4> lists = {
+        { &merged.vv_constraints, &merged.ev_constraints,
+          &merged.ee_constraints, &merged.fv_constraints }
+    };
+    size_t n = 0;
+    for (const ConstraintList* constraints : lists) {
+        n += constraints->ids.size();
+    }
+    merged_constraints.weights.reserve(n);
+    if (merged.m_should_compute_weight_gradient) {
+        merged_constraints.weight_gradients.reserve(n);
+    }
+    for (ConstraintList* constraints : lists) {
+        merged_constraints.weights.insert(
+            merged_constraints.weights.end(), constraints->weights.begin(),
+            constraints->weights.end());
+        std::move(
+            constraints->weight_gradients.begin(),
+            constraints->weight_gradients.end(),
+            std::back_inserter(merged_constraints.weight_gradients));
+    }
+
+    merged_constraints.vv_constraints = std::move(merged.vv_constraints.ids);
+    merged_constraints.ev_constraints = std::move(merged.ev_constraints.ids);
+    merged_constraints.ee_constraints = std::move(merged.ee_constraints.ids);
+    merged_constraints.fv_constraints = std::move(merged.fv_constraints.ids);
+    merged_constraints.ee_eps_x = std::move(merged.ee_eps_x);
+}
+
 } // namespace ipc
\ No newline at end of file
@@ -3,14 +3,23 @@
 #include <ipc/collision_mesh.hpp>
 #include <ipc/candidates/vertex_vertex.hpp>
 #include <ipc/candidates/edge_vertex.hpp>
+#include <ipc/candidates/compact_candidates.hpp>
 #include <ipc/collisions/collision_constraints.hpp>
-
-#include <tbb/enumerable_thread_specific.h>
+#include <ipc/utils/deterministic_reduction.hpp>
 
 #include <Eigen/Core>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 namespace ipc {
 
+class CompactCollisionConstraints;
+
 class CollisionConstraintsBuilder {
 public:
     CollisionConstraintsBuilder(const CollisionConstraints& empty_constraints);
@@ -39,11 +48,95 @@ public:
         const size_t start_i,
         const size_t end_i);
 
+    void add_edge_vertex_constraints(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const std::vector<CompactCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i);
+
+    void add_edge_edge_constraints(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const std::vector<CompactCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i);
+
+    void add_face_vertex_constraints(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const std::vector<CompactCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i);
+
+    /// @brief Merge the builders' constraints in order.
+    /// @param local_storage Builders to merge (merged in the given order).
+    /// @param merged_constraints Output merged constraints.
     static void merge(
-        const tbb::enumerable_thread_specific<CollisionConstraintsBuilder>&
-            local_storage,
+        const std::vector<CollisionConstraintsBuilder>& local_storage,
         CollisionConstraints& merged_constraints);
 
+    // ------------------------------------------------------------------------
+    // Interface used to add the classified constraints.
+
+    void add_vertex_vertex_constraint(
+        const long v0i,
+        const long v1i,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient)
+    {
+        add_vertex_vertex_constraint(
+            v0i, v1i, weight, weight_gradient, vv_to_id,
+            constraints.vv_constraints);
+    }
+
+    void add_edge_vertex_constraint(
+        const long ei,
+        const long vi,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient)
+    {
+        add_edge_vertex_constraint(
+            ei, vi, weight, weight_gradient, ev_to_id,
+            constraints.ev_constraints);
+    }
+
+    void add_edge_edge_constraint(
+        const long eai,
+        const long ebi,
+        const double eps_x,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient)
+    {
+        constraints.ee_constraints.emplace_back(eai, ebi, eps_x);
+        constraints.ee_constraints.back().weight = weight;
+        constraints.ee_constraints.back().weight_gradient = weight_gradient;
+    }
+
+    void add_face_vertex_constraint(
+        const long fi,
+        const long vi,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient)
+    {
+        constraints.fv_constraints.emplace_back(fi, vi);
+        constraints.fv_constraints.back().weight = weight;
+        constraints.fv_constraints.back().weight_gradient = weight_gradient;
+    }
+
+    bool use_convergent_formulation() const
+    {
+        return constraints.use_convergent_formulation();
+    }
+
+    bool should_compute_weight_gradient() const
+    {
+        return constraints.are_shape_derivatives_enabled();
+    }
+
 protected:
     static void add_vertex_vertex_constraint(
         const long v0i,
@@ -61,15 +154,66 @@ protected:
         unordered_map<EdgeVertexConstraint, long>& ev_to_id,
         std::vector<EdgeVertexConstraint>& ev_constraints);
 
+    // Store the indices to VV and EV pairs to avoid duplicates.
+    unordered_map<VertexVertexConstraint, long> vv_to_id;
+    unordered_map<EdgeVertexConstraint, long> ev_to_id;
+    CollisionConstraints constraints;
+};
+
+/// @brief Builder of compact collision constraints.
+///
+/// Classifies the candidates exactly as CollisionConstraintsBuilder, but emits
+/// the constraints as CompactCandidate ids with their weights (and weight
+/// gradients) in side arrays, so no polymorphic constraint is ever stored.
+class CompactCollisionConstraintsBuilder {
+public:
+    CompactCollisionConstraintsBuilder(
+        const CompactCollisionConstraints& empty_constraints);
+
+    void add_edge_vertex_constraints(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const std::vector<CompactCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i);
+
+    void add_edge_edge_constraints(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const std::vector<CompactCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i);
+
+    void add_face_vertex_constraints(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const std::vector<CompactCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i);
+
+    /// @brief Merge the builders' constraints in order.
+    /// @note The merged constraints have a weight per constraint (and a weight gradient per constraint if shape derivatives are enabled).
+    /// @param local_storage Builders to merge (merged in the given order).
+    /// @param merged_constraints Output merged constraints.
+    static void merge(
+        const std::vector<CompactCollisionConstraintsBuilder>& local_storage,
+        CompactCollisionConstraints& merged_constraints);
+
+    // ------------------------------------------------------------------------
+    // Interface used to add the classified constraints.
+
     void add_vertex_vertex_constraint(
         const long v0i,
         const long v1i,
         const double weight,
         const Eigen::SparseVector<double>& weight_gradient)
     {
-        add_vertex_vertex_constraint(
-            v0i, v1i, weight, weight_gradient, vv_to_id,
-            constraints.vv_constraints);
+        add_deduplicated_constraint(
+            CompactCandidate::make(v0i, v1i), weight, weight_gradient,
+            vv_to_id, vv_constraints);
     }
 
     void add_edge_vertex_constraint(
@@ -78,25 +222,151 @@ protected:
         const double weight,
         const Eigen::SparseVector<double>& weight_gradient)
     {
-        add_edge_vertex_constraint(
-            ei, vi, weight, weight_gradient, ev_to_id,
-            constraints.ev_constraints);
+        add_deduplicated_constraint(
+            CompactCandidate::make(ei, vi), weight, weight_gradient, ev_to_id,
+            ev_constraints);
+    }
+
+    void add_edge_edge_constraint(
+        const long eai,
+        const long ebi,
+        const double eps_x,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient)
+    {
+        ee_constraints.add(
+            CompactCandidate::make(eai, ebi), weight, weight_gradient,
+            m_should_compute_weight_gradient);
+        ee_eps_x.push_back(eps_x);
+    }
+
+    void add_face_vertex_constraint(
+        const long fi,
+        const long vi,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient)
+    {
+        fv_constraints.add(
+            CompactCandidate::make(fi, vi), weight, weight_gradient,
+            m_should_compute_weight_gradient);
     }
 
     bool use_convergent_formulation() const
     {
-        return constraints.use_convergent_formulation();
+        return m_use_convergent_formulation;
     }
 
     bool should_compute_weight_gradient() const
     {
-        return constraints.are_shape_derivatives_enabled();
+        return m_should_compute_weight_gradient;
     }
 
+protected:
+    /// @brief Constraints of one type with their weights and weight gradients.
+    struct ConstraintList {
+        void add(
+            const CompactCandidate& id,
+            const double weight,
+            const Eigen::SparseVector<double>& weight_gradient,
+            const bool with_weight_gradient)
+        {
+            ids.push_back(id);
+            weights.push_back(weight);
+            if (with_weight_gradient) {
+                weight_gradients.push_back(weight_gradient);
+            }
+        }
+
+        void append(const ConstraintList& other)
+        {
+            ids.insert(ids.end(), other.ids.begin(), other.ids.end());
+            weights.insert(
+                weights.end(), other.weights.begin(), other.weights.end());
+            weight_gradients.insert(
+                weight_gradients.end(), other.weight_gradients.begin(),
+                other.weight_gradients.end());
+        }
+
+        std::vector<CompactCandidate> ids;
+        std::vector<double> weights;
+        /// @brief Empty if the weight gradients are not computed.
+        std::vector<Eigen::SparseVector<double>> weight_gradients;
+    };
+
+    /// @brief Add a constraint or increase the weight of its existing copy.
+    void add_deduplicated_constraint(
+        const CompactCandidate& id,
+        const double weight,
+        const Eigen::SparseVector<double>& weight_gradient,
+        unordered_map<uint64_t, long>& to_id,
+        ConstraintList& constraints) const;
+
     // Store the indices to VV and EV pairs to avoid duplicates.
-    unordered_map<VertexVertexConstraint, long> vv_to_id;
-    unordered_map<EdgeVertexConstraint, long> ev_to_id;
-    CollisionConstraints constraints;
+    unordered_map<uint64_t, long> vv_to_id;
+    unordered_map<uint64_t, long> ev_to_id;
+    ConstraintList vv_constraints;
+    ConstraintList ev_constraints;
+    ConstraintList ee_constraints;
+    ConstraintList fv_constraints;
+    std::vector<double> ee_eps_x;
+
+    bool m_use_convergent_formulation;
+    bool m_should_compute_weight_gradient;
 };
 
+/// @brief Add the constraints of a fixed partition of the candidates into blocks in parallel.
+/// @note The partition does not depend on the scheduling, so neither do the merged constraints (and their accumulated weights).
+/// @param empty_builder Empty builder with the settings of the build.
+/// @param n_ev Number of edge-vertex candidates.
+/// @param n_ee Number of edge-edge candidates.
+/// @param n_fv Number of face-vertex candidates.
+/// @param add_ev Function add_ev(start, end, builder) adding the constraints of edge-vertex candidates [start, end).
+/// @param add_ee Function add_ee(start, end, builder) adding the constraints of edge-edge candidates [start, end).
+/// @param add_fv Function add_fv(start, end, builder) adding the constraints of face-vertex candidates [start, end).
+/// @return The builder of each block (in order).
+template <typename Builder, typename AddEV, typename AddEE, typename AddFV>
+std::vector<Builder> build_constraint_blocks(
+    const Builder& empty_builder,
+    const size_t n_ev,
+    const size_t n_ee,
+    const size_t n_fv,
+    const AddEV& add_ev,
+    const AddEE& add_ee,
+    const AddFV& add_fv)
+{
+    const size_t n_ev_blocks = num_deterministic_blocks(n_ev);
+    const size_t n_ee_blocks = num_deterministic_blocks(n_ee);
+    const size_t n_fv_blocks = num_deterministic_blocks(n_fv);
+
+    std::vector<Builder> storage(
+        n_ev_blocks + n_ee_blocks + n_fv_blocks, empty_builder);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), storage.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                if (b < n_ev_blocks) {
+                    const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                    add_ev(
+                        start, std::min(start + DETERMINISTIC_BLOCK_SIZE, n_ev),
+                        storage[b]);
+                } else if (b < n_ev_blocks + n_ee_blocks) {
+                    const size_t start =
+                        (b - n_ev_blocks) * DETERMINISTIC_BLOCK_SIZE;
+                    add_ee(
+                        start, std::min(start + DETERMINISTIC_BLOCK_SIZE, n_ee),
+                        storage[b]);
+                } else {
+                    const size_t start = (b - n_ev_blocks - n_ee_blocks)
+                        * DETERMINISTIC_BLOCK_SIZE;
+                    add_fv(
+                        start, std::min(start + DETERMINISTIC_BLOCK_SIZE, n_fv),
+                        storage[b]);
+                }
+            }
+        });
+
+    return storage;
+}
+
 } // namespace ipc
\ No newline at end of file
@@ -0,0 +1,423 @@
+#include "compact_collision_constraints.hpp"
+
+#include <ipc/collisions/collision_constraints_builder.hpp>
+#include <ipc/collisions/potential_hessian_visitors.hpp>
+#include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept> // std::invalid_argument, std::out_of_range
+#include <type_traits>
+
+namespace ipc {
+
+namespace {
+    /// @brief Call a function with the i-th constraint materialized on the stack.
+    /// @param constraints The compact constraints.
+    /// @param i Index of the constraint (in the order vv, ev, ee, fv).
+    /// @param f Function called with the constraint.
+    template <typename Function>
+    auto visit_constraint(
+        const CompactCollisionConstraints& constraints,
+        const size_t i,
+        const Function& f)
+    {
+        const auto materialize = [&](auto&& constraint) {
+            constraint.minimum_distance = constraints.minimum_distance(i);
+            constraint.weight = constraints.weight(i);
+            return f(constraint);
+        };
+
+        size_t idx = i;
+        if (idx < constraints.vv_constraints.size()) {
+            const CompactCandidate& c = constraints.vv_constraints[idx];
+            return materialize(VertexVertexConstraint(c.id0, c.id1));
+        }
+        idx -= constraints.vv_constraints.size();
+        if (idx < constraints.ev_constraints.size()) {
+            const CompactCandidate& c = constraints.ev_constraints[idx];
+            return materialize(EdgeVertexConstraint(c.id0, c.id1));
+        }
+        idx -= constraints.ev_constraints.size();
+        if (idx < constraints.ee_constraints.size()) {
+            const CompactCandidate& c = constraints.ee_constraints[idx];
+            return materialize(EdgeEdgeConstraint(
+                c.id0, c.id1, constraints.ee_eps_x[idx]));
+        }
+        idx -= constraints.ee_constraints.size();
+        const CompactCandidate& c = constraints.fv_constraints.at(idx);
+        return materialize(FaceVertexConstraint(c.id0, c.id1));
+    }
+
+    /// @brief List of the compact constraints of one type materialized on access.
+    template <typename Constraint> class CompactConstraintList {
+    public:
+        /// @param constraints The compact constraints.
+        /// @param ids Element ids of the constraints of this type.
+        /// @param offset Index of the first constraint of this type.
+        CompactConstraintList(
+            const CompactCollisionConstraints& constraints,
+            const std::vector<CompactCandidate>& ids,
+            const size_t offset)
+            : m_constraints(constraints)
+            , m_ids(ids)
+            , m_offset(offset)
+        {
+        }
+
+        size_t size() const { return m_ids.size(); }
+
+        Constraint operator[](const size_t i) const
+        {
+            const CompactCandidate& c = m_ids[i];
+            Constraint constraint = make(c, i);
+            constraint.minimum_distance =
+                m_constraints.minimum_distance(m_offset + i);
+            constraint.weight = m_constraints.weight(m_offset + i);
+            return constraint;
+        }
+
+    private:
+        Constraint make(const CompactCandidate& c, const size_t i) const
+        {
+            if constexpr (std::is_same_v<Constraint, EdgeEdgeConstraint>) {
+                return EdgeEdgeConstraint(
+                    c.id0, c.id1, m_constraints.ee_eps_x[i]);
+            } else {
+                return Constraint(c.id0, c.id1);
+            }
+        }
+
+        const CompactCollisionConstraints& m_constraints;
+        const std::vector<CompactCandidate>& m_ids;
+        const size_t m_offset;
+    };
+
+    /// @brief View of the compact constraints as a constraint set for visit_potential_hessians.
+    struct CompactConstraintSet {
+        explicit CompactConstraintSet(
+            const CompactCollisionConstraints& constraints)
+            : vv_constraints(constraints, constraints.vv_constraints, 0)
+            , ev_constraints(
+                  constraints, constraints.ev_constraints, vv_constraints.size())
+            , ee_constraints(
+                  constraints,
+                  constraints.ee_constraints,
+                  vv_constraints.size() + ev_constraints.size())
+            , fv_constraints(
+                  constraints,
+                  constraints.fv_constraints,
+                  vv_constraints.size() + ev_constraints.size()
+                      + ee_constraints.size())
+        {
+        }
+
+        /// @brief Get the i-th constraint, which is only called for the vertex-vertex constraints.
+        VertexVertexConstraint operator[](const size_t i) const
+        {
+            if (i >= vv_constraints.size()) {
+                throw std::out_of_range(
+                    "Only vertex-vertex constraints are accessed by index!");
+            }
+            return vv_constraints[i];
+        }
+
+        CompactConstraintList<VertexVertexConstraint> vv_constraints;
+        CompactConstraintList<EdgeVertexConstraint> ev_constraints;
+        CompactConstraintList<EdgeEdgeConstraint> ee_constraints;
+        CompactConstraintList<FaceVertexConstraint> fv_constraints;
+    };
+} // namespace
+
+CompactCollisionConstraints::CompactCollisionConstraints(
+    const CollisionConstraints& constraints)
+    : use_convergent_formulation(constraints.use_convergent_formulation())
+    , are_shape_derivatives_enabled(
+          constraints.are_shape_derivatives_enabled())
+{
+    if (!constraints.pv_constraints.empty()
+        || !constraints.sdf_constraints.empty()) {
+        throw std::invalid_argument(
+            "Compact collision constraints do not support plane-vertex or "
+            "SDF-vertex constraints!");
+    }
+
+    vv_constraints.reserve(constraints.vv_constraints.size());
+    for (const VertexVertexConstraint& vv : constraints.vv_constraints) {
+        vv_constraints.push_back(
+            CompactCandidate::make(vv.vertex0_id, vv.vertex1_id));
+    }
+    ev_constraints.reserve(constraints.ev_constraints.size());
+    for (const EdgeVertexConstraint& ev : constraints.ev_constraints) {
+        ev_constraints.push_back(
+            CompactCandidate::make(ev.edge_id, ev.vertex_id));
+    }
+    ee_constraints.reserve(constraints.ee_constraints.size());
+    ee_eps_x.reserve(constraints.ee_constraints.size());
+    for (const EdgeEdgeConstraint& ee : constraints.ee_constraints) {
+        ee_constraints.push_back(
+            CompactCandidate::make(ee.edge0_id, ee.edge1_id));
+        ee_eps_x.push_back(ee.eps_x);
+    }
+    fv_constraints.reserve(constraints.fv_constraints.size());
+    for (const FaceVertexConstraint& fv : constraints.fv_constraints) {
+        fv_constraints.push_back(
+            CompactCandidate::make(fv.face_id, fv.vertex_id));
+    }
+
+    minimum_distances.resize(constraints.size());
+    weights.resize(constraints.size());
+    if (are_shape_derivatives_enabled) {
+        weight_gradients.resize(constraints.size());
+    }
+    for (size_t i = 0; i < constraints.size(); i++) {
+        const CollisionConstraint& constraint = constraints[i];
+        minimum_distances[i] = constraint.minimum_distance;
+        weights[i] = constraint.weight;
+        if (are_shape_derivatives_enabled) {
+            weight_gradients[i] = constraint.weight_gradient;
+        }
+    }
+
+    drop_default_side_arrays();
+}
+
+void CompactCollisionConstraints::build(
+    const CompactCandidates& candidates,
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const double dmin)
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    clear();
+
+    // Cull the candidates by measuring the distance and dropping those that are
+    // greater than dhat.
+    const double offset_sqr = (dmin + dhat) * (dmin + dhat);
+    auto is_active = [&](double distance_sqr) {
+        return distance_sqr < offset_sqr;
+    };
+
+    std::vector<CompactCollisionConstraintsBuilder> storage =
+        build_constraint_blocks(
+            CompactCollisionConstraintsBuilder(*this),
+            candidates.ev_candidates.size(), candidates.ee_candidates.size(),
+            candidates.fv_candidates.size(),
+            [&](size_t start, size_t end,
+                CompactCollisionConstraintsBuilder& builder) {
+                builder.add_edge_vertex_constraints(
+                    mesh, vertices, candidates.ev_candidates, is_active,
+                    start, end);
+            },
+            [&](size_t start, size_t end,
+                CompactCollisionConstraintsBuilder& builder) {
+                builder.add_edge_edge_constraints(
+                    mesh, vertices, candidates.ee_candidates, is_active,
+                    start, end);
+            },
+            [&](size_t start, size_t end,
+                CompactCollisionConstraintsBuilder& builder) {
+                builder.add_face_vertex_constraints(
+                    mesh, vertices, candidates.fv_candidates, is_active,
+                    start, end);
+            });
+
+    CompactCollisionConstraintsBuilder::merge(storage, *this);
+
+    minimum_distances.assign(size(), dmin);
+
+    if (use_convergent_formulation) {
+        // See CollisionConstraints::finalize_build() for the units.
+        const double barrier_to_physical_barrier_divisor =
+            dhat * std::pow(dhat + 2 * dmin, 2);
+
+        for (double& weight : weights) {
+            weight /= barrier_to_physical_barrier_divisor;
+        }
+        for (Eigen::SparseVector<double>& weight_gradient : weight_gradients) {
+            weight_gradient /= barrier_to_physical_barrier_divisor;
+        }
+    }
+
+    drop_default_side_arrays();
+}
+
+CollisionConstraints CompactCollisionConstraints::to_collision_constraints(
+    const CollisionMesh& mesh) const
+{
+    CollisionConstraints constraints;
+    constraints.set_use_convergent_formulation(use_convergent_formulation);
+    constraints.set_are_shape_derivatives_enabled(
+        are_shape_derivatives_enabled);
+
+    constraints.vv_constraints.reserve(vv_constraints.size());
+    for (const CompactCandidate& c : vv_constraints) {
+        constraints.vv_constraints.emplace_back(c.id0, c.id1);
+    }
+    constraints.ev_constraints.reserve(ev_constraints.size());
+    for (const CompactCandidate& c : ev_constraints) {
+        constraints.ev_constraints.emplace_back(c.id0, c.id1);
+    }
+    constraints.ee_constraints.reserve(ee_constraints.size());
+    for (size_t i = 0; i < ee_constraints.size(); i++) {
+        constraints.ee_constraints.emplace_back(
+            ee_constraints[i].id0, ee_constraints[i].id1, ee_eps_x[i]);
+    }
+    constraints.fv_constraints.reserve(fv_constraints.size());
+    for (const CompactCandidate& c : fv_constraints) {
+        constraints.fv_constraints.emplace_back(c.id0, c.id1);
+    }
+
+    for (size_t i = 0; i < constraints.size(); i++) {
+        CollisionConstraint& constraint = constraints[i];
+        constraint.minimum_distance = minimum_distance(i);
+        constraint.weight = weight(i);
+        if (!weight_gradients.empty()) {
+            constraint.weight_gradient = weight_gradients[i];
+        }
+    }
+
+    constraints.build_vertex_incidence(mesh);
+
+    return constraints;
+}
+
+// ============================================================================
+
+double CompactCollisionConstraints::compute_potential(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat) const
+{
+    assert(vertices.rows() == mesh.num_vertices());
+    assert(dhat > 0);
+
+    if (empty()) {
+        return 0;
+    }
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    // Quadrature weight is premultiplied by compute_potential
+    return deterministic_parallel_sum(size(), [&](size_t i) {
+        return visit_constraint(*this, i, [&](const auto& constraint) {
+            return constraint.compute_potential(vertices, edges, faces, dhat);
+        });
+    });
+}
+
+Eigen::VectorXd CompactCollisionConstraints::compute_potential_gradient(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat) const
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    if (empty()) {
+        return Eigen::VectorXd::Zero(vertices.size());
+    }
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    return deterministic_gradient_assembly(
+        size(), vertices.rows(), vertices.cols(),
+        [&](size_t i, VectorMax12d& local_grad, std::array<long, 4>& ids) {
+            visit_constraint(*this, i, [&](const auto& constraint) {
+                local_grad = constraint.compute_potential_gradient(
+                    vertices, edges, faces, dhat);
+                ids = constraint.vertex_ids(edges, faces);
+            });
+        });
+}
+
+Eigen::SparseMatrix<double>
+CompactCollisionConstraints::compute_potential_hessian(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const bool upper_triangular) const
+{
+    assert(vertices.rows() == mesh.num_vertices());
+
+    if (empty()) {
+        return Eigen::SparseMatrix<double>(vertices.size(), vertices.size());
+    }
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    const int dim = vertices.cols();
+
+    const CompactConstraintSet constraints(*this);
+
+    return deterministic_sparse_block_assembly(
+        size(), vertices.size(), vertices.size(),
+        [&](size_t start, size_t end,
+            std::vector<Eigen::Triplet<double>>& triplets) {
+            visit_potential_hessians(
+                constraints, start, end, vertices, edges, faces, dhat,
+                project_hessian_to_psd,
+                [&](size_t i, const MatrixMax12d& local_hess) {
+                    visit_constraint(*this, i, [&](const auto& constraint) {
+                        local_hessian_to_global_triplets(
+                            local_hess, constraint.vertex_ids(edges, faces),
+                            dim, triplets, upper_triangular);
+                    });
+                });
+        });
+}
+
+// ============================================================================
+
+size_t CompactCollisionConstraints::size() const
+{
+    return vv_constraints.size() + ev_constraints.size()
+        + ee_constraints.size() + fv_constraints.size();
+}
+
+bool CompactCollisionConstraints::empty() const
+{
+    return vv_constraints.empty() && ev_constraints.empty()
+        && ee_constraints.empty() && fv_constraints.empty();
+}
+
+void CompactCollisionConstraints::drop_default_side_arrays()
+{
+    if (std::all_of(
+            minimum_distances.begin(), minimum_distances.end(),
+            [](double d) { return d == 0; })) {
+        minimum_distances.clear();
+    }
+    if (std::all_of(weights.begin(), weights.end(), [](double w) {
+            return w == 1;
+        })) {
+        weights.clear();
+    }
+    if (std::all_of(
+            weight_gradients.begin(), weight_gradients.end(),
+            [](const Eigen::SparseVector<double>& g) {
+                return g.nonZeros() == 0;
+            })) {
+        weight_gradients.clear();
+    }
+}
+
+void CompactCollisionConstraints::clear()
+{
+    vv_constraints.clear();
+    ev_constraints.clear();
+    ee_constraints.clear();
+    fv_constraints.clear();
+    ee_eps_x.clear();
+    minimum_distances.clear();
+    weights.clear();
+    weight_gradients.clear();
+}
+
+} // namespace ipc
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <ipc/candidates/compact_candidates.hpp>
+#include <ipc/collisions/collision_constraints.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Collision constraints stored as plain-old-data.
+///
+/// Each constraint is stored as a CompactCandidate of its two element ids.
+/// The minimum distances, weights, and weight gradients are stored in
+/// optional side arrays, which are left empty when they hold the default
+/// value of every constraint (e.g., weight gradients when shape derivatives
+/// are disabled). The polymorphic constraint objects are only materialized on
+/// the stack when evaluating the potential.
+///
+/// Constraints are indexed in the order vv, ev, ee, fv (as in
+/// CollisionConstraints). Plane-vertex and SDF-vertex constraints are not
+/// supported.
+class CompactCollisionConstraints {
+public:
+    CompactCollisionConstraints() { }
+
+    /// @brief Convert a set of collision constraints to compact storage.
+    /// @param constraints The collision constraints to convert.
+    /// @throws std::invalid_argument if constraints has plane-vertex or SDF-vertex constraints.
+    explicit CompactCollisionConstraints(
+        const CollisionConstraints& constraints);
+
+    /// @brief Initialize the set of constraints from compact candidates.
+    /// @note The constraints are classified one block of candidates at a time and emitted directly in compact form (see CompactCollisionConstraintsBuilder).
+    /// @param candidates Compact distance candidates from which the constraint set is built.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    void build(
+        const CompactCandidates& candidates,
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        const double dmin = 0);
+
+    /// @brief Expand the compact constraints into the polymorphic constraints.
+    /// @param mesh The collision mesh (used to build the vertex incidence).
+    /// @return The equivalent collision constraints.
+    CollisionConstraints
+    to_collision_constraints(const CollisionMesh& mesh) const;
+
+    // ------------------------------------------------------------------------
+
+    /// @brief Compute the barrier potential.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @returns The sum of all barrier potentials (not scaled by the barrier stiffness).
+    double compute_potential(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat) const;
+
+    /// @brief Compute the gradient of the barrier potential.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @returns The gradient of all barrier potentials (not scaled by the barrier stiffness).
+    Eigen::VectorXd compute_potential_gradient(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat) const;
+
+    /// @brief Compute the hessian of the barrier potential.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @param upper_triangular Only assemble the upper triangle of the symmetric hessian.
+    /// @returns The hessian of all barrier potentials (not scaled by the barrier stiffness).
+    Eigen::SparseMatrix<double> compute_potential_hessian(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double dhat,
+        const bool project_hessian_to_psd = false,
+        const bool upper_triangular = false) const;
+
+    // ------------------------------------------------------------------------
+
+    /// @brief Get the number of collision constraints.
+    size_t size() const;
+
+    /// @brief Get if the collision constraints are empty.
+    bool empty() const;
+
+    /// @brief Clear the collision constraints and side arrays.
+    void clear();
+
+    /// @brief Get the minimum distance of constraint i.
+    double minimum_distance(const size_t i) const
+    {
+        return minimum_distances.empty() ? 0.0 : minimum_distances[i];
+    }
+
+    /// @brief Get the weight of constraint i.
+    double weight(const size_t i) const
+    {
+        return weights.empty() ? 1.0 : weights[i];
+    }
+
+protected:
+    /// @brief Clear the side arrays holding the default value of every constraint.
+    void drop_default_side_arrays();
+
+public:
+    /// @brief Vertex-vertex constraints as (vertex id, vertex id).
+    std::vector<CompactCandidate> vv_constraints;
+    /// @brief Edge-vertex constraints as (edge id, vertex id).
+    std::vector<CompactCandidate> ev_constraints;
+    /// @brief Edge-edge constraints as (edge id, edge id).
+    std::vector<CompactCandidate> ee_constraints;
+    /// @brief Face-vertex constraints as (face id, vertex id).
+    std::vector<CompactCandidate> fv_constraints;
+
+    /// @brief Mollifier threshold of each edge-edge constraint.
+    std::vector<double> ee_eps_x;
+
+    /// @brief Minimum distance of each constraint (empty if all are zero).
+    std::vector<double> minimum_distances;
+    /// @brief Weight of each constraint (empty if all are one).
+    std::vector<double> weights;
+    /// @brief Gradient of each constraint's weight wrt the rest positions (empty if shape derivatives are disabled).
+    std::vector<Eigen::SparseVector<double>> weight_gradients;
+
+    /// @brief If the constraints use the convergent formulation (set before calling build()).
+    bool use_convergent_formulation = false;
+    /// @brief If the constraints have shape derivatives enabled (set before calling build()).
+    bool are_shape_derivatives_enabled = false;
+};
+
+} // namespace ipc
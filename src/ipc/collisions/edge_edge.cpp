@@ -76,14 +76,6 @@ MatrixMax12d EdgeEdgeConstraint::compute_potential_hessian(
     const double dhat,
     const bool project_hessian_to_psd) const
 {
-    const double adjusted_dhat = 2 * minimum_distance * dhat + dhat * dhat;
-    const double min_dist_squared = minimum_distance * minimum_distance;
-
-    // ∇²[m(x) * b(d(x))] = ∇[∇m(x) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)]
-    //                    = ∇²m(x) * b(d(x)) + b'(d(x)) * ∇d(x) * ∇m(x)ᵀ
-    //                      + ∇m(x) * b'(d(x)) * ∇d(x))ᵀ
-    //                      + m(x) * b"(d(x)) * ∇d(x) * ∇d(x)ᵀ
-    //                      + m(x) * b'(d(x)) * ∇²d(x)
     const auto& [ea0, ea1, eb0, eb1] = this->vertices(vertices, edges, faces);
 
     // Compute distance derivatives
@@ -97,6 +89,31 @@ MatrixMax12d EdgeEdgeConstraint::compute_potential_hessian(
     const Matrix12d distance_hess =
         edge_edge_distance_hessian(ea0, ea1, eb0, eb1, dtype);
 
+    return compute_potential_hessian_from_distance(
+        vertices, edges, faces, distance, distance_grad, distance_hess, dhat,
+        project_hessian_to_psd);
+}
+
+MatrixMax12d EdgeEdgeConstraint::compute_potential_hessian_from_distance(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double distance,
+    const VectorMax12d& distance_grad,
+    const MatrixMax12d& distance_hess,
+    const double dhat,
+    const bool project_hessian_to_psd) const
+{
+    const double adjusted_dhat = 2 * minimum_distance * dhat + dhat * dhat;
+    const double min_dist_squared = minimum_distance * minimum_distance;
+
+    // ∇²[m(x) * b(d(x))] = ∇[∇m(x) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)]
+    //                    = ∇²m(x) * b(d(x)) + b'(d(x)) * ∇d(x) * ∇m(x)ᵀ
+    //                      + ∇m(x) * b'(d(x)) * ∇d(x))ᵀ
+    //                      + m(x) * b"(d(x)) * ∇d(x) * ∇d(x)ᵀ
+    //                      + m(x) * b'(d(x)) * ∇²d(x)
+    const auto& [ea0, ea1, eb0, eb1] = this->vertices(vertices, edges, faces);
+
     // Compute mollifier derivatives
     const double mollifier = edge_edge_mollifier(ea0, ea1, eb0, eb1, eps_x);
     const VectorMax12d mollifier_grad =
@@ -31,6 +31,27 @@ public:
         const double dhat,
         const bool project_hessian_to_psd) const override;
 
+    /// @brief Compute the mollified potential hessian from precomputed distance derivatives.
+    /// @note The mollifier derivatives are computed from the vertex positions.
+    /// @param vertices Collision mesh vertex positions.
+    /// @param edges Collision mesh edge indices.
+    /// @param faces Collision mesh face indices.
+    /// @param distance Squared distance of the stencil.
+    /// @param distance_grad Gradient of the squared distance.
+    /// @param distance_hess Hessian of the squared distance.
+    /// @param dhat The activation distance of the barrier.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @return The hessian of the potential.
+    MatrixMax12d compute_potential_hessian_from_distance(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double distance,
+        const VectorMax12d& distance_grad,
+        const MatrixMax12d& distance_hess,
+        const double dhat,
+        const bool project_hessian_to_psd) const;
+
     template <typename H>
     friend H AbslHashValue(H h, const EdgeEdgeConstraint& ee)
     {
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <ipc/distance/batched_distance.hpp>
+#include <ipc/distance/distance_type.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <vector>
+
+// Visitors of the potential hessians of a constraint set shared by
+// CollisionConstraints and CompactCollisionConstraints. The constraint lists
+// only need an operator[] returning a constraint (by reference or by value).
+
+namespace ipc {
+
+/// @brief Batched kernel of a squared distance, its gradient, and its packed upper-triangular Hessian.
+using BatchedDistanceKernel = void (*)(
+    const size_t n,
+    const double* __restrict x,
+    double* __restrict d,
+    double* __restrict g,
+    double* __restrict H);
+
+/// @brief Visit the distance derivatives of constraints[index(i)] for i ∈ [0, n) using a batched distance kernel.
+/// @param visitor Function visitor(i, distance, distance_grad, distance_hess) called for each constraint.
+template <typename ConstraintList, typename IndexFunction, typename Visitor>
+void visit_batched_distance_derivatives(
+    const ConstraintList& constraints,
+    const size_t n,
+    const IndexFunction& index,
+    const BatchedDistanceKernel kernel,
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const Visitor& visitor)
+{
+    if (n == 0) {
+        return;
+    }
+
+    const int dim = vertices.cols();
+    const int ndof = constraints[index(0)].num_vertices() * dim;
+
+    // Gather the positions in SoA layout.
+    std::vector<double> x(ndof * n);
+    for (size_t i = 0; i < n; i++) {
+        const VectorMax12d positions =
+            constraints[index(i)].dof(vertices, edges, faces);
+        for (int j = 0; j < ndof; j++) {
+            x[j * n + i] = positions[j];
+        }
+    }
+
+    std::vector<double> d(n), g(ndof * n), H(ndof * (ndof + 1) / 2 * n);
+    kernel(n, x.data(), d.data(), g.data(), H.data());
+
+    VectorMax12d distance_grad(ndof);
+    MatrixMax12d distance_hess(ndof, ndof);
+    for (size_t i = 0; i < n; i++) {
+        for (int j = 0, k = 0; j < ndof; j++) {
+            distance_grad[j] = g[j * n + i];
+            for (int l = 0; l <= j; l++, k++) {
+                distance_hess(l, j) = distance_hess(j, l) = H[k * n + i];
+            }
+        }
+        visitor(i, d[i], distance_grad, distance_hess);
+    }
+}
+
+/// @brief Visit the potential hessians of constraints [start, end) using a batched distance kernel.
+template <typename ConstraintList, typename Visitor>
+void visit_batched_potential_hessians(
+    const ConstraintList& constraints,
+    const size_t start,
+    const size_t end,
+    const BatchedDistanceKernel kernel,
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const Visitor& visitor)
+{
+    visit_batched_distance_derivatives(
+        constraints, end - start, [&](size_t i) { return start + i; },
+        kernel, vertices, edges, faces,
+        [&](size_t i, double distance, const VectorMax12d& distance_grad,
+            const MatrixMax12d& distance_hess) {
+            visitor(
+                i,
+                constraints[start + i]
+                    .compute_potential_hessian_from_distance(
+                        distance, distance_grad, distance_hess, dhat,
+                        project_hessian_to_psd));
+        });
+}
+
+/// @brief Visit the potential hessians of the edge-edge constraints [start, end) in order.
+/// @note Only the constraints closest between the interiors of both edges use the batched line-line kernel. The others are closest at an endpoint (e.g., the mollified parallel edges), so they are evaluated one at a time.
+template <typename ConstraintList, typename Visitor>
+void visit_edge_edge_potential_hessians(
+    const ConstraintList& constraints,
+    const size_t start,
+    const size_t end,
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const Visitor& visitor)
+{
+    std::vector<MatrixMax12d> hessians(end - start);
+
+    std::vector<size_t> line_line_ids;
+    for (size_t i = start; i < end; i++) {
+        const auto& [ea0, ea1, eb0, eb1] =
+            constraints[i].vertices(vertices, edges, faces);
+        if (edge_edge_distance_type(ea0, ea1, eb0, eb1)
+            == EdgeEdgeDistanceType::EA_EB) {
+            line_line_ids.push_back(i);
+        } else {
+            hessians[i - start] = constraints[i].compute_potential_hessian(
+                vertices, edges, faces, dhat, project_hessian_to_psd);
+        }
+    }
+
+    visit_batched_distance_derivatives(
+        constraints, line_line_ids.size(),
+        [&](size_t i) { return line_line_ids[i]; },
+        autogen::line_line_distance_derivatives_batched, vertices, edges,
+        faces,
+        [&](size_t i, double distance, const VectorMax12d& distance_grad,
+            const MatrixMax12d& distance_hess) {
+            const size_t ci = line_line_ids[i];
+            hessians[ci - start] =
+                constraints[ci].compute_potential_hessian_from_distance(
+                    vertices, edges, faces, distance, distance_grad,
+                    distance_hess, dhat, project_hessian_to_psd);
+        });
+
+    for (size_t i = 0; i < hessians.size(); i++) {
+        visitor(i, hessians[i]);
+    }
+}
+
+/// @brief Visit the potential hessians of constraints [start, end) in order.
+/// @note The distance derivatives of the edge-vertex, edge-edge, and face-vertex constraints (i.e., point-line, line-line, and point-plane) are evaluated by batched kernels.
+/// @param constraints Constraint set with indexable vv, ev, ee, and fv constraint lists (e.g., CollisionConstraints), where constraints[i] is the i-th constraint of the set.
+/// @param visitor Function visitor(i, local_hessian) called for each constraint.
+template <typename ConstraintSet, typename Visitor>
+void visit_potential_hessians(
+    const ConstraintSet& constraints,
+    const size_t start,
+    const size_t end,
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const Visitor& visitor)
+{
+    const size_t ev_start = constraints.vv_constraints.size();
+    const size_t ev_end = ev_start + constraints.ev_constraints.size();
+    const size_t ee_start = ev_end;
+    const size_t ee_end = ee_start + constraints.ee_constraints.size();
+    const size_t fv_start = ee_end;
+    const size_t fv_end = fv_start + constraints.fv_constraints.size();
+    const BatchedDistanceKernel ev_kernel = vertices.cols() == 2
+        ? autogen::point_line_distance_derivatives_batched_2D
+        : autogen::point_line_distance_derivatives_batched_3D;
+
+    for (size_t i = start; i < end;) {
+        if (ev_start <= i && i < ev_end) {
+            const size_t batch_end = std::min(end, ev_end);
+            visit_batched_potential_hessians(
+                constraints.ev_constraints, i - ev_start,
+                batch_end - ev_start, ev_kernel, vertices, edges, faces,
+                dhat, project_hessian_to_psd,
+                [&, offset = i](size_t j, const MatrixMax12d& hess) {
+                    visitor(offset + j, hess);
+                });
+            i = batch_end;
+        } else if (ee_start <= i && i < ee_end) {
+            const size_t batch_end = std::min(end, ee_end);
+            visit_edge_edge_potential_hessians(
+                constraints.ee_constraints, i - ee_start,
+                batch_end - ee_start, vertices, edges, faces, dhat,
+                project_hessian_to_psd,
+                [&, offset = i](size_t j, const MatrixMax12d& hess) {
+                    visitor(offset + j, hess);
+                });
+            i = batch_end;
+        } else if (fv_start <= i && i < fv_end) {
+            const size_t batch_end = std::min(end, fv_end);
+            visit_batched_potential_hessians(
+                constraints.fv_constraints, i - fv_start,
+                batch_end - fv_start,
+                autogen::point_plane_distance_derivatives_batched,
+                vertices, edges, faces, dhat, project_hessian_to_psd,
+                [&, offset = i](size_t j, const MatrixMax12d& hess) {
+                    visitor(offset + j, hess);
+                });
+            i = batch_end;
+        } else {
+            visitor(
+                i,
+                constraints[i].compute_potential_hessian(
+                    vertices, edges, faces, dhat, project_hessian_to_psd));
+            i++;
+        }
+    }
+}
+
+} // namespace ipc
@@ -0,0 +1,40 @@
+#include "sdf_vertex.hpp"
+
+namespace ipc {
+
+SDFVertexConstraint::SDFVertexConstraint(
+    const std::shared_ptr<const GridSDF>& sdf, const long vertex_id)
+    : sdf(sdf)
+    , vertex_id(vertex_id)
+{
+    assert(sdf != nullptr);
+}
+
+// NOTE: Like the other constraints, these are squared distances (i.e., s²).
+
+double SDFVertexConstraint::compute_distance(const VectorMax12d& point) const
+{
+    assert(point.size() == sdf->dim());
+    const double s = sdf->signed_distance(point);
+    return s * s;
+}
+
+VectorMax12d
+SDFVertexConstraint::compute_distance_gradient(const VectorMax12d& point) const
+{
+    assert(point.size() == sdf->dim());
+    const double s = sdf->signed_distance(point);
+    return 2 * s * sdf->signed_distance_gradient(point);
+}
+
+MatrixMax12d
+SDFVertexConstraint::compute_distance_hessian(const VectorMax12d& point) const
+{
+    assert(point.size() == sdf->dim());
+    const double s = sdf->signed_distance(point);
+    const VectorMax3d grad = sdf->signed_distance_gradient(point);
+    const MatrixMax3d hess = sdf->signed_distance_hessian(point);
+    return 2 * (grad * grad.transpose() + s * hess);
+}
+
+} // namespace ipc
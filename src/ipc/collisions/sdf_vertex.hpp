@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ipc/collisions/collision_constraint.hpp>
+#include <ipc/implicits/grid_sdf.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <memory>
+
+namespace ipc {
+
+/// @brief Constraint between a vertex and a static obstacle given by a grid SDF.
+/// @note The obstacle is shared, so copying the constraint does not copy the grid.
+class SDFVertexConstraint : public CollisionConstraint {
+public:
+    SDFVertexConstraint(
+        const std::shared_ptr<const GridSDF>& sdf, const long vertex_id);
+
+    int num_vertices() const override { return 1; };
+
+    std::array<long, 4> vertex_ids(
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces) const override
+    {
+        return { { vertex_id, -1, -1, -1 } };
+    }
+
+    std::shared_ptr<const GridSDF> sdf;
+    long vertex_id;
+
+protected:
+    double compute_distance(const VectorMax12d& point) const override;
+
+    VectorMax12d
+    compute_distance_gradient(const VectorMax12d& point) const override;
+
+    MatrixMax12d
+    compute_distance_hessian(const VectorMax12d& point) const override;
+};
+
+} // namespace ipc
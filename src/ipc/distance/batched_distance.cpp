@@ -0,0 +1,1065 @@
+#include "batched_distance.hpp"
+
+// The outputs of different stencils never alias, so the loops can be
+// vectorized without runtime alias checks between the output streams.
+#if defined(__clang__)
+#define IPC_TOOLKIT_VECTORIZE_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define IPC_TOOLKIT_VECTORIZE_LOOP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define IPC_TOOLKIT_VECTORIZE_LOOP __pragma(loop(ivdep))
+#else
+#define IPC_TOOLKIT_VECTORIZE_LOOP
+#endif
+
+// clang-format off
+namespace ipc {
+namespace autogen {
+    // x is (12×n) in SoA layout; d is (1×n); g is (12×n); H is (78×n)
+    void point_plane_distance_derivatives_batched(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H)
+    {
+        IPC_TOOLKIT_VECTORIZE_LOOP
+        for (size_t i = 0; i < n; i++) {
+            const double p_x = x[0 * n + i];
+            const double p_y = x[1 * n + i];
+            const double p_z = x[2 * n + i];
+            const double t0_x = x[3 * n + i];
+            const double t0_y = x[4 * n + i];
+            const double t0_z = x[5 * n + i];
+            const double t1_x = x[6 * n + i];
+            const double t1_y = x[7 * n + i];
+            const double t1_z = x[8 * n + i];
+            const double t2_x = x[9 * n + i];
+            const double t2_y = x[10 * n + i];
+            const double t2_z = x[11 * n + i];
+            const double t0 = -t1_x;
+            const double t1 = t0 + t0_x;
+            const double t2 = -t2_z;
+            const double t3 = t0_z + t2;
+            const double t4 = t1 * t3;
+            const double t5 = -t2_x;
+            const double t6 = t0_x + t5;
+            const double t7 = -t1_z;
+            const double t8 = t0_z + t7;
+            const double t9 = t6 * t8;
+            const double t10 = t4 - t9;
+            const double t11 = t10 * t10;
+            const double t12 = -t2_y;
+            const double t13 = t0_y + t12;
+            const double t14 = t1 * t13;
+            const double t15 = -t1_y;
+            const double t16 = t0_y + t15;
+            const double t17 = t16 * t6;
+            const double t18 = -t17;
+            const double t19 = t14 + t18;
+            const double t20 = t19 * t19;
+            const double t21 = t16 * t3;
+            const double t22 = t13 * t8;
+            const double t23 = -t22;
+            const double t24 = t21 + t23;
+            const double t25 = t24 * t24;
+            const double t26 = t20 + t25;
+            const double t27 = t11 + t26;
+            const double t28 = 1.0 / t27;
+            const double t29 = p_y - t0_y;
+            const double t30 = p_x - t0_x;
+            const double t31 = p_z - t0_z;
+            const double t32 = t19 * t31 + t24 * t30;
+            const double t33 = -t10 * t29 + t32;
+            const double t34 = t33 * t33;
+            const double t35 = t28 * t34;
+            const double t36 = t28 * t33;
+            const double t37 = 2 * t36;
+            const double t38 = t24 * t37;
+            const double t39 = t10 * t37;
+            const double t40 = t19 * t37;
+            const double t41 = t12 + t1_y;
+            const double t42 = -t1;
+            const double t43 = -t13;
+            const double t44 = t42 * t43;
+            const double t45 = -t6;
+            const double t46 = -t16;
+            const double t47 = t45 * t46;
+            const double t48 = t44 - t47;
+            const double t49 = t1_z + t2;
+            const double t50 = -t49;
+            const double t51 = -t3;
+            const double t52 = -t8;
+            const double t53 = t42 * t51 - t45 * t52;
+            const double t54 = -t53;
+            const double t55 = t41 * t48 + t50 * t54;
+            const double t56 = -t29 * t53 + t32;
+            const double t57 = t26 + (t53 * t53);
+            const double t58 = 1.0 / t57;
+            const double t59 = t56 * t58;
+            const double t60 = t55 * t59;
+            const double t61 = t24 + t29 * t49 - t31 * t41;
+            const double t62 = 2 * t59;
+            const double t63 = t1_x + t5;
+            const double t64 = -t63;
+            const double t65 = t46 * t51;
+            const double t66 = t43 * t52;
+            const double t67 = t65 - t66;
+            const double t68 = t48 * t64 + t49 * t67;
+            const double t69 = t59 * t68;
+            const double t70 = t31 * t63;
+            const double t71 = t30 * t49;
+            const double t72 = -t4 + t9;
+            const double t73 = t70 - t71 + t72;
+            const double t74 = -t41;
+            const double t75 = t54 * t63 + t67 * t74;
+            const double t76 = t59 * t75;
+            const double t77 = t19 - t29 * t63 + t30 * t41;
+            const double t78 = t13 * t19 + t3 * t53;
+            const double t79 = t36 * t78;
+            const double t80 = -t13 * t31 + t29 * t3;
+            const double t81 = t19 * t6 - t24 * t3;
+            const double t82 = t36 * t81;
+            const double t83 = t3 * t30 - t31 * t6;
+            const double t84 = t13 * t24 + t53 * t6;
+            const double t85 = t36 * t84;
+            const double t86 = t29 * t6;
+            const double t87 = -t13 * t30 + t86;
+            const double t88 = t16 * t19 + t53 * t8;
+            const double t89 = t36 * t88;
+            const double t90 = -t16 * t31 + t29 * t8;
+            const double t91 = -t1 * t19 + t24 * t8;
+            const double t92 = t36 * t91;
+            const double t93 = t1 * t31;
+            const double t94 = t30 * t8;
+            const double t95 = t93 - t94;
+            const double t96 = t1 * t53 + t16 * t24;
+            const double t97 = t36 * t96;
+            const double t98 = t16 * t30;
+            const double t99 = t1 * t29 - t98;
+            const double t100 = 2 * t28;
+            const double t101 = t100 * t24;
+            const double t102 = t10 * t100;
+            const double t103 = 2 * t60;
+            const double t104 = 2 * t58;
+            const double t105 = -t61;
+            const double t106 = t19 * t41 + t49 * t53;
+            const double t107 = t56 * t56;
+            const double t108 = t107 * t58;
+            const double t109 = 1.0 / (t57 * t57);
+            const double t110 = 4 * t107 * t109;
+            const double t111 = t10 - t70 + t71;
+            const double t112 = -t19 * t63 + t24 * t49;
+            const double t113 = t112 * t37;
+            const double t114 = 2 * t69;
+            const double t115 = t35 * t63;
+            const double t116 = t106 * t37;
+            const double t117 = 4 * t34 / (t27 * t27);
+            const double t118 = t106 * t117;
+            const double t119 = -t77;
+            const double t120 = 2 * t76;
+            const double t121 = t24 * t41 + t53 * t63;
+            const double t122 = t121 * t37;
+            const double t123 = t117 * t121;
+            const double t124 = 2 * t79;
+            const double t125 = t3 * t54 + t43 * t48;
+            const double t126 = t125 * t62;
+            const double t127 = p_z + t2;
+            const double t128 = -t44 + t47;
+            const double t129 = p_y + t12;
+            const double t130 = t13 * t13;
+            const double t131 = t3 * t3;
+            const double t132 = -t83;
+            const double t133 = t48 * t6 + t51 * t67;
+            const double t134 = t133 * t62;
+            const double t135 = t104 * t53;
+            const double t136 = 2 * t82;
+            const double t137 = p_x + t5;
+            const double t138 = -t65 + t66;
+            const double t139 = t117 * t78;
+            const double t140 = t6 * t6;
+            const double t141 = t13 * t30 - t86;
+            const double t142 = 2 * t85;
+            const double t143 = t13 * t67 + t45 * t54;
+            const double t144 = t100 * t19;
+            const double t145 = t143 * t62;
+            const double t146 = t117 * t84;
+            const double t147 = 2 * t89;
+            const double t148 = -t90;
+            const double t149 = t16 * t48 + t52 * t54;
+            const double t150 = t149 * t62;
+            const double t151 = p_z + t7;
+            const double t152 = t117 * t88;
+            const double t153 = p_y + t15;
+            const double t154 = t16 * t16;
+            const double t155 = t8 * t8;
+            const double t156 = -t93 + t94;
+            const double t157 = 2 * t92;
+            const double t158 = t42 * t48 + t67 * t8;
+            const double t159 = t158 * t62;
+            const double t160 = p_x + t0;
+            const double t161 = t1 * t35;
+            const double t162 = t1 * t1;
+            const double t163 = -t1 * t29 + t98;
+            const double t164 = -t163;
+            const double t165 = t1 * t54 + t46 * t67;
+            const double t166 = t165 * t62;
+            const double t167 = 2 * t97;
+            const double t168 = t117 * t96;
+            d[i] = t35;
+            g[0 * n + i] = t38;
+            g[1 * n + i] = -t39;
+            g[2 * n + i] = t40;
+            g[3 * n + i] = t62 * (-t60 - t61);
+            g[4 * n + i] = t62 * (-t69 - t73);
+            g[5 * n + i] = t62 * (-t76 - t77);
+            g[6 * n + i] = t37 * (t79 + t80);
+            g[7 * n + i] = -t37 * (t82 + t83);
+            g[8 * n + i] = t37 * (-t85 - t87);
+            g[9 * n + i] = -t37 * (t89 + t90);
+            g[10 * n + i] = t37 * (-t92 - t95);
+            g[11 * n + i] = t37 * (t97 + t99);
+            H[0 * n + i] = t100 * t25;
+            H[1 * n + i] = -t10 * t101;
+            H[2 * n + i] = t100 * t11;
+            H[3 * n + i] = t101 * t19;
+            H[4 * n + i] = -t102 * t19;
+            H[5 * n + i] = t100 * t20;
+            H[6 * n + i] = t104 * t24 * (-t103 - t61);
+            H[7 * n + i] = t104 * (-t105 * t53 - t49 * t56 + 2 * t53 * t55 * t56
+                * t58);
+            H[8 * n + i] = t100 * (-t106 * t40 - t19 * t61 + t33 * t41);
+            H[9 * n + i] = t104 * ((t105 * t105) - 4 * t105 * t60 - t108 * ((t41
+                * t41) + (t50 * t50)) + t110 * (t55 * t55));
+            H[10 * n + i] = t100 * (t111 * t24 - t112 * t38 + t33 * t49);
+            H[11 * n + i] = t102 * (t113 + t73);
+            H[12 * n + i] = t104 * (t111 * t19 - t114 * t19 - t56 * t63);
+            H[13 * n + i] = t100 * (-t111 * t116 - t111 * t61 + t112 * t118
+                + t113 * t61 + t115 * t41);
+            H[14 * n + i] = t104 * (-t108 * ((t49 * t49) + (t64 * t64)) + t110
+                * (t68 * t68) + (t111 * t111) - 4 * t111 * t69);
+            H[15 * n + i] = t104 * (t119 * t24 - t120 * t24 - t41 * t56);
+            H[16 * n + i] = t100 * (t10 * t77 - t121 * t39 + t33 * t63);
+            H[17 * n + i] = t104 * t19 * (-t120 - t77);
+            H[18 * n + i] = t100 * (t115 * t49 + t116 * t77 - t118 * t121 - t122
+                * t61 + t61 * t77);
+            H[19 * n + i] = t100 * (t111 * t122 - t111 * t77 - t112 * t123
+                + t113 * t77 + t35 * t41 * t49);
+            H[20 * n + i] = t104 * (-t108 * ((t63 * t63) + (t74 * t74)) + t110
+                * (t75 * t75) + (t119 * t119) - 4 * t119 * t76);
+            H[21 * n + i] = t101 * (t124 + t80);
+            H[22 * n + i] = t100 * (-t10 * t124 - t10 * t80 + t3 * t33);
+            H[23 * n + i] = t104 * (-t126 * t19 - t13 * t56 + t19 * t80);
+            H[24 * n + i] = t104 * (-t103 * t80 - t105 * t126 + t105 * t80 + 4
+                * t107 * t109 * t125 * t55 - t108 * (t3 * t50 + t41 * t43));
+            H[25 * n + i] = t104 * (4 * t107 * t109 * t125 * t68 - t108 * (t128
+                + t43 * t64) - t111 * t126 + t111 * t80 - t114 * t80 - t127
+                * t56);
+            H[26 * n + i] = t100 * (t122 * t80 + t123 * t78 - t124 * t77 + t129
+                * t33 - t35 * (t3 * t63 + t72) - t77 * t80);
+            H[27 * n + i] = t100 * (t117 * (t78 * t78) - t35 * (t130 + t131) + 4
+                * t79 * t80 + (t80 * t80));
+            H[28 * n + i] = t104 * (t132 * t24 - t134 * t24 - t3 * t56);
+            H[29 * n + i] = t135 * (t134 + t83);
+            H[30 * n + i] = t100 * (-t136 * t19 - t19 * t83 + t33 * t6);
+            H[31 * n + i] = t100 * (t116 * t83 + t118 * t81 + t127 * t33 + t136
+                * t61 - t35 * (t19 + t41 * t6) + t61 * t83);
+            H[32 * n + i] = t104 * (4 * t107 * t109 * t133 * t68 - t108 * (t49
+                * t51 + t6 * t64) + t111 * t132 - t111 * t134 - t114 * t132);
+            H[33 * n + i] = t104 * (4 * t107 * t109 * t133 * t75 - t108 * (t138
+                + t51 * t74) + t119 * t132 - t119 * t134 - t120 * t132 - t137
+                * t56);
+            H[34 * n + i] = t100 * (-t124 * t83 + t13 * t28 * t34 * t6 - t136
+                * t80 - t139 * t81 - t80 * t83);
+            H[35 * n + i] = t100 * (t117 * (t81 * t81) - t35 * (t131 + t140) + 4
+                * t82 * t83 + (t83 * t83));
+            H[36 * n + i] = t100 * (t13 * t33 + t141 * t24 - t142 * t24);
+            H[37 * n + i] = t104 * (-t141 * t53 + 2 * t143 * t53 * t56 * t58
+                - t56 * t6);
+            H[38 * n + i] = t144 * (-t142 - t87);
+            H[39 * n + i] = t104 * (-t103 * t141 + t105 * t141 - t105 * t145 + 4
+                * t107 * t109 * t143 * t55 - t108 * (t45 * t50 + t53) - t129
+                * t56);
+            H[40 * n + i] = t100 * (t111 * t141 - t111 * t142 + t112 * t146
+                - t113 * t141 + t137 * t33 - t35 * (t13 * t49 + t24));
+            H[41 * n + i] = t104 * (4 * t107 * t109 * t143 * t75 - t108 * (t13
+                * t74 + t45 * t63) + t119 * t141 - t119 * t145 - t120 * t141);
+            H[42 * n + i] = t100 * (t124 * t141 - t139 * t84 + t141 * t80 - t142
+                * t80 + t3 * t35 * t6);
+            H[43 * n + i] = t100 * (t13 * t3 * t35 - t136 * t141 - t141 * t83
+                + t142 * t83 + t146 * t81);
+            H[44 * n + i] = t100 * (t117 * (t84 * t84) + (t141 * t141) - 4
+                * t141 * t85 - t35 * (t130 + t140));
+            H[45 * n + i] = -t101 * (t147 + t90);
+            H[46 * n + i] = t104 * (-t148 * t53 + 2 * t149 * t53 * t56 * t58
+                - t56 * t8);
+            H[47 * n + i] = t100 * (-t147 * t19 + t16 * t33 - t19 * t90);
+            H[48 * n + i] = t104 * (-t103 * t148 + t105 * t148 - t105 * t150 + 4
+                * t107 * t109 * t149 * t55 - t108 * (t16 * t41 + t50 * t52));
+            H[49 * n + i] = t100 * (-t111 * t147 - t111 * t90 + t112 * t152
+                + t113 * t90 + t151 * t33 - t35 * (t14 - t16 * t63 - t17));
+            H[50 * n + i] = t104 * (4 * t107 * t109 * t149 * t75 - t108 * (t52
+                * t63 + t53) + t119 * t148 - t119 * t150 - t120 * t148 - t153
+                * t56);
+            H[51 * n + i] = t104 * (4 * t107 * t109 * t125 * t149 - t108 * (t16
+                * t43 + t3 * t52) - t126 * t148 + t148 * t80 - t150 * t80);
+            H[52 * n + i] = t104 * (4 * t107 * t109 * t133 * t149 - t108 * (t128
+                + t17) + t132 * t148 - t132 * t150 - t134 * t148 - t31 * t56);
+            H[53 * n + i] = t100 * (-t141 * t147 - t141 * t90 + t142 * t90
+                + t146 * t88 + t29 * t33 - t35 * (-t4 + 2 * t6 * t8));
+            H[54 * n + i] = t100 * (t117 * (t88 * t88) - t35 * (t154 + t155) + 4
+                * t89 * t90 + (t90 * t90));
+            H[55 * n + i] = t100 * (t156 * t24 - t157 * t24 + t33 * t8);
+            H[56 * n + i] = t135 * (t159 + t95);
+            H[57 * n + i] = t104 * (-t1 * t56 + t156 * t19 - t159 * t19);
+            H[58 * n + i] = t104 * (-t103 * t156 + t105 * t156 - t105 * t159 + 4
+                * t107 * t109 * t158 * t55 - t108 * (t128 + t41 * t42) - t151
+                * t56);
+            H[59 * n + i] = t104 * (4 * t107 * t109 * t158 * t68 - t108 * (t42
+                * t64 + t49 * t8) + t111 * t156 - t111 * t159 - t114 * t156);
+            H[60 * n + i] = t100 * (t122 * t156 - t123 * t91 - t156 * t77 + t157
+                * t77 + t160 * t33 - t35 * (t21 - t22 - t41 * t8));
+            H[61 * n + i] = t100 * (t124 * t156 - t139 * t91 + t156 * t80 - t157
+                * t80 + t31 * t33 - t35 * (2 * t14 + t18));
+            H[62 * n + i] = t104 * (4 * t107 * t109 * t133 * t158 - t108 * (t42
+                * t6 + t51 * t8) + t132 * t156 - t132 * t159 - t134 * t156);
+            H[63 * n + i] = t104 * (4 * t107 * t109 * t143 * t158 - t108 * (t138
+                + t22) + t141 * t156 - t141 * t159 - t145 * t156 - t30 * t56);
+            H[64 * n + i] = t100 * (-t147 * t156 + t152 * t91 - t156 * t90
+                + t157 * t90 + t16 * t161);
+            H[65 * n + i] = t100 * (t117 * (t91 * t91) + (t156 * t156) - 4
+                * t156 * t92 - t35 * (t155 + t162));
+            H[66 * n + i] = t104 * (-t16 * t56 + t164 * t24 - t166 * t24);
+            H[67 * n + i] = t100 * (t1 * t33 + t10 * t163 - t10 * t167);
+            H[68 * n + i] = t144 * (t167 + t99);
+            H[69 * n + i] = t100 * (t116 * t163 - t118 * t96 + t153 * t33 + t163
+                * t61 - t167 * t61 - t35 * (-t1 * t49 - t10));
+            H[70 * n + i] = t104 * (4 * t107 * t109 * t165 * t68 - t108 * (t138
+                + t46 * t49) + t111 * t164 - t111 * t166 - t114 * t164 - t160
+                * t56);
+            H[71 * n + i] = t104 * (4 * t107 * t109 * t165 * t75 - t108 * (t1
+                * t63 + t46 * t74) + t119 * t164 - t119 * t166 - t120 * t164);
+            H[72 * n + i] = t104 * (4 * t107 * t109 * t125 * t165 - t108 * (t4
+                + t53) - t126 * t164 + t164 * t80 - t166 * t80 - t29 * t56);
+            H[73 * n + i] = t100 * (t136 * t163 + t163 * t83 - t167 * t83 - t168
+                * t81 + t30 * t33 - t35 * (2 * t21 + t23));
+            H[74 * n + i] = t104 * (4 * t107 * t109 * t143 * t165 - t108 * (t1
+                * t45 + t13 * t46) + t141 * t164 - t141 * t166 - t145 * t164);
+            H[75 * n + i] = t100 * (t147 * t163 - t152 * t96 + t161 * t8 + t163
+                * t90 - t167 * t90);
+            H[76 * n + i] = t100 * (-t156 * t163 + t156 * t167 + t157 * t163
+                + t16 * t35 * t8 - t168 * t91);
+            H[77 * n + i] = t100 * (t117 * (t96 * t96) + (t163 * t163) - 4
+                * t163 * t97 - t35 * (t154 + t162));
+        }
+    }
+
+    // x is (12×n) in SoA layout; d is (1×n); g is (12×n); H is (78×n)
+    void line_line_distance_derivatives_batched(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H)
+    {
+        IPC_TOOLKIT_VECTORIZE_LOOP
+        for (size_t i = 0; i < n; i++) {
+            const double ea0_x = x[0 * n + i];
+            const double ea0_y = x[1 * n + i];
+            const double ea0_z = x[2 * n + i];
+            const double ea1_x = x[3 * n + i];
+            const double ea1_y = x[4 * n + i];
+            const double ea1_z = x[5 * n + i];
+            const double eb0_x = x[6 * n + i];
+            const double eb0_y = x[7 * n + i];
+            const double eb0_z = x[8 * n + i];
+            const double eb1_x = x[9 * n + i];
+            const double eb1_y = x[10 * n + i];
+            const double eb1_z = x[11 * n + i];
+            const double t0 = ea0_x - ea1_x;
+            const double t1 = -eb1_z;
+            const double t2 = eb0_z + t1;
+            const double t3 = t0 * t2;
+            const double t4 = ea0_z - ea1_z;
+            const double t5 = -eb1_x;
+            const double t6 = eb0_x + t5;
+            const double t7 = t4 * t6;
+            const double t8 = -t7;
+            const double t9 = t3 + t8;
+            const double t10 = -eb1_y;
+            const double t11 = eb0_y + t10;
+            const double t12 = t0 * t11;
+            const double t13 = ea0_y - ea1_y;
+            const double t14 = t13 * t6;
+            const double t15 = -t14;
+            const double t16 = t12 + t15;
+            const double t17 = t13 * t2;
+            const double t18 = t11 * t4;
+            const double t19 = -t18;
+            const double t20 = t17 + t19;
+            const double t21 = (t16 * t16) + (t20 * t20);
+            const double t22 = t21 + (t9 * t9);
+            const double t23 = 1.0 / t22;
+            const double t24 = -eb0_x;
+            const double t25 = ea0_x + t24;
+            const double t26 = -eb0_z;
+            const double t27 = ea0_z + t26;
+            const double t28 = -eb0_y;
+            const double t29 = ea0_y + t28;
+            const double t30 = -t0;
+            const double t31 = -t2;
+            const double t32 = t30 * t31;
+            const double t33 = -t4;
+            const double t34 = -t6;
+            const double t35 = t33 * t34;
+            const double t36 = t32 - t35;
+            const double t37 = t16 * t27 + t20 * t25 - t29 * t36;
+            const double t38 = t37 * t37;
+            const double t39 = t23 * t38;
+            const double t40 = -t11;
+            const double t41 = t30 * t40;
+            const double t42 = -t13;
+            const double t43 = -t34 * t42;
+            const double t44 = t41 + t43;
+            const double t45 = -t36;
+            const double t46 = t11 * t44 + t31 * t45;
+            const double t47 = -t37;
+            const double t48 = t21 + (t36 * t36);
+            const double t49 = 1.0 / t48;
+            const double t50 = t47 * t49;
+            const double t51 = t46 * t50;
+            const double t52 = t11 * t27;
+            const double t53 = t2 * t29;
+            const double t54 = t20 + t52 - t53;
+            const double t55 = 2 * t50;
+            const double t56 = t31 * t42;
+            const double t57 = -t33 * t40;
+            const double t58 = t56 + t57;
+            const double t59 = t2 * t58 + t34 * t44;
+            const double t60 = t50 * t59;
+            const double t61 = t2 * t25;
+            const double t62 = t27 * t6;
+            const double t63 = t61 - t62;
+            const double t64 = t40 * t58 + t45 * t6;
+            const double t65 = t50 * t64;
+            const double t66 = t29 * t6;
+            const double t67 = t11 * t25;
+            const double t68 = t66 - t67;
+            const double t69 = t16 + t68;
+            const double t70 = t11 * t16 + t2 * t36;
+            const double t71 = t23 * t37;
+            const double t72 = t70 * t71;
+            const double t73 = -t52 + t53;
+            const double t74 = 2 * t71;
+            const double t75 = t16 * t6 - t2 * t20;
+            const double t76 = t71 * t75;
+            const double t77 = t11 * t20 + t36 * t6;
+            const double t78 = t71 * t77;
+            const double t79 = t4 * t45 + t42 * t44;
+            const double t80 = t50 * t79;
+            const double t81 = t29 * t4;
+            const double t82 = t13 * t27;
+            const double t83 = t81 - t82;
+            const double t84 = t0 * t44 + t33 * t58;
+            const double t85 = t50 * t84;
+            const double t86 = t0 * t27;
+            const double t87 = t25 * t4;
+            const double t88 = t86 - t87;
+            const double t89 = t88 + t9;
+            const double t90 = t13 * t25;
+            const double t91 = t0 * t29;
+            const double t92 = t13 * t58 + t30 * t45;
+            const double t93 = t50 * t92;
+            const double t94 = t13 * t16 + t36 * t4;
+            const double t95 = t71 * t94;
+            const double t96 = t30 * t44 + t4 * t58;
+            const double t97 = t50 * t96;
+            const double t98 = t0 * t36 + t13 * t20;
+            const double t99 = t71 * t98;
+            const double t100 = -t90 + t91;
+            const double t101 = -t54;
+            const double t102 = t11 * t11;
+            const double t103 = t47 * t47;
+            const double t104 = t103 * t49;
+            const double t105 = 1.0 / (t48 * t48);
+            const double t106 = 4 * t103 * t105;
+            const double t107 = 2 * t49;
+            const double t108 = -t61 + t62 + t9;
+            const double t109 = t39 * t6;
+            const double t110 = 2 * t72;
+            const double t111 = -t75;
+            const double t112 = t111 * t74;
+            const double t113 = 1.0 / (t22 * t22);
+            const double t114 = 4 * t113 * t38;
+            const double t115 = t114 * t70;
+            const double t116 = 2 * t23;
+            const double t117 = t2 * t2;
+            const double t118 = 2 * t78;
+            const double t119 = t109 * t2 - t115 * t77;
+            const double t120 = t11 * t2;
+            const double t121 = t120 * t39;
+            const double t122 = t108 * t118;
+            const double t123 = t114 * t77;
+            const double t124 = t111 * t123;
+            const double t125 = -t69;
+            const double t126 = t6 * t6;
+            const double t127 = -t73;
+            const double t128 = t11 * t40;
+            const double t129 = t2 * t31;
+            const double t130 = 2 * t127;
+            const double t131 = t2 * t45 + t40 * t44;
+            const double t132 = t131 * t55;
+            const double t133 = t2 * t47;
+            const double t134 = t104 * t6;
+            const double t135 = t11 * t134;
+            const double t136 = t11 * t47;
+            const double t137 = t134 * t2;
+            const double t138 = 2 * t63;
+            const double t139 = t31 * t58 + t44 * t6;
+            const double t140 = t139 * t55;
+            const double t141 = t34 * t6;
+            const double t142 = 2 * t76;
+            const double t143 = -t66 + t67;
+            const double t144 = -t143;
+            const double t145 = 2 * t144;
+            const double t146 = t11 * t58 + t34 * t45;
+            const double t147 = t146 * t55;
+            const double t148 = -t81 + t82;
+            const double t149 = t148 + t20;
+            const double t150 = t11 * t42;
+            const double t151 = t31 * t4;
+            const double t152 = 2 * t80;
+            const double t153 = 2 * t149;
+            const double t154 = ea1_z + t1;
+            const double t155 = t39 * (-t12 + 2 * t13 * t6);
+            const double t156 = 2 * t95;
+            const double t157 = t114 * t94;
+            const double t158 = ea1_y + t10;
+            const double t159 = -t32 + t35;
+            const double t160 = t40 * t42;
+            const double t161 = t2 * t4;
+            const double t162 = ea0_z + t1;
+            const double t163 = ea0_y + t10;
+            const double t164 = t123 * t94 + t39 * (t3 - 2 * t7);
+            const double t165 = t42 * t42;
+            const double t166 = t4 * t4;
+            const double t167 = -t89;
+            const double t168 = 2 * t85;
+            const double t169 = 2 * t167;
+            const double t170 = t0 * t34;
+            const double t171 = t2 * t33;
+            const double t172 = ea1_x + t5;
+            const double t173 = t39 * (2 * t11 * t4 - t17);
+            const double t174 = t0 * t16 - t20 * t4;
+            const double t175 = t174 * t74;
+            const double t176 = t39 * (-2 * t12 - t15);
+            const double t177 = t0 * t6;
+            const double t178 = t31 * t33;
+            const double t179 = ea0_x + t5;
+            const double t180 = t0 * t39;
+            const double t181 = t13 * t180;
+            const double t182 = t0 * t0;
+            const double t183 = t33 * t33;
+            const double t184 = t100 + t16;
+            const double t185 = t39 * (2 * t3 + t8);
+            const double t186 = 2 * t99;
+            const double t187 = 2 * t93;
+            const double t188 = 2 * t184;
+            const double t189 = t30 * t6;
+            const double t190 = t13 * t40;
+            const double t191 = t39 * (-2 * t17 - t19);
+            const double t192 = t114 * t98;
+            const double t193 = t30 * t34;
+            const double t194 = t11 * t13;
+            const double t195 = -t157 * t98 + t180 * t4;
+            const double t196 = t13 * t4;
+            const double t197 = t196 * t39;
+            const double t198 = t174 * t192 - t186 * t89 + t197;
+            const double t199 = t30 * t30;
+            const double t200 = t13 * t13;
+            const double t201 = -t148;
+            const double t202 = 2 * t201;
+            const double t203 = t13 * t44 + t33 * t45;
+            const double t204 = t203 * t55;
+            const double t205 = ea1_z + t26;
+            const double t206 = ea1_y + t28;
+            const double t207 = t13 * t42;
+            const double t208 = t33 * t4;
+            const double t209 = t4 * t47;
+            const double t210 = t0 * t104;
+            const double t211 = t13 * t210;
+            const double t212 = t13 * t47;
+            const double t213 = t210 * t4;
+            const double t214 = 4 * t50;
+            const double t215 = -t174;
+            const double t216 = t215 * t74;
+            const double t217 = 2 * t88;
+            const double t218 = 2 * t97;
+            const double t219 = ea1_x + t24;
+            const double t220 = t0 * t30;
+            const double t221 = -t100;
+            const double t222 = 2 * t221;
+            const double t223 = t0 * t45 + t42 * t58;
+            const double t224 = t223 * t55;
+            d[i] = t39;
+            g[0 * n + i] = t55 * (-t51 - t54);
+            g[1 * n + i] = t55 * (t3 - t60 - t63 - t7);
+            g[2 * n + i] = t55 * (-t65 - t69);
+            g[3 * n + i] = t74 * (t72 + t73);
+            g[4 * n + i] = -t74 * (t63 + t76);
+            g[5 * n + i] = t74 * (-t68 - t78);
+            g[6 * n + i] = t55 * (t17 - t18 - t80 - t83);
+            g[7 * n + i] = t55 * (-t85 - t89);
+            g[8 * n + i] = t55 * (t12 - t14 - t90 + t91 - t93);
+            g[9 * n + i] = t74 * (-t83 - t95);
+            g[10 * n + i] = t55 * (t86 - t87 - t97);
+            g[11 * n + i] = t74 * (t100 + t99);
+            H[0 * n + i] = t107 * ((t101 * t101) - 4 * t101 * t51 - t104 * (t102
+                + (t31 * t31)) + t106 * (t46 * t46));
+            H[1 * n + i] = t116 * (t108 * t110 - t108 * t54 + t109 * t11 + t111
+                * t115 - t112 * t54);
+            H[2 * n + i] = t107 * (-t104 * (t117 + (t34 * t34)) + t106 * (t59
+                * t59) + (t108 * t108) - 4 * t108 * t60);
+            H[3 * n + i] = t116 * (-t110 * t69 + t118 * t54 + t119 + t54 * t69);
+            H[4 * n + i] = t116 * (-t108 * t69 - t112 * t69 + t121 - t122
+                - t124);
+            H[5 * n + i] = t107 * (-t104 * (t126 + (t40 * t40)) + t106 * (t64
+                * t64) + (t125 * t125) - 4 * t125 * t65);
+            H[6 * n + i] = t107 * (t101 * t127 - t101 * t132 + 4 * t103 * t105
+                * t131 * t46 - t104 * (t128 + t129) - t130 * t51);
+            H[7 * n + i] = t107 * (4 * t103 * t105 * t131 * t59 + t108 * t127
+                - t108 * t132 - t130 * t60 - t133 - t135);
+            H[8 * n + i] = t107 * (4 * t103 * t105 * t131 * t64 + t125 * t127
+                - t125 * t132 - t130 * t65 + t136 - t137);
+            H[9 * n + i] = t116 * (t114 * (t70 * t70) - t39 * (t102 + t117) + 4
+                * t72 * t73 + (t73 * t73));
+            H[10 * n + i] = t107 * (-t101 * t140 + t101 * t63 + 4 * t103 * t105
+                * t139 * t46 + t133 - t135 - t138 * t51);
+            H[11 * n + i] = t107 * (4 * t103 * t105 * t139 * t59 - t104 * (t129
+                + t141) - t108 * t140 + t108 * t63 - t138 * t60);
+            H[12 * n + i] = t107 * (4 * t103 * t105 * t139 * t64 - t104 * t120
+                - t125 * t140 + t125 * t63 - t138 * t65 - t47 * t6);
+            H[13 * n + i] = t116 * (t11 * t23 * t38 * t6 - t110 * t63 - t115
+                * t75 - t142 * t73 - t63 * t73);
+            H[14 * n + i] = t116 * (t114 * (t75 * t75) - t39 * (t117 + t126)
+                + (t63 * t63) + 4 * t63 * t76);
+            H[15 * n + i] = t107 * (t101 * t144 - t101 * t147 + 4 * t103 * t105
+                * t146 * t46 - t136 - t137 - t145 * t51);
+            H[16 * n + i] = t116 * (-t108 * t143 - t112 * t143 - t121 + t122
+                + t124 - t37 * t6);
+            H[17 * n + i] = t107 * (4 * t103 * t105 * t146 * t64 - t104 * (t128
+                + t141) + t125 * t144 - t125 * t147 - t145 * t65);
+            H[18 * n + i] = t116 * (t110 * t143 - t118 * t73 + t119 + t143
+                * t73);
+            H[19 * n + i] = t116 * (t118 * t63 + t121 + t123 * t75 - t142 * t143
+                - t143 * t63);
+            H[20 * n + i] = t116 * (t114 * (t77 * t77) + (t143 * t143) - 4
+                * t143 * t78 - t39 * (t102 + t126));
+            H[21 * n + i] = t107 * (t101 * t149 - t101 * t152 + 4 * t103 * t105
+                * t46 * t79 - t104 * (t150 + t151) - t153 * t51);
+            H[22 * n + i] = t116 * (t108 * t149 - t108 * t156 + 2 * t111 * t149
+                * t23 * t37 - t111 * t157 - t154 * t37 - t155);
+            H[23 * n + i] = t107 * (4 * t103 * t105 * t64 * t79 - t104 * (t159
+                + t7) + t125 * t149 - t125 * t152 - t153 * t65 - t158 * t47);
+            H[24 * n + i] = t107 * (4 * t103 * t105 * t131 * t79 - t104 * (t160
+                + t161) + t127 * t149 - t130 * t80 - t132 * t149);
+            H[25 * n + i] = t107 * (4 * t103 * t105 * t139 * t79 - t104 * (t42
+                * t6 + t44) - t138 * t80 - t140 * t149 + t149 * t63 - t162
+                * t47);
+            H[26 * n + i] = t116 * (-t143 * t149 + 2 * t143 * t23 * t37 * t94
+                + 2 * t149 * t23 * t37 * t77 - t163 * t37 - t164);
+            H[27 * n + i] = t107 * (-t104 * (t165 + t166) + t106 * (t79 * t79)
+                + (t149 * t149) - 4 * t149 * t80);
+            H[28 * n + i] = t107 * (t101 * t167 - t101 * t168 + 4 * t103 * t105
+                * t46 * t84 - t104 * (t12 + t44) - t154 * t47 - t169 * t51);
+            H[29 * n + i] = t107 * (4 * t103 * t105 * t59 * t84 - t104 * (t170
+                + t171) + t108 * t167 - t108 * t168 - t169 * t60);
+            H[30 * n + i] = t116 * (-t123 * t174 - t172 * t37 - t173 - t175
+                * t69 + 2 * t23 * t37 * t77 * t89 + t69 * t89);
+            H[31 * n + i] = t116 * (-t115 * t174 - t162 * t37 - t175 * t73
+                - t176 + 2 * t23 * t37 * t70 * t89 + t73 * t89);
+            H[32 * n + i] = t107 * (4 * t103 * t105 * t139 * t84 - t104 * (t177
+                + t178) - t138 * t85 - t140 * t167 + t167 * t63);
+            H[33 * n + i] = t107 * (4 * t103 * t105 * t146 * t84 - t104 * (t11
+                * t33 + t58) + t144 * t167 - t145 * t85 - t147 * t167 - t179
+                * t47);
+            H[34 * n + i] = t116 * (t149 * t175 - t149 * t89 + t156 * t89 - t157
+                * t174 + t181);
+            H[35 * n + i] = t107 * (-t104 * (t182 + t183) + t106 * (t84 * t84)
+                + (t167 * t167) - 4 * t167 * t85);
+            H[36 * n + i] = t116 * (4 * t113 * t38 * t70 * t98 - t158 * t37 + 2
+                * t184 * t23 * t37 * t70 - t184 * t54 - t185 - t186 * t54);
+            H[37 * n + i] = t107 * (4 * t103 * t105 * t59 * t92 - t104 * (t17
+                + t58) + t108 * t184 - t108 * t187 - t172 * t47 - t188 * t60);
+            H[38 * n + i] = t107 * (4 * t103 * t105 * t64 * t92 - t104 * (t189
+                + t190) + t125 * t184 - t125 * t187 - t188 * t65);
+            H[39 * n + i] = t107 * (4 * t103 * t105 * t131 * t92 - t104 * (t159
+                + t2 * t30) + t127 * t184 - t130 * t93 - t132 * t184 - t163
+                * t47);
+            H[40 * n + i] = t116 * (t138 * t99 + t142 * t184 - t179 * t37 + t184
+                * t63 - t191 + t192 * t75);
+            H[41 * n + i] = t107 * (4 * t103 * t105 * t146 * t92 - t104 * (t193
+                + t194) + t144 * t184 - t145 * t93 - t147 * t184);
+            H[42 * n + i] = t116 * (t149 * t184 + t153 * t99 - t156 * t184
+                + t195);
+            H[43 * n + i] = t116 * (t175 * t184 - t184 * t89 + t198);
+            H[44 * n + i] = t107 * (-t104 * (t199 + t200) + t106 * (t92 * t92)
+                + (t184 * t184) - 4 * t184 * t93);
+            H[45 * n + i] = t107 * (t101 * t201 - t101 * t204 + 4 * t103 * t105
+                * t203 * t46 - t104 * (t178 + t194) - t202 * t51);
+            H[46 * n + i] = t107 * (4 * t103 * t105 * t203 * t59 - t104 * (t13
+                * t34 + t44) + t108 * t201 - t108 * t204 - t202 * t60 - t205
+                * t47);
+            H[47 * n + i] = t116 * (2 * t148 * t23 * t37 * t77 + t148 * t69
+                - t156 * t69 - t164 - t206 * t37);
+            H[48 * n + i] = t107 * (4 * t103 * t105 * t131 * t203 - t104 * (t171
+                + t190) + t127 * t201 - t127 * t204 - t132 * t201);
+            H[49 * n + i] = t116 * (4 * t113 * t38 * t75 * t94 - t142 * t148
+                - t148 * t63 - t155 + 2 * t23 * t37 * t63 * t94 - t27 * t37);
+            H[50 * n + i] = t107 * (4 * t103 * t105 * t146 * t203 - t104 * (-t32
+                + 2 * t33 * t34) + t144 * t201 - t144 * t204 - t147 * t201 - t29
+                * t47);
+            H[51 * n + i] = t107 * (4 * t103 * t105 * t203 * t79 - t104 * (t207
+                + t208) + t149 * t201 - t149 * t204 - t152 * t201);
+            H[52 * n + i] = t107 * (4 * t103 * t105 * t203 * t84 + t167 * t201
+                - t167 * t204 - t168 * t201 - t209 - t211);
+            H[53 * n + i] = t107 * (4 * t103 * t105 * t203 * t92 + t184 * t201
+                - t184 * t204 - t187 * t201 + t212 - t213);
+            H[54 * n + i] = t107 * (-t104 * (t183 + t200) + t106 * (t203 * t203)
+                + (t201 * t201) - t201 * t203 * t214);
+            H[55 * n + i] = t116 * (4 * t113 * t215 * t38 * t70 - t176 - t205
+                * t37 - t216 * t54 + 2 * t23 * t37 * t70 * t88 - t54 * t88);
+            H[56 * n + i] = t107 * (4 * t103 * t105 * t59 * t96 - t104 * (t161
+                + t193) - t108 * t218 + t108 * t88 - t217 * t60);
+            H[57 * n + i] = t107 * (4 * t103 * t105 * t64 * t96 - t104 * (t4
+                * t40 + t58) - t125 * t218 + t125 * t88 - t217 * t65 - t219
+                * t47);
+            H[58 * n + i] = t107 * (4 * t103 * t105 * t131 * t96 - t104 * (2
+                * t41 + t43) + t127 * t88 - t130 * t97 - t132 * t88 - t27
+                * t47);
+            H[59 * n + i] = t107 * (4 * t103 * t105 * t139 * t96 - t104 * (t151
+                + t189) - t138 * t97 - t140 * t88 + t63 * t88);
+            H[60 * n + i] = t116 * (4 * t113 * t215 * t38 * t77 - t143 * t216
+                - t143 * t88 - t173 + 2 * t23 * t37 * t77 * t88 - t25 * t37);
+            H[61 * n + i] = t107 * (4 * t103 * t105 * t79 * t96 + t149 * t88
+                - t152 * t88 - t153 * t97 + t209 - t211);
+            H[62 * n + i] = t107 * (4 * t103 * t105 * t84 * t96 - t104 * (t208
+                + t220) + t167 * t88 - t168 * t88 - t169 * t97);
+            H[63 * n + i] = t107 * (-t0 * t47 + 4 * t103 * t105 * t92 * t96
+                - t104 * t196 + t184 * t88 - t187 * t88 - t188 * t97);
+            H[64 * n + i] = t116 * (-t148 * t216 - t148 * t88 + t156 * t88
+                + t157 * t215 + t181);
+            H[65 * n + i] = t107 * (-t104 * (t166 + t199) + t106 * (t96 * t96)
+                + (t88 * t88) - 4 * t88 * t97);
+            H[66 * n + i] = t107 * (t101 * t221 - t101 * t224 + 4 * t103 * t105
+                * t223 * t46 - t104 * (t0 * t31 + t159) - t206 * t47 - t222
+                * t51);
+            H[67 * n + i] = -t116 * (t100 * t108 + t100 * t112 + t108 * t186
+                + t111 * t192 + t191 + t219 * t37);
+            H[68 * n + i] = t107 * (4 * t103 * t105 * t223 * t64 - t104 * (t160
+                + t177) + t125 * t221 - t125 * t224 - t222 * t65);
+            H[69 * n + i] = t116 * (t100 * t110 + t100 * t73 + t115 * t98 - t185
+                + t186 * t73 - t29 * t37);
+            H[70 * n + i] = t107 * (4 * t103 * t105 * t139 * t223 - t104 * (2
+                * t56 + t57) - t140 * t221 + t221 * t63 - t224 * t63 - t25
+                * t47);
+            H[71 * n + i] = t107 * (4 * t103 * t105 * t146 * t223 - t104 * (t150
+                + t170) + t144 * t221 - t144 * t224 - t147 * t221);
+            H[72 * n + i] = t107 * (4 * t103 * t105 * t223 * t79 + t149 * t221
+                - t149 * t224 - t152 * t221 - t212 - t213);
+            H[73 * n + i] = t116 * (-t0 * t37 - t100 * t175 + t100 * t89
+                - t198);
+            H[74 * n + i] = t107 * (4 * t103 * t105 * t223 * t92 - t104 * (t207
+                + t220) + t184 * t221 - t184 * t224 - t187 * t221);
+            H[75 * n + i] = t116 * (t100 * t148 - t100 * t156 + t148 * t186
+                + t195);
+            H[76 * n + i] = t116 * (-t100 * t216 - t100 * t88 - t186 * t88
+                - t192 * t215 + t197);
+            H[77 * n + i] = t107 * (-t104 * (t165 + t182) + t106 * (t223 * t223)
+                - t214 * t221 * t223 + (t221 * t221));
+        }
+    }
+
+    // x is (6×n) in SoA layout; d is (1×n); g is (6×n); H is (21×n)
+    void point_line_distance_derivatives_batched_2D(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H)
+    {
+        IPC_TOOLKIT_VECTORIZE_LOOP
+        for (size_t i = 0; i < n; i++) {
+            const double p_x = x[0 * n + i];
+            const double p_y = x[1 * n + i];
+            const double e0_x = x[2 * n + i];
+            const double e0_y = x[3 * n + i];
+            const double e1_x = x[4 * n + i];
+            const double e1_y = x[5 * n + i];
+            const double t0 = -e1_x;
+            const double t1 = e0_x + t0;
+            const double t2 = t1 * t1;
+            const double t3 = -e1_y;
+            const double t4 = e0_y + t3;
+            const double t5 = t4 * t4;
+            const double t6 = t2 + t5;
+            const double t7 = 1.0 / t6;
+            const double t8 = -p_y;
+            const double t9 = e0_y + t8;
+            const double t10 = t1 * t9;
+            const double t11 = -p_x;
+            const double t12 = e0_x + t11;
+            const double t13 = t12 * t4;
+            const double t14 = t10 - t13;
+            const double t15 = t14 * t14;
+            const double t16 = t15 * t7;
+            const double t17 = t14 * t7;
+            const double t18 = 2 * t17;
+            const double t19 = t18 * t4;
+            const double t20 = t1 * t17;
+            const double t21 = 2 * t20;
+            const double t22 = -t14;
+            const double t23 = t22 * t7;
+            const double t24 = t1 * t23;
+            const double t25 = e1_y + t8;
+            const double t26 = 2 * t23;
+            const double t27 = t23 * t4;
+            const double t28 = p_x + t27;
+            const double t29 = -e0_x;
+            const double t30 = 2 * t7;
+            const double t31 = t30 * t4;
+            const double t32 = t1 * t25;
+            const double t33 = 4 * t17;
+            const double t34 = -t16;
+            const double t35 = 4 / (t6 * t6);
+            const double t36 = t15 * t35;
+            const double t37 = t2 * t36 + t34;
+            const double t38 = e1_x + t11;
+            const double t39 = t38 * t4;
+            const double t40 = 2 * t27;
+            const double t41 = p_x + t40;
+            const double t42 = t1 * t30;
+            const double t43 = t1 * t4;
+            const double t44 = t21 * t38 + t36 * t43;
+            const double t45 = t34 + t36 * t5;
+            const double t46 = 2 * t24;
+            const double t47 = t22 * t22;
+            const double t48 = t35 * t47;
+            const double t49 = 2 * t13;
+            const double t50 = t12 * t46 - t43 * t48;
+            d[i] = t16;
+            g[0 * n + i] = t19;
+            g[1 * n + i] = -t21;
+            g[2 * n + i] = -t26 * (t24 + t25);
+            g[3 * n + i] = t26 * (-t0 - t28);
+            g[4 * n + i] = t18 * (-e0_y + p_y + t20);
+            g[5 * n + i] = t26 * (t28 + t29);
+            H[0 * n + i] = t30 * t5;
+            H[1 * n + i] = -t1 * t31;
+            H[2 * n + i] = t2 * t30;
+            H[3 * n + i] = t31 * (-p_y - t21 - t3);
+            H[4 * n + i] = t30 * (-t14 - t2 * t26 - t32);
+            H[5 * n + i] = t30 * ((t25 * t25) - t32 * t33 + t37);
+            H[6 * n + i] = t30 * (t14 + t26 * t5 - t39);
+            H[7 * n + i] = t42 * (-t0 - t41);
+            H[8 * n + i] = t30 * (-t19 * t25 - t25 * t38 + t44);
+            H[9 * n + i] = t30 * (t33 * t39 + (t38 * t38) + t45);
+            H[10 * n + i] = -t31 * (t46 + t9);
+            H[11 * n + i] = t30 * (2 * t1 * t9 - t13 - t18 * t2);
+            H[12 * n + i] = t30 * (-2 * t10 * t23 - t2 * t48 - t25 * t9 - t26
+                * t32 + t47 * t7);
+            H[13 * n + i] = t30 * (2 * t14 * t4 * t7 * t9 - t14 + t38 * t9
+                - t44);
+            H[14 * n + i] = t30 * (-t10 * t33 + t37 + (t9 * t9));
+            H[15 * n + i] = t30 * (-t10 + t18 * t5 + t49);
+            H[16 * n + i] = t42 * (t29 + t41);
+            H[17 * n + i] = t30 * (t12 * t25 + t14 - t25 * t40 + t50);
+            H[18 * n + i] = t30 * (-t12 * t38 - t17 * t49 - t18 * t39 - t45);
+            H[19 * n + i] = t30 * (-t12 * t9 + 2 * t22 * t4 * t7 * t9 - t50);
+            H[20 * n + i] = t30 * ((t12 * t12) + t13 * t33 + t45);
+        }
+    }
+
+    // x is (9×n) in SoA layout; d is (1×n); g is (9×n); H is (45×n)
+    void point_line_distance_derivatives_batched_3D(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H)
+    {
+        IPC_TOOLKIT_VECTORIZE_LOOP
+        for (size_t i = 0; i < n; i++) {
+            const double p_x = x[0 * n + i];
+            const double p_y = x[1 * n + i];
+            const double p_z = x[2 * n + i];
+            const double e0_x = x[3 * n + i];
+            const double e0_y = x[4 * n + i];
+            const double e0_z = x[5 * n + i];
+            const double e1_x = x[6 * n + i];
+            const double e1_y = x[7 * n + i];
+            const double e1_z = x[8 * n + i];
+            const double t0 = e0_x - e1_x;
+            const double t1 = t0 * t0;
+            const double t2 = e0_y - e1_y;
+            const double t3 = t2 * t2;
+            const double t4 = e0_z - e1_z;
+            const double t5 = t4 * t4;
+            const double t6 = t3 + t5;
+            const double t7 = t1 + t6;
+            const double t8 = 1.0 / t7;
+            const double t9 = -p_y;
+            const double t10 = e0_y + t9;
+            const double t11 = t0 * t10;
+            const double t12 = -p_x;
+            const double t13 = e0_x + t12;
+            const double t14 = t13 * t2;
+            const double t15 = -t14;
+            const double t16 = t11 + t15;
+            const double t17 = -p_z;
+            const double t18 = e0_z + t17;
+            const double t19 = t0 * t18;
+            const double t20 = t13 * t4;
+            const double t21 = -t20;
+            const double t22 = t19 + t21;
+            const double t23 = -t22;
+            const double t24 = t18 * t2;
+            const double t25 = t10 * t4;
+            const double t26 = -t25;
+            const double t27 = t24 + t26;
+            const double t28 = (t16 * t16) + (t23 * t23) + (t27 * t27);
+            const double t29 = t28 * t8;
+            const double t30 = -t16;
+            const double t31 = -t0 * t18 + t13 * t4;
+            const double t32 = 2 * t8;
+            const double t33 = t32 * (t2 * t30 + t31 * t4);
+            const double t34 = -t0 * t16 + t27 * t4;
+            const double t35 = t32 * t34;
+            const double t36 = t0 * t23 - t2 * t27;
+            const double t37 = t32 * t36;
+            const double t38 = -t27;
+            const double t39 = (t30 * t30) + (t31 * t31) + (t38 * t38);
+            const double t40 = t39 * t8;
+            const double t41 = e1_y + t9;
+            const double t42 = e1_z + t17;
+            const double t43 = t30 * t41 + t31 * t42;
+            const double t44 = t38 * t42;
+            const double t45 = e1_x + t12;
+            const double t46 = t31 * t45 + t38 * t41;
+            const double t47 = t10 * t16;
+            const double t48 = t13 * t30;
+            const double t49 = t10 * t38 + t13 * t31;
+            const double t50 = t0 * t32;
+            const double t51 = t2 * t32;
+            const double t52 = t2 * t41;
+            const double t53 = t4 * t42;
+            const double t54 = t0 * t33;
+            const double t55 = t0 * t30 - t38 * t4;
+            const double t56 = t0 * t31 + t2 * t38;
+            const double t57 = t41 * t41;
+            const double t58 = 4 / (t7 * t7);
+            const double t59 = t28 * t58;
+            const double t60 = t1 * t59;
+            const double t61 = 4 * t8;
+            const double t62 = t0 * t61;
+            const double t63 = -t29;
+            const double t64 = (t42 * t42) + t63;
+            const double t65 = t2 * t33;
+            const double t66 = t0 * t45;
+            const double t67 = t30 * t45 - t44;
+            const double t68 = t0 * t2;
+            const double t69 = t39 * t58;
+            const double t70 = t43 * t51 + t68 * t69;
+            const double t71 = t45 * t45;
+            const double t72 = -t16 * t45 + t27 * t42;
+            const double t73 = t2 * t61;
+            const double t74 = t3 * t59;
+            const double t75 = t33 * t4;
+            const double t76 = t32 * t4;
+            const double t77 = -t24;
+            const double t78 = t25 + t77;
+            const double t79 = t4 * t69;
+            const double t80 = t0 * t79 + t43 * t76;
+            const double t81 = -t2 * t79 + t67 * t76;
+            const double t82 = t23 * t45 - t27 * t41;
+            const double t83 = t4 * t61;
+            const double t84 = t5 * t59 + t63;
+            const double t85 = t10 * t2;
+            const double t86 = t18 * t4;
+            const double t87 = t10 * t41;
+            const double t88 = t18 * t23 - t47;
+            const double t89 = t18 * t42 + t63;
+            const double t90 = t51 * t88 + t59 * t68;
+            const double t91 = t4 * t59;
+            const double t92 = t0 * t91 + t76 * t88;
+            const double t93 = t10 * t10;
+            const double t94 = (t18 * t18) + t63;
+            const double t95 = t0 * t13;
+            const double t96 = -t18 * t38 + t48;
+            const double t97 = t13 * t45;
+            const double t98 = -t2 * t91 + t76 * t96;
+            const double t99 = t13 * t13;
+            const double t100 = -t49 * t50;
+            const double t101 = t49 * t51;
+            d[i] = t29;
+            g[0 * n + i] = -t33;
+            g[1 * n + i] = t35;
+            g[2 * n + i] = t37;
+            g[3 * n + i] = -t32 * (t0 * t40 + t43);
+            g[4 * n + i] = t32 * (-t2 * t40 + t30 * t45 - t44);
+            g[5 * n + i] = t32 * (-t4 * t40 + t46);
+            g[6 * n + i] = t32 * (t0 * t29 + t18 * t23 - t47);
+            g[7 * n + i] = t32 * (t18 * t38 + t2 * t29 - t48);
+            g[8 * n + i] = t32 * (t28 * t4 * t8 - t49);
+            H[0 * n + i] = t32 * t6;
+            H[1 * n + i] = -t2 * t50;
+            H[2 * n + i] = t32 * (t1 + t5);
+            H[3 * n + i] = -t4 * t50;
+            H[4 * n + i] = -t4 * t51;
+            H[5 * n + i] = t32 * (t1 + t3);
+            H[6 * n + i] = t32 * (t52 + t53 + t54);
+            H[7 * n + i] = t32 * (-t0 * t41 - t16 - t50 * t55);
+            H[8 * n + i] = t32 * (-t0 * t42 - t22 - t50 * t56);
+            H[9 * n + i] = t32 * (t43 * t62 + t57 + t60 + t64);
+            H[10 * n + i] = t32 * (t16 - t2 * t45 + t65);
+            H[11 * n + i] = t32 * (-t51 * t55 + t53 + t66);
+            H[12 * n + i] = t32 * (-t2 * t42 - t27 - t51 * t56);
+            H[13 * n + i] = t32 * (-t41 * t45 - t50 * t67 + t70);
+            H[14 * n + i] = t32 * (t64 + t71 - t72 * t73 + t74);
+            H[15 * n + i] = t32 * (t22 - t4 * t45 + t75);
+            H[16 * n + i] = t32 * (-t4 * t41 - t55 * t76 - t78);
+            H[17 * n + i] = t32 * (t52 - t56 * t76 + t66);
+            H[18 * n + i] = t32 * (-t42 * t45 - t46 * t50 + t80);
+            H[19 * n + i] = t32 * (-t41 * t42 - t46 * t51 - t81);
+            H[20 * n + i] = t32 * (t57 + t71 - t82 * t83 + t84);
+            H[21 * n + i] = -t32 * (t54 + t85 + t86);
+            H[22 * n + i] = t32 * (t0 * t35 + 2 * t11 + t15);
+            H[23 * n + i] = t32 * (t0 * t37 + 2 * t19 + t21);
+            H[24 * n + i] = t32 * (-t43 * t50 - t50 * t88 - t60 - t87 - t89);
+            H[25 * n + i] = t32 * (2 * t0 * t72 * t8 + t10 * t45 - t16 - t90);
+            H[26 * n + i] = t32 * (2 * t0 * t8 * t82 + t18 * t45 - t22 - t92);
+            H[27 * n + i] = t32 * (t60 + t62 * t88 + t93 + t94);
+            H[28 * n + i] = t32 * (-t11 + 2 * t13 * t2 - t65);
+            H[29 * n + i] = t32 * (2 * t2 * t34 * t8 - t86 - t95);
+            H[30 * n + i] = t32 * (t2 * t37 + 2 * t24 + t26);
+            H[31 * n + i] = t32 * (t11 + t13 * t41 - t14 + t50 * t96 - t70);
+            H[32 * n + i] = t32 * (2 * t2 * t72 * t8 + 2 * t2 * t8 * t96 - t74
+                - t89 - t97);
+            H[33 * n + i] = t32 * (t18 * t41 + t51 * t82 + t78 + t98);
+            H[34 * n + i] = t32 * (-t10 * t13 - t50 * t96 + t90);
+            H[35 * n + i] = t32 * (-t73 * t96 + t74 + t94 + t99);
+            H[36 * n + i] = t32 * (2 * t13 * t4 - t19 - t75);
+            H[37 * n + i] = t32 * (2 * t25 + t35 * t4 + t77);
+            H[38 * n + i] = t32 * (2 * t36 * t4 * t8 - t85 - t95);
+            H[39 * n + i] = t32 * (-t100 + t13 * t42 + t19 - t20 - t80);
+            H[40 * n + i] = t32 * (t10 * t42 + t101 + t27 + t81);
+            H[41 * n + i] = t32 * (2 * t4 * t49 * t8 + 2 * t4 * t8 * t82 - t84
+                - t87 - t97);
+            H[42 * n + i] = t32 * (t100 - t13 * t18 + t92);
+            H[43 * n + i] = t32 * (-t10 * t18 - t101 - t98);
+            H[44 * n + i] = t32 * (-t49 * t83 + t84 + t93 + t99);
+        }
+    }
+} // namespace autogen
+} // namespace ipc
+// clang-format on
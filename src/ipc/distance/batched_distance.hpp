@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+// Batched distance kernels generated by notebooks/batched_distances.ipynb.
+//
+// Each kernel evaluates the squared distance (d), its gradient (g), and the
+// upper triangle of its Hessian packed in column-major order (H) of n stencils.
+// All arrays are in SoA layout (e.g., g[k * n + i] is the k-th entry of the
+// i-th stencil's gradient), so the loops vectorize across stencils.
+namespace ipc {
+namespace autogen {
+    // x is (12×n) in SoA layout; d is (1×n); g is (12×n); H is (78×n)
+    void point_plane_distance_derivatives_batched(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H);
+
+    // x is (12×n) in SoA layout; d is (1×n); g is (12×n); H is (78×n)
+    void line_line_distance_derivatives_batched(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H);
+
+    // x is (6×n) in SoA layout; d is (1×n); g is (6×n); H is (21×n)
+    void point_line_distance_derivatives_batched_2D(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H);
+
+    // x is (9×n) in SoA layout; d is (1×n); g is (9×n); H is (45×n)
+    void point_line_distance_derivatives_batched_3D(
+        const size_t n,
+        const double* __restrict x,
+        double* __restrict d,
+        double* __restrict g,
+        double* __restrict H);
+} // namespace autogen
+} // namespace ipc
@@ -2,10 +2,10 @@
 
 #include <ipc/distance/edge_edge_mollifier.hpp>
 #include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
-#include <tbb/enumerable_thread_specific.h>
 
 #include <stdexcept> // std::out_of_range
 
@@ -101,24 +101,11 @@ double FrictionConstraints::compute_potential(
         return 0;
     }
 
-    tbb::enumerable_thread_specific<double> storage(0);
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
-        [&](tbb::blocked_range<size_t> r) {
-            auto& local_potential = storage.local();
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                // Quadrature weight is premultiplied by compute_potential
-                local_potential += (*this)[i].compute_potential(
-                    velocity, mesh.edges(), mesh.faces(), epsv);
-            }
-        });
-
-    double potential = 0;
-    for (const auto& local_potential : storage) {
-        potential += local_potential;
-    }
-    return potential;
+    // Quadrature weight is premultiplied by compute_potential
+    return deterministic_parallel_sum(size(), [&](size_t i) {
+        return (*this)[i].compute_potential(
+            velocity, mesh.edges(), mesh.faces(), epsv);
+    });
 }
 
 Eigen::VectorXd FrictionConstraints::compute_potential_gradient(
@@ -134,34 +121,14 @@ Eigen::VectorXd FrictionConstraints::compute_potential_gradient(
     }
     assert(epsv > 0);
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(ndof));
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& global_grad = storage.local();
-
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                const auto& constraint = (*this)[i];
-
-                const VectorMax12d local_grad =
-                    constraint.compute_potential_gradient(
-                        velocity, mesh.edges(), mesh.faces(), epsv);
-
-                const std::array<long, 4> vis =
-                    constraint.vertex_ids(mesh.edges(), mesh.faces());
-
-                local_gradient_to_global_gradient(
-                    local_grad, vis, dim, global_grad);
-            }
+    return deterministic_gradient_assembly(
+        size(), velocity.rows(), dim,
+        [&](size_t i, VectorMax12d& local_grad, std::array<long, 4>& vis) {
+            const auto& constraint = (*this)[i];
+            local_grad = constraint.compute_potential_gradient(
+                velocity, mesh.edges(), mesh.faces(), epsv);
+            vis = constraint.vertex_ids(mesh.edges(), mesh.faces());
         });
-
-    Eigen::VectorXd grad = Eigen::VectorXd::Zero(ndof);
-    for (const auto& local_grad : storage) {
-        grad += local_grad;
-    }
-    return grad;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -170,7 +137,8 @@ Eigen::SparseMatrix<double> FrictionConstraints::compute_potential_hessian(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& velocity,
     const double epsv,
-    const bool project_hessian_to_psd) const
+    const bool project_hessian_to_psd,
+    const bool upper_triangular) const
 {
     const int dim = velocity.cols();
     const int ndof = velocity.size();
@@ -180,38 +148,76 @@ Eigen::SparseMatrix<double> FrictionConstraints::compute_potential_hessian(
     }
     assert(epsv > 0);
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
+    return deterministic_sparse_assembly(
+        size(), ndof, ndof,
+        [&](size_t i, std::vector<Eigen::Triplet<double>>& hess_triplets) {
+            const auto& constraint = (*this)[i];
+
+            const MatrixMax12d local_hess =
+                constraint.compute_potential_hessian(
+                    velocity, mesh.edges(), mesh.faces(), epsv,
+                    project_hessian_to_psd);
+
+            const std::array<long, 4> vis =
+                constraint.vertex_ids(mesh.edges(), mesh.faces());
+
+            local_hessian_to_global_triplets(
+                local_hess, vis, dim, hess_triplets, upper_triangular);
+        });
+}
+
+void FrictionConstraints::compute_potential_local_gradients(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& velocity,
+    const double epsv,
+    LocalValuesBuffer local_gradients,
+    LocalVertexIdsBuffer vertex_ids) const
+{
+    assert(epsv > 0);
+
+    const int dim = velocity.cols();
+    check_local_buffers(size(), 4 * dim, local_gradients, vertex_ids);
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& hess_triplets = storage.local();
-
             for (size_t i = r.begin(); i < r.end(); i++) {
                 const auto& constraint = (*this)[i];
+                local_gradient_to_buffer(
+                    constraint.compute_potential_gradient(
+                        velocity, mesh.edges(), mesh.faces(), epsv),
+                    constraint.vertex_ids(mesh.edges(), mesh.faces()),
+                    local_gradients.row(i), vertex_ids.row(i));
+            }
+        });
+}
 
-                const MatrixMax12d local_hess =
-                    constraint.compute_potential_hessian(
-                        velocity, mesh.edges(), mesh.faces(), epsv,
-                        project_hessian_to_psd);
+void FrictionConstraints::compute_potential_local_hessians(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& velocity,
+    const double epsv,
+    LocalValuesBuffer local_hessians,
+    LocalVertexIdsBuffer vertex_ids,
+    const bool project_hessian_to_psd) const
+{
+    assert(epsv > 0);
 
-                const std::array<long, 4> vis =
-                    constraint.vertex_ids(mesh.edges(), mesh.faces());
+    const int dim = velocity.cols();
+    check_local_buffers(size(), 16 * dim * dim, local_hessians, vertex_ids);
 
-                local_hessian_to_global_triplets(
-                    local_hess, vis, dim, hess_triplets);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const auto& constraint = (*this)[i];
+                local_hessian_to_buffer(
+                    constraint.compute_potential_hessian(
+                        velocity, mesh.edges(), mesh.faces(), epsv,
+                        project_hessian_to_psd),
+                    constraint.vertex_ids(mesh.edges(), mesh.faces()), dim,
+                    local_hessians.row(i), vertex_ids.row(i));
             }
         });
-
-    Eigen::SparseMatrix<double> hess(ndof, ndof);
-    for (const auto& local_hess_triplets : storage) {
-        Eigen::SparseMatrix<double> local_hess(ndof, ndof);
-        local_hess.setFromTriplets(
-            local_hess_triplets.begin(), local_hess_triplets.end());
-        hess += local_hess;
-    }
-    return hess;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -234,32 +240,15 @@ Eigen::VectorXd FrictionConstraints::compute_force(
 
     int dim = velocities.cols();
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(velocities.size()));
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            Eigen::VectorXd& force = storage.local();
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                const auto& constraint = (*this)[i];
-
-                const VectorMax12d local_force = constraint.compute_force(
-                    X, Ut, velocities, mesh.edges(), mesh.faces(), dhat,
-                    barrier_stiffness, epsv, dmin, no_mu);
-
-                const std::array<long, 4> vis =
-                    constraint.vertex_ids(mesh.edges(), mesh.faces());
-
-                local_gradient_to_global_gradient(local_force, vis, dim, force);
-            }
+    return deterministic_gradient_assembly(
+        size(), velocities.rows(), dim,
+        [&](size_t i, VectorMax12d& local_force, std::array<long, 4>& vis) {
+            const auto& constraint = (*this)[i];
+            local_force = constraint.compute_force(
+                X, Ut, velocities, mesh.edges(), mesh.faces(), dhat,
+                barrier_stiffness, epsv, dmin, no_mu);
+            vis = constraint.vertex_ids(mesh.edges(), mesh.faces());
         });
-
-    Eigen::VectorXd force = Eigen::VectorXd::Zero(velocities.size());
-    for (const auto& local_force : storage) {
-        force += local_force;
-    }
-    return force;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -285,39 +274,23 @@ Eigen::SparseMatrix<double> FrictionConstraints::compute_force_jacobian(
     const Eigen::MatrixXi& edges = mesh.edges();
     const Eigen::MatrixXi& faces = mesh.faces();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& jac_triplets = storage.local();
-
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                const FrictionConstraint& constraint = (*this)[i];
+    Eigen::SparseMatrix<double> jacobian = deterministic_sparse_assembly(
+        size(), velocities.size(), velocities.size(),
+        [&](size_t i, std::vector<Eigen::Triplet<double>>& jac_triplets) {
+            const FrictionConstraint& constraint = (*this)[i];
 
-                const MatrixMax12d local_force_jacobian =
-                    constraint.compute_force_jacobian(
-                        X, Ut, velocities, edges, faces, dhat,
-                        barrier_stiffness, epsv, wrt, dmin);
+            const MatrixMax12d local_force_jacobian =
+                constraint.compute_force_jacobian(
+                    X, Ut, velocities, edges, faces, dhat, barrier_stiffness,
+                    epsv, wrt, dmin);
 
-                const std::array<long, 4> vis =
-                    constraint.vertex_ids(mesh.edges(), mesh.faces());
+            const std::array<long, 4> vis =
+                constraint.vertex_ids(mesh.edges(), mesh.faces());
 
-                local_hessian_to_global_triplets(
-                    local_force_jacobian, vis, dim, jac_triplets);
-            }
+            local_hessian_to_global_triplets(
+                local_force_jacobian, vis, dim, jac_triplets);
         });
 
-    Eigen::SparseMatrix<double> jacobian(velocities.size(), velocities.size());
-    for (const auto& local_jac_triplets : storage) {
-        Eigen::SparseMatrix<double> local_jacobian(
-            velocities.size(), velocities.size());
-        local_jacobian.setFromTriplets(
-            local_jac_triplets.begin(), local_jac_triplets.end());
-        jacobian += local_jacobian;
-    }
-
     // if wrt == X then compute ∇ₓ w(x)
     if (wrt == FrictionConstraint::DiffWRT::X) {
         for (int i = 0; i < this->size(); i++) {
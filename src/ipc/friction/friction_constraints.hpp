@@ -69,11 +69,45 @@ public:
     /// @param velocity Current vertex velocity (rowwise).
     /// @param epsv Mollifier parameter \f$\epsilon_v\f$.
     /// @param project_hessian_to_psd If true, project the Hessian to be positive semi-definite.
+    /// @param upper_triangular If true, only assemble the upper triangle of the symmetric Hessian.
     /// @return The Hessian of the friction dissapative potential wrt the velocity.
     Eigen::SparseMatrix<double> compute_potential_hessian(
         const CollisionMesh& mesh,
         const Eigen::MatrixXd& velocity,
         const double epsv,
+        const bool project_hessian_to_psd = false,
+        const bool upper_triangular = false) const;
+
+    /// @brief Compute the unassembled gradients of the friction dissapative potential of each constraint.
+    /// @note Row i of the buffers holds the local gradient of constraint i zero padded to 4·dim entries and its vertex ids (-1 for unused vertices).
+    /// @param mesh The collision mesh.
+    /// @param velocity Current vertex velocity (rowwise).
+    /// @param epsv Mollifier parameter \f$\epsilon_v\f$.
+    /// @param[out] local_gradients Buffer of at least size() × (4·dim) local gradients.
+    /// @param[out] vertex_ids Buffer of at least size() × 4 vertex ids.
+    /// @throws std::invalid_argument If a buffer is too small.
+    void compute_potential_local_gradients(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& velocity,
+        const double epsv,
+        LocalValuesBuffer local_gradients,
+        LocalVertexIdsBuffer vertex_ids) const;
+
+    /// @brief Compute the unassembled Hessians of the friction dissapative potential of each constraint.
+    /// @note Row i of the buffers holds the local Hessian of constraint i as a (4·dim)×(4·dim) column-major matrix (zero padded) and its vertex ids (-1 for unused vertices).
+    /// @param mesh The collision mesh.
+    /// @param velocity Current vertex velocity (rowwise).
+    /// @param epsv Mollifier parameter \f$\epsilon_v\f$.
+    /// @param[out] local_hessians Buffer of at least size() × (4·dim)² local Hessians.
+    /// @param[out] vertex_ids Buffer of at least size() × 4 vertex ids.
+    /// @param project_hessian_to_psd If true, project the Hessians to be positive semi-definite.
+    /// @throws std::invalid_argument If a buffer is too small.
+    void compute_potential_local_hessians(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& velocity,
+        const double epsv,
+        LocalValuesBuffer local_hessians,
+        LocalVertexIdsBuffer vertex_ids,
         const bool project_hessian_to_psd = false) const;
 
     // ------------------------------------------------------------------------
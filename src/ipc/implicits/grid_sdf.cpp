@@ -0,0 +1,277 @@
+#include "grid_sdf.hpp"
+
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace ipc {
+
+GridSDF::GridSDF(
+    const VectorMax3d& origin,
+    const double spacing,
+    const ArrayMax3i& resolution,
+    const Eigen::VectorXd& values)
+    : m_origin(origin)
+    , m_spacing(spacing)
+    , m_resolution(resolution)
+    , m_values(values)
+{
+    if (origin.size() != 2 && origin.size() != 3) {
+        throw std::runtime_error("Grid SDF must be 2D or 3D!");
+    }
+    if (resolution.size() != origin.size() || (resolution < 2).any()) {
+        throw std::runtime_error(
+            "Grid SDF must have at least two samples along each axis!");
+    }
+    if (values.size() != resolution.cast<long>().prod()) {
+        throw std::runtime_error(
+            "Number of grid SDF samples does not match the resolution!");
+    }
+    if (!(spacing > 0)) {
+        throw std::runtime_error("Grid SDF spacing must be positive!");
+    }
+
+    m_max_corner = m_origin.array()
+        + spacing * (m_resolution - 1).cast<double>().matrix().array();
+
+    init_lipschitz_constant();
+}
+
+GridSDF GridSDF::load(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open grid SDF file: " + filename);
+    }
+
+    const auto read = [&](void* data, const size_t size) {
+        if (!file.read(reinterpret_cast<char*>(data), size)) {
+            throw std::runtime_error("Invalid grid SDF file: " + filename);
+        }
+    };
+
+    int32_t dim;
+    read(&dim, sizeof(dim));
+    if (dim != 2 && dim != 3) {
+        throw std::runtime_error("Invalid grid SDF file: " + filename);
+    }
+
+    std::array<int32_t, 3> resolution;
+    read(resolution.data(), dim * sizeof(int32_t));
+    VectorMax3d origin(dim);
+    read(origin.data(), dim * sizeof(double));
+    double spacing;
+    read(&spacing, sizeof(spacing));
+
+    ArrayMax3i res(dim);
+    for (int i = 0; i < dim; i++) {
+        if (resolution[i] < 2) {
+            throw std::runtime_error("Invalid grid SDF file: " + filename);
+        }
+        res[i] = resolution[i];
+    }
+
+    Eigen::VectorXd values(res.cast<long>().prod());
+    read(values.data(), values.size() * sizeof(double));
+
+    return GridSDF(origin, spacing, res, values);
+}
+
+void GridSDF::save(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open grid SDF file: " + filename);
+    }
+
+    const int32_t dim = this->dim();
+    file.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+    for (int i = 0; i < dim; i++) {
+        const int32_t n = m_resolution[i];
+        file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    }
+    file.write(
+        reinterpret_cast<const char*>(m_origin.data()), dim * sizeof(double));
+    file.write(reinterpret_cast<const char*>(&m_spacing), sizeof(m_spacing));
+    file.write(
+        reinterpret_cast<const char*>(m_values.data()),
+        m_values.size() * sizeof(double));
+}
+
+// ============================================================================
+
+double GridSDF::signed_distance(const VectorMax3d& p) const
+{
+    return evaluate(p, nullptr, nullptr);
+}
+
+VectorMax3d GridSDF::signed_distance_gradient(const VectorMax3d& p) const
+{
+    VectorMax3d grad;
+    evaluate(p, &grad, nullptr);
+    return grad;
+}
+
+MatrixMax3d GridSDF::signed_distance_hessian(const VectorMax3d& p) const
+{
+    MatrixMax3d hess;
+    evaluate(p, nullptr, &hess);
+    return hess;
+}
+
+double GridSDF::evaluate(
+    const VectorMax3d& p, VectorMax3d* grad, MatrixMax3d* hess) const
+{
+    assert(p.size() == dim());
+
+    // Closest point on the grid's bounding box
+    const VectorMax3d q = p.cwiseMax(m_origin).cwiseMin(m_max_corner);
+    const VectorMax3d offset = p - q;
+    const double r = offset.norm();
+
+    const double value = interpolate(q, grad, hess) + r;
+
+    if (r == 0) {
+        return value;
+    }
+
+    // Along the clamped axes the interpolation is constant, and the distance
+    // to the box increases instead.
+    const VectorMax3d n = offset / r;
+    for (int i = 0; i < dim(); i++) {
+        if (offset[i] == 0) {
+            continue;
+        }
+        if (grad != nullptr) {
+            (*grad)[i] = 0;
+        }
+        if (hess != nullptr) {
+            hess->row(i).setZero();
+            hess->col(i).setZero();
+            (*hess)(i, i) = 1 / r;
+        }
+    }
+    if (grad != nullptr) {
+        *grad += n;
+    }
+    if (hess != nullptr) {
+        *hess -= n * n.transpose() / r;
+    }
+
+    return value;
+}
+
+double GridSDF::interpolate(
+    const VectorMax3d& p, VectorMax3d* grad, MatrixMax3d* hess) const
+{
+    const int dim = this->dim();
+
+    // Cell containing p and the local coordinates of p in the cell
+    std::array<int, 3> cell = { { 0, 0, 0 } };
+    std::array<double, 3> u = { { 0, 0, 0 } };
+    for (int i = 0; i < dim; i++) {
+        const double x = (p[i] - m_origin[i]) / m_spacing;
+        cell[i] = std::clamp(int(std::floor(x)), 0, m_resolution[i] - 2);
+        u[i] = x - cell[i];
+    }
+
+    double value = 0;
+    if (grad != nullptr) {
+        grad->setZero(dim);
+    }
+    if (hess != nullptr) {
+        hess->setZero(dim, dim);
+    }
+
+    for (int c = 0; c < (1 << dim); c++) {
+        // Weight of the corner along each axis and its derivative
+        std::array<double, 3> w, dw;
+        for (int i = 0; i < dim; i++) {
+            const bool upper = (c >> i) & 1;
+            w[i] = upper ? u[i] : 1 - u[i];
+            dw[i] = (upper ? 1 : -1) / m_spacing;
+        }
+        const double v = this->value(
+            cell[0] + (c & 1), cell[1] + ((c >> 1) & 1),
+            dim == 3 ? cell[2] + ((c >> 2) & 1) : 0);
+
+        double weight = v;
+        for (int i = 0; i < dim; i++) {
+            weight *= w[i];
+        }
+        value += weight;
+
+        for (int i = 0; i < dim; i++) {
+            if (grad != nullptr) {
+                double gi = v * dw[i];
+                for (int j = 0; j < dim; j++) {
+                    gi *= j == i ? 1 : w[j];
+                }
+                (*grad)[i] += gi;
+            }
+            if (hess == nullptr) {
+                continue;
+            }
+            // The interpolation is linear along each axis, so only the mixed
+            // derivatives are non-zero.
+            for (int j = i + 1; j < dim; j++) {
+                double hij = v * dw[i] * dw[j];
+                for (int k = 0; k < dim; k++) {
+                    hij *= k == i || k == j ? 1 : w[k];
+                }
+                (*hess)(i, j) += hij;
+                (*hess)(j, i) += hij;
+            }
+        }
+    }
+
+    return value;
+}
+
+void GridSDF::init_lipschitz_constant()
+{
+    // Inside a cell, the derivative along an axis interpolates the differences
+    // of the samples along that axis, so it is bounded by their maximum.
+    const int dim = this->dim();
+    const int nx = m_resolution[0], ny = m_resolution[1];
+    const int nz = dim == 3 ? m_resolution[2] : 1;
+
+    const Eigen::Array3d max_slope = tbb::parallel_reduce(
+        tbb::blocked_range<int>(0, ny * nz), Eigen::Array3d::Zero().eval(),
+        [&](const tbb::blocked_range<int>& r, Eigen::Array3d slope) {
+            for (int yz = r.begin(); yz < r.end(); yz++) {
+                const int y = yz % ny, z = yz / ny;
+                for (int x = 0; x < nx; x++) {
+                    const double v = value(x, y, z);
+                    if (x + 1 < nx) {
+                        slope[0] = std::max(
+                            slope[0], std::abs(value(x + 1, y, z) - v));
+                    }
+                    if (y + 1 < ny) {
+                        slope[1] = std::max(
+                            slope[1], std::abs(value(x, y + 1, z) - v));
+                    }
+                    if (z + 1 < nz) {
+                        slope[2] = std::max(
+                            slope[2], std::abs(value(x, y, z + 1) - v));
+                    }
+                }
+            }
+            return slope;
+        },
+        [](const Eigen::Array3d& a, const Eigen::Array3d& b) -> Eigen::Array3d {
+            return a.max(b);
+        });
+
+    // Outside the grid the distance to the box adds an orthogonal unit slope.
+    m_lipschitz_constant =
+        std::sqrt((max_slope / m_spacing).square().sum() + 1);
+}
+
+} // namespace ipc
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Core>
+
+#include <string>
+
+namespace ipc {
+
+/// @brief Signed distance field sampled on a regular grid.
+///
+/// The field is the bilinear (2D) or trilinear (3D) interpolation of the
+/// samples. Outside the grid, the distance to the grid's bounding box is added
+/// to the value at the closest point on the box, so the field stays continuous
+/// and Lipschitz everywhere.
+class GridSDF {
+public:
+    GridSDF() { }
+
+    /// @brief Construct a grid signed distance field.
+    /// @param origin Position of the first sample (i.e., the minimum corner of the grid).
+    /// @param spacing Distance between neighboring samples.
+    /// @param resolution Number of samples along each axis (at least 2).
+    /// @param values Samples ordered with x varying fastest, then y, then z.
+    GridSDF(
+        const VectorMax3d& origin,
+        const double spacing,
+        const ArrayMax3i& resolution,
+        const Eigen::VectorXd& values);
+
+    /// @brief Load a grid signed distance field from a binary file.
+    ///
+    /// The file contains, in native byte order: the dimension (int32), the
+    /// resolution (dim × int32), the origin (dim × float64), the spacing
+    /// (float64), and the samples (float64) ordered as in the constructor.
+    ///
+    /// @param filename Path to the file.
+    /// @return The loaded signed distance field.
+    static GridSDF load(const std::string& filename);
+
+    /// @brief Save the grid signed distance field to a binary file.
+    /// @param filename Path to the file.
+    void save(const std::string& filename) const;
+
+    /// @brief Get the dimension of the field.
+    int dim() const { return m_origin.size(); }
+
+    /// @brief Get the position of the first sample.
+    const VectorMax3d& origin() const { return m_origin; }
+
+    /// @brief Get the distance between neighboring samples.
+    double spacing() const { return m_spacing; }
+
+    /// @brief Get the number of samples along each axis.
+    const ArrayMax3i& resolution() const { return m_resolution; }
+
+    /// @brief Get the samples.
+    const Eigen::VectorXd& values() const { return m_values; }
+
+    /// @brief Get a Lipschitz constant of the field.
+    /// @note The field never changes faster than this along any path.
+    double lipschitz_constant() const { return m_lipschitz_constant; }
+
+    /// @brief Evaluate the signed distance at a point.
+    /// @param p Query point.
+    /// @return The interpolated signed distance.
+    double signed_distance(const VectorMax3d& p) const;
+
+    /// @brief Evaluate the gradient of the signed distance at a point.
+    /// @param p Query point.
+    /// @return The gradient of the interpolated signed distance.
+    VectorMax3d signed_distance_gradient(const VectorMax3d& p) const;
+
+    /// @brief Evaluate the Hessian of the signed distance at a point.
+    /// @param p Query point.
+    /// @return The Hessian of the interpolated signed distance.
+    MatrixMax3d signed_distance_hessian(const VectorMax3d& p) const;
+
+protected:
+    /// @brief Interpolate the samples at a point inside the grid.
+    /// @param p Query point (clamped to the grid).
+    /// @param[out] grad Gradient of the interpolation (if not null).
+    /// @param[out] hess Hessian of the interpolation (if not null).
+    /// @return The interpolated value.
+    double interpolate(
+        const VectorMax3d& p, VectorMax3d* grad, MatrixMax3d* hess) const;
+
+    /// @brief Evaluate the field and its derivatives at any point.
+    double evaluate(
+        const VectorMax3d& p, VectorMax3d* grad, MatrixMax3d* hess) const;
+
+    /// @brief Get the sample at a grid index.
+    double value(const int x, const int y, const int z) const
+    {
+        return m_values[(long(z) * m_resolution[1] + y) * m_resolution[0] + x];
+    }
+
+    /// @brief Compute a Lipschitz constant of the interpolated samples.
+    void init_lipschitz_constant();
+
+    VectorMax3d m_origin;
+    double m_spacing = 1;
+    ArrayMax3i m_resolution;
+    Eigen::VectorXd m_values;
+    VectorMax3d m_max_corner;
+    double m_lipschitz_constant = 0;
+};
+
+} // namespace ipc
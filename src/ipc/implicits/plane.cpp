@@ -2,13 +2,87 @@
 
 #include <ipc/distance/point_plane.hpp>
 #include <ipc/ccd/point_static_plane.hpp>
+#include <ipc/utils/atomic_min.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
-#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_group.h>
+
+#include <atomic>
 
 namespace ipc {
 
+namespace {
+    /// @brief Planes in Hessian normal form (n̂ · x = offset).
+    struct UnitPlanes {
+        UnitPlanes(
+            const Eigen::MatrixXd& plane_origins,
+            const Eigen::MatrixXd& plane_normals)
+        {
+            assert(plane_normals.rows() == plane_origins.rows());
+            normals = plane_normals.rowwise().normalized();
+            offsets = normals.cwiseProduct(plane_origins).rowwise().sum();
+        }
+
+        /// @brief Signed distances of a block of points to every plane.
+        /// @note The column-major points are already in SoA layout, so this is
+        /// a single vectorized matrix product over the block.
+        /// @param points Points as rows of a matrix.
+        /// @param start First point of the block.
+        /// @param n Number of points in the block.
+        /// @param[out] distances Signed distances (n × #planes).
+        void signed_distances(
+            const Eigen::MatrixXd& points,
+            const size_t start,
+            const size_t n,
+            Eigen::MatrixXd& distances) const
+        {
+            distances.noalias() =
+                points.middleRows(start, n) * normals.transpose();
+            distances.rowwise() -= offsets.transpose();
+        }
+
+        size_t size() const { return normals.rows(); }
+
+        Eigen::MatrixXd normals;
+        Eigen::VectorXd offsets;
+    };
+
+    /// @brief Determine if can_collide is the default (all pairs collide).
+    bool is_default_can_collide(
+        const std::function<bool(size_t, size_t)>& can_collide)
+    {
+        const auto* f = can_collide.target<bool (*)(size_t, size_t)>();
+        return f != nullptr && *f == default_can_point_plane_collide;
+    }
+
+    /// @brief Conservatively determine if a point can impact a plane.
+    ///
+    /// The CCD only reports an impact once the point moves within
+    /// (1 - r)|s0| of the plane, so a point that does not get closer than
+    /// (1 - r/2)|s0| is culled (the r/2 margin absorbs rounding errors).
+    ///
+    /// @param s0 Signed distance at the start of the step.
+    /// @param s1 Signed distance at the end of the step.
+    /// @return False if the point cannot impact the plane.
+    bool can_impact(const double s0, const double s1)
+    {
+        constexpr double r = DEFAULT_CCD_CONSERVATIVE_RESCALING;
+        return s0 * s1 <= 0 || std::abs(s1) <= (1 - r / 2) * std::abs(s0);
+    }
+
+    /// @brief Determine if the impact of a point must be earlier than tmax.
+    ///
+    /// The CCD returns a time of impact of r|s0| / |s0 - s1|, so the pair is
+    /// skipped if this is more than twice tmax.
+    bool can_impact_before(const double s0, const double s1, const double tmax)
+    {
+        constexpr double r = DEFAULT_CCD_CONSERVATIVE_RESCALING;
+        return r * std::abs(s0) <= 2 * tmax * std::abs(s0 - s1);
+    }
+} // namespace
+
 void construct_point_plane_constraint_set(
     const Eigen::MatrixXd& points,
     const Eigen::MatrixXd& plane_origins,
@@ -20,32 +94,53 @@ void construct_point_plane_constraint_set(
 {
     pv_constraints.clear();
 
-    double dhat_squared = dhat * dhat;
-    double dmin_squared = dmin * dmin;
-
     // Cull the candidates by measuring the distance and dropping those that are
     // greater than dhat.
+    const double offset_sqr = (dmin + dhat) * (dmin + dhat);
 
-    size_t n_planes = plane_origins.rows();
-    assert(plane_normals.rows() == n_planes);
+    const UnitPlanes planes(plane_origins, plane_normals);
+    const bool check_can_collide = !is_default_can_collide(can_collide);
 
-    for (size_t vi = 0; vi < points.rows(); vi++) {
-        for (size_t pi = 0; pi < n_planes; pi++) {
-            if (!can_collide(vi, pi)) {
-                continue;
-            }
-
-            const auto& plane_origin = plane_origins.row(pi);
-            const auto& plane_normal = plane_normals.row(pi);
+    // The constraints of each fixed block of points are concatenated in block
+    // order, so the result matches the serial (vertex-major) order.
+    const size_t n_points = points.rows();
+    std::vector<std::vector<PlaneVertexConstraint>> block_constraints(
+        num_deterministic_blocks(n_points));
 
-            double distance_sqr = point_plane_distance(
-                points.row(vi), plane_origin, plane_normal);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), block_constraints.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            Eigen::MatrixXd distances;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t n =
+                    std::min(DETERMINISTIC_BLOCK_SIZE, n_points - start);
+                planes.signed_distances(points, start, n, distances);
 
-            if (distance_sqr - dmin_squared < 2 * dmin * dhat + dhat_squared) {
-                pv_constraints.emplace_back(plane_origin, plane_normal, vi);
-                pv_constraints.back().minimum_distance = dmin;
+                for (size_t i = 0; i < n; i++) {
+                    const size_t vi = start + i;
+                    for (size_t pi = 0; pi < planes.size(); pi++) {
+                        const double distance = distances(i, pi);
+                        if (distance * distance >= offset_sqr
+                            || (check_can_collide && !can_collide(vi, pi))) {
+                            continue;
+                        }
+                        block_constraints[b].emplace_back(
+                            plane_origins.row(pi), plane_normals.row(pi), vi);
+                        block_constraints[b].back().minimum_distance = dmin;
+                    }
+                }
             }
-        }
+        });
+
+    size_t n_constraints = 0;
+    for (const auto& constraints : block_constraints) {
+        n_constraints += constraints.size();
+    }
+    pv_constraints.reserve(n_constraints);
+    for (const auto& constraints : block_constraints) {
+        pv_constraints.insert(
+            pv_constraints.end(), constraints.begin(), constraints.end());
     }
 }
 
@@ -58,31 +153,57 @@ bool is_step_point_plane_collision_free(
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide)
 {
-    size_t n_planes = plane_origins.rows();
-    assert(plane_normals.rows() == n_planes);
     assert(points_t0.rows() == points_t1.rows());
 
-    for (size_t vi = 0; vi < points_t0.rows(); vi++) {
-        for (size_t pi = 0; pi < n_planes; pi++) {
-            if (!can_collide(vi, pi)) {
-                continue;
-            }
+    const UnitPlanes planes(plane_origins, plane_normals);
+    const bool check_can_collide = !is_default_can_collide(can_collide);
 
-            const auto& plane_origin = plane_origins.row(pi);
-            const auto& plane_normal = plane_normals.row(pi);
+    const size_t n_points = points_t0.rows();
+    std::atomic<bool> is_collision(false);
 
-            double toi;
-            bool is_collision = point_static_plane_ccd(
-                points_t0.row(vi), points_t1.row(vi), plane_origin,
-                plane_normal, toi);
+    // Cancelling the context stops the loop at the first collision.
+    tbb::task_group_context context;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(n_points)),
+        [&](const tbb::blocked_range<size_t>& r) {
+            Eigen::MatrixXd distances_t0, distances_t1;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                if (is_collision.load(std::memory_order_relaxed)) {
+                    return;
+                }
 
-            if (is_collision) {
-                return false;
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t n =
+                    std::min(DETERMINISTIC_BLOCK_SIZE, n_points - start);
+                planes.signed_distances(points_t0, start, n, distances_t0);
+                planes.signed_distances(points_t1, start, n, distances_t1);
+
+                for (size_t i = 0; i < n; i++) {
+                    const size_t vi = start + i;
+                    for (size_t pi = 0; pi < planes.size(); pi++) {
+                        if (!can_impact(distances_t0(i, pi), distances_t1(i, pi))
+                            || (check_can_collide && !can_collide(vi, pi))) {
+                            continue;
+                        }
+
+                        double toi;
+                        if (point_static_plane_ccd(
+                                points_t0.row(vi), points_t1.row(vi),
+                                plane_origins.row(pi), plane_normals.row(pi),
+                                toi)) {
+                            is_collision = true;
+                            context.cancel_group_execution();
+                            return;
+                        }
+                    }
+                }
             }
-        }
-    }
+        },
+        context);
 
-    return true;
+    return !is_collision;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -94,44 +215,59 @@ double compute_point_plane_collision_free_stepsize(
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide)
 {
-    size_t n_planes = plane_origins.rows();
-    assert(plane_normals.rows() == n_planes);
     assert(points_t0.rows() == points_t1.rows());
 
-    tbb::enumerable_thread_specific<double> storage(1);
+    const UnitPlanes planes(plane_origins, plane_normals);
+    const bool check_can_collide = !is_default_can_collide(can_collide);
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, points_t0.rows()),
-        [&](tbb::blocked_range<size_t> r) {
-            double& earliest_toi = storage.local();
-
-            for (size_t vi = r.begin(); vi < r.end(); vi++) {
-                for (size_t pi = 0; pi < n_planes; pi++) {
-                    if (!can_collide(vi, pi)) {
-                        continue;
-                    }
+    const size_t n_points = points_t0.rows();
+    std::atomic<double> earliest_toi(1);
 
-                    const auto& plane_origin = plane_origins.row(pi);
-                    const auto& plane_normal = plane_normals.row(pi);
+    // Cancelling the context stops the loop once no step can be taken.
+    tbb::task_group_context context;
 
-                    double toi;
-                    bool are_colliding = point_static_plane_ccd(
-                        points_t0.row(vi), points_t1.row(vi), plane_origin,
-                        plane_normal, toi);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(n_points)),
+        [&](const tbb::blocked_range<size_t>& r) {
+            Eigen::MatrixXd distances_t0, distances_t1;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t n =
+                    std::min(DETERMINISTIC_BLOCK_SIZE, n_points - start);
+                planes.signed_distances(points_t0, start, n, distances_t0);
+                planes.signed_distances(points_t1, start, n, distances_t1);
+
+                for (size_t i = 0; i < n; i++) {
+                    const size_t vi = start + i;
+                    for (size_t pi = 0; pi < planes.size(); pi++) {
+                        const double s0 = distances_t0(i, pi);
+                        const double s1 = distances_t1(i, pi);
+                        if (!can_impact(s0, s1)
+                            || !can_impact_before(
+                                s0, s1,
+                                earliest_toi.load(std::memory_order_relaxed))
+                            || (check_can_collide && !can_collide(vi, pi))) {
+                            continue;
+                        }
 
-                    if (are_colliding) {
-                        if (toi < earliest_toi) {
-                            earliest_toi = toi;
+                        double toi;
+                        if (point_static_plane_ccd(
+                                points_t0.row(vi), points_t1.row(vi),
+                                plane_origins.row(pi), plane_normals.row(pi),
+                                toi)) {
+                            atomic_min(earliest_toi, toi);
+                            if (toi <= 0) {
+                                context.cancel_group_execution();
+                                return;
+                            }
                         }
                     }
                 }
             }
-        });
+        },
+        context);
 
-    double earliest_toi = 1;
-    for (const auto& local_earliest_toi : storage) {
-        earliest_toi = std::min(earliest_toi, local_earliest_toi);
-    }
     assert(earliest_toi >= 0 && earliest_toi <= 1.0);
     return earliest_toi;
 }
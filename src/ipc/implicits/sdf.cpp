@@ -0,0 +1,203 @@
+#include "sdf.hpp"
+
+#include <ipc/ccd/point_sdf.hpp>
+#include <ipc/utils/atomic_min.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/task_group.h>
+
+#include <atomic>
+#include <limits>
+
+namespace ipc {
+
+namespace {
+    /// @brief Determine if can_collide is the default (all points collide).
+    bool is_default_can_collide(const std::function<bool(size_t)>& can_collide)
+    {
+        const auto* f = can_collide.target<bool (*)(size_t)>();
+        return f != nullptr && *f == default_can_point_sdf_collide;
+    }
+
+    /// @brief Lower bound on the time of impact reported by point_sdf_ccd.
+    ///
+    /// The first advancement step of the CCD is always taken, so a point with
+    /// a bound of at least one (or at least the current earliest impact) can
+    /// be skipped without running the CCD.
+    double min_time_of_impact(
+        const GridSDF& sdf,
+        const VectorMax3d& p_t0,
+        const VectorMax3d& p_t1)
+    {
+        constexpr double r = DEFAULT_CCD_CONSERVATIVE_RESCALING;
+        const double s0 = sdf.signed_distance(p_t0);
+        const double max_speed = sdf.lipschitz_constant() * (p_t1 - p_t0).norm();
+        if (s0 <= 0) {
+            return 0;
+        }
+        if (max_speed == 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        const double dt = r * s0 / max_speed;
+        // A first step below the tolerance is reported as an impact at t=0.
+        return dt <= DEFAULT_CCD_TOLERANCE ? 0 : dt;
+    }
+} // namespace
+
+void construct_point_sdf_constraint_set(
+    const Eigen::MatrixXd& points,
+    const std::shared_ptr<const GridSDF>& sdf,
+    const double dhat,
+    std::vector<SDFVertexConstraint>& sdf_constraints,
+    const double dmin,
+    const std::function<bool(size_t)>& can_collide)
+{
+    assert(sdf != nullptr && points.cols() == sdf->dim());
+
+    sdf_constraints.clear();
+
+    const double offset = dmin + dhat;
+    const bool check_can_collide = !is_default_can_collide(can_collide);
+
+    // The constraints of each fixed block of points are concatenated in block
+    // order, so the result matches the serial (vertex-major) order.
+    const size_t n_points = points.rows();
+    std::vector<std::vector<SDFVertexConstraint>> block_constraints(
+        num_deterministic_blocks(n_points));
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), block_constraints.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end =
+                    std::min(start + DETERMINISTIC_BLOCK_SIZE, n_points);
+                for (size_t vi = start; vi < end; vi++) {
+                    if ((check_can_collide && !can_collide(vi))
+                        || std::abs(sdf->signed_distance(points.row(vi)))
+                            >= offset) {
+                        continue;
+                    }
+                    block_constraints[b].emplace_back(sdf, vi);
+                    block_constraints[b].back().minimum_distance = dmin;
+                }
+            }
+        });
+
+    size_t n_constraints = 0;
+    for (const auto& constraints : block_constraints) {
+        n_constraints += constraints.size();
+    }
+    sdf_constraints.reserve(n_constraints);
+    for (const auto& constraints : block_constraints) {
+        sdf_constraints.insert(
+            sdf_constraints.end(), constraints.begin(), constraints.end());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool is_step_point_sdf_collision_free(
+    const Eigen::MatrixXd& points_t0,
+    const Eigen::MatrixXd& points_t1,
+    const GridSDF& sdf,
+    const std::function<bool(size_t)>& can_collide)
+{
+    assert(points_t0.rows() == points_t1.rows());
+    assert(points_t0.cols() == sdf.dim() && points_t1.cols() == sdf.dim());
+
+    const bool check_can_collide = !is_default_can_collide(can_collide);
+
+    const size_t n_points = points_t0.rows();
+    std::atomic<bool> is_collision(false);
+
+    // Cancelling the context stops the loop at the first collision.
+    tbb::task_group_context context;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(n_points)),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end =
+                    std::min(start + DETERMINISTIC_BLOCK_SIZE, n_points);
+                for (size_t vi = start; vi < end; vi++) {
+                    if (is_collision.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    if (check_can_collide && !can_collide(vi)) {
+                        continue;
+                    }
+
+                    double toi;
+                    if (point_sdf_ccd(
+                            points_t0.row(vi), points_t1.row(vi), sdf, toi)) {
+                        is_collision = true;
+                        context.cancel_group_execution();
+                        return;
+                    }
+                }
+            }
+        },
+        context);
+
+    return !is_collision;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+double compute_point_sdf_collision_free_stepsize(
+    const Eigen::MatrixXd& points_t0,
+    const Eigen::MatrixXd& points_t1,
+    const GridSDF& sdf,
+    const std::function<bool(size_t)>& can_collide)
+{
+    assert(points_t0.rows() == points_t1.rows());
+    assert(points_t0.cols() == sdf.dim() && points_t1.cols() == sdf.dim());
+
+    const bool check_can_collide = !is_default_can_collide(can_collide);
+
+    const size_t n_points = points_t0.rows();
+    std::atomic<double> earliest_toi(1);
+
+    // Cancelling the context stops the loop once no step can be taken.
+    tbb::task_group_context context;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            size_t(0), num_deterministic_blocks(n_points)),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end =
+                    std::min(start + DETERMINISTIC_BLOCK_SIZE, n_points);
+                for (size_t vi = start; vi < end; vi++) {
+                    if ((check_can_collide && !can_collide(vi))
+                        || min_time_of_impact(
+                               sdf, points_t0.row(vi), points_t1.row(vi))
+                            >= earliest_toi.load(std::memory_order_relaxed)) {
+                        continue;
+                    }
+
+                    double toi;
+                    if (point_sdf_ccd(
+                            points_t0.row(vi), points_t1.row(vi), sdf, toi)) {
+                        atomic_min(earliest_toi, toi);
+                        if (toi <= 0) {
+                            context.cancel_group_execution();
+                            return;
+                        }
+                    }
+                }
+            }
+        },
+        context);
+
+    assert(earliest_toi >= 0 && earliest_toi <= 1.0);
+    return earliest_toi;
+}
+
+} // namespace ipc
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ipc/collisions/sdf_vertex.hpp>
+#include <ipc/implicits/grid_sdf.hpp>
+
+#include <Eigen/Core>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+inline bool default_can_point_sdf_collide(size_t) { return true; }
+
+/// @brief Construct a set of point-SDF distance constraints used to compute
+/// the barrier potential.
+///
+/// @note The given sdf_constraints will be cleared.
+///
+/// @param[in]  points Points as rows of a matrix.
+/// @param[in]  sdf  Signed distance field of the static obstacle.
+/// @param[in]  dhat  The activation distance of the barrier.
+/// @param[out] sdf_constraints  The constructed set of constraints.
+/// @param[in]  dmin  Minimum distance.
+/// @param[in] can_collide A function that takes a vertex ID (row number in points) then returns true if the vertex can collide with the obstacle. By default all points can collide with the obstacle.
+void construct_point_sdf_constraint_set(
+    const Eigen::MatrixXd& points,
+    const std::shared_ptr<const GridSDF>& sdf,
+    const double dhat,
+    std::vector<SDFVertexConstraint>& sdf_constraints,
+    const double dmin = 0,
+    const std::function<bool(size_t)>& can_collide =
+        default_can_point_sdf_collide);
+
+///////////////////////////////////////////////////////////////////////////////
+// Collision detection
+
+/// @brief Determine if the step is collision free.
+///
+/// @note Assumes the trajectory is linear.
+///
+/// @param[in] points_t0 Points at start as rows of a matrix.
+/// @param[in] points_t1 Points at end as rows of a matrix.
+/// @param[in] sdf Signed distance field of the static obstacle.
+/// @param[in] can_collide A function that takes a vertex ID (row number in points) then returns true if the vertex can collide with the obstacle. By default all points can collide with the obstacle.
+/// @returns True if <b>no</b> collisions occur.
+bool is_step_point_sdf_collision_free(
+    const Eigen::MatrixXd& points_t0,
+    const Eigen::MatrixXd& points_t1,
+    const GridSDF& sdf,
+    const std::function<bool(size_t)>& can_collide =
+        default_can_point_sdf_collide);
+
+/// @brief Computes a maximal step size that is collision free.
+///
+/// @note Assumes points_t0 is intersection free.
+/// @note Assumes the trajectory is linear.
+/// @note A value of 1.0 if a full step and 0.0 is no step.
+///
+/// @param points_t0 Points at start as rows of a matrix.
+/// @param points_t1 Points at end as rows of a matrix.
+/// @param sdf Signed distance field of the static obstacle.
+/// @param can_collide A function that takes a vertex ID (row number in points) then returns true if the vertex can collide with the obstacle. By default all points can collide with the obstacle.
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free.
+double compute_point_sdf_collision_free_stepsize(
+    const Eigen::MatrixXd& points_t0,
+    const Eigen::MatrixXd& points_t1,
+    const GridSDF& sdf,
+    const std::function<bool(size_t)>& can_collide =
+        default_can_point_sdf_collide);
+
+} // namespace ipc
@@ -1,6 +1,10 @@
 #include "ipc.hpp"
 
+#include <ipc/broad_phase/bvh.hpp>
+#include <ipc/utils/async.hpp>
+#include <ipc/utils/atomic_min.hpp>
 #include <ipc/utils/intersection.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/world_bbox_diagonal_length.hpp>
 
 #include <ipc/config.hpp>
@@ -11,6 +15,15 @@
 
 #include <igl/predicates/segment_segment_intersect.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <tuple>
+
 namespace ipc {
 
 bool is_step_collision_free(
@@ -46,7 +59,8 @@ double compute_collision_free_stepsize(
     const BroadPhaseMethod broad_phase_method,
     const double min_distance,
     const double tolerance,
-    const long max_iterations)
+    const long max_iterations,
+    const int max_temporal_subdivisions)
 {
     assert(vertices_t0.rows() == mesh.num_vertices());
     assert(vertices_t1.rows() == mesh.num_vertices());
@@ -71,7 +85,7 @@ double compute_collision_free_stepsize(
     Candidates candidates;
     candidates.build(
         mesh, vertices_t0, vertices_t1, /*inflation_radius=*/min_distance / 2,
-        broad_phase_method);
+        broad_phase_method, max_temporal_subdivisions);
 
     // Narrow phase
     return candidates.compute_collision_free_stepsize(
@@ -79,63 +93,288 @@ double compute_collision_free_stepsize(
         max_iterations);
 }
 
+std::future<double> compute_collision_free_stepsize_async(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const BroadPhaseMethod broad_phase_method,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const int max_temporal_subdivisions)
+{
+    return run_async([&mesh, &vertices_t0, &vertices_t1, broad_phase_method,
+                      min_distance, tolerance, max_iterations,
+                      max_temporal_subdivisions]() {
+        return compute_collision_free_stepsize(
+            mesh, vertices_t0, vertices_t1, broad_phase_method, min_distance,
+            tolerance, max_iterations, max_temporal_subdivisions);
+    });
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+    /// @brief Visit the self intersections of the mesh in parallel.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param broad_phase_method The broad phase method to use.
+    /// @param ee_visitor Visitor of the intersecting edge-edge pairs (2D).
+    /// @param ef_visitor Visitor of the intersecting edge-face pairs (3D).
+    /// @return False if a visitor stopped the enumeration early.
+    bool visit_intersections(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const BroadPhaseMethod broad_phase_method,
+        const CandidateVisitor<EdgeEdgeCandidate>& ee_visitor,
+        const CandidateVisitor<EdgeFaceCandidate>& ef_visitor)
+    {
+        assert(vertices.rows() == mesh.num_vertices());
+
+        const double conservative_inflation_radius =
+            1e-6 * world_bbox_diagonal_length(vertices);
+
+        std::unique_ptr<BroadPhase> broad_phase =
+            BroadPhase::make_broad_phase(broad_phase_method, mesh);
+
+        broad_phase->build(
+            vertices, mesh.edges(), mesh.faces(),
+            conservative_inflation_radius);
+
+        // The narrow phase runs as the broad phase finds the candidates, so
+        // the enumeration stops at the first intersection if requested.
+        if (vertices.cols() == 2) {
+            // Need to check segment-segment intersections in 2D
+            igl::predicates::exactinit();
+            return broad_phase->visit_edge_edge_candidates(
+                [&](const EdgeEdgeCandidate& candidate) {
+                    const auto& [ea_id, eb_id] = candidate;
+                    if (igl::predicates::segment_segment_intersect(
+                            vertices.row(mesh.edges()(ea_id, 0)).head<2>(),
+                            vertices.row(mesh.edges()(ea_id, 1)).head<2>(),
+                            vertices.row(mesh.edges()(eb_id, 0)).head<2>(),
+                            vertices.row(mesh.edges()(eb_id, 1)).head<2>())) {
+                        return ee_visitor(candidate);
+                    }
+                    return true;
+                });
+        } else {
+            // Need to check segment-triangle intersections in 3D
+            assert(vertices.cols() == 3);
+            return broad_phase->visit_edge_face_candidates(
+                [&](const EdgeFaceCandidate& candidate) {
+                    const auto& [e_id, f_id] = candidate;
+                    if (is_edge_intersecting_triangle(
+                            vertices.row(mesh.edges()(e_id, 0)),
+                            vertices.row(mesh.edges()(e_id, 1)),
+                            vertices.row(mesh.faces()(f_id, 0)),
+                            vertices.row(mesh.faces()(f_id, 1)),
+                            vertices.row(mesh.faces()(f_id, 2)))) {
+                        return ef_visitor(candidate);
+                    }
+                    return true;
+                });
+        }
+    }
+} // namespace
+
 bool has_intersections(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices,
     const BroadPhaseMethod broad_phase_method)
+{
+    // Stop at the first intersection
+    return !visit_intersections(
+        mesh, vertices, broad_phase_method,
+        [](const EdgeEdgeCandidate&) { return false; },
+        [](const EdgeFaceCandidate&) { return false; });
+}
+
+void find_intersections(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    std::vector<EdgeEdgeCandidate>& ee_intersections,
+    std::vector<EdgeFaceCandidate>& ef_intersections,
+    const BroadPhaseMethod broad_phase_method)
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> ee_storage;
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> ef_storage;
+
+    visit_intersections(
+        mesh, vertices, broad_phase_method,
+        [&](const EdgeEdgeCandidate& candidate) {
+            ee_storage.local().push_back(candidate);
+            return true;
+        },
+        [&](const EdgeFaceCandidate& candidate) {
+            ef_storage.local().push_back(candidate);
+            return true;
+        });
+
+    ee_intersections.clear();
+    ef_intersections.clear();
+    merge_thread_local_vectors(ee_storage, ee_intersections);
+    merge_thread_local_vectors(ef_storage, ef_intersections);
+
+    // Sort the intersections so they do not depend on the scheduling.
+    std::sort(ee_intersections.begin(), ee_intersections.end());
+    std::sort(ef_intersections.begin(), ef_intersections.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+double compute_minimum_distance(
+    const CollisionMesh& mesh, const Eigen::MatrixXd& vertices)
+{
+    ClosestPair closest_pair;
+    return compute_minimum_distance(mesh, vertices, closest_pair);
+}
+
+double compute_minimum_distance(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    ClosestPair& closest_pair)
 {
     assert(vertices.rows() == mesh.num_vertices());
 
-    const double conservative_inflation_radius =
-        1e-6 * world_bbox_diagonal_length(vertices);
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
 
-    std::unique_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
+    std::vector<AABB> vertex_boxes, edge_boxes, face_boxes;
+    build_boxes(vertices, edges, faces, vertex_boxes, edge_boxes, face_boxes);
 
-    broad_phase->build(
-        vertices, mesh.edges(), mesh.faces(), conservative_inflation_radius);
+    // Pairs of elements are only evaluated if their boxes can be closer than
+    // the smallest distance found so far by any thread.
+    std::atomic<double> bound(std::numeric_limits<double>::infinity());
+    const auto get_bound = [&]() {
+        return bound.load(std::memory_order_relaxed);
+    };
 
-    if (vertices.cols() == 2) {
-        // Need to check segment-segment intersections in 2D
-        std::vector<EdgeEdgeCandidate> ee_candidates;
-
-        broad_phase->detect_edge_edge_candidates(ee_candidates);
-        broad_phase->clear();
-
-        // narrow-phase using igl
-        igl::predicates::exactinit();
-        for (const auto& [ea_id, eb_id] : ee_candidates) {
-            if (igl::predicates::segment_segment_intersect(
-                    vertices.row(mesh.edges()(ea_id, 0)).head<2>(),
-                    vertices.row(mesh.edges()(ea_id, 1)).head<2>(),
-                    vertices.row(mesh.edges()(eb_id, 0)).head<2>(),
-                    vertices.row(mesh.edges()(eb_id, 1)).head<2>())) {
-                return true;
+    struct LocalClosestPair {
+        double distance = std::numeric_limits<double>::infinity();
+        ClosestPair pair;
+    };
+    tbb::enumerable_thread_specific<LocalClosestPair> storage;
+
+    // Ties are broken by the pair so the result does not depend on the
+    // scheduling.
+    const auto update = [&](const double distance, const ClosestPair& pair) {
+        LocalClosestPair& local = storage.local();
+        if (std::tie(distance, pair) < std::tie(local.distance, local.pair)) {
+            local.distance = distance;
+            local.pair = pair;
+            atomic_min(bound, distance);
+        }
+    };
+
+    // Same filtering as the broad phase: skip adjacent elements, pairs of
+    // static vertices, and pairs excluded by the mesh's can_collide.
+    const auto can_collide = [&](const std::array<long, 4>& a_ids, int na,
+                                 const std::array<long, 4>& b_ids, int nb) {
+        bool any_can_collide = false, all_static = true;
+        for (int i = 0; i < na; i++) {
+            all_static &= mesh.is_vertex_static(a_ids[i]);
+            for (int j = 0; j < nb; j++) {
+                if (a_ids[i] == b_ids[j]) {
+                    return false;
+                }
+                any_can_collide |= mesh.can_collide(a_ids[i], b_ids[j]);
             }
         }
+        for (int j = 0; j < nb; j++) {
+            all_static &= mesh.is_vertex_static(b_ids[j]);
+        }
+        return any_can_collide && !all_static;
+    };
+
+    const auto edge_ids = [&](long ei) {
+        return std::array<long, 4> { { edges(ei, 0), edges(ei, 1), -1, -1 } };
+    };
+    const auto face_ids = [&](long fi) {
+        return std::array<long, 4> {
+            { faces(fi, 0), faces(fi, 1), faces(fi, 2), -1 }
+        };
+    };
+
+    BVH bvh;
+    if (vertices.cols() == 2) {
+        // Edge-vertex pairs
+        bvh.build(edge_boxes);
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, vertices.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long vi = r.begin(); vi < r.end(); vi++) {
+                    const std::array<long, 4> v_ids { { vi, -1, -1, -1 } };
+                    bvh.branch_and_bound(
+                        vertex_boxes[vi], get_bound, [&](int ei) {
+                            if (!can_collide(v_ids, 1, edge_ids(ei), 2)) {
+                                return;
+                            }
+                            const EdgeVertexCandidate candidate(ei, vi);
+                            update(
+                                candidate.compute_distance(
+                                    vertices, edges, faces),
+                                candidate);
+                        });
+                }
+            });
     } else {
-        // Need to check segment-triangle intersections in 3D
         assert(vertices.cols() == 3);
 
-        std::vector<EdgeFaceCandidate> ef_candidates;
-        broad_phase->detect_edge_face_candidates(ef_candidates);
-        broad_phase->clear();
-
-        for (const auto& [e_id, f_id] : ef_candidates) {
-            if (is_edge_intersecting_triangle(
-                    vertices.row(mesh.edges()(e_id, 0)),
-                    vertices.row(mesh.edges()(e_id, 1)),
-                    vertices.row(mesh.faces()(f_id, 0)),
-                    vertices.row(mesh.faces()(f_id, 1)),
-                    vertices.row(mesh.faces()(f_id, 2)))) {
-                return true;
-            }
-        }
+        // Edge-edge pairs
+        bvh.build(edge_boxes);
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, edges.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long eai = r.begin(); eai < r.end(); eai++) {
+                    bvh.branch_and_bound(
+                        edge_boxes[eai], get_bound, [&](int ebi) {
+                            // Visit each unordered pair once
+                            if (ebi <= eai
+                                || !can_collide(
+                                    edge_ids(eai), 2, edge_ids(ebi), 2)) {
+                                return;
+                            }
+                            const EdgeEdgeCandidate candidate(eai, ebi);
+                            update(
+                                candidate.compute_distance(
+                                    vertices, edges, faces),
+                                candidate);
+                        });
+                }
+            });
+
+        // Face-vertex pairs
+        bvh.build(face_boxes);
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, vertices.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long vi = r.begin(); vi < r.end(); vi++) {
+                    const std::array<long, 4> v_ids { { vi, -1, -1, -1 } };
+                    bvh.branch_and_bound(
+                        vertex_boxes[vi], get_bound, [&](int fi) {
+                            if (!can_collide(v_ids, 1, face_ids(fi), 3)) {
+                                return;
+                            }
+                            const FaceVertexCandidate candidate(fi, vi);
+                            update(
+                                candidate.compute_distance(
+                                    vertices, edges, faces),
+                                candidate);
+                        });
+                }
+            });
     }
 
-    return false;
+    LocalClosestPair closest;
+    for (const LocalClosestPair& local : storage) {
+        if (std::tie(local.distance, local.pair)
+            < std::tie(closest.distance, closest.pair)) {
+            closest = local;
+        }
+    }
+    closest_pair = closest.pair;
+    return closest.distance;
 }
+
 } // namespace ipc
@@ -2,14 +2,21 @@
 
 // NOTE: Include this so the user can just include ipc.hpp
 #include <ipc/collisions/collision_constraints.hpp>
+#include <ipc/collisions/batched_collision_constraints.hpp>
+#include <ipc/collisions/compact_collision_constraints.hpp>
 #include <ipc/friction/friction_constraints.hpp>
 
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/candidates/cached_candidates.hpp>
+#include <ipc/candidates/compact_candidates.hpp>
 #include <ipc/collision_mesh.hpp>
 
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <future>
+#include <variant>
+
 /// Incremental Potential Contact functions
 namespace ipc {
 
@@ -44,6 +51,7 @@ bool is_step_collision_free(
 /// @param min_distance The minimum distance allowable between any two elements.
 /// @param tolerance The tolerance for the CCD algorithm.
 /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @param max_temporal_subdivisions Maximum number of sub-intervals of time used to cull the broad-phase candidates of fast-moving elements (1 disables it).
 /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
 double compute_collision_free_stepsize(
     const CollisionMesh& mesh,
@@ -52,7 +60,30 @@ double compute_collision_free_stepsize(
     const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
     const double min_distance = 0.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
-    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+    const int max_temporal_subdivisions = 1);
+
+/// @brief Asynchronously computes a maximal step size that is collision free.
+/// @note Assumes the trajectory is linear.
+/// @note The mesh and vertices must not be modified or destroyed until the future is ready.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param broad_phase_method The broad phase method to use.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @param max_temporal_subdivisions Maximum number of sub-intervals of time used to cull the broad-phase candidates of fast-moving elements (1 disables it).
+/// @returns A future to a step-size \f$\in [0, 1]\f$ that is collision free.
+std::future<double> compute_collision_free_stepsize_async(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
+    const double min_distance = 0.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+    const int max_temporal_subdivisions = 1);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Utilities
@@ -67,4 +98,45 @@ bool has_intersections(
     const Eigen::MatrixXd& vertices,
     const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
+/// @brief Find all self intersections of the mesh.
+/// @param[in] mesh The collision mesh.
+/// @param[in] vertices Vertices of the collision mesh.
+/// @param[out] ee_intersections Sorted intersecting edge-edge pairs (2D only).
+/// @param[out] ef_intersections Sorted intersecting edge-face pairs (3D only).
+/// @param[in] broad_phase_method The broad phase method to use.
+void find_intersections(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    std::vector<EdgeEdgeCandidate>& ee_intersections,
+    std::vector<EdgeFaceCandidate>& ef_intersections,
+    const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
+/// @brief Pair of elements attaining the minimum distance.
+/// @note Holds std::monostate if no pair of elements can collide.
+using ClosestPair = std::variant<
+    std::monostate,
+    EdgeVertexCandidate,
+    EdgeEdgeCandidate,
+    FaceVertexCandidate>;
+
+/// @brief Compute the global minimum distance between the elements of the mesh.
+/// @note The distance is actually squared distance.
+/// @note Unlike CollisionConstraints::compute_minimum_distance this does not require a set of active constraints.
+/// @param mesh The collision mesh.
+/// @param vertices Vertices of the collision mesh.
+/// @return The minimum distance between any pair of elements that can collide (infinity if there is none).
+double compute_minimum_distance(
+    const CollisionMesh& mesh, const Eigen::MatrixXd& vertices);
+
+/// @brief Compute the global minimum distance between the elements of the mesh.
+/// @note The distance is actually squared distance.
+/// @param[in] mesh The collision mesh.
+/// @param[in] vertices Vertices of the collision mesh.
+/// @param[out] closest_pair The pair of elements attaining the minimum distance (edge-vertex in 2D, edge-edge or face-vertex in 3D).
+/// @return The minimum distance between any pair of elements that can collide (infinity if there is none).
+double compute_minimum_distance(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    ClosestPair& closest_pair);
+
 } // namespace ipc
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <tbb/task_arena.h>
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ipc {
+
+/// @brief Get the task arena used to run asynchronous work.
+/// @note The arena has the default concurrency and lives for the whole program.
+/// @return A reference to the task arena.
+inline tbb::task_arena& async_arena()
+{
+    static tbb::task_arena arena;
+    return arena;
+}
+
+/// @brief Run a function asynchronously and get a future to its result.
+///
+/// The function is enqueued in async_arena(), so its (nested) parallel loops
+/// run on TBB worker threads while the caller continues with its own work.
+/// Any exception thrown by the function is rethrown by future::get().
+///
+/// @note Everything the function references must outlive the future.
+/// @param f Function to run.
+/// @return A future to the return value of f.
+template <typename Function>
+std::future<std::invoke_result_t<std::decay_t<Function>>>
+run_async(Function&& f)
+{
+    using Result = std::invoke_result_t<std::decay_t<Function>>;
+
+    auto promise = std::make_shared<std::promise<Result>>();
+    std::future<Result> future = promise->get_future();
+
+    async_arena().enqueue(
+        [promise, f = std::forward<Function>(f)]() {
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    f();
+                    promise->set_value();
+                } else {
+                    promise->set_value(f());
+                }
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+
+    return future;
+}
+
+} // namespace ipc
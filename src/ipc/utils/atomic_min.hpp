@@ -0,0 +1,18 @@
+#pragma once
+
+#include <atomic>
+
+namespace ipc {
+
+/// @brief Atomically replace a value with the minimum of it and x.
+/// @param value The shared value.
+/// @param x The candidate minimum.
+inline void atomic_min(std::atomic<double>& value, const double x)
+{
+    double current = value.load(std::memory_order_relaxed);
+    while (x < current
+           && !value.compare_exchange_weak(
+               current, x, std::memory_order_relaxed)) { }
+}
+
+} // namespace ipc
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+// NOTE: The reductions in this file only depend on a fixed partition of the
+// elements into blocks of DETERMINISTIC_BLOCK_SIZE. The partition does not
+// depend on the number of threads or the scheduling, so the results are
+// bitwise reproducible between runs and thread counts.
+
+namespace ipc {
+
+/// @brief Number of elements in each block of the fixed partition.
+static constexpr size_t DETERMINISTIC_BLOCK_SIZE = 256;
+
+/// @brief Compute the number of fixed blocks needed to cover n elements.
+/// @param n Number of elements.
+/// @return Number of blocks of size DETERMINISTIC_BLOCK_SIZE.
+inline size_t num_deterministic_blocks(const size_t n)
+{
+    return (n + DETERMINISTIC_BLOCK_SIZE - 1) / DETERMINISTIC_BLOCK_SIZE;
+}
+
+/// @brief Sum an array of values using pairwise (cascade) summation.
+/// @param values Pointer to the values.
+/// @param n Number of values.
+/// @return The sum of the values.
+inline double pairwise_sum(const double* values, const size_t n)
+{
+    constexpr size_t BASE_CASE_SIZE = 8;
+    if (n <= BASE_CASE_SIZE) {
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += values[i];
+        }
+        return sum;
+    }
+    const size_t half = n / 2;
+    return pairwise_sum(values, half) + pairwise_sum(values + half, n - half);
+}
+
+/// @brief Deterministically sum f(i) for i ∈ [0, n) in parallel.
+/// @param n Number of elements.
+/// @param f Function returning the value of element i.
+/// @return The pairwise sum of all element values.
+template <typename Function>
+double deterministic_parallel_sum(const size_t n, const Function& f)
+{
+    const size_t n_blocks = num_deterministic_blocks(n);
+    std::vector<double> block_sums(n_blocks, 0);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n_blocks),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::array<double, DETERMINISTIC_BLOCK_SIZE> values;
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end =
+                    std::min(n, start + DETERMINISTIC_BLOCK_SIZE);
+                for (size_t i = start; i < end; i++) {
+                    values[i - start] = f(i);
+                }
+                block_sums[b] = pairwise_sum(values.data(), end - start);
+            }
+        });
+
+    return pairwise_sum(block_sums.data(), n_blocks);
+}
+
+/// @brief Deterministically assemble local gradients into a global gradient.
+///
+/// The local gradients are computed in parallel and then gathered per vertex
+/// in element order, so every entry is summed in the same order regardless of
+/// the scheduling.
+///
+/// @param n Number of elements.
+/// @param num_vertices Number of vertices in the global gradient.
+/// @param dim Dimension of the vertices.
+/// @param f Function f(i, local_grad, ids) computing the local gradient of element i and its vertex ids.
+/// @return The global gradient of size num_vertices * dim.
+template <typename Function>
+Eigen::VectorXd deterministic_gradient_assembly(
+    const size_t n, const size_t num_vertices, const int dim, const Function& f)
+{
+    std::vector<VectorMax12d> local_grads(n);
+    std::vector<std::array<long, 4>> local_ids(n);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                f(i, local_grads[i], local_ids[i]);
+                assert(local_grads[i].size() % dim == 0);
+            }
+        });
+
+    // Build the vertex → (element, local vertex) incidence in element order.
+    std::vector<size_t> offsets(num_vertices + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        const int n_verts = local_grads[i].size() / dim;
+        for (int j = 0; j < n_verts; j++) {
+            offsets[local_ids[i][j] + 1]++;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<size_t> incidences(offsets.back());
+    {
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < n; i++) {
+            const int n_verts = local_grads[i].size() / dim;
+            for (int j = 0; j < n_verts; j++) {
+                incidences[cursor[local_ids[i][j]]++] = 4 * i + j;
+            }
+        }
+    }
+
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(num_vertices * dim);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), num_vertices),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t vi = r.begin(); vi < r.end(); vi++) {
+                for (size_t k = offsets[vi]; k < offsets[vi + 1]; k++) {
+                    const size_t i = incidences[k] / 4, j = incidences[k] % 4;
+                    grad.segment(dim * vi, dim) +=
+                        local_grads[i].segment(dim * j, dim);
+                }
+            }
+        });
+
+    return grad;
+}
+
+/// @brief Deterministically assemble a sparse matrix from blocks of local triplets.
+/// @note This is useful to evaluate a block of elements at once (e.g., with batched kernels).
+/// @param n Number of elements.
+/// @param rows Number of rows in the global matrix.
+/// @param cols Number of columns in the global matrix.
+/// @param f Function f(start, end, triplets) appending the triplets of elements [start, end) in element order.
+/// @return The assembled sparse matrix.
+template <typename Function>
+Eigen::SparseMatrix<double> deterministic_sparse_block_assembly(
+    const size_t n, const size_t rows, const size_t cols, const Function& f)
+{
+    const size_t n_blocks = num_deterministic_blocks(n);
+    std::vector<std::vector<Eigen::Triplet<double>>> block_triplets(n_blocks);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n_blocks),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const size_t start = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end =
+                    std::min(n, start + DETERMINISTIC_BLOCK_SIZE);
+                f(start, end, block_triplets[b]);
+            }
+        });
+
+    // Prefix-scan the block sizes to place each block in the global buffer.
+    std::vector<size_t> offsets(n_blocks + 1, 0);
+    for (size_t b = 0; b < n_blocks; b++) {
+        offsets[b + 1] = offsets[b] + block_triplets[b].size();
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets(offsets.back());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n_blocks),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                std::copy(
+                    block_triplets[b].begin(), block_triplets[b].end(),
+                    triplets.begin() + offsets[b]);
+            }
+        });
+
+    Eigen::SparseMatrix<double> matrix(rows, cols);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return matrix;
+}
+
+/// @brief Deterministically assemble a sparse matrix from local triplets.
+///
+/// Each fixed block of elements appends its triplets to its own buffer. The
+/// buffers are concatenated in block order, so the triplets (and the order in
+/// which duplicates are summed) are always in element order.
+///
+/// @param n Number of elements.
+/// @param rows Number of rows in the global matrix.
+/// @param cols Number of columns in the global matrix.
+/// @param f Function f(i, triplets) appending the triplets of element i.
+/// @return The assembled sparse matrix.
+template <typename Function>
+Eigen::SparseMatrix<double> deterministic_sparse_assembly(
+    const size_t n, const size_t rows, const size_t cols, const Function& f)
+{
+    return deterministic_sparse_block_assembly(
+        n, rows, cols,
+        [&](size_t start, size_t end,
+            std::vector<Eigen::Triplet<double>>& triplets) {
+            for (size_t i = start; i < end; i++) {
+                f(i, triplets);
+            }
+        });
+}
+
+} // namespace ipc
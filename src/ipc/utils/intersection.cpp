@@ -10,8 +10,92 @@
 
 #include <Eigen/Geometry>
 
+#include <array>
+#include <limits>
+
 namespace ipc {
 
+namespace {
+    /// @brief Compute det([a, b, c]) and a bound on its rounding error.
+    ///
+    /// Each column must be the (rounded) difference of two input points. The
+    /// error bound follows Shewchuk's orient3d bound (with extra slack).
+    ///
+    /// @param[in] a First column.
+    /// @param[in] b Second column.
+    /// @param[in] c Third column.
+    /// @param[out] error_bound Bound on the absolute error of the result.
+    /// @return The determinant computed in floating point.
+    double determinant_with_error_bound(
+        const Eigen::Vector3d& a,
+        const Eigen::Vector3d& b,
+        const Eigen::Vector3d& c,
+        double& error_bound)
+    {
+        constexpr double eps = std::numeric_limits<double>::epsilon();
+        const Eigen::Vector3d abs_b = b.cwiseAbs(), abs_c = c.cwiseAbs();
+        const double permanent = a.cwiseAbs().dot(Eigen::Vector3d(
+            abs_b[1] * abs_c[2] + abs_b[2] * abs_c[1],
+            abs_b[2] * abs_c[0] + abs_b[0] * abs_c[2],
+            abs_b[0] * abs_c[1] + abs_b[1] * abs_c[0]));
+        error_bound = (8 + 64 * eps) * eps * permanent;
+        return a.dot(b.cross(c));
+    }
+
+    /// @brief Floating-point filter for the edge-triangle intersection test.
+    ///
+    /// The intersection point e0 + t (e1 - e0) = t0 + u (t1 - t0) + v (t2 - t0)
+    /// is computed with Cramer's rule. Every coordinate's sign test is only
+    /// trusted if the determinants are larger than their rounding error.
+    ///
+    /// @param[out] is_intersecting The result of the test if it was decided.
+    /// @return True if the floating-point test decided the result.
+    bool filtered_edge_triangle_intersection(
+        const Eigen::Vector3d& e0,
+        const Eigen::Vector3d& e1,
+        const Eigen::Vector3d& t0,
+        const Eigen::Vector3d& t1,
+        const Eigen::Vector3d& t2,
+        bool& is_intersecting)
+    {
+        const Eigen::Vector3d t10 = t1 - t0, t20 = t2 - t0, e01 = e0 - e1,
+                              e0t0 = e0 - t0;
+
+        double d_err;
+        const double d = determinant_with_error_bound(t10, t20, e01, d_err);
+        if (std::abs(d) <= d_err) {
+            return false; // Nearly parallel
+        }
+
+        // Each numerator must have the same sign as its denominator.
+        std::array<double, 5> numerators, errors;
+        // t ⋅ d and (1 - t) ⋅ d
+        numerators[0] =
+            determinant_with_error_bound(t10, t20, e0t0, errors[0]);
+        numerators[1] =
+            determinant_with_error_bound(t10, t20, t0 - e1, errors[1]);
+        // u ⋅ d and v ⋅ d
+        numerators[2] = determinant_with_error_bound(e0t0, t20, e01, errors[2]);
+        numerators[3] = determinant_with_error_bound(t10, e0t0, e01, errors[3]);
+        // (1 - u - v) ⋅ d (using t1 as the origin, which negates d)
+        numerators[4] =
+            -determinant_with_error_bound(e0 - t1, t2 - t1, e01, errors[4]);
+
+        bool is_decided = true;
+        for (int i = 0; i < numerators.size(); i++) {
+            if (std::abs(numerators[i]) <= errors[i]) {
+                is_decided = false; // Near an edge, vertex, or endpoint
+            } else if ((numerators[i] > 0) != (d > 0)) {
+                is_intersecting = false;
+                return true; // Certainly outside
+            }
+        }
+
+        is_intersecting = true;
+        return is_decided;
+    }
+} // namespace
+
 #ifdef IPC_TOOLKIT_WITH_RATIONAL_INTERSECTION
 bool is_edge_intersecting_triangle_rational(
     const Eigen::Vector3d& e0_float,
@@ -111,7 +195,14 @@ bool is_edge_intersecting_triangle(
         return false;
     }
 
-#ifdef IPC_TOOLKIT_USE_RATIONAL_INTERSECTION
+    // Only fall back to the (slow) exact test for near-degenerate cases.
+    bool is_intersecting;
+    if (filtered_edge_triangle_intersection(
+            e0, e1, t0, t1, t2, is_intersecting)) {
+        return is_intersecting;
+    }
+
+#ifdef IPC_TOOLKIT_WITH_RATIONAL_INTERSECTION
     return is_edge_intersecting_triangle_rational(e0, e1, t0, t1, t2);
 #else
     Eigen::Matrix3d M;
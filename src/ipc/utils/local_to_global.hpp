@@ -3,10 +3,25 @@
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <array>
+#include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 namespace ipc {
 
+/// @brief Caller-provided buffer of local gradients or Hessians (one element per row).
+using LocalValuesBuffer = Eigen::Ref<
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+/// @brief Vertex ids of each element (one element per row).
+/// @note The ids are 64-bit on every platform (long is 32-bit on Windows), so they map to NumPy's int64 without a copy.
+using LocalVertexIds =
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 4, Eigen::RowMajor>;
+
+/// @brief Caller-provided buffer of the vertex ids of each element (one element per row).
+using LocalVertexIdsBuffer = Eigen::Ref<LocalVertexIds>;
+
 template <typename DerivedLocalGrad, typename IDContainer, typename DerivedGrad>
 void local_gradient_to_global_gradient(
     const Eigen::MatrixBase<DerivedLocalGrad>& local_grad,
@@ -42,12 +57,19 @@ void local_gradient_to_global_gradient(
     }
 }
 
+/// @brief Append the entries of a local hessian to global triplets.
+/// @param local_hessian Local hessian of the element.
+/// @param ids Vertex ids of the element.
+/// @param dim Dimension of the vertices.
+/// @param triplets Global triplets to append to.
+/// @param upper_triangular Only append the entries of the upper triangle of the global matrix (the local hessian must be symmetric).
 template <typename Derived, typename IDContainer>
 void local_hessian_to_global_triplets(
     const Eigen::MatrixBase<Derived>& local_hessian,
     const IDContainer& ids,
     int dim,
-    std::vector<Eigen::Triplet<double>>& triplets)
+    std::vector<Eigen::Triplet<double>>& triplets,
+    const bool upper_triangular = false)
 {
     assert(local_hessian.rows() == local_hessian.cols());
     assert(local_hessian.rows() % dim == 0);
@@ -55,8 +77,12 @@ void local_hessian_to_global_triplets(
     assert(ids.size() >= n_verts); // Can be extra ids
     for (int i = 0; i < n_verts; i++) {
         for (int j = 0; j < n_verts; j++) {
+            if (upper_triangular && ids[i] > ids[j]) {
+                continue; // Block is in the lower triangle
+            }
+            const bool is_diagonal_block = upper_triangular && ids[i] == ids[j];
             for (int k = 0; k < dim; k++) {
-                for (int l = 0; l < dim; l++) {
+                for (int l = is_diagonal_block ? k : 0; l < dim; l++) {
                     triplets.emplace_back(
                         dim * ids[i] + k, dim * ids[j] + l,
                         local_hessian(dim * i + k, dim * j + l));
@@ -66,4 +92,66 @@ void local_hessian_to_global_triplets(
     }
 }
 
+/// @brief Check the size of the buffers of unassembled local values.
+/// @param n Number of elements.
+/// @param row_size Number of local values per element.
+/// @param values Buffer of local values.
+/// @param ids Buffer of vertex ids.
+/// @throws std::invalid_argument If a buffer is too small.
+inline void check_local_buffers(
+    const size_t n,
+    const size_t row_size,
+    const LocalValuesBuffer& values,
+    const LocalVertexIdsBuffer& ids)
+{
+    if (size_t(values.rows()) < n || size_t(values.cols()) < row_size
+        || size_t(ids.rows()) < n) {
+        throw std::invalid_argument("Local buffers are too small!");
+    }
+}
+
+/// @brief Write a local gradient and its vertex ids into a row of unassembled buffers.
+/// @note The gradient is zero padded, and the unused vertex ids are -1.
+/// @param local_grad Local gradient of the element.
+/// @param ids Vertex ids of the element.
+/// @param values Row of the buffer of local gradients.
+/// @param ids_row Row of the buffer of vertex ids.
+template <typename DerivedLocalGrad, typename ValuesRow, typename IDsRow>
+void local_gradient_to_buffer(
+    const Eigen::MatrixBase<DerivedLocalGrad>& local_grad,
+    const std::array<long, 4>& ids,
+    ValuesRow&& values,
+    IDsRow&& ids_row)
+{
+    const Eigen::Index n = local_grad.size();
+    values.head(n) = local_grad.transpose();
+    values.tail(values.size() - n).setZero();
+    ids_row = Eigen::Map<const Eigen::Matrix<long, 1, 4>>(ids.data())
+                  .cast<int64_t>();
+}
+
+/// @brief Write a local Hessian and its vertex ids into a row of unassembled buffers.
+/// @note The row holds a (4·dim)×(4·dim) column-major matrix with the local Hessian in its top-left corner (zero padded), and the unused vertex ids are -1.
+/// @param local_hessian Local Hessian of the element.
+/// @param ids Vertex ids of the element.
+/// @param dim Dimension of the vertices.
+/// @param values Row of the buffer of local Hessians.
+/// @param ids_row Row of the buffer of vertex ids.
+template <typename Derived, typename ValuesRow, typename IDsRow>
+void local_hessian_to_buffer(
+    const Eigen::MatrixBase<Derived>& local_hessian,
+    const std::array<long, 4>& ids,
+    const int dim,
+    ValuesRow&& values,
+    IDsRow&& ids_row)
+{
+    const int m = 4 * dim;
+    Eigen::Map<Eigen::MatrixXd> hessian(values.data(), m, m);
+    hessian.setZero();
+    hessian.topLeftCorner(local_hessian.rows(), local_hessian.cols()) =
+        local_hessian;
+    ids_row = Eigen::Map<const Eigen::Matrix<long, 1, 4>>(ids.data())
+                  .cast<int64_t>();
+}
+
 } // namespace ipc
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace ipc {
+
+/// @brief Maximum coordinate (exclusive) of a 2D Morton code.
+constexpr int MORTON_2D_MAX_COORD = 1 << 30;
+/// @brief Maximum coordinate (exclusive) of a 3D Morton code.
+constexpr int MORTON_3D_MAX_COORD = 1 << 21;
+
+/// @brief Spread the lower 32 bits of x so there is one zero bit between each.
+inline uint64_t morton_spread_bits_2d(uint64_t x)
+{
+    x &= 0x00000000ffffffff;
+    x = (x | (x << 16)) & 0x0000ffff0000ffff;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | (x << 2)) & 0x3333333333333333;
+    x = (x | (x << 1)) & 0x5555555555555555;
+    return x;
+}
+
+/// @brief Spread the lower 21 bits of x so there are two zero bits between each.
+inline uint64_t morton_spread_bits_3d(uint64_t x)
+{
+    x &= 0x00000000001fffff;
+    x = (x | (x << 32)) & 0x001f00000000ffff;
+    x = (x | (x << 16)) & 0x001f0000ff0000ff;
+    x = (x | (x << 8)) & 0x100f00f00f00f00f;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+    x = (x | (x << 2)) & 0x1249249249249249;
+    return x;
+}
+
+/// @brief Compute the Morton (Z-order) code of a 2D cell.
+/// @note The code of a cell with coordinates less than MORTON_2D_MAX_COORD fits in a signed 64-bit integer.
+inline int64_t morton_code(int x, int y)
+{
+    assert(x >= 0 && x < MORTON_2D_MAX_COORD);
+    assert(y >= 0 && y < MORTON_2D_MAX_COORD);
+    return int64_t(morton_spread_bits_2d(x) | (morton_spread_bits_2d(y) << 1));
+}
+
+/// @brief Compute the Morton (Z-order) code of a 3D cell.
+/// @note The code of a cell with coordinates less than MORTON_3D_MAX_COORD fits in a signed 64-bit integer.
+inline int64_t morton_code(int x, int y, int z)
+{
+    assert(x >= 0 && x < MORTON_3D_MAX_COORD);
+    assert(y >= 0 && y < MORTON_3D_MAX_COORD);
+    assert(z >= 0 && z < MORTON_3D_MAX_COORD);
+    return int64_t(
+        morton_spread_bits_3d(x) | (morton_spread_bits_3d(y) << 1)
+        | (morton_spread_bits_3d(z) << 2));
+}
+
+} // namespace ipc
@@ -0,0 +1,291 @@
+#include "transport.hpp"
+
+#include <ipc/utils/logger.hpp>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <crt_externs.h>
+#define environ (*_NSGetEnviron())
+#else
+extern char** environ;
+#endif
+#endif
+
+namespace ipc {
+
+#ifndef _WIN32
+
+namespace {
+    /// @brief Socket transport to a worker thread.
+    class ThreadTransport : public SocketTransport {
+    public:
+        ThreadTransport(
+            std::unique_ptr<SocketTransport> transport,
+            std::unique_ptr<SocketTransport> worker_transport,
+            const WorkerFunction& worker)
+            : SocketTransport(transport->release())
+            , m_worker_transport(std::move(worker_transport))
+            , m_thread([this, worker]() {
+                try {
+                    worker(*m_worker_transport);
+                } catch (const std::exception& e) {
+                    logger().error("worker thread failed: {}", e.what());
+                }
+            })
+        {
+        }
+
+        ~ThreadTransport() override
+        {
+            ::close(m_fd);
+            m_fd = -1;
+            m_thread.join();
+        }
+
+    protected:
+        std::unique_ptr<SocketTransport> m_worker_transport;
+        std::thread m_thread;
+    };
+
+    /// @brief Socket transport to a worker process.
+    class ProcessTransport : public SocketTransport {
+    public:
+        ProcessTransport(int fd, pid_t pid) : SocketTransport(fd), m_pid(pid)
+        {
+        }
+
+        ~ProcessTransport() override
+        {
+            // A worker blocked on the socket exits once it is closed.
+            ::close(m_fd);
+            m_fd = -1;
+            int status;
+            while (::waitpid(m_pid, &status, 0) < 0 && errno == EINTR) { }
+        }
+
+    protected:
+        pid_t m_pid;
+    };
+
+    /// @brief Create a pair of connected local sockets closed on exec.
+    std::array<int, 2> make_close_on_exec_socket_pair()
+    {
+        int fds[2];
+#ifdef SOCK_CLOEXEC
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            throw std::runtime_error("Unable to create a local socket pair!");
+        }
+#else
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            throw std::runtime_error("Unable to create a local socket pair!");
+        }
+        ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+        return { { fds[0], fds[1] } };
+    }
+} // namespace
+
+SocketTransport::~SocketTransport()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+int SocketTransport::release()
+{
+    const int fd = m_fd;
+    m_fd = -1;
+    return fd;
+}
+
+void SocketTransport::send(const std::vector<char>& message)
+{
+    const uint64_t size = message.size();
+    write_all(reinterpret_cast<const char*>(&size), sizeof(size));
+    write_all(message.data(), message.size());
+}
+
+std::vector<char> SocketTransport::receive()
+{
+    uint64_t size;
+    read_all(reinterpret_cast<char*>(&size), sizeof(size));
+    std::vector<char> message(size);
+    read_all(message.data(), message.size());
+    return message;
+}
+
+void SocketTransport::write_all(const char* data, size_t size)
+{
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL; // Report a closed peer as an error.
+#else
+    constexpr int flags = 0;
+#endif
+    while (size > 0) {
+        const ssize_t n = ::send(m_fd, data, size, flags);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Unable to write to the socket!");
+        }
+        data += n;
+        size -= n;
+    }
+}
+
+void SocketTransport::read_all(char* data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t n = ::recv(m_fd, data, size, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Unable to read from the socket!");
+        }
+        if (n == 0) {
+            throw std::runtime_error("The socket was closed!");
+        }
+        data += n;
+        size -= n;
+    }
+}
+
+std::pair<std::unique_ptr<SocketTransport>, std::unique_ptr<SocketTransport>>
+SocketTransport::make_local_pair()
+{
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        throw std::runtime_error("Unable to create a local socket pair!");
+    }
+    return std::make_pair(
+        std::make_unique<SocketTransport>(fds[0]),
+        std::make_unique<SocketTransport>(fds[1]));
+}
+
+std::unique_ptr<Transport> launch_local_thread(const WorkerFunction& worker)
+{
+    auto [transport, worker_transport] = SocketTransport::make_local_pair();
+    return std::make_unique<ThreadTransport>(
+        std::move(transport), std::move(worker_transport), worker);
+}
+
+WorkerLauncher launch_local_process(const std::string& executable)
+{
+    return [executable](const WorkerFunction&) -> std::unique_ptr<Transport> {
+        // Both ends are closed on exec, so no other spawned process (e.g., a
+        // sibling worker) inherits them.
+        const auto [fd, worker_fd] = make_close_on_exec_socket_pair();
+
+        // The worker inherits a duplicate of its end, which dup2 does not
+        // close on exec as long as it is a different descriptor.
+        const int inherited_fd = worker_fd == 3 ? 4 : 3;
+
+        std::string path = executable;
+        std::string fd_arg = std::to_string(inherited_fd);
+        char* const argv[] = { path.data(), fd_arg.data(), nullptr };
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, worker_fd, inherited_fd);
+        pid_t pid;
+        const int error = ::posix_spawn(
+            &pid, path.c_str(), &actions, nullptr, argv, environ);
+        posix_spawn_file_actions_destroy(&actions);
+        ::close(worker_fd);
+
+        if (error != 0) {
+            ::close(fd);
+            throw std::runtime_error(fmt::format(
+                "Unable to spawn the worker process {}: {}", executable,
+                std::strerror(error)));
+        }
+        return std::make_unique<ProcessTransport>(fd, pid);
+    };
+}
+
+int serve_socket_worker(int argc, char* argv[], const WorkerFunction& worker)
+{
+    if (argc != 2) {
+        logger().error(
+            "usage: {} <socket file descriptor>",
+            argc > 0 ? argv[0] : "worker");
+        return EXIT_FAILURE;
+    }
+
+    try {
+        SocketTransport transport(std::stoi(argv[1]));
+        worker(transport);
+    } catch (const std::exception& e) {
+        logger().error("worker process failed: {}", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+#else
+
+SocketTransport::~SocketTransport() { }
+
+int SocketTransport::release()
+{
+    const int fd = m_fd;
+    m_fd = -1;
+    return fd;
+}
+
+void SocketTransport::send(const std::vector<char>& message)
+{
+    throw std::runtime_error("Socket transports are not supported on Windows!");
+}
+
+std::vector<char> SocketTransport::receive()
+{
+    throw std::runtime_error("Socket transports are not supported on Windows!");
+}
+
+void SocketTransport::write_all(const char* data, size_t size) { }
+
+void SocketTransport::read_all(char* data, size_t size) { }
+
+std::pair<std::unique_ptr<SocketTransport>, std::unique_ptr<SocketTransport>>
+SocketTransport::make_local_pair()
+{
+    throw std::runtime_error("Socket transports are not supported on Windows!");
+}
+
+std::unique_ptr<Transport> launch_local_thread(const WorkerFunction& worker)
+{
+    throw std::runtime_error("Worker threads are not supported on Windows!");
+}
+
+WorkerLauncher launch_local_process(const std::string& executable)
+{
+    throw std::runtime_error("Worker processes are not supported on Windows!");
+}
+
+int serve_socket_worker(int argc, char* argv[], const WorkerFunction& worker)
+{
+    logger().error("Worker processes are not supported on Windows!");
+    return EXIT_FAILURE;
+}
+
+#endif
+
+} // namespace ipc
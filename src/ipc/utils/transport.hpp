@@ -0,0 +1,184 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Ordered, reliable channel of byte messages between two processes.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    /// @brief Send a message to the other end.
+    /// @param message The bytes of the message.
+    virtual void send(const std::vector<char>& message) = 0;
+
+    /// @brief Receive the next message from the other end (blocking).
+    /// @return The bytes of the message.
+    virtual std::vector<char> receive() = 0;
+};
+
+/// @brief Transport over a connected stream socket (e.g., a Unix domain socket).
+/// @note Messages are prefixed by their length. The socket is closed on destruction. Sockets are only supported on POSIX systems: on Windows, every operation throws a std::runtime_error.
+class SocketTransport : public Transport {
+public:
+    /// @brief Take ownership of a connected socket.
+    /// @param fd File descriptor of the socket.
+    explicit SocketTransport(int fd) : m_fd(fd) { }
+
+    ~SocketTransport() override;
+
+    SocketTransport(const SocketTransport&) = delete;
+    SocketTransport& operator=(const SocketTransport&) = delete;
+
+    void send(const std::vector<char>& message) override;
+
+    std::vector<char> receive() override;
+
+    /// @brief Release the ownership of the socket.
+    /// @return The file descriptor of the socket.
+    int release();
+
+    /// @brief Create a pair of connected local (Unix domain) socket transports.
+    static std::pair<
+        std::unique_ptr<SocketTransport>,
+        std::unique_ptr<SocketTransport>>
+    make_local_pair();
+
+protected:
+    void write_all(const char* data, size_t size);
+    void read_all(char* data, size_t size);
+
+    int m_fd;
+};
+
+/// @brief Function serving the requests of a coordinator on a worker's end of a transport.
+using WorkerFunction = std::function<void(Transport& transport)>;
+
+/// @brief Function starting a worker and returning the coordinator's end of its transport.
+/// @note A launcher may also start the worker in another process (see launch_local_process), as long as it does not fork this multithreaded process.
+using WorkerLauncher =
+    std::function<std::unique_ptr<Transport>(const WorkerFunction& worker)>;
+
+/// @brief Start a worker in a thread of this process connected by a Unix domain socket.
+/// @note The thread is joined when the returned transport is destroyed. Only available on POSIX systems.
+/// @param worker Function run by the worker thread.
+/// @return The coordinator's end of the transport.
+std::unique_ptr<Transport> launch_local_thread(const WorkerFunction& worker);
+
+/// @brief Make a launcher starting each worker as a new process of an executable.
+/// @note The process is created with posix_spawn (never by forking this process) and receives its end of a Unix domain socket as the file descriptor given by its only argument (see serve_socket_worker). The executable serves the protocol itself, so the launcher ignores the WorkerFunction. The process is waited for when the returned transport is destroyed. Only available on POSIX systems.
+/// @param executable Path to the worker executable.
+/// @return The launcher.
+WorkerLauncher launch_local_process(const std::string& executable);
+
+/// @brief Run a worker on the inherited socket named by the command line of a worker executable.
+/// @note This is the main function of the executables started by launch_local_process.
+/// @param argc Number of command line arguments.
+/// @param argv Command line arguments (the second one is the file descriptor of the socket).
+/// @param worker Function serving the requests on the socket.
+/// @return The exit code of the executable.
+int serve_socket_worker(int argc, char* argv[], const WorkerFunction& worker);
+
+// ============================================================================
+
+/// @brief Serialize trivially copyable values and Eigen matrices into a message.
+class MessageWriter {
+public:
+    template <typename T> void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        m_message.insert(m_message.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T> void write(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(values.size());
+        const char* bytes = reinterpret_cast<const char*>(values.data());
+        m_message.insert(
+            m_message.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    template <typename Scalar>
+    void write(const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>& M)
+    {
+        write(M.rows());
+        write(M.cols());
+        const char* bytes = reinterpret_cast<const char*>(M.data());
+        m_message.insert(
+            m_message.end(), bytes, bytes + M.size() * sizeof(Scalar));
+    }
+
+    /// @brief Get the serialized message.
+    const std::vector<char>& message() const { return m_message; }
+
+protected:
+    std::vector<char> m_message;
+};
+
+/// @brief Deserialize values written by a MessageWriter in the same order.
+/// @note Reading past the end of the message throws a std::runtime_error.
+class MessageReader {
+public:
+    explicit MessageReader(const std::vector<char>& message)
+        : m_message(message)
+    {
+    }
+
+    template <typename T> void read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::memcpy(&value, next(sizeof(T)), sizeof(T));
+    }
+
+    template <typename T> void read(std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        size_t size;
+        read(size);
+        const char* data = next(size * sizeof(T));
+        values.resize(size);
+        std::memcpy(values.data(), data, size * sizeof(T));
+    }
+
+    template <typename Scalar>
+    void read(Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>& M)
+    {
+        Eigen::Index rows, cols;
+        read(rows);
+        read(cols);
+        const char* data = next(rows * cols * sizeof(Scalar));
+        M.resize(rows, cols);
+        std::memcpy(M.data(), data, M.size() * sizeof(Scalar));
+    }
+
+    /// @brief Check if the whole message has been read.
+    bool done() const { return m_position == m_message.size(); }
+
+protected:
+    const char* next(size_t size)
+    {
+        if (size > m_message.size() - m_position) {
+            throw std::runtime_error("Message is too short!");
+        }
+        const char* data = m_message.data() + m_position;
+        m_position += size;
+        return data;
+    }
+
+    const std::vector<char>& m_message;
+    size_t m_position = 0;
+};
+
+} // namespace ipc
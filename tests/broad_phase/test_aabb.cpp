@@ -103,3 +103,61 @@ TEST_CASE("AABB overlapping", "[broad_phase][AABB]")
     }
     CHECK(a.intersects(b) == are_overlapping);
 }
+
+TEST_CASE("AABB conservative inflation", "[broad_phase][AABB]")
+{
+    const double inflation_radius = GENERATE(1e-3, 0.1, 1.0 / 3.0);
+    CAPTURE(inflation_radius);
+
+    for (int i = 0; i < 100; i++) {
+        const ArrayMax3d p = ArrayMax3d::Random(3);
+        ArrayMax3d min = p, max = p;
+        AABB::conservative_inflation(min, max, inflation_radius);
+        for (int j = 0; j < 3; j++) {
+            CHECK(
+                (long double)min[j] <= (long double)p[j] - inflation_radius);
+            CHECK(
+                (long double)max[j] >= (long double)p[j] + inflation_radius);
+        }
+    }
+}
+
+TEST_CASE("Build boxes", "[broad_phase][AABB]")
+{
+    Eigen::MatrixXd V_t0 = Eigen::MatrixXd::Random(10, 3);
+    Eigen::MatrixXd V_t1 = Eigen::MatrixXd::Random(10, 3);
+    Eigen::MatrixXi E(3, 2), F(2, 3);
+    E << 0, 1, 2, 3, 4, 5;
+    F << 5, 6, 7, 7, 8, 9;
+    const double inflation_radius = 1e-2;
+
+    std::vector<AABB> vertex_boxes, edge_boxes, face_boxes;
+    build_boxes(
+        V_t0, V_t1, E, F, vertex_boxes, edge_boxes, face_boxes,
+        inflation_radius);
+
+    std::vector<AABB> expected_vertex_boxes, expected_edge_boxes,
+        expected_face_boxes;
+    build_vertex_boxes(V_t0, V_t1, expected_vertex_boxes, inflation_radius);
+    build_edge_boxes(expected_vertex_boxes, E, expected_edge_boxes);
+    build_face_boxes(expected_vertex_boxes, F, expected_face_boxes);
+
+    const auto check_boxes = [](const std::vector<AABB>& boxes,
+                                const std::vector<AABB>& expected_boxes) {
+        REQUIRE(boxes.size() == expected_boxes.size());
+        for (size_t i = 0; i < boxes.size(); i++) {
+            CHECK((boxes[i].min == expected_boxes[i].min).all());
+            CHECK((boxes[i].max == expected_boxes[i].max).all());
+            CHECK(boxes[i].vertex_ids == expected_boxes[i].vertex_ids);
+        }
+    };
+    check_boxes(vertex_boxes, expected_vertex_boxes);
+    check_boxes(edge_boxes, expected_edge_boxes);
+    check_boxes(face_boxes, expected_face_boxes);
+
+    // The vertex boxes contain the vertices at both times.
+    for (int i = 0; i < V_t0.rows(); i++) {
+        CHECK((vertex_boxes[i].min <= V_t0.row(i).transpose().array()).all());
+        CHECK((vertex_boxes[i].max >= V_t1.row(i).transpose().array()).all());
+    }
+}
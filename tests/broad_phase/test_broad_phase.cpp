@@ -7,11 +7,23 @@
 
 #include <ipc/ipc.hpp>
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/distributed_broad_phase.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/broad_phase/partitioned_broad_phase.hpp>
+#include <ipc/broad_phase/voxel_size_heuristic.hpp>
 #include <ipc/ccd/ccd.hpp>
 
 #include "brute_force_comparison.hpp"
 #include "test_utils.hpp"
 
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+
 using namespace ipc;
 
 void test_broad_phase(
@@ -224,3 +236,536 @@ TEST_CASE("Cloth-Ball", "[ccd][broad_phase][cloth-ball][.]")
         mesh, V0, V1, method, true,
         TEST_DATA_DIR + "cloth_ball_bf_ccd_candidated.json");
 }
+
+TEST_CASE("Stream candidates in batches", "[broad_phase]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    const double dhat = 1e-1;
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+    broad_phase->can_vertices_collide = mesh.can_collide;
+    broad_phase->build(V, mesh.edges(), mesh.faces(), dhat / 2);
+
+    std::vector<EdgeEdgeCandidate> expected_ee;
+    broad_phase->detect_edge_edge_candidates(expected_ee);
+    std::sort(expected_ee.begin(), expected_ee.end());
+    expected_ee.erase(
+        std::unique(expected_ee.begin(), expected_ee.end()), expected_ee.end());
+
+    std::vector<FaceVertexCandidate> expected_fv;
+    broad_phase->detect_face_vertex_candidates(expected_fv);
+    std::sort(expected_fv.begin(), expected_fv.end());
+    expected_fv.erase(
+        std::unique(expected_fv.begin(), expected_fv.end()), expected_fv.end());
+
+    std::mutex mutex;
+    std::vector<EdgeEdgeCandidate> streamed_ee;
+    broad_phase->stream_edge_edge_candidates(
+        [&](size_t, const std::vector<EdgeEdgeCandidate>& candidates) {
+            std::lock_guard<std::mutex> lock(mutex);
+            streamed_ee.insert(
+                streamed_ee.end(), candidates.begin(), candidates.end());
+        });
+    std::sort(streamed_ee.begin(), streamed_ee.end());
+
+    std::vector<FaceVertexCandidate> streamed_fv;
+    broad_phase->stream_face_vertex_candidates(
+        [&](size_t, const std::vector<FaceVertexCandidate>& candidates) {
+            std::lock_guard<std::mutex> lock(mutex);
+            streamed_fv.insert(
+                streamed_fv.end(), candidates.begin(), candidates.end());
+        });
+    std::sort(streamed_fv.begin(), streamed_fv.end());
+
+    CHECK(streamed_ee == expected_ee);
+    CHECK(streamed_fv == expected_fv);
+
+    // The fused build must match building from the full list of candidates.
+    Candidates candidates;
+    candidates.build(mesh, V, dhat / 2, method);
+
+    CollisionConstraints expected_constraints;
+    expected_constraints.build(candidates, mesh, V, dhat);
+
+    CollisionConstraints constraints;
+    constraints.build(mesh, V, dhat, /*dmin=*/0, method);
+
+    CHECK(constraints.size() == expected_constraints.size());
+    CHECK(
+        constraints.compute_potential(mesh, V, dhat)
+        == Catch::Approx(
+            expected_constraints.compute_potential(mesh, V, dhat)));
+}
+
+TEST_CASE("Hash grid candidates are unique", "[broad_phase][hash_grid]")
+{
+    // A large inflation radius makes the boxes span many cells.
+    const double inflation_radius = GENERATE(1e-2, 1e-1, 5e-1);
+    CAPTURE(inflation_radius);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    HashGrid hash_grid;
+    hash_grid.can_vertices_collide = mesh.can_collide;
+    hash_grid.build(V, mesh.edges(), mesh.faces(), inflation_radius);
+
+    BruteForce brute_force;
+    brute_force.can_vertices_collide = mesh.can_collide;
+    brute_force.build(V, mesh.edges(), mesh.faces(), inflation_radius);
+
+    std::vector<EdgeEdgeCandidate> ee_candidates, expected_ee;
+    hash_grid.detect_edge_edge_candidates(ee_candidates);
+    brute_force.detect_edge_edge_candidates(expected_ee);
+    std::sort(ee_candidates.begin(), ee_candidates.end());
+    std::sort(expected_ee.begin(), expected_ee.end());
+    CHECK(
+        std::adjacent_find(ee_candidates.begin(), ee_candidates.end())
+        == ee_candidates.end());
+    CHECK(ee_candidates == expected_ee);
+
+    std::vector<FaceVertexCandidate> fv_candidates, expected_fv;
+    hash_grid.detect_face_vertex_candidates(fv_candidates);
+    brute_force.detect_face_vertex_candidates(expected_fv);
+    std::sort(fv_candidates.begin(), fv_candidates.end());
+    std::sort(expected_fv.begin(), expected_fv.end());
+    CHECK(
+        std::adjacent_find(fv_candidates.begin(), fv_candidates.end())
+        == fv_candidates.end());
+    CHECK(fv_candidates == expected_fv);
+}
+
+TEST_CASE("Morton codes", "[broad_phase][hash_grid]")
+{
+    CHECK(morton_code(0, 0) == 0);
+    CHECK(morton_code(1, 0) == 1);
+    CHECK(morton_code(0, 1) == 2);
+    CHECK(morton_code(1, 1) == 3);
+    CHECK(morton_code(2, 0) == 4);
+
+    CHECK(morton_code(0, 0, 0) == 0);
+    CHECK(morton_code(1, 0, 0) == 1);
+    CHECK(morton_code(0, 1, 0) == 2);
+    CHECK(morton_code(0, 0, 1) == 4);
+    CHECK(morton_code(1, 1, 1) == 7);
+    CHECK(morton_code(2, 0, 0) == 8);
+
+    // The largest codes still fit in a signed 64-bit integer.
+    const int max_2d = MORTON_2D_MAX_COORD - 1;
+    CHECK(morton_code(max_2d, max_2d) == (int64_t(1) << 60) - 1);
+    const int max_3d = MORTON_3D_MAX_COORD - 1;
+    CHECK(morton_code(max_3d, max_3d, max_3d)
+        == std::numeric_limits<int64_t>::max());
+}
+
+TEST_CASE("Median lengths", "[broad_phase][voxel_size]")
+{
+    // Small inputs have an exact median, large inputs a sampled one.
+    const int n = GENERATE(5, 6, 1000, 3 * int(MAX_MEDIAN_SAMPLES));
+    CAPTURE(n);
+
+    const Eigen::MatrixXd V0 = Eigen::MatrixXd::Random(n, 3);
+    const Eigen::MatrixXd V1 = V0 + Eigen::MatrixXd::Random(n, 3);
+
+    const Eigen::VectorXd norms = (V1 - V0).rowwise().norm();
+    std::vector<double> lengths(norms.data(), norms.data() + n);
+    std::sort(lengths.begin(), lengths.end());
+    const double expected = n % 2 == 1
+        ? lengths[n / 2]
+        : (lengths[n / 2 - 1] + lengths[n / 2]) / 2;
+
+    const double median = median_displacement_length(V0, V1);
+    CHECK(median == median_displacement_length(V1 - V0));
+    if (size_t(n) <= MAX_MEDIAN_SAMPLES) {
+        CHECK(median == expected);
+    } else {
+        // The rank of the sampled median is close to the middle.
+        const double rank =
+            std::lower_bound(lengths.begin(), lengths.end(), median)
+            - lengths.begin();
+        CHECK(std::abs(rank / n - 0.5) < 0.01);
+    }
+}
+
+TEST_CASE("Median of periodic lengths", "[broad_phase][voxel_size]")
+{
+    // Every third length is short, so a sample strided by the period would
+    // only see short lengths. The median of a uniform sample has a rank close
+    // to the middle regardless of the order of the lengths.
+    const int n = 3 * int(MAX_MEDIAN_SAMPLES);
+
+    Eigen::MatrixXd displacements = Eigen::MatrixXd::Zero(n, 3);
+    for (int i = 0; i < n; i++) {
+        displacements(i, 0) = i % 3 == 0 ? i : n + i;
+    }
+    std::vector<double> lengths(n);
+    for (int i = 0; i < n; i++) {
+        lengths[i] = displacements(i, 0);
+    }
+    std::sort(lengths.begin(), lengths.end());
+
+    const double median = median_displacement_length(displacements);
+    const double rank =
+        std::lower_bound(lengths.begin(), lengths.end(), median)
+        - lengths.begin();
+    CHECK(std::abs(rank / n - 0.5) < 0.01);
+}
+
+TEST_CASE("Hash grid voxel size heuristics", "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+    const double inflation_radius = 1e-2;
+
+    BruteForce brute_force;
+    brute_force.can_vertices_collide = mesh.can_collide;
+    brute_force.build(V, mesh.edges(), mesh.faces(), inflation_radius);
+    std::vector<EdgeEdgeCandidate> expected_ee;
+    brute_force.detect_edge_edge_candidates(expected_ee);
+    std::sort(expected_ee.begin(), expected_ee.end());
+
+    HashGrid hash_grid;
+    hash_grid.can_vertices_collide = mesh.can_collide;
+    hash_grid.voxel_size_heuristic = GENERATE(
+        VoxelSizeHeuristic::MEDIAN_EDGE_LENGTH, VoxelSizeHeuristic::COST_MODEL);
+    hash_grid.build(V, mesh.edges(), mesh.faces(), inflation_radius);
+    const double cell_size = hash_grid.cellSize();
+    CHECK(cell_size > 0);
+
+    // Rebuilding with a scaled mesh reuses the previous voxel size.
+    hash_grid.reuse_voxel_size = true;
+    hash_grid.build(2 * V, mesh.edges(), mesh.faces(), 2 * inflation_radius);
+    CHECK(hash_grid.cellSize() == cell_size);
+
+    std::vector<EdgeEdgeCandidate> ee_candidates;
+    hash_grid.build(V, mesh.edges(), mesh.faces(), inflation_radius);
+    hash_grid.detect_edge_edge_candidates(ee_candidates);
+    std::sort(ee_candidates.begin(), ee_candidates.end());
+    CHECK(ee_candidates == expected_ee);
+}
+
+TEST_CASE("Visit candidates", "[broad_phase]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+    broad_phase->can_vertices_collide = mesh.can_collide;
+    broad_phase->build(V, mesh.edges(), mesh.faces(), 5e-2);
+
+    std::vector<FaceVertexCandidate> expected;
+    broad_phase->detect_face_vertex_candidates(expected);
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    REQUIRE(expected.size() > 1);
+
+    std::atomic<size_t> num_visited(0);
+    CHECK(broad_phase->visit_face_vertex_candidates(
+        [&](const FaceVertexCandidate&) {
+            ++num_visited;
+            return true;
+        }));
+    CHECK(num_visited == expected.size());
+
+    // Stop at the first candidate
+    num_visited = 0;
+    CHECK(!broad_phase->visit_face_vertex_candidates(
+        [&](const FaceVertexCandidate&) {
+            ++num_visited;
+            return false;
+        }));
+    // Each thread can visit at most one candidate before seeing the stop.
+    CHECK(num_visited >= 1);
+    CHECK(num_visited <= tbb::this_task_arena::max_concurrency());
+}
+
+TEST_CASE("Partitioned broad phase", "[broad_phase]")
+{
+    const BroadPhaseMethod method = GENERATE(
+        BroadPhaseMethod::BRUTE_FORCE, BroadPhaseMethod::HASH_GRID);
+    CAPTURE(method);
+
+    const double dhat = 1e-1;
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    // The first half of the vertices stay at rest.
+    std::vector<bool> is_vertex_static(V.rows(), false);
+    for (int i = 0; i < V.rows() / 2; i++) {
+        is_vertex_static[i] = true;
+    }
+    CollisionMesh partitioned_mesh = mesh;
+    partitioned_mesh.set_static_vertices(is_vertex_static);
+    REQUIRE(partitioned_mesh.has_static_vertices());
+    CHECK(!mesh.has_static_vertices());
+
+    Eigen::MatrixXd V1 = V;
+    for (int i = V.rows() / 2; i < V.rows(); i++) {
+        V1(i, 0) -= 0.1;
+    }
+
+    Candidates expected, candidates;
+    expected.build(mesh, V, V1, dhat / 2, method);
+    candidates.build(partitioned_mesh, V, V1, dhat / 2, method);
+
+    // Pairs of static elements are never considered.
+    const auto is_static = [&](const auto& candidate) {
+        const std::array<long, 4> ids =
+            candidate.vertex_ids(mesh.edges(), mesh.faces());
+        return std::all_of(ids.begin(), ids.end(), [&](long vi) {
+            return vi < 0 || is_vertex_static[vi];
+        });
+    };
+    const auto remove_static = [&](auto& v) {
+        v.erase(std::remove_if(v.begin(), v.end(), is_static), v.end());
+    };
+    remove_static(expected.ee_candidates);
+    remove_static(expected.fv_candidates);
+    REQUIRE(expected.size() > 0);
+
+    CHECK(candidates.ee_candidates == expected.ee_candidates);
+    CHECK(candidates.fv_candidates == expected.fv_candidates);
+
+    CollisionConstraints expected_constraints, constraints;
+    expected_constraints.build(mesh, V, dhat, /*dmin=*/0, method);
+    constraints.build(partitioned_mesh, V, dhat, /*dmin=*/0, method);
+
+    CHECK(
+        constraints.compute_potential(partitioned_mesh, V, dhat)
+        == Catch::Approx(expected_constraints.compute_potential(mesh, V, dhat)));
+
+    // Moving a static vertex would make the static grid stale.
+    Eigen::MatrixXd V_moved = V;
+    V_moved(0, 0) += 0.1;
+    PartitionedBroadPhase partitioned_bp(
+        partitioned_mesh, BroadPhase::make_broad_phase(method));
+    partitioned_bp.validate_static_vertices = true;
+    CHECK_NOTHROW(partitioned_bp.build(
+        V, V1, partitioned_mesh.edges(), partitioned_mesh.faces()));
+    CHECK_THROWS_AS(
+        partitioned_bp.build(
+            V, V_moved, partitioned_mesh.edges(), partitioned_mesh.faces()),
+        std::runtime_error);
+}
+
+// The socket transports are only available on POSIX systems.
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32))
+TEST_CASE("Distributed broad phase", "[broad_phase][distributed]")
+{
+    const size_t num_partitions = GENERATE(1, 2, 4);
+    CAPTURE(num_partitions);
+    WorkerLauncher launcher = launch_local_thread;
+#ifdef IPC_TOOLKIT_BROAD_PHASE_WORKER
+    // Also run the workers as child processes of the worker executable.
+    const bool use_processes = GENERATE(false, true);
+    CAPTURE(use_processes);
+    if (use_processes) {
+        launcher = launch_local_process(IPC_TOOLKIT_BROAD_PHASE_WORKER);
+    }
+#endif
+
+    const double inflation_radius = 1e-2;
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V0, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+
+    Eigen::MatrixXd V1 = V0;
+    for (int i = V0.rows() / 2; i < V0.rows(); i++) {
+        V1(i, 0) -= 0.5;
+    }
+
+    BruteForce expected_bp;
+    expected_bp.can_vertices_collide = mesh.can_collide;
+    expected_bp.build(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+
+    DistributedBroadPhase bp(
+        num_partitions, BroadPhaseMethod::HASH_GRID, launcher);
+    bp.can_vertices_collide = mesh.can_collide;
+    bp.build(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+    CHECK(bp.partition().num_slabs() == num_partitions);
+
+    const auto check_candidates = [](auto candidates, auto expected) {
+        std::sort(candidates.begin(), candidates.end());
+        std::sort(expected.begin(), expected.end());
+        CHECK(candidates == expected);
+    };
+
+    {
+        std::vector<EdgeVertexCandidate> candidates, expected;
+        bp.detect_edge_vertex_candidates(candidates);
+        expected_bp.detect_edge_vertex_candidates(expected);
+        check_candidates(candidates, expected);
+    }
+    {
+        std::vector<EdgeEdgeCandidate> candidates, expected;
+        bp.detect_edge_edge_candidates(candidates);
+        expected_bp.detect_edge_edge_candidates(expected);
+        REQUIRE(!expected.empty());
+        check_candidates(candidates, expected);
+    }
+    {
+        std::vector<FaceVertexCandidate> candidates, expected;
+        bp.detect_face_vertex_candidates(candidates);
+        expected_bp.detect_face_vertex_candidates(expected);
+        REQUIRE(!expected.empty());
+        check_candidates(candidates, expected);
+    }
+    {
+        std::vector<EdgeFaceCandidate> candidates, expected;
+        bp.detect_edge_face_candidates(candidates);
+        expected_bp.detect_edge_face_candidates(expected);
+        check_candidates(candidates, expected);
+    }
+
+    const double expected_toi = compute_collision_free_stepsize(
+        mesh, V0, V1, BroadPhaseMethod::BRUTE_FORCE);
+    CHECK(expected_toi < 1);
+    CHECK(
+        compute_distributed_collision_free_stepsize(
+            mesh, V0, V1, num_partitions, BroadPhaseMethod::HASH_GRID,
+            /*min_distance=*/0, DEFAULT_CCD_TOLERANCE,
+            DEFAULT_CCD_MAX_ITERATIONS, launcher)
+        == Catch::Approx(expected_toi).margin(1e-6));
+}
+
+TEST_CASE("Persistent distributed workers", "[broad_phase][distributed]")
+{
+    const size_t num_partitions = 3;
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V0, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+
+    size_t num_launches = 0;
+    DistributedBroadPhase bp(
+        num_partitions, BroadPhaseMethod::HASH_GRID,
+        [&](const WorkerFunction& worker) {
+            num_launches++;
+            return launch_local_thread(worker);
+        });
+    bp.can_vertices_collide = mesh.can_collide;
+
+    BruteForce expected_bp;
+    expected_bp.can_vertices_collide = mesh.can_collide;
+
+    // The workers are reused by every query and rebuild.
+    Eigen::MatrixXd V1 = V0;
+    for (int step = 0; step < 3; step++) {
+        for (int i = V0.rows() / 2; i < V0.rows(); i++) {
+            V1(i, 0) -= 0.1;
+        }
+
+        bp.build(V1, mesh.edges(), mesh.faces(), /*inflation_radius=*/1e-2);
+        expected_bp.build(
+            V1, mesh.edges(), mesh.faces(), /*inflation_radius=*/1e-2);
+
+        for (int query = 0; query < 2; query++) {
+            std::vector<FaceVertexCandidate> candidates, expected;
+            bp.detect_face_vertex_candidates(candidates);
+            expected_bp.detect_face_vertex_candidates(expected);
+            std::sort(candidates.begin(), candidates.end());
+            std::sort(expected.begin(), expected.end());
+            CHECK(candidates == expected);
+        }
+
+        CHECK(bp.compute_collision_free_stepsize() == 1);
+    }
+
+    CHECK(num_launches == num_partitions);
+}
+#endif
+
+TEST_CASE("Temporal subdivision of swept boxes", "[broad_phase][temporal]")
+{
+    // A short edge moves diagonally across a row of static edges placed along
+    // the anti-diagonal. The swept box of the full step overlaps all of them,
+    // but only the center one is near the trajectory.
+    const int n = 11;
+    Eigen::MatrixXd V0(2 * n + 2, 2);
+    Eigen::MatrixXi E(n + 1, 2);
+    for (int i = 0; i < n; i++) {
+        V0.row(2 * i) << i - 0.05, n - 1 - i;
+        V0.row(2 * i + 1) << i + 0.05, n - 1 - i;
+        E.row(i) << 2 * i, 2 * i + 1;
+    }
+    V0.row(2 * n) << 0, 0;
+    V0.row(2 * n + 1) << 0.1, 0;
+    E.row(n) << 2 * n, 2 * n + 1;
+
+    Eigen::MatrixXd V1 = V0;
+    V1.bottomRows(2).rowwise() += Eigen::RowVector2d(n - 1, n - 1);
+
+    const CollisionMesh mesh(V0, E, /*F=*/Eigen::MatrixXi());
+    const double inflation_radius = 1e-3;
+
+    Candidates candidates, subdivided_candidates;
+    candidates.build(mesh, V0, V1, inflation_radius);
+    subdivided_candidates.build(
+        mesh, V0, V1, inflation_radius, DEFAULT_BROAD_PHASE_METHOD,
+        /*max_temporal_subdivisions=*/64);
+
+    CHECK(subdivided_candidates.size() > 0);
+    CHECK(subdivided_candidates.size() < candidates.size());
+
+    // Every remaining candidate was also found without subdivision.
+    for (const auto& ev : subdivided_candidates.ev_candidates) {
+        CHECK(std::binary_search(
+            candidates.ev_candidates.begin(), candidates.ev_candidates.end(),
+            ev));
+    }
+
+    // The compact candidates are culled the same way.
+    CompactCandidates compact_candidates;
+    compact_candidates.build(
+        mesh, V0, V1, inflation_radius, DEFAULT_BROAD_PHASE_METHOD,
+        /*max_temporal_subdivisions=*/64);
+    CHECK(
+        compact_candidates.to_candidates().ev_candidates
+        == subdivided_candidates.ev_candidates);
+
+    // No collision is lost.
+    CHECK(
+        subdivided_candidates.compute_collision_free_stepsize(mesh, V0, V1)
+        == candidates.compute_collision_free_stepsize(mesh, V0, V1));
+    CHECK(
+        compute_collision_free_stepsize(
+            mesh, V0, V1, DEFAULT_BROAD_PHASE_METHOD, /*min_distance=*/0,
+            DEFAULT_CCD_TOLERANCE, DEFAULT_CCD_MAX_ITERATIONS,
+            /*max_temporal_subdivisions=*/64)
+        < 1);
+}
@@ -1,13 +1,23 @@
 #include <catch2/catch_all.hpp>
 
+#include <finitediff.hpp>
+
 #include <ipc/ipc.hpp>
 #include <ipc/ccd/ccd.hpp>
+#include <ipc/ccd/ccd_prefilter.hpp>
+#include <ipc/ccd/closed_form_ccd.hpp>
+#include <ipc/ccd/point_sdf.hpp>
 #include <ipc/ccd/point_static_plane.hpp>
+#include <ipc/implicits/plane.hpp>
+#include <ipc/implicits/sdf.hpp>
+#include <ipc/distance/point_plane.hpp>
 
 #include <test_utils.hpp>
 
 #include "collision_generator.hpp"
 
+#include <cstdio>
+
 using namespace ipc;
 
 static const double EPSILON = std::numeric_limits<float>::epsilon();
@@ -684,4 +694,439 @@ TEST_CASE("Squash Tet", "[ccd]")
         ipc::compute_collision_free_stepsize(
             mesh, rest_vertices, deformed_vertices));
     // };
-}
\ No newline at end of file
+}
+TEST_CASE("Point-plane CCD of many points", "[ccd][point-plane]")
+{
+    const int n_points = GENERATE(0, 1, 1000);
+    CAPTURE(n_points);
+
+    Eigen::MatrixXd plane_origins(2, 3), plane_normals(2, 3);
+    plane_origins << 0, -1, 0, //
+        2, 0, 0;
+    plane_normals << 0, 2, 0, //
+        -1, 0, 0;
+
+    // Points above the ground falling or resting
+    Eigen::MatrixXd points_t0 = Eigen::MatrixXd::Random(n_points, 3);
+    Eigen::MatrixXd points_t1 = points_t0;
+    for (int i = 0; i < n_points; i += 2) {
+        points_t1(i, 1) -= 1.5;
+    }
+
+    const auto can_collide = [](size_t vi, size_t) { return vi % 3 != 0; };
+
+    double expected_toi = 1;
+    for (int vi = 0; vi < n_points; vi++) {
+        for (int pi = 0; pi < plane_origins.rows(); pi++) {
+            double toi;
+            if (can_collide(vi, pi)
+                && point_static_plane_ccd(
+                    points_t0.row(vi), points_t1.row(vi),
+                    plane_origins.row(pi), plane_normals.row(pi), toi)) {
+                expected_toi = std::min(expected_toi, toi);
+            }
+        }
+    }
+
+    const double toi = compute_point_plane_collision_free_stepsize(
+        points_t0, points_t1, plane_origins, plane_normals, can_collide);
+    CHECK(toi == expected_toi);
+    CHECK(
+        is_step_point_plane_collision_free(
+            points_t0, points_t1, plane_origins, plane_normals, can_collide)
+        == (expected_toi == 1));
+
+    const double dhat = 0.1;
+    std::vector<PlaneVertexConstraint> constraints;
+    construct_point_plane_constraint_set(
+        points_t1, plane_origins, plane_normals, dhat, constraints);
+
+    size_t expected_num_constraints = 0;
+    for (int vi = 0; vi < n_points; vi++) {
+        for (int pi = 0; pi < plane_origins.rows(); pi++) {
+            expected_num_constraints += point_plane_distance(
+                                            points_t1.row(vi),
+                                            plane_origins.row(pi),
+                                            plane_normals.row(pi))
+                < dhat * dhat;
+        }
+    }
+    CHECK(constraints.size() == expected_num_constraints);
+    for (size_t i = 1; i < constraints.size(); i++) {
+        CHECK(constraints[i - 1].vertex_id <= constraints[i].vertex_id);
+    }
+}
+
+namespace {
+/// Sphere of the given radius sampled on [-1, 1]³
+std::shared_ptr<GridSDF> sphere_grid_sdf(const double radius, const int n)
+{
+    const double spacing = 2.0 / (n - 1);
+    Eigen::VectorXd values(n * n * n);
+    for (int z = 0, i = 0; z < n; z++) {
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n; x++, i++) {
+                values[i] =
+                    (spacing * Eigen::Vector3d(x, y, z).array() - 1.0)
+                        .matrix()
+                        .norm()
+                    - radius;
+            }
+        }
+    }
+    return std::make_shared<GridSDF>(
+        Eigen::Vector3d::Constant(-1), spacing, Eigen::Array3i::Constant(n),
+        values);
+}
+} // namespace
+
+TEST_CASE("Point-SDF CCD", "[ccd][sdf]")
+{
+    const double radius = 0.5, spacing = 0.05;
+    const auto sdf = sphere_grid_sdf(radius, 41);
+    REQUIRE(sdf->spacing() == Catch::Approx(spacing));
+    CHECK(sdf->lipschitz_constant() >= 1);
+
+    SECTION("Evaluation")
+    {
+        for (int i = 0; i < 100; i++) {
+            // Outside of the grid the field is only an upper bound.
+            const Eigen::Vector3d p = 1.5 * Eigen::Vector3d::Random();
+            CAPTURE(p.transpose());
+            if (p.array().abs().maxCoeff() <= 1) {
+                CHECK(
+                    sdf->signed_distance(p)
+                    == Catch::Approx(p.norm() - radius).margin(spacing));
+            } else {
+                CHECK(sdf->signed_distance(p) >= p.norm() - radius - spacing);
+            }
+
+            // Central differences of the signed distance
+            const double h = 1e-7;
+            Eigen::Vector3d fgrad;
+            for (int j = 0; j < 3; j++) {
+                const Eigen::Vector3d dp = h * Eigen::Vector3d::Unit(j);
+                fgrad[j] = (sdf->signed_distance(p + dp)
+                            - sdf->signed_distance(p - dp))
+                    / (2 * h);
+            }
+            CHECK((sdf->signed_distance_gradient(p) - fgrad).norm() < 1e-5);
+        }
+
+        const std::string filename = "test_grid_sdf.bin";
+        sdf->save(filename);
+        const GridSDF loaded = GridSDF::load(filename);
+        std::remove(filename.c_str());
+        CHECK(loaded.values() == sdf->values());
+        CHECK(loaded.origin() == sdf->origin());
+        CHECK(loaded.resolution().matrix() == sdf->resolution().matrix());
+        CHECK(loaded.spacing() == sdf->spacing());
+    }
+
+    SECTION("Single point")
+    {
+        const Eigen::Vector3d p_t0(0, 0, 2);
+        double toi;
+        CHECK(point_sdf_ccd(p_t0, Eigen::Vector3d::Zero(), *sdf, toi));
+        CHECK(toi > 0);
+        CHECK(toi < 1);
+        CHECK(
+            sdf->signed_distance(p_t0 * (1 - toi))
+            >= (1 - DEFAULT_CCD_CONSERVATIVE_RESCALING)
+                * sdf->signed_distance(p_t0));
+
+        CHECK(!point_sdf_ccd(p_t0, Eigen::Vector3d(0, 0, 3), *sdf, toi));
+        CHECK(!point_sdf_ccd(p_t0, Eigen::Vector3d(1, 0, 2), *sdf, toi));
+    }
+
+    SECTION("Many points")
+    {
+        const int n_points = GENERATE(0, 1, 1000);
+        CAPTURE(n_points);
+
+        // Points around the sphere, half moving through its center
+        Eigen::MatrixXd points_t0(n_points, 3);
+        for (int i = 0; i < n_points; i++) {
+            points_t0.row(i) = (0.6 + 0.5 * double(i) / n_points)
+                * Eigen::Vector3d::Random().normalized();
+        }
+        Eigen::MatrixXd points_t1 = points_t0;
+        for (int i = 0; i < n_points; i += 2) {
+            points_t1.row(i) *= -1;
+        }
+
+        const auto can_collide = [](size_t vi) { return vi % 3 != 0; };
+
+        double expected_toi = 1;
+        for (int vi = 0; vi < n_points; vi++) {
+            double toi;
+            if (can_collide(vi)
+                && point_sdf_ccd(
+                    points_t0.row(vi), points_t1.row(vi), *sdf, toi)) {
+                expected_toi = std::min(expected_toi, toi);
+            }
+        }
+
+        const double toi = compute_point_sdf_collision_free_stepsize(
+            points_t0, points_t1, *sdf, can_collide);
+        CHECK(toi == expected_toi);
+        CHECK(
+            is_step_point_sdf_collision_free(
+                points_t0, points_t1, *sdf, can_collide)
+            == (expected_toi == 1));
+
+        const double dhat = 0.2;
+        std::vector<SDFVertexConstraint> constraints;
+        construct_point_sdf_constraint_set(points_t0, sdf, dhat, constraints);
+
+        size_t expected_num_constraints = 0;
+        for (int vi = 0; vi < n_points; vi++) {
+            expected_num_constraints +=
+                std::abs(sdf->signed_distance(points_t0.row(vi))) < dhat;
+        }
+        CHECK(constraints.size() == expected_num_constraints);
+        for (size_t i = 1; i < constraints.size(); i++) {
+            CHECK(constraints[i - 1].vertex_id < constraints[i].vertex_id);
+        }
+    }
+}
+
+TEST_CASE("SDF-vertex constraint derivatives", "[sdf][collisions]")
+{
+    const double radius = 0.5, spacing = 0.05, dhat = 0.2;
+    const auto sdf = sphere_grid_sdf(radius, 41);
+
+    // The interpolation is only smooth inside a grid cell, so keep the point
+    // near the center of the cell containing it.
+    const int i = GENERATE(range(0, 20));
+    CAPTURE(i);
+    Eigen::Vector3d p = (radius + 0.1) * Eigen::Vector3d::Random().normalized();
+    p = spacing * (((p.array() + 1) / spacing).floor() + 0.5).matrix()
+        + 0.2 * spacing * Eigen::Vector3d::Random() - Eigen::Vector3d::Ones();
+
+    const Eigen::MatrixXd V = p.transpose();
+    const Eigen::MatrixXi E, F;
+    const SDFVertexConstraint constraint(sdf, 0);
+    REQUIRE(constraint.compute_potential(V, E, F, dhat) > 0);
+
+    const Eigen::VectorXd grad =
+        constraint.compute_potential_gradient(V, E, F, dhat);
+    auto f = [&](const Eigen::VectorXd& x) {
+        return constraint.compute_potential(
+            fd::unflatten(x, V.cols()), E, F, dhat);
+    };
+    Eigen::VectorXd fgrad;
+    fd::finite_gradient(fd::flatten(V), f, fgrad);
+    CHECK(fd::compare_gradient(grad, fgrad));
+
+    const Eigen::MatrixXd hess = constraint.compute_potential_hessian(
+        V, E, F, dhat, /*project_hessian_to_psd=*/false);
+    auto g = [&](const Eigen::VectorXd& x) -> Eigen::VectorXd {
+        return constraint.compute_potential_gradient(
+            fd::unflatten(x, V.cols()), E, F, dhat);
+    };
+    Eigen::MatrixXd fhess;
+    fd::finite_jacobian(fd::flatten(V), g, fhess);
+    CHECK(fd::compare_hessian(hess, fhess, 1e-3));
+}
+
+TEST_CASE("Closed-form point-point CCD", "[ccd][closed-form]")
+{
+    const double min_distance = GENERATE(0.0, 1e-4, 0.1);
+    const double tmax = GENERATE(1.0, 0.5);
+
+    // Head-on collision at speed 2 from a distance of 1.
+    const Eigen::Vector3d p0_t0(0, 0, 0), p1_t0(1, 0, 0);
+    const Eigen::Vector3d p0_t1(1, 0, 0), p1_t1(0, 0, 0);
+    const double expected_toi = (1 - min_distance) / 2;
+
+    double toi = -1;
+    const ClosedFormCCDResult result = closed_form_point_point_ccd(
+        p0_t0, p1_t0, p0_t1, p1_t1, toi, min_distance, tmax);
+    if (expected_toi <= tmax) {
+        REQUIRE(result == ClosedFormCCDResult::IMPACT);
+        CHECK(toi <= expected_toi);
+        CHECK(toi == Catch::Approx(expected_toi).margin(1e-12));
+    } else {
+        CHECK(result == ClosedFormCCDResult::NO_IMPACT);
+    }
+
+    // Parallel motion never gets closer.
+    CHECK(
+        closed_form_point_point_ccd(
+            p0_t0, p1_t0, Eigen::Vector3d(0, 1, 0), Eigen::Vector3d(1, 1, 0),
+            toi, min_distance, tmax)
+        == ClosedFormCCDResult::NO_IMPACT);
+
+    // Initially in contact is left to the robust CCD.
+    CHECK(
+        closed_form_point_point_ccd(
+            p0_t0, p0_t0, p0_t1, p1_t1, toi, min_distance, tmax)
+        == ClosedFormCCDResult::UNCERTAIN);
+}
+
+TEST_CASE("Closed-form point-edge 2D CCD", "[ccd][closed-form]")
+{
+    const double min_distance = GENERATE(0.0, 1e-4);
+    const double tolerance = 1e-6;
+
+    const Eigen::Vector2d e0(-1, 0), e1(1, 0);
+    double toi = -1;
+
+    SECTION("Point falls onto the edge")
+    {
+        const double x = GENERATE(-0.5, 0.0, 0.9);
+        const ClosedFormCCDResult result = closed_form_point_edge_ccd_2D(
+            Eigen::Vector2d(x, 1), e0, e1, Eigen::Vector2d(x, -1), e0, e1, toi,
+            min_distance, /*tmax=*/1.0, tolerance);
+        const double expected_toi = (1 - min_distance) / 2;
+        REQUIRE(result == ClosedFormCCDResult::IMPACT);
+        CHECK(toi <= expected_toi);
+        CHECK(toi == Catch::Approx(expected_toi).margin(1e-12));
+
+        // Agrees with the full CCD (up to its conservative rescaling).
+        double ccd_toi;
+        CHECK(point_edge_ccd_2D(
+            Eigen::Vector2d(x, 1), e0, e1, Eigen::Vector2d(x, -1), e0, e1,
+            ccd_toi, min_distance));
+        CHECK(ccd_toi <= 0.5);
+    }
+
+    SECTION("Point stops short of the edge")
+    {
+        CHECK(
+            closed_form_point_edge_ccd_2D(
+                Eigen::Vector2d(0, 1), e0, e1, Eigen::Vector2d(0, 0.5), e0, e1,
+                toi, min_distance, /*tmax=*/1.0, tolerance)
+            == ClosedFormCCDResult::NO_IMPACT);
+    }
+
+    SECTION("Point passes beyond the end of the edge")
+    {
+        // The point crosses the line but not the edge, so the filter cannot
+        // certify the result.
+        CHECK(
+            closed_form_point_edge_ccd_2D(
+                Eigen::Vector2d(3, 1), e0, e1, Eigen::Vector2d(3, -1), e0, e1,
+                toi, min_distance, /*tmax=*/1.0, tolerance)
+            == ClosedFormCCDResult::UNCERTAIN);
+
+        double ccd_toi;
+        CHECK(!point_edge_ccd_2D(
+            Eigen::Vector2d(3, 1), e0, e1, Eigen::Vector2d(3, -1), e0, e1,
+            ccd_toi, min_distance));
+    }
+}
+
+TEST_CASE("CCD prefilters", "[ccd][prefilter]")
+{
+    const double min_distance = GENERATE(0.0, 1e-3);
+    CAPTURE(min_distance);
+
+    SECTION("Point-triangle")
+    {
+        Eigen::MatrixXd V0(4, 3), V1;
+        V0 << 0, 1, 0, // point
+            -1, 0, -1, // triangle
+            1, 0, -1, //
+            0, 0, 1;
+        V1 = V0;
+        const std::array<long, 4> ids = { { 0, 1, 2, 3 } };
+
+        // The point moves toward but stays above the triangle.
+        V1(0, 1) = 0.5;
+        CHECK(separating_axis_ccd_prefilter(V0, V1, ids, 1, min_distance));
+        CHECK(coplanarity_ccd_prefilter(
+            V0.row(2) - V0.row(1), V0.row(3) - V0.row(1),
+            V0.row(0) - V0.row(1), V1.row(2) - V1.row(1),
+            V1.row(3) - V1.row(1), V1.row(0) - V1.row(1), min_distance));
+
+        // The point passes through the triangle.
+        V1(0, 1) = -1;
+        CHECK(
+            apply_ccd_prefilters(
+                V0, V1, ids, 1, min_distance, CCDPrefilterOptions::all())
+            == CCDPrefilterResult::NOT_REJECTED);
+
+        // The point passes through the plane beside the triangle, so only the
+        // separating-axis test rejects it.
+        V0(0, 0) = V1(0, 0) = 3;
+        CHECK(
+            apply_ccd_prefilters(
+                V0, V1, ids, 1, min_distance, CCDPrefilterOptions::all())
+            == CCDPrefilterResult::SEPARATING_AXIS);
+        CHECK(
+            apply_ccd_prefilters(
+                V0, V1, ids, 1, min_distance, { false, true })
+            == CCDPrefilterResult::NOT_REJECTED);
+    }
+
+    SECTION("Edge-edge")
+    {
+        Eigen::MatrixXd V0(4, 3), V1;
+        V0 << -1, 1, 0, // edge a
+            1, 1, 0, //
+            0, 0, -1, // edge b
+            0, 0, 1;
+        V1 = V0;
+        const std::array<long, 4> ids = { { 0, 1, 2, 3 } };
+
+        // Edge a rotates above edge b without crossing its plane.
+        V1.row(0) << -1, 0.5, 1;
+        V1.row(1) << 1, 0.5, -1;
+        CHECK(
+            apply_ccd_prefilters(
+                V0, V1, ids, 2, min_distance, CCDPrefilterOptions::all())
+            != CCDPrefilterResult::NOT_REJECTED);
+        CHECK(
+            apply_ccd_prefilters(
+                V0, V1, ids, 2, min_distance, { false, true })
+            == CCDPrefilterResult::COPLANARITY);
+
+        // Edge a passes through edge b.
+        V1.row(0) << -1, -1, 0;
+        V1.row(1) << 1, -1, 0;
+        CHECK(
+            apply_ccd_prefilters(
+                V0, V1, ids, 2, min_distance, CCDPrefilterOptions::all())
+            == CCDPrefilterResult::NOT_REJECTED);
+    }
+
+    SECTION("Collision-free step size")
+    {
+        Eigen::MatrixXd V;
+        Eigen::MatrixXi E, F;
+        REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+        const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+        V = mesh.vertices(V);
+
+        Eigen::MatrixXd V1 = V;
+        V1.col(1) *= -1;
+
+        Candidates candidates;
+        candidates.build(mesh, V, V1, /*inflation_radius=*/min_distance);
+        REQUIRE(candidates.size() > 0);
+
+        CCDPrefilterStatistics statistics;
+        const double step = candidates.compute_collision_free_stepsize(
+            mesh, V, V1, min_distance, DEFAULT_CCD_TOLERANCE,
+            DEFAULT_CCD_MAX_ITERATIONS, CCDPrefilterOptions::all(),
+            &statistics);
+
+        CHECK(
+            step
+            == Catch::Approx(candidates.compute_collision_free_stepsize(
+                                 mesh, V, V1, min_distance))
+                   .margin(1e-3));
+        CHECK(statistics.num_candidates == candidates.size());
+        CHECK(statistics.num_rejections() > 0);
+        CHECK(statistics.num_rejections() < statistics.num_candidates);
+
+        CHECK(
+            candidates.is_step_collision_free(
+                mesh, V, V1, min_distance, DEFAULT_CCD_TOLERANCE,
+                DEFAULT_CCD_MAX_ITERATIONS, CCDPrefilterOptions::all())
+            == candidates.is_step_collision_free(mesh, V, V1, min_distance));
+    }
+}
@@ -0,0 +1,137 @@
+#include <catch2/catch_all.hpp>
+
+#include <ipc/distance/batched_distance.hpp>
+#include <ipc/distance/line_line.hpp>
+#include <ipc/distance/point_line.hpp>
+#include <ipc/distance/point_plane.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <functional>
+#include <vector>
+
+using namespace ipc;
+
+namespace {
+using BatchedKernel = std::function<void(
+    size_t, const double*, double*, double*, double*)>;
+using DistanceFunction = std::function<double(const Eigen::VectorXd&)>;
+using GradientFunction = std::function<VectorMax12d(const Eigen::VectorXd&)>;
+using HessianFunction = std::function<MatrixMax12d(const Eigen::VectorXd&)>;
+
+void check_batched_kernel(
+    const int ndof,
+    const BatchedKernel& kernel,
+    const DistanceFunction& distance,
+    const GradientFunction& gradient,
+    const HessianFunction& hessian)
+{
+    const size_t n = 37; // not a multiple of the vector width
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(ndof, n);
+
+    std::vector<double> x(ndof * n), d(n), g(ndof * n),
+        H(ndof * (ndof + 1) / 2 * n);
+    for (size_t i = 0; i < n; i++) {
+        for (int j = 0; j < ndof; j++) {
+            x[j * n + i] = X(j, i);
+        }
+    }
+
+    kernel(n, x.data(), d.data(), g.data(), H.data());
+
+    for (size_t i = 0; i < n; i++) {
+        const Eigen::VectorXd stencil = X.col(i);
+        CHECK(d[i] == Catch::Approx(distance(stencil)));
+
+        const VectorMax12d expected_grad = gradient(stencil);
+        const MatrixMax12d expected_hess = hessian(stencil);
+        for (int j = 0, k = 0; j < ndof; j++) {
+            CHECK(
+                g[j * n + i]
+                == Catch::Approx(expected_grad[j]).margin(1e-10));
+            for (int l = 0; l <= j; l++, k++) {
+                CHECK(
+                    H[k * n + i]
+                    == Catch::Approx(expected_hess(l, j)).margin(1e-10));
+            }
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("Batched distance kernels", "[distance][batched]")
+{
+    SECTION("Point-plane")
+    {
+        check_batched_kernel(
+            12, autogen::point_plane_distance_derivatives_batched,
+            [](const Eigen::VectorXd& x) {
+                return point_plane_distance(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                    x.segment<3>(9));
+            },
+            [](const Eigen::VectorXd& x) -> VectorMax12d {
+                return point_plane_distance_gradient(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                    x.segment<3>(9));
+            },
+            [](const Eigen::VectorXd& x) -> MatrixMax12d {
+                return point_plane_distance_hessian(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                    x.segment<3>(9));
+            });
+    }
+    SECTION("Line-line")
+    {
+        check_batched_kernel(
+            12, autogen::line_line_distance_derivatives_batched,
+            [](const Eigen::VectorXd& x) {
+                return line_line_distance(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                    x.segment<3>(9));
+            },
+            [](const Eigen::VectorXd& x) -> VectorMax12d {
+                return line_line_distance_gradient(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                    x.segment<3>(9));
+            },
+            [](const Eigen::VectorXd& x) -> MatrixMax12d {
+                return line_line_distance_hessian(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                    x.segment<3>(9));
+            });
+    }
+    SECTION("Point-line 2D")
+    {
+        check_batched_kernel(
+            6, autogen::point_line_distance_derivatives_batched_2D,
+            [](const Eigen::VectorXd& x) {
+                return point_line_distance(
+                    x.segment<2>(0), x.segment<2>(2), x.segment<2>(4));
+            },
+            [](const Eigen::VectorXd& x) -> VectorMax12d {
+                return point_line_distance_gradient(
+                    x.segment<2>(0), x.segment<2>(2), x.segment<2>(4));
+            },
+            [](const Eigen::VectorXd& x) -> MatrixMax12d {
+                return point_line_distance_hessian(
+                    x.segment<2>(0), x.segment<2>(2), x.segment<2>(4));
+            });
+    }
+    SECTION("Point-line 3D")
+    {
+        check_batched_kernel(
+            9, autogen::point_line_distance_derivatives_batched_3D,
+            [](const Eigen::VectorXd& x) {
+                return point_line_distance(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6));
+            },
+            [](const Eigen::VectorXd& x) -> VectorMax12d {
+                return point_line_distance_gradient(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6));
+            },
+            [](const Eigen::VectorXd& x) -> MatrixMax12d {
+                return point_line_distance_hessian(
+                    x.segment<3>(0), x.segment<3>(3), x.segment<3>(6));
+            });
+    }
+}
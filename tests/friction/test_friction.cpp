@@ -52,6 +52,75 @@ TEST_CASE("Test friction gradient and hessian", "[friction][gradient][hessian]")
     CHECK(fd::compare_hessian(hess, fhess, 1e-3));
 }
 
+TEST_CASE("Test friction unassembled local derivatives", "[friction][local]")
+{
+    const bool project_hessian_to_psd = GENERATE(true, false);
+
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, collision_constraints, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    const Eigen::MatrixXd U = V1 - V0;
+
+    const CollisionMesh mesh(V0, E, F);
+
+    FrictionConstraints friction_constraints;
+    friction_constraints.build(
+        mesh, V0, collision_constraints, dhat, barrier_stiffness, mu);
+    REQUIRE(friction_constraints.size() > 0);
+
+    const int dim = U.cols(), m = 4 * dim;
+    const size_t n = friction_constraints.size();
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        local_grads(n, m), local_hessians(n, m * m);
+    LocalVertexIds grad_ids(n, 4), hess_ids(n, 4);
+    friction_constraints.compute_potential_local_gradients(
+        mesh, U, epsv_times_h, local_grads, grad_ids);
+    friction_constraints.compute_potential_local_hessians(
+        mesh, U, epsv_times_h, local_hessians, hess_ids,
+        project_hessian_to_psd);
+    CHECK(grad_ids == hess_ids);
+
+    // Scatter the local values into global ones.
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(U.size());
+    Eigen::MatrixXd hess = Eigen::MatrixXd::Zero(U.size(), U.size());
+    for (size_t c = 0; c < n; c++) {
+        const Eigen::Map<const Eigen::MatrixXd> local_hess(
+            local_hessians.row(c).data(), m, m);
+        for (int i = 0; i < 4; i++) {
+            if (grad_ids(c, i) < 0) {
+                CHECK(local_grads.row(c).segment(dim * i, dim).isZero());
+                continue;
+            }
+            grad.segment(dim * grad_ids(c, i), dim) +=
+                local_grads.row(c).segment(dim * i, dim);
+            for (int j = 0; j < 4; j++) {
+                if (grad_ids(c, j) >= 0) {
+                    hess.block(
+                        dim * grad_ids(c, i), dim * grad_ids(c, j), dim,
+                        dim) += local_hess.block(dim * i, dim * j, dim, dim);
+                }
+            }
+        }
+    }
+
+    const Eigen::VectorXd expected_grad =
+        friction_constraints.compute_potential_gradient(mesh, U, epsv_times_h);
+    const Eigen::MatrixXd expected_hess =
+        friction_constraints.compute_potential_hessian(
+            mesh, U, epsv_times_h, project_hessian_to_psd);
+    CHECK(grad.isApprox(expected_grad, 1e-12));
+    CHECK(hess.isApprox(expected_hess, 1e-12));
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        too_small(n - 1, m);
+    CHECK_THROWS_AS(
+        friction_constraints.compute_potential_local_gradients(
+            mesh, U, epsv_times_h, too_small, grad_ids),
+        std::invalid_argument);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void mmcvids_to_friction_constraints(
@@ -0,0 +1,134 @@
+#include <catch2/catch_all.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/utils/deterministic_reduction.hpp>
+
+#include "test_utils.hpp"
+
+#include <tbb/task_arena.h>
+
+using namespace ipc;
+
+TEST_CASE("Pairwise sum", "[determinism]")
+{
+    const int n = GENERATE(0, 1, 7, 8, 9, 100, 1000, 12345);
+
+    std::vector<double> values(n);
+    double expected = 0;
+    for (int i = 0; i < n; i++) {
+        values[i] = 1.0 / (i + 1);
+        expected += values[i];
+    }
+
+    CHECK(pairwise_sum(values.data(), n) == Catch::Approx(expected));
+    CHECK(
+        deterministic_parallel_sum(values.size(), [&](size_t i) {
+            return values[i];
+        }) == pairwise_sum(values.data(), n));
+}
+
+TEST_CASE("Bitwise reproducible potentials", "[determinism][ipc]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+
+    const double dhat = 1e-1;
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    struct Result {
+        Candidates candidates;
+        double potential;
+        Eigen::VectorXd gradient;
+        Eigen::SparseMatrix<double> hessian;
+    };
+
+    const auto evaluate = [&]() {
+        Result result;
+        result.candidates.build(mesh, V, dhat / 2, method);
+
+        CollisionConstraints constraints;
+        constraints.build(result.candidates, mesh, V, dhat);
+        result.potential = constraints.compute_potential(mesh, V, dhat);
+        result.gradient = constraints.compute_potential_gradient(mesh, V, dhat);
+        result.hessian = constraints.compute_potential_hessian(mesh, V, dhat);
+        return result;
+    };
+
+    Result serial;
+    tbb::task_arena(1).execute([&]() { serial = evaluate(); });
+    const Result parallel = evaluate();
+
+    REQUIRE(serial.candidates.size() > 0);
+    REQUIRE(serial.candidates.size() == parallel.candidates.size());
+    CHECK(
+        serial.candidates.ev_candidates == parallel.candidates.ev_candidates);
+    CHECK(
+        serial.candidates.ee_candidates == parallel.candidates.ee_candidates);
+    CHECK(
+        serial.candidates.fv_candidates == parallel.candidates.fv_candidates);
+
+    CHECK(serial.potential == parallel.potential);
+    CHECK(serial.gradient == parallel.gradient);
+    CHECK(
+        Eigen::MatrixXd(serial.hessian) == Eigen::MatrixXd(parallel.hessian));
+}
+
+TEST_CASE("Bitwise reproducible friction", "[determinism][friction]")
+{
+    const double dhat = 1e-1, barrier_stiffness = 1e3, mu = 0.5, epsv = 1e-3;
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    // Tangential sliding with a per-vertex perturbation.
+    Eigen::MatrixXd velocity(V.rows(), V.cols());
+    for (int i = 0; i < V.rows(); i++) {
+        velocity.row(i) << 1e-3 * std::sin(i), 1e-3 * std::cos(i), 1e-4;
+    }
+
+    struct Result {
+        size_t num_constraints;
+        double potential;
+        Eigen::VectorXd gradient;
+        Eigen::SparseMatrix<double> hessian;
+    };
+
+    const auto evaluate = [&]() {
+        Result result;
+
+        CollisionConstraints constraints;
+        constraints.build(mesh, V, dhat);
+
+        FrictionConstraints friction_constraints;
+        friction_constraints.build(
+            mesh, V, constraints, dhat, barrier_stiffness, mu);
+
+        result.num_constraints = friction_constraints.size();
+        result.potential =
+            friction_constraints.compute_potential(mesh, velocity, epsv);
+        result.gradient = friction_constraints.compute_potential_gradient(
+            mesh, velocity, epsv);
+        result.hessian = friction_constraints.compute_potential_hessian(
+            mesh, velocity, epsv, /*project_hessian_to_psd=*/true);
+        return result;
+    };
+
+    Result serial;
+    tbb::task_arena(1).execute([&]() { serial = evaluate(); });
+    const Result parallel = evaluate();
+
+    REQUIRE(serial.num_constraints > 0);
+    REQUIRE(serial.num_constraints == parallel.num_constraints);
+
+    CHECK(serial.potential == parallel.potential);
+    CHECK(serial.gradient == parallel.gradient);
+    CHECK(
+        Eigen::MatrixXd(serial.hessian) == Eigen::MatrixXd(parallel.hessian));
+}
@@ -15,6 +15,8 @@
 
 #include <Eigen/Geometry>
 
+#include <algorithm>
+
 using namespace ipc;
 
 Eigen::MatrixXi remove_faces_with_degenerate_edges(
@@ -199,3 +201,70 @@ TEST_CASE("Test has_intersections()", "[intersection][thisone]")
     CAPTURE(mesh1_name, mesh2_name, R1, R2);
     CHECK(has_intersections(CollisionMesh(V, E, F), V));
 }
+
+TEST_CASE("Test find_intersections()", "[intersection]")
+{
+    std::string mesh_name = GENERATE("cube.obj", "bunny.obj");
+    int dim = GENERATE(2, 3);
+
+    Eigen::Matrix3d R1 = GENERATE(take(2, RotationGenerator::create()));
+    Eigen::Matrix3d R2 = GENERATE(take(2, RotationGenerator::create()));
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = combine_meshes(mesh_name, mesh_name, R1, R2, dim, V, E, F);
+    REQUIRE(success);
+
+    CAPTURE(mesh_name, R1, R2);
+
+    const CollisionMesh mesh(V, E, F);
+
+    std::vector<EdgeEdgeCandidate> ee_intersections;
+    std::vector<EdgeFaceCandidate> ef_intersections;
+    find_intersections(mesh, V, ee_intersections, ef_intersections);
+
+    CHECK(has_intersections(mesh, V));
+    if (dim == 2) {
+        CHECK(!ee_intersections.empty());
+        CHECK(ef_intersections.empty());
+        CHECK(std::is_sorted(ee_intersections.begin(), ee_intersections.end()));
+        for (const auto& [ea_id, eb_id] : ee_intersections) {
+            CHECK(igl::predicates::segment_segment_intersect(
+                V.row(E(ea_id, 0)).head<2>(), V.row(E(ea_id, 1)).head<2>(),
+                V.row(E(eb_id, 0)).head<2>(), V.row(E(eb_id, 1)).head<2>()));
+        }
+    } else {
+        CHECK(ee_intersections.empty());
+        CHECK(!ef_intersections.empty());
+        CHECK(std::is_sorted(ef_intersections.begin(), ef_intersections.end()));
+        for (const auto& [e_id, f_id] : ef_intersections) {
+            CHECK(is_edge_intersecting_triangle(
+                V.row(E(e_id, 0)), V.row(E(e_id, 1)), V.row(F(f_id, 0)),
+                V.row(F(f_id, 1)), V.row(F(f_id, 2))));
+        }
+    }
+}
+
+TEST_CASE("Edge-triangle intersection", "[intersection]")
+{
+    const Eigen::Vector3d t0(0, 0, 0), t1(1, 0, 0), t2(0, 1, 0);
+
+    // Generic cases are decided by the floating-point filter
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.25, 0.25, -1), Eigen::Vector3d(0.25, 0.25, 1), t0,
+        t1, t2));
+    CHECK(!is_edge_intersecting_triangle(
+        Eigen::Vector3d(1, 1, -1), Eigen::Vector3d(1, 1, 1), t0, t1, t2));
+    CHECK(!is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.25, 0.25, 0.5), Eigen::Vector3d(0.25, 0.25, 1), t0,
+        t1, t2));
+
+    // Degenerate cases fall back to the exact test
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.5, 0, -1), Eigen::Vector3d(0.5, 0, 1), t0, t1, t2));
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0, 0, -1), Eigen::Vector3d(0, 0, 1), t0, t1, t2));
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.25, 0.25, 0), Eigen::Vector3d(0.25, 0.25, 1), t0,
+        t1, t2));
+}
@@ -7,6 +7,9 @@
 
 #include <ipc/ipc.hpp>
 #include <ipc/config.hpp>
+#include <ipc/distance/distance_type.hpp>
+#include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/world_bbox_diagonal_length.hpp>
 
 #include "test_utils.hpp"
 
@@ -202,6 +205,51 @@ TEST_CASE("Test IPC full hessian", "[ipc][hessian]")
     CHECK(fd::compare_hessian(hess_b, fhess_b, 1e-3));
 }
 
+TEST_CASE("Test batched edge-edge hessian", "[ipc][hessian][batched]")
+{
+    // Edge 0 crosses edge 1 (closest between the interiors) and is parallel
+    // to edge 2 (mollified and closest at the endpoints).
+    Eigen::MatrixXd V(6, 3);
+    V << -1, 0, 0, /**/ 1, 0, 0, /**/ 0, -1, 0.05, /**/ 0, 1, 0.05,
+        /**/ -1, 0, -0.05, /**/ 1, 0, -0.05;
+    Eigen::MatrixXi E(3, 2);
+    E << 0, 1, /**/ 2, 3, /**/ 4, 5;
+    const Eigen::MatrixXi F;
+    const CollisionMesh mesh(V, E, F);
+    const double dhat = 0.08;
+
+    CollisionConstraints collision_constraints;
+    collision_constraints.build(
+        mesh, V, dhat, /*dmin=*/0, BroadPhaseMethod::BRUTE_FORCE);
+    REQUIRE(collision_constraints.ee_constraints.size() == 2);
+
+    std::vector<EdgeEdgeDistanceType> dtypes;
+    for (const auto& ee : collision_constraints.ee_constraints) {
+        const auto& [ea0, ea1, eb0, eb1] = ee.vertices(V, E, F);
+        dtypes.push_back(edge_edge_distance_type(ea0, ea1, eb0, eb1));
+    }
+    CHECK(
+        std::count(dtypes.begin(), dtypes.end(), EdgeEdgeDistanceType::EA_EB)
+        == 1);
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (const auto& ee : collision_constraints.ee_constraints) {
+        local_hessian_to_global_triplets(
+            ee.compute_potential_hessian(
+                V, E, F, dhat, /*project_hessian_to_psd=*/false),
+            ee.vertex_ids(E, F), V.cols(), triplets);
+    }
+    Eigen::SparseMatrix<double> expected(V.size(), V.size());
+    expected.setFromTriplets(triplets.begin(), triplets.end());
+
+    const Eigen::SparseMatrix<double> hess =
+        collision_constraints.compute_potential_hessian(
+            mesh, V, dhat, /*project_hessian_to_psd=*/false);
+
+    REQUIRE(expected.norm() > 0);
+    CHECK((hess - expected).norm() <= 1e-10 * expected.norm());
+}
+
 TEST_CASE("Test IPC shape derivative", "[ipc][shape_opt]")
 {
     nlohmann::json data;
@@ -310,4 +358,538 @@ TEST_CASE("Benchmark IPC shape derivative", "[ipc][shape_opt][!benchmark]")
         JF_wrt_X =
             collision_constraints.compute_shape_derivative(mesh, V, dhat);
     };
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test batched collision constraints", "[ipc][batched]")
+{
+    const double dhat = 1e-1;
+
+    std::vector<CollisionMesh> meshes;
+    std::vector<Eigen::MatrixXd> vertices;
+    for (const std::string mesh_name :
+         { "cube.obj", "two-cubes-close.obj", "two-cubes-far.obj" }) {
+        Eigen::MatrixXd V;
+        Eigen::MatrixXi E, F;
+        REQUIRE(load_mesh(mesh_name, V, E, F));
+
+        meshes.push_back(CollisionMesh::build_from_full_mesh(V, E, F));
+        vertices.push_back(meshes.back().vertices(V));
+    }
+
+    BatchedCollisionConstraints batch;
+    batch.build(meshes, vertices, dhat);
+    REQUIRE(batch.size() == meshes.size());
+
+    const Eigen::VectorXd potentials =
+        batch.compute_potential(meshes, vertices, dhat);
+    const std::vector<Eigen::VectorXd> gradients =
+        batch.compute_potential_gradient(meshes, vertices, dhat);
+    const std::vector<Eigen::SparseMatrix<double>> hessians =
+        batch.compute_potential_hessian(meshes, vertices, dhat);
+
+    for (size_t i = 0; i < meshes.size(); i++) {
+        CollisionConstraints constraints;
+        constraints.build(meshes[i], vertices[i], dhat);
+        CHECK(batch[i].size() == constraints.size());
+
+        CHECK(
+            potentials[i]
+            == constraints.compute_potential(meshes[i], vertices[i], dhat));
+        CHECK(
+            gradients[i]
+            == constraints.compute_potential_gradient(
+                meshes[i], vertices[i], dhat));
+        CHECK(
+            Eigen::MatrixXd(hessians[i])
+            == Eigen::MatrixXd(constraints.compute_potential_hessian(
+                meshes[i], vertices[i], dhat)));
+    }
+
+    meshes.pop_back();
+    CHECK_THROWS_AS(
+        batch.compute_potential(meshes, vertices, dhat), std::runtime_error);
+}
+
+TEST_CASE("Test unassembled local derivatives", "[ipc][local]")
+{
+    const double dhat = 1e-1;
+    const bool use_convergent_formulation = GENERATE(true, false);
+    const bool project_hessian_to_psd = GENERATE(true, false);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+    const int dim = V.cols(), m = 4 * dim;
+
+    CollisionConstraints constraints;
+    constraints.set_use_convergent_formulation(use_convergent_formulation);
+    constraints.build(mesh, V, dhat);
+    REQUIRE(constraints.size() > 0);
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        local_grads(constraints.size(), m), local_hessians(
+                                                constraints.size(), m * m);
+    LocalVertexIds grad_ids(constraints.size(), 4),
+        hess_ids(constraints.size(), 4);
+    constraints.compute_potential_local_gradients(
+        mesh, V, dhat, local_grads, grad_ids);
+    constraints.compute_potential_local_hessians(
+        mesh, V, dhat, local_hessians, hess_ids, project_hessian_to_psd);
+    CHECK(grad_ids == hess_ids);
+
+    // Scatter the local values into global ones.
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
+    Eigen::MatrixXd hess = Eigen::MatrixXd::Zero(V.size(), V.size());
+    for (size_t c = 0; c < constraints.size(); c++) {
+        const Eigen::Map<const Eigen::MatrixXd> local_hess(
+            local_hessians.row(c).data(), m, m);
+        for (int i = 0; i < 4; i++) {
+            if (grad_ids(c, i) < 0) {
+                CHECK(local_grads.row(c).segment(dim * i, dim).isZero());
+                continue;
+            }
+            grad.segment(dim * grad_ids(c, i), dim) +=
+                local_grads.row(c).segment(dim * i, dim);
+            for (int j = 0; j < 4; j++) {
+                if (grad_ids(c, j) >= 0) {
+                    hess.block(
+                        dim * grad_ids(c, i), dim * grad_ids(c, j), dim,
+                        dim) += local_hess.block(dim * i, dim * j, dim, dim);
+                }
+            }
+        }
+    }
+
+    const Eigen::VectorXd expected_grad =
+        constraints.compute_potential_gradient(mesh, V, dhat);
+    const Eigen::MatrixXd expected_hess =
+        constraints.compute_potential_hessian(
+            mesh, V, dhat, project_hessian_to_psd);
+    CHECK(grad.isApprox(expected_grad, 1e-12));
+    CHECK(hess.isApprox(expected_hess, 1e-12));
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        too_small(constraints.size() - 1, m);
+    CHECK_THROWS_AS(
+        constraints.compute_potential_local_gradients(
+            mesh, V, dhat, too_small, grad_ids),
+        std::invalid_argument);
+}
+
+TEST_CASE("Test upper triangular hessian", "[ipc][hessian]")
+{
+    const double dhat = 1e-1;
+    const bool project_hessian_to_psd = GENERATE(true, false);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    CollisionConstraints constraints;
+    constraints.build(mesh, V, dhat);
+    REQUIRE(constraints.size() > 0);
+
+    const Eigen::SparseMatrix<double> hess =
+        constraints.compute_potential_hessian(
+            mesh, V, dhat, project_hessian_to_psd);
+    const Eigen::SparseMatrix<double> upper_hess =
+        constraints.compute_potential_hessian(
+            mesh, V, dhat, project_hessian_to_psd, /*upper_triangular=*/true);
+
+    CHECK(Eigen::SparseMatrix<double>(upper_hess.triangularView<Eigen::Upper>())
+              .nonZeros()
+          == upper_hess.nonZeros());
+    CHECK(upper_hess.nonZeros() < hess.nonZeros());
+
+    // Sparse self-adjoint views can only be evaluated into sparse matrices.
+    const Eigen::SparseMatrix<double> full_from_upper =
+        upper_hess.selfadjointView<Eigen::Upper>();
+    CHECK(Eigen::MatrixXd(full_from_upper)
+              .isApprox(Eigen::MatrixXd(hess), 1e-12));
+}
+
+TEST_CASE("Test vertex-centric derivatives", "[ipc][vertex]")
+{
+    const double dhat = 1e-1;
+    const bool project_hessian_to_psd = GENERATE(true, false);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+    const int dim = V.cols();
+
+    CollisionConstraints constraints;
+    constraints.build(mesh, V, dhat);
+    REQUIRE(constraints.size() > 0);
+
+    const Eigen::VectorXd expected_grad =
+        constraints.compute_potential_gradient(mesh, V, dhat);
+    const Eigen::MatrixXd expected_hess = constraints.compute_potential_hessian(
+        mesh, V, dhat, project_hessian_to_psd);
+
+    Eigen::MatrixXd grads, hessians;
+    constraints.compute_vertex_potential_derivatives(
+        mesh, V, dhat, grads, hessians, project_hessian_to_psd);
+    REQUIRE(grads.rows() == V.rows());
+    REQUIRE(hessians.rows() == V.size());
+
+    for (int vi = 0; vi < V.rows(); vi++) {
+        CHECK(grads.row(vi).transpose().isApprox(
+            expected_grad.segment(dim * vi, dim), 1e-12));
+        if (!project_hessian_to_psd) {
+            // The diagonal blocks of the projected local hessians differ from
+            // the blocks of the projected sum.
+            CHECK(hessians.middleRows(dim * vi, dim)
+                      .isApprox(
+                          expected_hess.block(dim * vi, dim * vi, dim, dim),
+                          1e-12));
+        }
+        if (constraints.num_vertex_constraints(vi) == 0) {
+            CHECK(grads.row(vi).isZero());
+        }
+    }
+
+    // Evaluate a subset of the vertices (e.g., a color group).
+    const std::vector<long> subset = { 3, 0, long(V.rows()) - 1 };
+    Eigen::MatrixXd subset_grads, subset_hessians;
+    constraints.compute_vertex_potential_derivatives(
+        mesh, V, dhat, subset, subset_grads, subset_hessians,
+        project_hessian_to_psd);
+    for (size_t i = 0; i < subset.size(); i++) {
+        CHECK(subset_grads.row(i) == grads.row(subset[i]));
+        CHECK(
+            subset_hessians.middleRows(dim * i, dim)
+            == hessians.middleRows(dim * subset[i], dim));
+    }
+
+    // Modifying the constraints invalidates the vertex incidence.
+    constraints.vv_constraints.emplace_back(0, 1);
+    CHECK_THROWS_AS(
+        constraints.compute_vertex_potential_derivatives(
+            mesh, V, dhat, grads, hessians),
+        std::runtime_error);
+    constraints.build_vertex_incidence(mesh);
+    CHECK(constraints.num_vertex_constraints(0) > 0);
+    CHECK_NOTHROW(constraints.compute_vertex_potential_derivatives(
+        mesh, V, dhat, grads, hessians));
+
+#ifndef NDEBUG
+    // Even if the number of constraints is unchanged (only checked in debug).
+    constraints.vv_constraints.back() = VertexVertexConstraint(0, 2);
+    CHECK_THROWS_AS(
+        constraints.compute_vertex_potential_derivatives(
+            mesh, V, dhat, grads, hessians),
+        std::runtime_error);
+#endif
+}
+
+TEST_CASE("Test asynchronous collision pipeline", "[ipc][async]")
+{
+    const double dhat = 1e-1;
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    CollisionConstraints expected_constraints;
+    expected_constraints.build(mesh, V, dhat);
+
+    CollisionConstraints constraints;
+    std::future<void> built = constraints.build_async(mesh, V, dhat);
+    built.get();
+    REQUIRE(constraints.size() == expected_constraints.size());
+
+    std::future<Eigen::SparseMatrix<double>> hess =
+        constraints.compute_potential_hessian_async(mesh, V, dhat);
+    CHECK(
+        Eigen::MatrixXd(hess.get())
+        == Eigen::MatrixXd(
+            expected_constraints.compute_potential_hessian(mesh, V, dhat)));
+
+    Eigen::MatrixXd V1 = V;
+    V1.col(1) *= -1;
+    std::future<double> step_size =
+        compute_collision_free_stepsize_async(mesh, V, V1);
+    CHECK(
+        step_size.get()
+        == Catch::Approx(compute_collision_free_stepsize(mesh, V, V1))
+               .margin(1e-3));
+
+#ifndef IPC_TOOLKIT_WITH_CUDA
+    // Exceptions are forwarded to the caller
+    CHECK_THROWS_AS(
+        compute_collision_free_stepsize_async(
+            mesh, V, V1, BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU)
+            .get(),
+        std::runtime_error);
+#endif
+}
+
+TEST_CASE("Test cached candidates", "[ipc][candidates]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+
+    const double dhat = 1e-1;
+    const double skin = 2e-2;
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    CachedCandidates cached_candidates(skin);
+    CHECK(cached_candidates.update(mesh, V, dhat / 2, method));
+    CHECK(cached_candidates.num_builds() == 1);
+
+    // Move every vertex by less than skin / 2
+    Eigen::MatrixXd U = Eigen::MatrixXd::Random(V.rows(), V.cols());
+    U.rowwise().normalize();
+    const Eigen::MatrixXd V_small = V + 0.49 * skin / 2 * U;
+
+    CHECK(!cached_candidates.update(mesh, V_small, dhat / 2, method));
+    CHECK(cached_candidates.num_builds() == 1);
+
+    Candidates candidates;
+    candidates.build(mesh, V_small, dhat / 2, method);
+    const Candidates& superset = cached_candidates.candidates();
+    CHECK(superset.size() >= candidates.size());
+
+    // Building the constraints from the superset gives the same potential.
+    CollisionConstraints constraints, expected_constraints;
+    constraints.build(superset, mesh, V_small, dhat);
+    expected_constraints.build(candidates, mesh, V_small, dhat);
+    CHECK(constraints.size() == expected_constraints.size());
+    CHECK(
+        constraints.compute_potential(mesh, V_small, dhat)
+        == Catch::Approx(
+            expected_constraints.compute_potential(mesh, V_small, dhat)));
+
+    // Move a vertex by more than skin / 2
+    Eigen::MatrixXd V_large = V;
+    V_large(0, 0) += skin;
+    CHECK(cached_candidates.update(mesh, V_large, dhat / 2, method));
+    CHECK(cached_candidates.num_builds() == 2);
+
+    // A larger inflation radius needs a new broad phase
+    CHECK(cached_candidates.update(mesh, V_large, dhat, method));
+    CHECK(cached_candidates.num_builds() == 3);
+}
+
+TEST_CASE("Test compact candidates", "[ipc][candidates][compact]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+
+    const double inflation_radius = 1e-2;
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V0, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+    Eigen::MatrixXd V1 = V0;
+    V1.col(1) *= -1;
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1, inflation_radius, method);
+    REQUIRE(!candidates.empty());
+
+    CompactCandidates compact_candidates;
+    compact_candidates.build(mesh, V0, V1, inflation_radius, method);
+    CHECK(compact_candidates.size() == candidates.size());
+
+    // Expanding the compact candidates gives the same (sorted) candidates.
+    const Candidates expanded = compact_candidates.to_candidates();
+    CHECK(expanded.ev_candidates == candidates.ev_candidates);
+    CHECK(expanded.ee_candidates == candidates.ee_candidates);
+    CHECK(expanded.fv_candidates == candidates.fv_candidates);
+
+    // Converting back and deduplicating is a no-op.
+    CompactCandidates converted(candidates);
+    converted.sort_and_deduplicate();
+    CHECK(converted.ee_candidates == compact_candidates.ee_candidates);
+    CHECK(converted.fv_candidates == compact_candidates.fv_candidates);
+
+    CHECK(
+        compact_candidates.compute_collision_free_stepsize(mesh, V0, V1)
+        == Catch::Approx(
+               candidates.compute_collision_free_stepsize(mesh, V0, V1))
+               .margin(1e-3));
+    CHECK(
+        compact_candidates.is_step_collision_free(mesh, V0, V1)
+        == candidates.is_step_collision_free(mesh, V0, V1));
+
+    // Both test the candidates in the same order, so they stop at the same
+    // collision with the same prefilter statistics.
+    CCDPrefilterStatistics statistics, expected_statistics;
+    CHECK(
+        compact_candidates.is_step_collision_free(
+            mesh, V0, V1, /*min_distance=*/0, DEFAULT_CCD_TOLERANCE,
+            DEFAULT_CCD_MAX_ITERATIONS, CCDPrefilterOptions::all(),
+            &statistics)
+        == candidates.is_step_collision_free(
+            mesh, V0, V1, /*min_distance=*/0, DEFAULT_CCD_TOLERANCE,
+            DEFAULT_CCD_MAX_ITERATIONS, CCDPrefilterOptions::all(),
+            &expected_statistics));
+    CHECK(statistics.num_candidates > 0);
+    CHECK(statistics.num_candidates == expected_statistics.num_candidates);
+    CHECK(
+        statistics.num_separating_axis_rejections
+        == expected_statistics.num_separating_axis_rejections);
+    CHECK(
+        statistics.num_coplanarity_rejections
+        == expected_statistics.num_coplanarity_rejections);
+
+    const long too_large_id = long(std::numeric_limits<uint32_t>::max()) + 1;
+    CHECK_THROWS_AS(
+        CompactCandidate::make(too_large_id, 0), std::out_of_range);
+}
+
+TEST_CASE("Test compact collision constraints", "[ipc][compact]")
+{
+    const double dhat = 1e-1;
+    const bool use_convergent_formulation = GENERATE(false, true);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    CollisionConstraints constraints;
+    constraints.set_use_convergent_formulation(use_convergent_formulation);
+    constraints.build(mesh, V, dhat);
+    REQUIRE(!constraints.empty());
+
+    const CompactCollisionConstraints compact_constraints(constraints);
+    CHECK(compact_constraints.size() == constraints.size());
+    // Side arrays are only stored when needed.
+    CHECK(compact_constraints.minimum_distances.empty());
+    CHECK(compact_constraints.weight_gradients.empty());
+    for (size_t i = 0; i < constraints.size(); i++) {
+        CHECK(compact_constraints.weight(i) == constraints[i].weight);
+    }
+
+    CHECK(
+        compact_constraints.compute_potential(mesh, V, dhat)
+        == Catch::Approx(constraints.compute_potential(mesh, V, dhat)));
+    CHECK(compact_constraints.compute_potential_gradient(mesh, V, dhat)
+              .isApprox(
+                  constraints.compute_potential_gradient(mesh, V, dhat),
+                  1e-12));
+    CHECK(Eigen::MatrixXd(
+              compact_constraints.compute_potential_hessian(mesh, V, dhat))
+              .isApprox(
+                  Eigen::MatrixXd(
+                      constraints.compute_potential_hessian(mesh, V, dhat)),
+                  1e-10));
+
+    // Round trip
+    const CollisionConstraints expanded =
+        compact_constraints.to_collision_constraints(mesh);
+    REQUIRE(expanded.size() == constraints.size());
+    CHECK(
+        expanded.use_convergent_formulation()
+        == constraints.use_convergent_formulation());
+    for (size_t i = 0; i < constraints.size(); i++) {
+        CHECK(
+            expanded[i].vertex_ids(mesh.edges(), mesh.faces())
+            == constraints[i].vertex_ids(mesh.edges(), mesh.faces()));
+        CHECK(expanded[i].weight == constraints[i].weight);
+    }
+    CHECK(
+        expanded.compute_potential(mesh, V, dhat)
+        == Catch::Approx(constraints.compute_potential(mesh, V, dhat)));
+
+    // Building from compact candidates gives the same constraints.
+    CompactCandidates candidates;
+    candidates.build(mesh, V, /*inflation_radius=*/dhat / 2);
+    CompactCollisionConstraints built;
+    built.use_convergent_formulation = use_convergent_formulation;
+    built.build(candidates, mesh, V, dhat);
+    CHECK(built.size() == constraints.size());
+    CHECK(
+        built.compute_potential(mesh, V, dhat)
+        == Catch::Approx(constraints.compute_potential(mesh, V, dhat)));
+    CHECK(built.compute_potential_gradient(mesh, V, dhat)
+              .isApprox(
+                  constraints.compute_potential_gradient(mesh, V, dhat),
+                  1e-12));
+
+    // The compact build matches the polymorphic build constraint by constraint.
+    const double dmin = 1e-3;
+    CollisionConstraints reference;
+    reference.set_use_convergent_formulation(use_convergent_formulation);
+    reference.build(candidates, mesh, V, dhat, dmin);
+    built.build(candidates, mesh, V, dhat, dmin);
+    REQUIRE(built.size() == reference.size());
+    const CollisionConstraints built_expanded =
+        built.to_collision_constraints(mesh);
+    for (size_t i = 0; i < reference.size(); i++) {
+        CHECK(
+            built_expanded[i].vertex_ids(mesh.edges(), mesh.faces())
+            == reference[i].vertex_ids(mesh.edges(), mesh.faces()));
+        CHECK(built.minimum_distance(i) == reference[i].minimum_distance);
+        CHECK(built.weight(i) == reference[i].weight);
+    }
+
+    CollisionConstraints with_planes = constraints;
+    with_planes.pv_constraints.emplace_back(
+        Eigen::Vector3d::Zero(), Eigen::Vector3d::UnitY(), 0);
+    CHECK_THROWS_AS(
+        CompactCollisionConstraints(with_planes), std::invalid_argument);
+}
+
+TEST_CASE("Test global minimum distance", "[ipc][distance]")
+{
+    std::string mesh_name = GENERATE("cube.obj", "two-cubes-close.obj");
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh(mesh_name, V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    // Activating every pair makes the constraints' minimum the global minimum.
+    CollisionConstraints constraints;
+    constraints.build(
+        mesh, V, /*dhat=*/world_bbox_diagonal_length(V),
+        /*dmin=*/0, BroadPhaseMethod::BRUTE_FORCE);
+    const double expected_distance =
+        constraints.compute_minimum_distance(mesh, V);
+
+    ClosestPair closest_pair;
+    const double distance = compute_minimum_distance(mesh, V, closest_pair);
+
+    CAPTURE(mesh_name);
+    CHECK(distance == Catch::Approx(expected_distance));
+    REQUIRE(!std::holds_alternative<std::monostate>(closest_pair));
+    std::visit(
+        [&](const auto& candidate) {
+            if constexpr (!std::is_same_v<
+                              std::decay_t<decltype(candidate)>,
+                              std::monostate>) {
+                CHECK(
+                    candidate.compute_distance(V, mesh.edges(), mesh.faces())
+                    == distance);
+            }
+        },
+        closest_pair);
+
+    // The result does not depend on the scheduling.
+    CHECK(compute_minimum_distance(mesh, V) == distance);
+}
@@ -0,0 +1,11 @@
+// Worker of a DistributedBroadPhase started by ipc::launch_local_process.
+// Usage: ipc_toolkit_broad_phase_worker <socket file descriptor>
+
+#include <ipc/broad_phase/distributed_broad_phase.hpp>
+#include <ipc/utils/transport.hpp>
+
+int main(int argc, char* argv[])
+{
+    return ipc::serve_socket_worker(
+        argc, argv, ipc::DistributedBroadPhase::serve);
+}